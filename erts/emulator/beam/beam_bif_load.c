@@ -82,6 +82,7 @@ struct {
     erts_mtx_t mtx;
     ErtsLiteralAreaRef *first;
     ErtsLiteralAreaRef *last;
+    erts_atomic_t pending;	/* Queued and not yet freed */
 } release_literal_areas;
 
 static void set_default_trace_pattern(Eterm module);
@@ -122,6 +123,7 @@ erts_beam_bif_load_init(void)
 
     release_literal_areas.first = NULL;
     release_literal_areas.last = NULL;
+    erts_atomic_init_nob(&release_literal_areas.pending, 0);
     erts_atomic_init_nob(&erts_copy_literal_area__,
 			     (erts_aint_t) NULL);
 
@@ -1342,6 +1344,7 @@ later_release_literal_area(void *vlrlap)
     ErtsLaterReleasLiteralArea *lrlap;
     lrlap = (ErtsLaterReleasLiteralArea *) vlrlap;
     erts_release_literal_area(lrlap->la);
+    erts_atomic_dec_nob(&release_literal_areas.pending);
     erts_free(ERTS_ALC_T_RELEASE_LAREA, vlrlap);
 }
 
@@ -1352,8 +1355,10 @@ complete_literal_area_switch(void *literal_area)
     erts_proc_lock(p, ERTS_PROC_LOCK_STATUS);
     erts_resume(p, ERTS_PROC_LOCK_STATUS);
     erts_proc_unlock(p, ERTS_PROC_LOCK_STATUS);
-    if (literal_area)
+    if (literal_area) {
 	erts_release_literal_area((ErtsLiteralArea *) literal_area);
+	erts_atomic_dec_nob(&release_literal_areas.pending);
+    }
 }
 
 BIF_RETTYPE erts_internal_release_literal_area_switch_0(BIF_ALIST_0)
@@ -1764,6 +1769,13 @@ BIF_RETTYPE erts_internal_purge_module_2(BIF_ALIST_2)
     }
 }
 
+/* Number of literal areas queued for release that are not yet freed */
+Uint
+erts_literal_areas_pending_release(void)
+{
+    return (Uint) erts_atomic_read_nob(&release_literal_areas.pending);
+}
+
 void
 erts_queue_release_literals(Process* c_p, ErtsLiteralArea* literals)
 {
@@ -1773,6 +1785,7 @@ erts_queue_release_literals(Process* c_p, ErtsLiteralArea* literals)
                      sizeof(ErtsLiteralAreaRef));
     ref->literal_area = literals;
     ref->next = NULL;
+    erts_atomic_inc_nob(&release_literal_areas.pending);
     erts_mtx_lock(&release_literal_areas.mtx);
     if (release_literal_areas.last) {
         release_literal_areas.last->next = ref;
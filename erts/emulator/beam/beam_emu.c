@@ -2456,7 +2456,9 @@ erts_hibernate(Process* c_p, Eterm* reg)
 	PROCESS_MAIN_CHK_LOCKS(c_p);
 	erts_proc_lock(c_p, ERTS_PROC_LOCK_MSGQ|ERTS_PROC_LOCK_STATUS);
 	if (!erts_proc_sig_fetch(c_p))
-	    erts_atomic32_read_band_relb(&c_p->state, ~ERTS_PSFLG_ACTIVE);
+	    erts_proc_sig_deactivate(c_p, (ERTS_PROC_LOCK_MAIN
+					   | ERTS_PROC_LOCK_MSGQ
+					   | ERTS_PROC_LOCK_STATUS));
 	ASSERT(!ERTS_PROC_IS_EXITING(c_p));
     }
     erts_proc_unlock(c_p, ERTS_PROC_LOCK_MSGQ|ERTS_PROC_LOCK_STATUS);
@@ -3829,6 +3829,52 @@ gen_literal_timeout_locked(LoaderState* stp, GenOpArg Fail, GenOpArg Time)
     return op;
 }
 
+/*
+ * Generate a loop_rec for a receive whose first clause matches
+ * a tuple with a known tag. i_recv_tagged needs the label of the
+ * loop_rec instruction to be able to restart it.
+ */
+
+static GenOp*
+gen_loop_rec_tagged(LoaderState* stp, GenOpArg L, GenOpArg Fail,
+                    GenOpArg Skip, GenOpArg Arity, GenOpArg Atom)
+{
+    GenOp* label;
+    GenOp* loop_rec;
+    GenOp* recv_tagged;
+    GenOp* is_tagged_tuple;
+
+    NEW_GENOP(stp, label);
+    GENOP_NAME_ARITY(label, label, 1);
+    label->a[0] = L;
+
+    NEW_GENOP(stp, loop_rec);
+    GENOP_NAME_ARITY(loop_rec, i_loop_rec, 1);
+    loop_rec->a[0] = Fail;
+
+    NEW_GENOP(stp, recv_tagged);
+    GENOP_NAME_ARITY(recv_tagged, i_recv_tagged, 4);
+    recv_tagged->a[0].type = TAG_f;
+    recv_tagged->a[0].val = L.val;
+    recv_tagged->a[1] = Skip;
+    recv_tagged->a[2] = Arity;
+    recv_tagged->a[3] = Atom;
+
+    NEW_GENOP(stp, is_tagged_tuple);
+    GENOP_NAME_ARITY(is_tagged_tuple, is_tagged_tuple, 4);
+    is_tagged_tuple->a[0] = Skip;
+    is_tagged_tuple->a[1].type = TAG_x;
+    is_tagged_tuple->a[1].val = 0;
+    is_tagged_tuple->a[2] = Arity;
+    is_tagged_tuple->a[3] = Atom;
+
+    label->next = loop_rec;
+    loop_rec->next = recv_tagged;
+    recv_tagged->next = is_tagged_tuple;
+    is_tagged_tuple->next = NULL;
+    return label;
+}
+
 /*
  * Tag the list of values with tuple arity tags.
  */
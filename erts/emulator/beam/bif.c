@@ -1614,6 +1614,24 @@ BIF_RETTYPE process_flag_2(BIF_ALIST_2)
        MAX_HEAP_SIZE_FLAGS_SET(BIF_P, max_heap_flags);
        BIF_RET(old_value);
    }
+   else if (BIF_ARG_1 == am_tenure_age) {
+       old_value = erts_set_tenure_age(BIF_P, BIF_ARG_2);
+       if (is_non_value(old_value))
+	   goto error;
+       BIF_RET(old_value);
+   }
+   else if (BIF_ARG_1 == am_major_gc_slice) {
+       old_value = erts_set_major_gc_slice(BIF_P, BIF_ARG_2);
+       if (is_non_value(old_value))
+	   goto error;
+       BIF_RET(old_value);
+   }
+   else if (BIF_ARG_1 == am_receive_index) {
+       old_value = erts_proc_sig_set_receive_index(BIF_P, BIF_ARG_2);
+       if (is_non_value(old_value))
+	   goto error;
+       BIF_RET(old_value);
+   }
    else if (BIF_ARG_1 == am_message_queue_data) {
        old_value = erts_change_message_queue_management(BIF_P, BIF_ARG_2);
        if (is_non_value(old_value))
@@ -2313,6 +2331,188 @@ done:
     return retval;
 }
 
+/*
+ * erts_internal:send_many/2 sends a message to all local processes in
+ * a list of destinations with the message copied once, see
+ * erts_send_many_copy(). Each receiver gets a copy of the outermost
+ * tuple, list cell or map of the message only, which keeps everything
+ * a receiver refers to in the shared area reachable from its own
+ * message when the area is collected. Other destinations are returned
+ * for erlang:send_many/2 to send to one at a time.
+ */
+
+#define ERTS_SEND_MANY_DESTS_PER_RED 4
+
+typedef struct {
+    ErtsLiteralArea *area;
+    Eterm msg;
+    Uint size;
+    int copied;
+} ErtsSendManyState;
+
+static Export send_many_trap_export;
+
+static int send_many_state_destructor(Binary *mbp)
+{
+    ErtsSendManyState *state = (ErtsSendManyState *) ERTS_MAGIC_BIN_DATA(mbp);
+    if (state->area)
+        erts_send_many_release(NULL, state->area);
+    return 1;
+}
+
+/* Number of words in the outermost term of msg, 0 if it cannot be shared */
+static Uint send_many_root_size(Eterm msg)
+{
+    Eterm hdr;
+
+    if (is_list(msg))
+        return 2;
+    ASSERT(is_boxed(msg));
+    hdr = *boxed_val(msg);
+    if (is_arity_value(hdr))
+        return arityval(hdr) + 1;
+    if (is_flatmap_header(hdr))
+        return flatmap_get_size(flatmap_val(msg)) + 3;
+    if (is_map_header(hdr)) {
+        ASSERT(is_hashmap_header_head(hdr));
+        return 1 + hashmap_bitcount(MAP_HEADER_VAL(hdr)) + header_arity(hdr);
+    }
+    return 0;
+}
+
+static void send_many_enqueue(Process *c_p, Process *rp, Eterm lit, Uint n)
+{
+    ErtsProcLocks rp_locks = c_p == rp ? ERTS_PROC_LOCK_MAIN : 0;
+    Uint root_sz = is_immed(lit) ? 0 : send_many_root_size(lit);
+    Eterm *root = (is_immed(lit) ? NULL
+                   : is_list(lit) ? list_val(lit)
+                   : boxed_val(lit));
+    ErtsMessage *first = NULL, **last = &first;
+    Uint i;
+
+    for (i = 0; i < n; i++) {
+        Eterm *hp;
+        ErtsMessage *mp = erts_alloc_message(root_sz, &hp);
+        Eterm msg = lit;
+
+        if (root_sz) {
+            sys_memcpy(hp, root, root_sz * sizeof(Eterm));
+            msg = is_list(lit) ? make_list(hp) : make_boxed(hp);
+        }
+        ERL_MESSAGE_TERM(mp) = msg;
+        ERL_MESSAGE_FROM(mp) = c_p->common.id;
+        ERL_MESSAGE_TOKEN(mp) = NIL;
+#ifdef USE_VM_PROBES
+        ERL_MESSAGE_DT_UTAG(mp) = NIL;
+#endif
+        *last = mp;
+        last = &mp->next;
+    }
+    erts_queue_proc_messages(c_p, rp, rp_locks, first, last, n);
+}
+
+static BIF_RETTYPE send_many(Process *c_p, Eterm dests, Eterm state_ref,
+                             ErtsSendManyState *state, Eterm acc)
+{
+    Sint budget = ERTS_BIF_REDS_LEFT(c_p) * ERTS_SEND_MANY_DESTS_PER_RED;
+    Sint used = 0;
+
+    while (is_list(dests) && used < budget) {
+        Eterm to = CAR(list_val(dests));
+
+        dests = CDR(list_val(dests));
+        used++;
+        if (is_internal_pid(to)) {
+            Process *rp;
+            Uint n = 1;
+
+            while (is_list(dests) && CAR(list_val(dests)) == to) {
+                dests = CDR(list_val(dests));
+                n++;
+            }
+            used += n - 1;
+            rp = erts_proc_lookup_raw(to);
+            if (!rp)
+                continue;
+            if (!state->copied) {
+                state->area = erts_send_many_copy(c_p, state->msg, state->size,
+                                                  &state->msg);
+                state->copied = 1;
+            }
+            send_many_enqueue(c_p, rp, state->msg, n);
+        }
+        else {
+            Eterm *hp = HAlloc(c_p, 2);
+            acc = CONS(hp, to, acc);
+        }
+    }
+
+    BUMP_REDS(c_p, used / ERTS_SEND_MANY_DESTS_PER_RED);
+
+    if (is_list(dests)) {
+        if (is_non_value(state_ref)) {
+            Binary *mbp = erts_create_magic_binary(sizeof(ErtsSendManyState),
+                                                   send_many_state_destructor);
+            ErtsSendManyState *saved = ERTS_MAGIC_BIN_DATA(mbp);
+            Eterm *hp = HAlloc(c_p, ERTS_MAGIC_REF_THING_SIZE);
+
+            /* The saved state may only refer to a literal message */
+            if (!state->copied) {
+                state->area = erts_send_many_copy(c_p, state->msg, state->size,
+                                                  &state->msg);
+                state->copied = 1;
+            }
+            *saved = *state;
+            state_ref = erts_mk_magic_ref(&hp, &MSO(c_p), mbp);
+        }
+        BIF_TRAP3(&send_many_trap_export, c_p, dests, state_ref, acc);
+    }
+
+    if (state->area) {
+        erts_send_many_release(c_p, state->area);
+        state->area = NULL;
+    }
+    if (is_not_nil(dests))
+        BIF_ERROR(c_p, BADARG);
+    BIF_RET(acc);
+}
+
+static BIF_RETTYPE send_many_trap_3(BIF_ALIST_3)
+{
+    Binary *mbp = erts_magic_ref2bin(BIF_ARG_2);
+
+    ASSERT(ERTS_MAGIC_BIN_DESTRUCTOR(mbp) == send_many_state_destructor);
+    return send_many(BIF_P, BIF_ARG_1, BIF_ARG_2,
+                     (ErtsSendManyState *) ERTS_MAGIC_BIN_DATA(mbp),
+                     BIF_ARG_3);
+}
+
+BIF_RETTYPE erts_internal_send_many_2(BIF_ALIST_2)
+{
+    ErtsSendManyState state;
+
+    if (is_not_list(BIF_ARG_1) && is_not_nil(BIF_ARG_1))
+        BIF_ERROR(BIF_P, BADARG);
+
+    /* Traced and seq traced sends, and messages that cannot or should
+     * not be shared, are left for erlang:send_many/2 to send one at a
+     * time. */
+    if (IS_TRACED_FL(BIF_P, F_TRACE_SEND)
+        || ERTS_PROC_GET_SAVED_CALLS_BUF(BIF_P)
+        || SEQ_TRACE_TOKEN(BIF_P) != NIL)
+        BIF_RET(BIF_ARG_1);
+    if (is_immed(BIF_ARG_2))
+        state.size = 0;
+    else if (send_many_root_size(BIF_ARG_2) == 0
+             || (state.size = erts_send_many_copy_size(BIF_ARG_2)) == 0)
+        BIF_RET(BIF_ARG_1);
+
+    state.area = NULL;
+    state.msg = BIF_ARG_2;
+    state.copied = is_immed(BIF_ARG_2);
+    return send_many(BIF_P, BIF_ARG_1, THE_NON_VALUE, &state, NIL);
+}
+
 /**********************************************************************/
 /*
  * apply/3 is implemented as an instruction and as erlang code in the
@@ -4703,6 +4903,25 @@ BIF_RETTYPE system_flag_2(BIF_ALIST_2)
 	if (BIF_ARG_2 == am_true || BIF_ARG_2 == am_false)
             BIF_TRAP1(system_flag_scheduler_wall_time_trap,
                       BIF_P, BIF_ARG_2);
+    } else if (BIF_ARG_1 == am_scheduler_wait) {
+	if (BIF_ARG_2 == am_true || BIF_ARG_2 == am_false) {
+	    int old = erts_sched_set_wakeup_latency(BIF_ARG_2 == am_true);
+	    BIF_RET(old ? am_true : am_false);
+	}
+    } else if (BIF_ARG_1 == am_run_queue_delay) {
+	if (BIF_ARG_2 == am_true || BIF_ARG_2 == am_false) {
+	    int old = erts_sched_set_runq_delay(BIF_ARG_2 == am_true);
+	    BIF_RET(old ? am_true : am_false);
+	}
+    } else if (BIF_ARG_1 == am_dirty_queue_weight) {
+	Uint weight, old_weight;
+	if (is_tuple_arity(BIF_ARG_2, 2)) {
+	    Eterm *tp = tuple_val(BIF_ARG_2);
+	    if (term_to_Uint(tp[2], &weight)
+		&& erts_sched_set_dirty_class_weight(tp[1], weight,
+						     &old_weight))
+		BIF_RET(make_small(old_weight));
+	}
     } else if (BIF_ARG_1 == am_dirty_cpu_schedulers_online) {
 	Sint old_no;
 	if (!is_small(BIF_ARG_2))
@@ -5003,6 +5222,10 @@ void erts_init_bif(void)
     erts_init_trap_export(&await_exit_trap, am_erts_internal,
                           am_await_exit, 0, erts_internal_await_exit_trap);
 
+    erts_init_trap_export(&send_many_trap_export,
+			  am_erts_internal, am_send_many_trap, 3,
+			  send_many_trap_3);
+
     flush_monitor_messages_trap = erts_export_put(am_erts_internal,
 						  am_flush_monitor_messages,
 						  3);
@@ -72,6 +72,16 @@ port_info(fmtfn_t to, void *to_arg)
     }
 }
 
+static void
+free_proc_info(fmtfn_t to, void *to_arg, Process *p)
+{
+    while (p) {
+        if (ERTS_PSFLG_FREE & erts_atomic32_read_acqb(&p->state))
+            print_process_info(to, to_arg, p, 0);
+        p = p->next;
+    }
+}
+
 void
 process_info(fmtfn_t to, void *to_arg)
 {
@@ -99,13 +109,13 @@ process_info(fmtfn_t to, void *to_arg)
     /* First loop through all run-queues */
     for (i = 0; i < erts_no_schedulers + ERTS_NUM_DIRTY_RUNQS; i++) {
         ErtsRunQueue *rq = ERTS_RUNQ_IX(i);
-        int j;
+        int j, k;
         for (j = 0; j < ERTS_NO_PROC_PRIO_QUEUES; j++) {
-            Process *p = rq->procs.prio[j].first;
-            while (p) {
-                if (ERTS_PSFLG_FREE & erts_atomic32_read_acqb(&p->state))
-                    print_process_info(to, to_arg, p, 0);
-                p = p->next;
+            free_proc_info(to, to_arg, rq->procs.prio[j].first);
+            if (rq->dirty_classes) {
+                for (k = 0; k < ERTS_DIRTY_RUNQ_CLASSES; k++)
+                    free_proc_info(to, to_arg,
+                                   rq->dirty_classes->cls[k].prio[j].first);
             }
         }
     }
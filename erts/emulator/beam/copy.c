@@ -76,7 +76,83 @@ Eterm copy_object_x(Eterm obj, Process* to, Uint extra)
         (lit_purge_ptr <= (PTR) &&                   \
         (PTR) < (lit_purge_ptr + lit_purge_sz))))
 
-Uint size_object_x(Eterm obj, erts_literal_area_t *litopt)
+/*
+ * A sampling bloom filter over the addresses of the compound terms
+ * visited while sizing a message. Visiting an address that is already
+ * in the filter is a hit; a term without internal sharing only hits on
+ * false positives, while a term that expands much when copied flat
+ * hits on most of the visits into its shared subterms. When an eighth
+ * of the bits are set the filter is cleared and the sampling rate
+ * halved, so a large term is still sampled across its whole extent.
+ */
+
+#define ERTS_SHARING_BLOOM_LOG2 12
+#define ERTS_SHARING_BLOOM_BITS (1 << ERTS_SHARING_BLOOM_LOG2)
+#define ERTS_SHARING_BLOOM_WORDS (ERTS_SHARING_BLOOM_BITS / (8*sizeof(UWord)))
+#define ERTS_SHARING_BLOOM_MAX_FILL (ERTS_SHARING_BLOOM_BITS / 8)
+#define ERTS_SHARING_BLOOM_MAX_SAMPLE_MASK 0xffff
+/* Sharing is not looked for in the first words of a term */
+#define ERTS_SHARING_MIN_WORDS 64
+#define ERTS_SHARING_MIN_VISITS 64
+
+#ifdef ARCH_64
+#  define ERTS_SHARING_BLOOM_MULT ((UWord) 0x9e3779b97f4a7c15)
+#else
+#  define ERTS_SHARING_BLOOM_MULT ((UWord) 0x9e3779b9)
+#endif
+
+typedef struct {
+    UWord bits[ERTS_SHARING_BLOOM_WORDS];
+    UWord sample_mask;
+    Uint fill;
+    Uint visits;
+    Uint hits;
+    int active;
+} ErtsSharingBloom;
+
+static void
+sharing_bloom_visit(ErtsSharingBloom *bloom, Eterm *ptr)
+{
+    UWord h = ((UWord) ptr) * ERTS_SHARING_BLOOM_MULT;
+    UWord ix = h >> (8*sizeof(UWord) - ERTS_SHARING_BLOOM_LOG2);
+    UWord bit = ((UWord) 1) << (ix % (8*sizeof(UWord)));
+    UWord *wp = &bloom->bits[ix / (8*sizeof(UWord))];
+
+    if (!bloom->active) {
+        sys_memzero(bloom->bits, sizeof(bloom->bits));
+        bloom->active = 1;
+    }
+    if ((h >> (8*sizeof(UWord) - ERTS_SHARING_BLOOM_LOG2 - 16))
+        & bloom->sample_mask)
+        return;
+
+    bloom->visits++;
+    if (*wp & bit) {
+        bloom->hits++;
+        return;
+    }
+    *wp |= bit;
+    if (++bloom->fill >= ERTS_SHARING_BLOOM_MAX_FILL) {
+        sys_memzero(bloom->bits, sizeof(bloom->bits));
+        bloom->fill = 0;
+        if (bloom->sample_mask < ERTS_SHARING_BLOOM_MAX_SAMPLE_MASK)
+            bloom->sample_mask = (bloom->sample_mask << 1) | 1;
+    }
+}
+
+#define SHARING_BLOOM_VISIT(Bloom, Ptr, Sum)                            \
+    do {                                                                \
+        if ((Bloom) && (Sum) >= ERTS_SHARING_MIN_WORDS)                 \
+            sharing_bloom_visit((Bloom), (Ptr));                        \
+    } while (0)
+
+/*
+ * If emasculate is set, writable binaries reached are made read-only
+ * as copy_struct() would do when copying them.
+ */
+static ERTS_INLINE Uint
+size_object_bloom(Eterm obj, erts_literal_area_t *litopt,
+                  ErtsSharingBloom *bloom, int emasculate)
 {
     Uint sum = 0;
     Eterm* ptr;
@@ -96,6 +172,7 @@ Uint size_object_x(Eterm obj, erts_literal_area_t *litopt)
             if (litopt && erts_is_literal(obj,ptr) && !in_literal_purge_area(ptr)) {
                 goto pop_next;
             }
+            SHARING_BLOOM_VISIT(bloom, ptr, sum);
 	    sum += 2;
 	    obj = *ptr++;
 	    if (!IS_CONST(obj)) {
@@ -110,6 +187,7 @@ Uint size_object_x(Eterm obj, erts_literal_area_t *litopt)
                 if (litopt && erts_is_literal(obj,ptr) && !in_literal_purge_area(ptr)) {
                     goto pop_next;
                 }
+                SHARING_BLOOM_VISIT(bloom, ptr, sum);
                 hdr = *ptr;
 		ASSERT(is_header(hdr));
 		switch (hdr & _TAG_HEADER_MASK) {
@@ -211,6 +289,10 @@ Uint size_object_x(Eterm obj, erts_literal_area_t *litopt)
 			}
 			hdr = *binary_val(real_bin);
 			if (thing_subtag(hdr) == REFC_BINARY_SUBTAG) {
+			    ProcBin *pb = (ProcBin *) binary_val(real_bin);
+			    if (emasculate && pb->flags) {
+				erts_emasculate_writable_binary(pb);
+			    }
 			    sum += PROC_BIN_SIZE;
 			} else {
 			    sum += heap_bin_size(binary_size(obj)+extra_bytes);
@@ -221,6 +303,12 @@ Uint size_object_x(Eterm obj, erts_literal_area_t *litopt)
                 case BIN_MATCHSTATE_SUBTAG:
 		    erts_exit(ERTS_ABORT_EXIT,
 			     "size_object: matchstate term not allowed");
+		case REFC_BINARY_SUBTAG:
+		    if (emasculate && ((ProcBin *) ptr)->flags) {
+			erts_emasculate_writable_binary((ProcBin *) ptr);
+		    }
+		    sum += thing_arityval(hdr) + 1;
+		    goto pop_next;
 		default:
 		    sum += thing_arityval(hdr) + 1;
 		    goto pop_next;
@@ -242,6 +330,33 @@ Uint size_object_x(Eterm obj, erts_literal_area_t *litopt)
     }
 }
 
+Uint size_object_x(Eterm obj, erts_literal_area_t *litopt)
+{
+    return size_object_bloom(obj, litopt, NULL, 0);
+}
+
+/*
+ * Return the flat size of the object, like size_object_x(), and set
+ * *sharedp if the object looks like it has enough internal sharing for
+ * a sharing-preserving copy to be worth considering.
+ */
+Uint erts_size_object_sharing_hint(Eterm obj, erts_literal_area_t *litopt,
+                                   int *sharedp)
+{
+    ErtsSharingBloom bloom;
+    Uint sum;
+
+    bloom.sample_mask = 0;
+    bloom.fill = 0;
+    bloom.visits = 0;
+    bloom.hits = 0;
+    bloom.active = 0;
+    sum = size_object_bloom(obj, litopt, &bloom, 0);
+    *sharedp = (bloom.visits >= ERTS_SHARING_MIN_VISITS
+                && bloom.hits * 4 >= bloom.visits);
+    return sum;
+}
+
 /*
  *  Machinery for sharing preserving information
  *  Using a WSTACK but not very transparently; consider refactoring
@@ -954,6 +1069,527 @@ Eterm copy_struct_x(Eterm obj, Uint sz, Eterm** hpp, ErlOffHeap* off_heap, Uint
 }
 
 
+/*
+ *  Parallel copy of large terms
+ *
+ *  A term of at least erts_par_copy_threshold words is split into a
+ *  skeleton and a number of parts. The skeleton is made up of the
+ *  tuples, maps and short lists closest to the root of the term and is
+ *  copied by the calling thread. A part is either a range of slots in a
+ *  skeleton node or a segment of a long list, and is copied with
+ *  copy_struct_x() into an area of its own. Idle dirty CPU schedulers
+ *  pick up parts while the caller copies the rest of them itself, so the
+ *  copy never waits for a helper that does not show up. The result is
+ *  laid out as the skeleton followed by the parts in one contiguous heap
+ *  area of exactly the size returned by erts_par_copy_calculate().
+ */
+
+#define ERTS_PAR_COPY_PART_WORDS (16*1024)
+#define ERTS_PAR_COPY_MAX_DEPTH 3
+#define ERTS_PAR_COPY_WIDE 16
+#define ERTS_PAR_COPY_NO_DST (~((Uint) 0))
+#define ERTS_PAR_COPY_SPIN_UNTIL_YIELD 100
+
+Uint erts_par_copy_threshold;
+
+static erts_mtx_t par_copy_jobs_mtx;
+static ErtsParCopy *par_copy_jobs;
+static erts_atomic32_t par_copy_no_jobs;
+
+void
+erts_init_par_copy(void)
+{
+    erts_mtx_init(&par_copy_jobs_mtx, "par_copy_jobs", NIL,
+                  ERTS_LOCK_FLAGS_PROPERTY_STATIC | ERTS_LOCK_FLAGS_CATEGORY_GENERIC);
+    par_copy_jobs = NULL;
+    erts_atomic32_init_nob(&par_copy_no_jobs, 0);
+}
+
+static ERTS_INLINE int
+par_copy_is_literal(Eterm obj, erts_literal_area_t *litopt)
+{
+    Eterm *lit_purge_ptr;
+    Uint lit_purge_sz;
+    Eterm *ptr;
+
+    if (!litopt)
+        return 0;
+    lit_purge_ptr = litopt->lit_purge_ptr;
+    lit_purge_sz = litopt->lit_purge_sz;
+    ptr = ptr_val(obj);
+    return erts_is_literal(obj, ptr) && !in_literal_purge_area(ptr);
+}
+
+/* Tuples, maps and lists can be part of the skeleton */
+static ERTS_INLINE int
+par_copy_is_node(Eterm obj, erts_literal_area_t *litopt)
+{
+    if (is_list(obj))
+        return !par_copy_is_literal(obj, litopt);
+    if (is_boxed(obj)) {
+        Eterm hdr = *boxed_val(obj);
+        if (is_arity_value(hdr) || is_map_header(hdr))
+            return !par_copy_is_literal(obj, litopt);
+    }
+    return 0;
+}
+
+static int
+par_copy_is_short_list(Eterm list, erts_literal_area_t *litopt)
+{
+    int n;
+
+    for (n = 0; n < ERTS_PAR_COPY_WIDE; n++) {
+        list = CDR(list_val(list));
+        if (!is_list(list) || par_copy_is_literal(list, litopt))
+            return 1;
+    }
+    return 0;
+}
+
+static void *
+par_copy_grow(void *vec, void *def, Uint *szp, size_t esz)
+{
+    Uint sz = *szp * 2;
+    void *res;
+
+    if (vec == def) {
+        res = erts_alloc(ERTS_ALC_T_TMP, sz * esz);
+        sys_memcpy(res, vec, *szp * esz);
+    }
+    else {
+        res = erts_realloc(ERTS_ALC_T_TMP, vec, sz * esz);
+    }
+    *szp = sz;
+    return res;
+}
+
+/*
+ * Size a subterm that will be copied by a helper. Writable binaries in
+ * it are made read-only here, on the sending thread, so that the
+ * helpers copying the parts never have to.
+ */
+static ERTS_INLINE Uint
+par_copy_size(ErtsParCopy *pc, Eterm obj)
+{
+    return size_object_bloom(obj, pc->litopt, NULL, 1);
+}
+
+static Uint
+par_copy_add_node(ErtsParCopy *pc, Eterm *src, Uint size, Uint dst, int list)
+{
+    ErtsParCopyNode *node;
+    Uint offs = pc->skel_words;
+
+    if (pc->nnodes == pc->nodes_sz)
+        pc->nodes = par_copy_grow(pc->nodes, pc->nodes_default,
+                                  &pc->nodes_sz, sizeof(ErtsParCopyNode));
+    node = &pc->nodes[pc->nnodes++];
+    node->src = src;
+    node->size = size;
+    node->dst = dst;
+    node->list = list;
+    pc->skel_words += size;
+    return offs;
+}
+
+static Sint
+par_copy_add_part(ErtsParCopy *pc, Eterm *src, Uint dst, int list)
+{
+    ErtsParCopyPart *part;
+
+    if (pc->nparts == pc->parts_sz)
+        pc->parts = par_copy_grow(pc->parts, pc->parts_default,
+                                  &pc->parts_sz, sizeof(ErtsParCopyPart));
+    part = &pc->parts[pc->nparts];
+    part->src = src;
+    part->n = 0;
+    part->size = 0;
+    part->dst = dst;
+    part->tail = THE_NON_VALUE;
+    part->list = list;
+    return (Sint) pc->nparts++;
+}
+
+/*
+ * Add the slot to the open part if it follows it and the part is not
+ * yet full, otherwise open a new part. Immediates between the slots of
+ * a part are skipped when the part is copied.
+ */
+static Uint
+par_copy_slot(ErtsParCopy *pc, Eterm *slotp, Uint dst, Sint *openp)
+{
+    ErtsParCopyPart *part;
+    Uint sz = par_copy_size(pc, *slotp);
+
+    if (*openp < 0 || pc->parts[*openp].size >= ERTS_PAR_COPY_PART_WORDS)
+        *openp = par_copy_add_part(pc, slotp, dst, 0);
+    part = &pc->parts[*openp];
+    part->n = slotp - part->src + 1;
+    part->size += sz;
+    return sz;
+}
+
+static Uint par_copy_node(ErtsParCopy *pc, Eterm obj, Uint dst, int depth);
+
+static Uint
+par_copy_list(ErtsParCopy *pc, Eterm obj, Uint dst, int depth)
+{
+    Eterm *cellp = list_val(obj);
+    Eterm tail;
+    Uint sz = 0;
+    Sint open;
+
+    if (depth < ERTS_PAR_COPY_MAX_DEPTH
+        && par_copy_is_short_list(obj, pc->litopt)) {
+        while (1) {
+            Uint offs = par_copy_add_node(pc, cellp, 2, dst, 1);
+            Eterm car = CAR(cellp);
+
+            sz += 2;
+            open = -1;
+            if (!IS_CONST(car) && !par_copy_is_literal(car, pc->litopt)) {
+                if (par_copy_is_node(car, pc->litopt))
+                    sz += par_copy_node(pc, car, offs, depth + 1);
+                else
+                    sz += par_copy_slot(pc, &CAR(cellp), offs, &open);
+            }
+            dst = offs + 1;
+            tail = CDR(cellp);
+            if (is_list(tail) && !par_copy_is_literal(tail, pc->litopt)) {
+                cellp = list_val(tail);
+                continue;
+            }
+            if (!IS_CONST(tail) && !par_copy_is_literal(tail, pc->litopt)) {
+                open = -1;
+                if (par_copy_is_node(tail, pc->litopt))
+                    sz += par_copy_node(pc, tail, dst, depth + 1);
+                else
+                    sz += par_copy_slot(pc, &CDR(cellp), dst, &open);
+            }
+            return sz;
+        }
+    }
+
+    open = par_copy_add_part(pc, cellp, dst, 1);
+    while (1) {
+        ErtsParCopyPart *part = &pc->parts[open];
+        Eterm car = CAR(cellp);
+        Uint csz = 2;
+
+        if (!IS_CONST(car))
+            csz += par_copy_size(pc, car);
+        part->n++;
+        part->size += csz;
+        sz += csz;
+        tail = CDR(cellp);
+        if (is_list(tail) && !par_copy_is_literal(tail, pc->litopt)) {
+            cellp = list_val(tail);
+            if (part->size >= ERTS_PAR_COPY_PART_WORDS)
+                open = par_copy_add_part(pc, cellp, ERTS_PAR_COPY_NO_DST, 1);
+            continue;
+        }
+        part->tail = tail;
+        if (!IS_CONST(tail)) {
+            csz = par_copy_size(pc, tail);
+            part->size += csz;
+            sz += csz;
+        }
+        return sz;
+    }
+}
+
+static Uint
+par_copy_node(ErtsParCopy *pc, Eterm obj, Uint dst, int depth)
+{
+    Eterm *objp;
+    Eterm hdr;
+    Uint raw, n, i, offs, sz;
+    Sint open = -1;
+    int expand;
+
+    if (is_list(obj))
+        return par_copy_list(pc, obj, dst, depth);
+
+    objp = boxed_val(obj);
+    hdr = *objp;
+    if (is_arity_value(hdr)) {
+        raw = 1;
+        n = arityval(hdr);
+    }
+    else {
+        switch (MAP_HEADER_TYPE(hdr)) {
+        case MAP_HEADER_TAG_FLATMAP_HEAD:
+            raw = 2;
+            n = flatmap_get_size(objp) + 1;
+            break;
+        case MAP_HEADER_TAG_HAMT_HEAD_BITMAP:
+        case MAP_HEADER_TAG_HAMT_HEAD_ARRAY:
+            raw = 2;
+            n = hashmap_bitcount(MAP_HEADER_VAL(hdr));
+            break;
+        default:
+            ASSERT(MAP_HEADER_TYPE(hdr) == MAP_HEADER_TAG_HAMT_NODE_BITMAP);
+            raw = 1;
+            n = hashmap_bitcount(MAP_HEADER_VAL(hdr));
+            break;
+        }
+    }
+
+    offs = par_copy_add_node(pc, objp, raw + n, dst, 0);
+    sz = raw + n;
+    expand = n <= ERTS_PAR_COPY_WIDE && depth < ERTS_PAR_COPY_MAX_DEPTH;
+    for (i = 0; i < n; i++) {
+        Eterm *slotp = objp + raw + i;
+
+        if (IS_CONST(*slotp) || par_copy_is_literal(*slotp, pc->litopt))
+            continue;
+        if (expand && par_copy_is_node(*slotp, pc->litopt)) {
+            sz += par_copy_node(pc, *slotp, offs + raw + i, depth + 1);
+            open = -1;
+        }
+        else {
+            sz += par_copy_slot(pc, slotp, offs + raw + i, &open);
+        }
+    }
+    return sz;
+}
+
+/*
+ * Calculate the size of a term that is to be copied by
+ * erts_par_copy_perform(), splitting it into parts if it is large
+ * enough to be copied in parallel.
+ */
+Uint
+erts_par_copy_calculate(Eterm obj, ErtsParCopy *pc, erts_literal_area_t *litopt)
+{
+    Uint sz;
+
+    pc->litopt = litopt;
+    if (!erts_par_copy_threshold || !par_copy_is_node(obj, litopt))
+        return size_object_litopt(obj, litopt);
+
+    sz = par_copy_node(pc, obj, ERTS_PAR_COPY_NO_DST, 0);
+    ASSERT(sz == size_object_litopt(obj, litopt));
+    if (sz < erts_par_copy_threshold)
+        pc->nparts = 0;
+    return sz;
+}
+
+static void
+par_copy_part(ErtsParCopy *pc, Uint ix)
+{
+    ErtsParCopyPart *part = &pc->parts[ix];
+    erts_literal_area_t *litopt = pc->litopt;
+    Eterm *hp = part->hp;
+    Eterm *hbot = part->hp + part->size;
+    struct erl_off_heap_header *ohh;
+    ErlOffHeap oh;
+    Eterm obj;
+    Uint bsz, i;
+
+    ERTS_INIT_OFF_HEAP(&oh);
+
+    if (!part->list) {
+        Eterm *dst = pc->skel + part->dst;
+        for (i = 0; i < part->n; i++) {
+            obj = part->src[i];
+            if (IS_CONST(obj) || par_copy_is_literal(obj, litopt))
+                continue;
+            dst[i] = copy_struct_x(obj, hbot - hp, &hp, &oh, &bsz, litopt);
+            hbot -= bsz;
+        }
+    }
+    else {
+        Eterm *cellp = part->src;
+        Eterm *cells = hp;
+
+        hp += 2 * part->n;
+        for (i = 0; i < part->n; i++) {
+            obj = CAR(cellp);
+            if (!IS_CONST(obj) && !par_copy_is_literal(obj, litopt)) {
+                obj = copy_struct_x(obj, hbot - hp, &hp, &oh, &bsz, litopt);
+                hbot -= bsz;
+            }
+            CAR(cells + 2*i) = obj;
+            if (i + 1 < part->n) {
+                CDR(cells + 2*i) = make_list(cells + 2*(i + 1));
+                cellp = list_val(CDR(cellp));
+            }
+        }
+        obj = part->tail;
+        if (is_non_value(obj)) {
+            ASSERT(ix + 1 < pc->nparts && pc->parts[ix + 1].list);
+            obj = make_list(pc->parts[ix + 1].hp);
+        }
+        else if (!IS_CONST(obj) && !par_copy_is_literal(obj, litopt)) {
+            obj = copy_struct_x(obj, hbot - hp, &hp, &oh, &bsz, litopt);
+            hbot -= bsz;
+        }
+        CDR(cells + 2*(part->n - 1)) = obj;
+    }
+
+    ASSERT(hp == hbot);
+
+    part->oh_first = oh.first;
+    part->oh_overhead = oh.overhead;
+    ohh = oh.first;
+    if (ohh) {
+        while (ohh->next)
+            ohh = ohh->next;
+    }
+    part->oh_last = ohh;
+}
+
+static void
+par_copy_work(ErtsParCopy *pc)
+{
+    Uint ix, done = 0;
+
+    while (1) {
+        ix = (Uint) erts_atomic_inc_read_nob(&pc->claimed) - 1;
+        if (ix >= pc->nparts)
+            break;
+        par_copy_part(pc, ix);
+        done++;
+    }
+    if (done)
+        erts_atomic_add_relb(&pc->done, (erts_aint_t) done);
+}
+
+/*
+ * Called by idle dirty CPU schedulers before they go to sleep.
+ */
+void
+erts_par_copy_help(void)
+{
+    ErtsParCopy *pc;
+
+    if (!erts_atomic32_read_nob(&par_copy_no_jobs))
+        return;
+
+    while (1) {
+        erts_mtx_lock(&par_copy_jobs_mtx);
+        for (pc = par_copy_jobs; pc; pc = pc->next) {
+            if ((Uint) erts_atomic_read_nob(&pc->claimed) < pc->nparts)
+                break;
+        }
+        if (!pc) {
+            erts_mtx_unlock(&par_copy_jobs_mtx);
+            return;
+        }
+        erts_atomic32_inc_nob(&pc->helpers);
+        erts_mtx_unlock(&par_copy_jobs_mtx);
+
+        par_copy_work(pc);
+
+        /* pc may be gone as soon as we have left it */
+        erts_atomic32_dec_relb(&pc->helpers);
+    }
+}
+
+static void
+par_copy_run(ErtsParCopy *pc)
+{
+    ErtsParCopy **pcpp;
+    int until_yield = ERTS_PAR_COPY_SPIN_UNTIL_YIELD;
+    Uint wake;
+
+    erts_atomic_init_nob(&pc->claimed, 0);
+    erts_atomic_init_nob(&pc->done, 0);
+    erts_atomic32_init_nob(&pc->helpers, 0);
+
+    erts_mtx_lock(&par_copy_jobs_mtx);
+    pc->next = par_copy_jobs;
+    par_copy_jobs = pc;
+    erts_atomic32_inc_nob(&par_copy_no_jobs);
+    erts_mtx_unlock(&par_copy_jobs_mtx);
+
+    wake = pc->nparts - 1;
+    if (wake > erts_no_dirty_cpu_schedulers)
+        wake = erts_no_dirty_cpu_schedulers;
+    erts_wake_dirty_cpu_schedulers((int) wake);
+
+    par_copy_work(pc);
+
+    while ((Uint) erts_atomic_read_acqb(&pc->done) != pc->nparts) {
+        ERTS_SPIN_BODY;
+        if (--until_yield == 0) {
+            until_yield = ERTS_PAR_COPY_SPIN_UNTIL_YIELD;
+            erts_thr_yield();
+        }
+    }
+
+    erts_mtx_lock(&par_copy_jobs_mtx);
+    for (pcpp = &par_copy_jobs; *pcpp != pc; pcpp = &(*pcpp)->next)
+        ASSERT(*pcpp);
+    *pcpp = pc->next;
+    erts_atomic32_dec_nob(&par_copy_no_jobs);
+    erts_mtx_unlock(&par_copy_jobs_mtx);
+
+    while (erts_atomic32_read_acqb(&pc->helpers))
+        ERTS_SPIN_BODY;
+}
+
+/*
+ * Copy a term sized by erts_par_copy_calculate() to *hpp. Terms that
+ * were not split are copied by copy_struct() as usual. Writable
+ * binaries in the parts were already made read-only while sizing them.
+ */
+Eterm
+erts_par_copy_perform(Eterm obj, Uint sz, ErtsParCopy *pc, Eterm **hpp,
+                      ErlOffHeap *off_heap)
+{
+    Eterm *skel = *hpp;
+    Eterm *hp;
+    Eterm res;
+    Uint i, offs;
+
+    if (pc->nparts < 2)
+        return copy_struct_litopt(obj, sz, hpp, off_heap, pc->litopt);
+
+    offs = 0;
+    for (i = 0; i < pc->nnodes; i++) {
+        ErtsParCopyNode *node = &pc->nodes[i];
+        sys_memcpy(skel + offs, node->src, node->size * sizeof(Eterm));
+        if (node->dst != ERTS_PAR_COPY_NO_DST)
+            skel[node->dst] = (node->list
+                               ? make_list(skel + offs)
+                               : make_boxed(skel + offs));
+        offs += node->size;
+    }
+
+    hp = skel + pc->skel_words;
+    for (i = 0; i < pc->nparts; i++) {
+        ErtsParCopyPart *part = &pc->parts[i];
+        part->hp = hp;
+        hp += part->size;
+        if (part->list && part->dst != ERTS_PAR_COPY_NO_DST)
+            skel[part->dst] = make_list(part->hp);
+    }
+    ASSERT(hp == skel + sz);
+
+    if (pc->nnodes)
+        res = pc->nodes[0].list ? make_list(skel) : make_boxed(skel);
+    else
+        res = make_list(pc->parts[0].hp);
+
+    pc->skel = skel;
+    par_copy_run(pc);
+
+    for (i = 0; i < pc->nparts; i++) {
+        ErtsParCopyPart *part = &pc->parts[i];
+        if (part->oh_first) {
+            part->oh_last->next = off_heap->first;
+            off_heap->first = part->oh_first;
+        }
+        OH_OVERHEAD(off_heap, part->oh_overhead);
+    }
+
+    *hpp = hp;
+    return res;
+}
+
 /*
  *  Machinery for the table used by the sharing preserving copier
  *  Using an ESTACK but not very transparently; consider refactoring
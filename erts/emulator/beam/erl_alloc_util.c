@@ -3557,12 +3557,53 @@ cpool_delete(Allctr_t *allctr, Allctr_t *prev_allctr, Carrier_t *crr)
 
 }
 
+/*
+ * Try to employ a carrier found in the shared pool. 'exp' is the
+ * expected value of crr->allctr, i.e. in pool and not busy.
+ */
+static ERTS_INLINE int
+cpool_employ(Allctr_t *allctr, Carrier_t *crr, erts_aint_t exp)
+{
+    erts_aint_t act;
+    erts_aint_t want = (((erts_aint_t) allctr)
+                        | (exp & ERTS_CRR_ALCTR_FLG_HOMECOMING));
+    /* Try to fetch it... */
+    act = erts_atomic_cmpxchg_mb(&crr->allctr, want, exp);
+    if (act != exp)
+        return 0;
+    cpool_delete(allctr, ((Allctr_t *) (act & ~ERTS_CRR_ALCTR_FLG_MASK)), crr);
+    if (crr->cpool.orig_allctr == allctr) {
+        unlink_abandoned_carrier(crr);
+        crr->cpool.state = ERTS_MBC_IS_HOME;
+    }
+    return 1;
+}
+
+/*
+ * In NUMA aware mode, carriers created on another NUMA node than
+ * the one of the calling scheduler are only employed if no carrier
+ * from our own node was found. The first one seen is retried here.
+ * It cannot have been deallocated since we saw it, since that
+ * requires thread progress which we are preventing.
+ */
+static ERTS_INLINE int
+cpool_employ_numa_fallback(Allctr_t *allctr, Carrier_t *crr, UWord size)
+{
+    erts_aint_t exp = erts_atomic_read_rb(&crr->allctr);
+    if (erts_atomic_read_nob(&crr->cpool.max_size) < size
+        || ((exp & (ERTS_CRR_ALCTR_FLG_IN_POOL | ERTS_CRR_ALCTR_FLG_BUSY))
+            != ERTS_CRR_ALCTR_FLG_IN_POOL))
+        return 0;
+    return cpool_employ(allctr, crr, exp);
+}
+
 static Carrier_t *
 cpool_fetch(Allctr_t *allctr, UWord size)
 {
-    int i, seen_sentinel;
+    int i, seen_sentinel, numa_node;
     Carrier_t *crr;
     Carrier_t *reinsert_crr = NULL;
+    Carrier_t *numa_crr = NULL;
     ErtsAlcCPoolData_t *cpdp;
     ErtsAlcCPoolData_t *cpool_entrance = NULL;
     ErtsAlcCPoolData_t *sentinel;
@@ -3686,6 +3727,8 @@ cpool_fetch(Allctr_t *allctr, UWord size)
 	    goto check_dc_list;
     }
 
+    numa_node = erts_sched_numa_aware ? erts_get_numa_node() : -1;
+
     cpdp = cpool_entrance;
     seen_sentinel = 0;
     do {
@@ -3708,21 +3751,15 @@ cpool_fetch(Allctr_t *allctr, UWord size)
         if (erts_atomic_read_nob(&cpdp->max_size) < size) {
             INC_CC(allctr->cpool.stat.skip_size);
         }
+        else if (numa_node >= 0 && cpdp->numa_node != numa_node) {
+            if (!numa_crr)
+                numa_crr = crr;
+            INC_CC(allctr->cpool.stat.skip_numa);
+        }
         else if ((exp & (ERTS_CRR_ALCTR_FLG_IN_POOL | ERTS_CRR_ALCTR_FLG_BUSY))
                   == ERTS_CRR_ALCTR_FLG_IN_POOL) {
-	    erts_aint_t act;
-            erts_aint_t want = (((erts_aint_t) allctr)
-                                | (exp & ERTS_CRR_ALCTR_FLG_HOMECOMING));
-            /* Try to fetch it... */
-	    act = erts_atomic_cmpxchg_mb(&crr->allctr, want, exp);
-	    if (act == exp) {
-		cpool_delete(allctr, ((Allctr_t *) (act & ~ERTS_CRR_ALCTR_FLG_MASK)), crr);
-		if (crr->cpool.orig_allctr == allctr) {
-		    unlink_abandoned_carrier(crr);
-                    crr->cpool.state = ERTS_MBC_IS_HOME;
-                }
+	    if (cpool_employ(allctr, crr, exp))
 		return crr;
-	    }
 	}
 
         if (exp & ERTS_CRR_ALCTR_FLG_BUSY)
@@ -3732,10 +3769,15 @@ cpool_fetch(Allctr_t *allctr, UWord size)
 
 	if (--i <= 0) {
             INC_CC(allctr->cpool.stat.fail_shared);
+	    if (numa_crr && cpool_employ_numa_fallback(allctr, numa_crr, size))
+		return numa_crr;
 	    return NULL;
         }
     }while (cpdp != cpool_entrance);
 
+    if (numa_crr && cpool_employ_numa_fallback(allctr, numa_crr, size))
+        return numa_crr;
+
 check_dc_list:
     /* Last; check our own pending dealloc carrier list... */
     crr = allctr->cpool.dc_list.last;
@@ -3911,6 +3953,7 @@ cpool_init_carrier_data(Allctr_t *allctr, Carrier_t *crr)
     erts_atomic_init_nob(&crr->cpool.next, ERTS_AINT_NULL);
     erts_atomic_init_nob(&crr->cpool.prev, ERTS_AINT_NULL);
     crr->cpool.orig_allctr = allctr;
+    crr->cpool.numa_node = erts_get_numa_node();
     crr->cpool.thr_prgr = ERTS_THR_PRGR_INVALID;
     erts_atomic_init_nob(&crr->cpool.max_size, 0);
     sys_memset(&crr->cpool.blocks_size, 0, sizeof(crr->cpool.blocks_size));
@@ -4625,6 +4668,7 @@ static struct {
     Eterm skip_not_pooled;
     Eterm skip_homecoming;
     Eterm skip_race;
+    Eterm skip_numa;
     Eterm entrance_removed;
     Eterm sbcs;
 
@@ -4728,6 +4772,7 @@ init_atoms(Allctr_t *allctr)
         AM_INIT(skip_not_pooled);
         AM_INIT(skip_homecoming);
         AM_INIT(skip_race);
+        AM_INIT(skip_numa);
         AM_INIT(entrance_removed);
 	AM_INIT(sbcs);
 
@@ -5057,6 +5102,10 @@ info_cpool(Allctr_t *allctr,
                  bld_unstable_uint(hpp, szp, ERTS_ALC_CC_GIGA_VAL(allctr->cpool.stat.skip_race)),
                  bld_unstable_uint(hpp, szp, ERTS_ALC_CC_VAL(allctr->cpool.stat.skip_race)));
 
+        add_3tup(hpp, szp, &res, am.skip_numa,
+                 bld_unstable_uint(hpp, szp, ERTS_ALC_CC_GIGA_VAL(allctr->cpool.stat.skip_numa)),
+                 bld_unstable_uint(hpp, szp, ERTS_ALC_CC_VAL(allctr->cpool.stat.skip_numa)));
+
         add_3tup(hpp, szp, &res, am.entrance_removed,
                  bld_unstable_uint(hpp, szp, ERTS_ALC_CC_GIGA_VAL(allctr->cpool.stat.entrance_removed)),
                  bld_unstable_uint(hpp, szp, ERTS_ALC_CC_VAL(allctr->cpool.stat.entrance_removed)));
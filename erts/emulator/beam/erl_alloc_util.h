@@ -453,6 +453,7 @@ typedef struct {
     erts_atomic_t next;
     erts_atomic_t prev;
     Allctr_t *orig_allctr;      /* read-only while carrier is alive */
+    int numa_node;              /* read-only while carrier is alive */
     ErtsThrPrgrVal thr_prgr;
     erts_atomic_t max_size;
     UWord abandon_limit;
@@ -668,6 +669,7 @@ struct Allctr_t_ {
 	    CallCounter_t       skip_not_pooled;
 	    CallCounter_t       skip_homecoming;
 	    CallCounter_t       skip_race;
+	    CallCounter_t       skip_numa;
 	    CallCounter_t       entrance_removed;
 	} stat;
     } cpool;
@@ -766,7 +766,7 @@ static ErtsProcessInfoArgs pi_args[] = {
     {am_heap_size, 0, 0, ERTS_PROC_LOCK_MAIN},
     {am_stack_size, 0, 0, ERTS_PROC_LOCK_MAIN},
     {am_memory, 0, ERTS_PI_FLAG_NEED_MSGQ_LEN|ERTS_PI_FLAG_FORCE_SIG_SEND, ERTS_PROC_LOCK_MAIN},
-    {am_garbage_collection, 3+2 + 3+2 + 3+2 + 3+2 + 3+2 + ERTS_MAX_HEAP_SIZE_MAP_SZ, 0, ERTS_PROC_LOCK_MAIN},
+    {am_garbage_collection, 3+2 + 3+2 + 3+2 + 3+2 + 3+2 + 3+2 + ERTS_MAX_HEAP_SIZE_MAP_SZ, 0, ERTS_PROC_LOCK_MAIN},
     {am_group_leader, 0, 0, ERTS_PROC_LOCK_MAIN},
     {am_reductions, 0, 0, ERTS_PROC_LOCK_MAIN},
     {am_priority, 0, 0, 0},
@@ -784,7 +784,7 @@ static ErtsProcessInfoArgs pi_args[] = {
     {am_current_location, 0, ERTS_PI_FLAG_FORCE_SIG_SEND, ERTS_PROC_LOCK_MAIN},
     {am_current_stacktrace, 0, ERTS_PI_FLAG_FORCE_SIG_SEND, ERTS_PROC_LOCK_MAIN},
     {am_message_queue_data, 0, 0, ERTS_PROC_LOCK_MAIN},
-    {am_garbage_collection_info, ERTS_PROCESS_GC_INFO_MAX_SIZE, 0, ERTS_PROC_LOCK_MAIN},
+    {am_garbage_collection_info, ERTS_PROCESS_GC_INFO_MAX_SIZE + ERTS_GC_AGE_SURVIVAL_MAX_SIZE, 0, ERTS_PROC_LOCK_MAIN},
     {am_magic_ref, 0, ERTS_PI_FLAG_FORCE_SIG_SEND, ERTS_PROC_LOCK_MAIN},
     {am_fullsweep_after, 0, 0, ERTS_PROC_LOCK_MAIN}
 };
@@ -1805,7 +1805,7 @@ process_info_aux(Process *c_p,
 
         erts_max_heap_size_map(MAX_HEAP_SIZE_GET(rp), MAX_HEAP_SIZE_FLAGS_GET(rp), NULL, &map_sz);
 
-        hp = erts_produce_heap(hfact, 3+2 + 3+2 + 3+2 + 3+2 + 3+2 + map_sz, reserve_size);
+        hp = erts_produce_heap(hfact, 3+2 + 3+2 + 3+2 + 3+2 + 3+2 + 3+2 + 3+2 + map_sz, reserve_size);
 
 	t = TUPLE2(hp, AM_minor_gcs, make_small(GEN_GCS(rp))); hp += 3;
 	res = CONS(hp, t, NIL); hp += 2;
@@ -1821,16 +1821,36 @@ process_info_aux(Process *c_p,
 
 	t = TUPLE2(hp, am_max_heap_size, t); hp += 3;
 	res = CONS(hp, t, res); hp += 2;
+	t = TUPLE2(hp, am_tenure_age, make_small(erts_get_tenure_age(rp))); hp += 3;
+	res = CONS(hp, t, res); hp += 2;
+	t = TUPLE2(hp, am_major_gc_slice, make_small(erts_get_major_gc_slice(rp))); hp += 3;
+	res = CONS(hp, t, res); hp += 2;
 	break;
     }
 
     case ERTS_PI_IX_GARBAGE_COLLECTION_INFO: {
+        ERTS_DECL_AM(age_survival);
         Uint sz = 0, actual_sz = 0;
+        int aging = erts_get_tenure_age(rp) > 1;
+        int predict = erts_heap_sizing == ERTS_HEAP_SIZING_EWMA;
 
         erts_process_gc_info(rp, &sz, NULL, 0, 0);
+        if (aging) {
+            erts_process_gc_age_survival(rp, &sz, NULL);
+            sz += 3 + 2;
+        }
+        if (predict)
+            erts_process_gc_heap_sizing(rp, &sz, NULL, NIL);
 
         hp = erts_produce_heap(hfact, sz, reserve_size);
         res = erts_process_gc_info(rp, &actual_sz, &hp, 0, 0);
+        if (aging) {
+            Eterm t = erts_process_gc_age_survival(rp, NULL, &hp);
+            t = TUPLE2(hp, AM_age_survival, t); hp += 3;
+            res = CONS(hp, t, res); hp += 2;
+        }
+        if (predict)
+            res = erts_process_gc_heap_sizing(rp, NULL, &hp, res);
 
         break;
     }
@@ -2728,6 +2748,15 @@ BIF_RETTYPE system_info_1(BIF_ALIST_1)
 #endif
     } else if (BIF_ARG_1 == am_heap_sizes) {
 	return erts_heap_sizes(BIF_P);
+    } else if (ERTS_IS_ATOM_STR("heap_sizing", BIF_ARG_1)) {
+	if (erts_heap_sizing == ERTS_HEAP_SIZING_EWMA) {
+	    ERTS_DECL_AM(ewma);
+	    BIF_RET(AM_ewma);
+	}
+	else {
+	    ERTS_DECL_AM(last);
+	    BIF_RET(AM_last);
+	}
     } else if (BIF_ARG_1 == am_heap_type) {
 	return am_private;
     } else if (ERTS_IS_ATOM_STR("cpu_topology", BIF_ARG_1)) {
@@ -3119,6 +3148,15 @@ BIF_RETTYPE system_info_1(BIF_ALIST_1)
     else if (ERTS_IS_ATOM_STR("ets_count",BIF_ARG_1)) {
         BIF_RET(make_small(erts_ets_table_count()));
     }
+    else if (ERTS_IS_ATOM_STR("re_cache",BIF_ARG_1)) {
+        BIF_RET(erts_re_cache_info(BIF_P));
+    }
+    else if (ERTS_IS_ATOM_STR("message_sharing",BIF_ARG_1)) {
+        BIF_RET(erts_message_sharing_info(BIF_P));
+    }
+    else if (ERTS_IS_ATOM_STR("numa_migrations",BIF_ARG_1)) {
+        BIF_RET(erts_make_integer(erts_get_total_numa_migrations(), BIF_P));
+    }
     else if (ERTS_IS_ATOM_STR("atom_limit",BIF_ARG_1)) {
         BIF_RET(make_small(erts_get_atom_limit()));
     }
@@ -3740,6 +3778,12 @@ BIF_RETTYPE statistics_1(BIF_ALIST_1)
 	    BIF_RET(am_undefined);
 	BIF_TRAP2(gather_msacc_res_trap, BIF_P, res, threads);
 #endif
+    } else if (BIF_ARG_1 == am_run_queue_delay) {
+	BIF_RET(erts_sched_runq_delay_info(BIF_P));
+    } else if (BIF_ARG_1 == am_dirty_queue_classes) {
+	BIF_RET(erts_sched_dirty_class_info(BIF_P));
+    } else if (BIF_ARG_1 == am_scheduler_wait) {
+	BIF_RET(erts_sched_wait_info(BIF_P));
     } else if (BIF_ARG_1 == am_context_switches) {
 	Eterm cs = erts_make_integer(erts_get_total_context_switches(), BIF_P);
 	hp = HAlloc(BIF_P, 3);
@@ -3887,9 +3931,10 @@ BIF_RETTYPE erts_debug_get_internal_state_1(BIF_ALIST_1)
 	else if (ERTS_IS_ATOM_STR("DbTable_words", BIF_ARG_1)) {
 	    /* Used by ets_SUITE (stdlib) */
 	    size_t words = (sizeof(DbTable) + sizeof(Uint) - 1)/sizeof(Uint);
-            Eterm* hp = HAlloc(BIF_P ,3);
-	    BIF_RET(TUPLE2(hp, make_small((Uint) words),
-                           erts_ets_hash_sizeof_ext_segtab()));
+            Eterm* hp = HAlloc(BIF_P ,4);
+	    BIF_RET(TUPLE3(hp, make_small((Uint) words),
+                           erts_ets_hash_sizeof_ext_segtab(),
+                           erts_ets_hash_sizeof_segment_header()));
 	}
 	else if (ERTS_IS_ATOM_STR("check_io_debug", BIF_ARG_1)) {
 	    /* Used by driver_SUITE (emulator) */
@@ -4042,6 +4087,17 @@ BIF_RETTYPE erts_debug_get_internal_state_1(BIF_ALIST_1)
 		    BIF_RET(erts_process_status(NULL, tp[2]));
 		}
 	    }
+	    else if (ERTS_IS_ATOM_STR("sig_inq_buffers", tp[1])) {
+		/* Used by process_SUITE (emulator) */
+		Process *p;
+		if (!is_internal_pid(tp[2]))
+		    BIF_ERROR(BIF_P, BADARG);
+		p = erts_proc_lookup(tp[2]);
+		if (!p)
+		    BIF_RET(am_undefined);
+		BIF_RET(erts_atomic_read_nob(&p->sig_inq_buffers)
+			? am_true : am_false);
+	    }
             else if (ERTS_IS_ATOM_STR("connection_id", tp[1])) {
                 DistEntry *dep;
                 Eterm *hp, res;
@@ -4522,6 +4578,19 @@ BIF_RETTYPE erts_debug_set_internal_state_2(BIF_ALIST_2)
 	    erts_set_gc_state(BIF_P, enable);
 	    BIF_RET(res);
 	}
+	else if (ERTS_IS_ATOM_STR("sig_inq_buffers", BIF_ARG_1)) {
+	    /* Used by process_SUITE (emulator) */
+	    Process *rp;
+	    if (!is_internal_pid(BIF_ARG_2))
+		BIF_ERROR(BIF_P, BADARG);
+	    rp = erts_pid2proc(BIF_P, ERTS_PROC_LOCK_MAIN,
+			       BIF_ARG_2, ERTS_PROC_LOCK_MSGQ);
+	    if (!rp)
+		BIF_RET(am_false);
+	    erts_proc_sig_queue_install_buffers(rp);
+	    erts_proc_unlock(rp, ERTS_PROC_LOCK_MSGQ);
+	    BIF_RET(am_true);
+	}
         else if (ERTS_IS_ATOM_STR("colliding_names", BIF_ARG_1)) {
 	    /* Used by ets_SUITE (stdlib) */
 	    if (is_tuple(BIF_ARG_2)) {
@@ -4704,6 +4773,11 @@ BIF_RETTYPE erts_debug_set_internal_state_2(BIF_ALIST_2)
                     BIF_RET(am_ok);
             }
         }
+        else if (ERTS_IS_ATOM_STR("ets_match_threaded", BIF_ARG_1)) {
+            if (db_match_set_threaded(BIF_ARG_2 == am_true))
+                BIF_RET(am_ok);
+            BIF_RET(am_notsup);
+        }
         else if (ERTS_IS_ATOM_STR("mbuf", BIF_ARG_1)) {
             Uint sz = size_object(BIF_ARG_2);
             ErlHeapFragment* frag = new_message_buffer(sz);
@@ -45,23 +45,48 @@
 #define MUST_SHRINK(t) (((Uint)200) * t->num_entries <= LOAD_FACTOR * t->allocated && \
                         t->allocated > INITIAL_SIZE)
 
+/*
+ * The terms are spread over a number of hash tables (shards) selected
+ * by the high bits of the key hash. Each shard is copied on update
+ * independently of the others, so the cost of an update is
+ * proportional to the size of the shard.
+ */
+#define SHARD_HASH_SHIFT 20
+#define SHARD_IX(HX) (((HX) >> SHARD_HASH_SHIFT) & (num_shards - 1))
+
 typedef struct hash_table {
     Uint allocated;
     Uint num_entries;
     Uint mask;
+    Uint shard_ix;
     Uint first_to_delete;
     Uint num_to_delete;
+    Uint num_to_release;
+    Eterm* to_release;          /* Replaced terms, see put_many/1 */
     erts_atomic_t refc;
     struct hash_table* delete_next;
+    struct hash_table* update_next;
     ErtsThrPrgrLaterOp thr_prog_op;
     Eterm term[1];
 } HashTable;
 
+/*
+ * The terms stored by put_many/1 share one literal area. They are
+ * tuples of arity 3 with a pointer to a bignum at the start of the
+ * area as the last element, and the digit of that bignum counts the
+ * entries referring to the area. The area is released when the last
+ * of them has been deleted.
+ */
+#define BATCH_HEADER_WORDS 2
+#define BATCH_REFC(AREA) ((erts_atomic_t *) &(AREA)->start[1])
+
 typedef struct trap_data {
-    HashTable* table;
+    int pinned;                 /* The tables are referenced */
+    Uint table_ix;
     Uint idx;
     Uint remaining;
     Uint memory;    /* Used by info/0 to count used memory */
+    HashTable* table[1];        /* One per shard */
 } TrapData;
 
 typedef enum {
@@ -97,6 +122,7 @@ typedef struct {
     ErtsPersistentTermPut2TrapLocation trap_location;
     Eterm key;
     Eterm term;
+    Uint32 hx;
     Uint entry_index;
     HashTable* hash_table;
     Eterm heap[3];
@@ -112,6 +138,7 @@ typedef enum {
 typedef struct {
     ErtsPersistentTermErase1TrapLocation trap_location;
     Eterm key;
+    Uint32 hx;
     HashTable* old_table;
     HashTable* new_table;
     Uint entry_index;
@@ -120,12 +147,45 @@ typedef struct {
     ErtsPersistentTermCpyTableCtx cpy_ctx;
 } ErtsPersistentTermErase1Context;
 
+typedef enum {
+    PUT_MANY1_TRAP_LOCATION_COPY_TERMS,
+    PUT_MANY1_TRAP_LOCATION_MOVE_TERMS,
+    PUT_MANY1_TRAP_LOCATION_SEIZE,
+    PUT_MANY1_TRAP_LOCATION_COPY_TABLES
+} ErtsPersistentTermPutMany1TrapLocation;
+
+typedef struct {
+    HashTable* old_table;
+    HashTable* new_table;
+    Uint num_pairs;
+    int changed;
+} PutManyShard;
+
+typedef struct {
+    ErtsPersistentTermPutMany1TrapLocation trap_location;
+    Eterm list;
+    Uint num_pairs;
+    Uint ix;
+    Eterm* tuples;                  /* NULL until the list is validated */
+    Uint32* hxs;
+    ErlHeapFragment** frags;        /* One per pair until moved */
+    PutManyShard* shards;
+    Uint area_size;
+    ErtsLiteralArea* literal_area;  /* NULL when installed */
+    Eterm* area_top;
+    Eterm area_ref;
+    ErlOffHeap code_off_heap;
+    int has_permission;
+    Eterm heap[4];
+    ErtsPersistentTermCpyTableCtx cpy_ctx;
+} ErtsPersistentTermPutMany1Context;
+
 /*
  * Declarations of local functions.
  */
 
-static HashTable* create_initial_table(void);
-static Uint lookup(HashTable* hash_table, Eterm key);
+static HashTable* create_initial_table(Uint shard_ix);
+static Uint lookup(HashTable* hash_table, Eterm key, Uint32 hx);
 static HashTable* copy_table(ErtsPersistentTermCpyTableCtx* ctx);
 static int try_seize_update_permission(Process* c_p);
 static void release_update_permission(int release_updater);
@@ -135,12 +195,17 @@ static void dec_table_refc(Process* c_p, HashTable* old_table);
 static void delete_table(Process* c_p, HashTable* table);
 static void mark_for_deletion(HashTable* hash_table, Uint entry_index);
 static ErtsLiteralArea* term_to_area(Eterm tuple);
+static void release_term(Process* c_p, Eterm term);
 static void suspend_updater(Process* c_p);
 static Eterm do_get_all(Process* c_p, TrapData* trap_data, Eterm res);
 static Eterm do_info(Process* c_p, TrapData* trap_data);
 static void append_to_delete_queue(HashTable* table);
 static HashTable* next_to_delete(void);
 static Eterm alloc_trap_data(Process* c_p);
+static Uint snapshot_tables(TrapData* trap_data);
+static void pin_tables(TrapData* trap_data);
+static void unpin_tables(Process* c_p, TrapData* trap_data);
+static Eterm next_term(TrapData* trap_data);
 static int cleanup_trap_data(Binary *bp);
 
 /*
@@ -153,10 +218,13 @@ static Export persistent_term_info_export;
 static BIF_RETTYPE persistent_term_info_trap(BIF_ALIST_1);
 
 /*
- * Pointer to the current hash table.
+ * Pointers to the current hash table of each shard.
  */
 
-static erts_atomic_t the_hash_table;
+static Uint num_shards;
+static erts_atomic_t* the_hash_tables;
+
+#define GET_TABLE(IX) ((HashTable *) erts_atomic_read_nob(&the_hash_tables[IX]))
 
 /*
  * Queue of processes waiting to update the hash table.
@@ -190,9 +258,9 @@ static HashTable** delete_queue_tail = &delete_queue_head;
 ErtsLiteralArea** erts_persistent_areas;
 Uint erts_num_persistent_areas;
 
-void erts_init_bif_persistent_term(void)
+void erts_init_bif_persistent_term(Uint shards)
 {
-    HashTable* hash_table;
+    Uint i;
 
     /*
      * Initialize the mutex protecting updates.
@@ -215,11 +283,18 @@ void erts_init_bif_persistent_term(void)
                   ERTS_LOCK_FLAGS_CATEGORY_GENERIC);
 
     /*
-     * Allocate a small initial hash table.
+     * Allocate a small initial hash table for each shard.
      */
 
-    hash_table = create_initial_table();
-    erts_atomic_init_nob(&the_hash_table, (erts_aint_t)hash_table);
+    ASSERT(shards > 0 && shards <= ERTS_PERSISTENT_TERM_MAX_SHARDS);
+    ASSERT((shards & (shards - 1)) == 0);
+    num_shards = shards;
+    the_hash_tables = erts_alloc(ERTS_ALC_T_PERSISTENT_TERM,
+                                 num_shards * sizeof(erts_atomic_t));
+    for (i = 0; i < num_shards; i++) {
+        erts_atomic_init_nob(&the_hash_tables[i],
+                             (erts_aint_t)create_initial_table(i));
+    }
 
     /*
      * Initialize export entry for traps
@@ -269,7 +344,8 @@ static int persistent_term_put_2_ctx_bin_dtor(Binary *context_bin)
 /*
  * A linear congruential generator that is used in the debug emulator
  * to trap after a random number of iterations in
- * persistent_term_put_2 and persistent_term_erase_1.
+ * persistent_term_put_2, persistent_term_put_many_1 and
+ * persistent_term_erase_1.
  *
  * https://en.wikipedia.org/wiki/Linear_congruential_generator
  */
@@ -332,12 +408,12 @@ BIF_RETTYPE persistent_term_put_2(BIF_ALIST_2)
 	ERTS_BIF_YIELD2(bif_export[BIF_persistent_term_put_2],
                         BIF_P, BIF_ARG_1, BIF_ARG_2);
     }
-    ctx->hash_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
-
     ctx->key = BIF_ARG_1;
     ctx->term = BIF_ARG_2;
+    ctx->hx = make_internal_hash(ctx->key, 0);
 
-    ctx->entry_index = lookup(ctx->hash_table, ctx->key);
+    ctx->hash_table = GET_TABLE(SHARD_IX(ctx->hx));
+    ctx->entry_index = lookup(ctx->hash_table, ctx->key, ctx->hx);
 
     ctx->heap[0] = make_arityval(2);
     ctx->heap[1] = ctx->key;
@@ -354,13 +430,13 @@ BIF_RETTYPE persistent_term_put_2(BIF_ALIST_2)
                                 new_size,
                                 ERTS_PERSISTENT_TERM_CPY_NO_REHASH,
                                 PUT2_TRAP_LOCATION_NEW_KEY);
-        ctx->entry_index = lookup(ctx->hash_table, ctx->key);
+        ctx->entry_index = lookup(ctx->hash_table, ctx->key, ctx->hx);
         ctx->hash_table->num_entries++;
     } else {
         Eterm tuple = ctx->hash_table->term[ctx->entry_index];
         Eterm old_term;
 
-        ASSERT(is_tuple_arity(tuple, 2));
+        ASSERT(is_tuple(tuple));
         old_term = boxed_val(tuple)[2];
         if (EQ(ctx->term, old_term)) {
             /* Same value. No need to update anything. */
@@ -411,31 +487,363 @@ BIF_RETTYPE persistent_term_put_2(BIF_ALIST_2)
     ERTS_BIF_YIELD_RETURN(BIF_P, am_ok);
 }
 
+/*
+ * Store all terms in a single literal area and replace the hash tables
+ * of the shards involved in one update. Terms replaced by later calls
+ * are released together when all of them are gone, see BATCH_REFC().
+ *
+ * Each pair is first copied into a heap fragment of its own. The
+ * fragments are then moved into the literal area, the way the loader
+ * places the literals of a module, so that the call can trap between
+ * pairs as well as while copying the hash tables.
+ */
+
+static int persistent_term_put_many_1_ctx_bin_dtor(Binary *context_bin)
+{
+    ErtsPersistentTermPutMany1Context* ctx = ERTS_MAGIC_BIN_DATA(context_bin);
+    Uint i;
+
+    if (ctx->tuples == NULL) {
+        return 1;
+    }
+    for (i = 0; i < ctx->num_pairs; i++) {
+        if (ctx->frags[i] != NULL) {
+            free_message_buffer(ctx->frags[i]);
+        }
+    }
+    if (ctx->literal_area != NULL) {
+        ctx->literal_area->off_heap = ctx->code_off_heap.first;
+        erts_release_literal_area(ctx->literal_area);
+    }
+    if (ctx->has_permission) {
+        for (i = 0; i < num_shards; i++) {
+            if (ctx->shards[i].new_table != NULL) {
+                erts_free(ERTS_ALC_T_PERSISTENT_TERM, ctx->shards[i].new_table);
+            }
+        }
+        if (ctx->cpy_ctx.new_table != NULL) {
+            erts_free(ERTS_ALC_T_PERSISTENT_TERM, ctx->cpy_ctx.new_table);
+        }
+        release_update_permission(0);
+    }
+    erts_free(ERTS_ALC_T_PERSISTENT_TERM_TMP, ctx->tuples);
+    return 1;
+}
+
+BIF_RETTYPE persistent_term_put_many_1(BIF_ALIST_1)
+{
+    static const Uint ITERATIONS_PER_RED = 32;
+    ErtsPersistentTermPutMany1Context* ctx;
+    Eterm state_mref = THE_NON_VALUE;
+    long iterations_until_trap;
+    long max_iterations;
+    ErtsLiteralArea* literal_area;
+    HashTable* new_tables = NULL;
+    Eterm list;
+    Uint num_pairs;
+    Uint installed = 0;
+    Uint i;
+#define PUT_MANY_TRAP(LOC_NAME)                                         \
+    do {                                                                \
+        ctx->trap_location = LOC_NAME;                                  \
+        erts_set_gc_state(BIF_P, 0);                                    \
+        BUMP_ALL_REDS(BIF_P);                                           \
+        BIF_TRAP1(bif_export[BIF_persistent_term_put_many_1],           \
+                  BIF_P, state_mref);                                   \
+    } while (0)
+
+#ifdef DEBUG
+        (void)ITERATIONS_PER_RED;
+        iterations_until_trap = max_iterations =
+            GET_SMALL_RANDOM_INT(ERTS_BIF_REDS_LEFT(BIF_P) + (Uint)&ctx);
+#else
+        iterations_until_trap = max_iterations =
+            ITERATIONS_PER_RED * ERTS_BIF_REDS_LEFT(BIF_P);
+#endif
+    if (is_internal_magic_ref(BIF_ARG_1) &&
+        (ERTS_MAGIC_BIN_DESTRUCTOR(erts_magic_ref2bin(BIF_ARG_1)) ==
+         persistent_term_put_many_1_ctx_bin_dtor)) {
+        /* Restore state after a trap */
+        Binary* state_bin;
+        state_mref = BIF_ARG_1;
+        state_bin = erts_magic_ref2bin(state_mref);
+        ctx = ERTS_MAGIC_BIN_DATA(state_bin);
+        ASSERT(BIF_P->flags & F_DISABLE_GC);
+        erts_set_gc_state(BIF_P, 1);
+        switch (ctx->trap_location) {
+        case PUT_MANY1_TRAP_LOCATION_COPY_TERMS:
+            goto L_PUT_MANY1_TRAP_LOCATION_COPY_TERMS;
+        case PUT_MANY1_TRAP_LOCATION_MOVE_TERMS:
+            goto L_PUT_MANY1_TRAP_LOCATION_MOVE_TERMS;
+        case PUT_MANY1_TRAP_LOCATION_SEIZE:
+            goto L_PUT_MANY1_TRAP_LOCATION_SEIZE;
+        case PUT_MANY1_TRAP_LOCATION_COPY_TABLES:
+            goto L_PUT_MANY1_TRAP_LOCATION_COPY_TABLES;
+        }
+    }
+
+    num_pairs = 0;
+    for (list = BIF_ARG_1; is_list(list); list = CDR(list_val(list))) {
+        if (!is_tuple_arity(CAR(list_val(list)), 2)) {
+            BIF_ERROR(BIF_P, BADARG);
+        }
+        num_pairs++;
+    }
+    if (is_not_nil(list)) {
+        BIF_ERROR(BIF_P, BADARG);
+    } else if (num_pairs == 0) {
+        BIF_RET(am_ok);
+    }
+    iterations_until_trap -= num_pairs;
+
+    {
+        /* Save state in magic bin in case trapping is necessary */
+        Eterm* hp;
+        Binary* state_bin = erts_create_magic_binary(sizeof(ErtsPersistentTermPutMany1Context),
+                                                     persistent_term_put_many_1_ctx_bin_dtor);
+        hp = HAlloc(BIF_P, ERTS_MAGIC_REF_THING_SIZE);
+        state_mref = erts_mk_magic_ref(&hp, &MSO(BIF_P), state_bin);
+        ctx = ERTS_MAGIC_BIN_DATA(state_bin);
+    }
+
+    /*
+     * IMPORTANT: persistent_term_put_many_1_ctx_bin_dtor uses tuples,
+     * frags, literal_area, has_permission, the new tables of the
+     * shards and cpy_ctx.new_table to tell what needs to be freed.
+     */
+    ctx->num_pairs = num_pairs;
+    ctx->tuples = erts_alloc(ERTS_ALC_T_PERSISTENT_TERM_TMP,
+                             num_pairs * (sizeof(Eterm) +
+                                          sizeof(ErlHeapFragment *) +
+                                          sizeof(Uint32)) +
+                             num_shards * sizeof(PutManyShard));
+    ctx->frags = (ErlHeapFragment **) &ctx->tuples[num_pairs];
+    ctx->shards = (PutManyShard *) &ctx->frags[num_pairs];
+    ctx->hxs = (Uint32 *) &ctx->shards[num_shards];
+    for (i = 0; i < num_pairs; i++) {
+        ctx->frags[i] = NULL;
+    }
+    for (i = 0; i < num_shards; i++) {
+        ctx->shards[i].new_table = NULL;
+        ctx->shards[i].num_pairs = 0;
+        ctx->shards[i].changed = 0;
+    }
+    ctx->literal_area = NULL;
+    ctx->has_permission = 0;
+    ctx->cpy_ctx.new_table = NULL;
+    ctx->list = BIF_ARG_1;
+    ctx->ix = 0;
+    ctx->area_size = BATCH_HEADER_WORDS;
+
+    /*
+     * Copy each pair into a heap fragment as a {Key,Value,Area}
+     * tuple, preserving sharing within the pair.
+     */
+
+ L_PUT_MANY1_TRAP_LOCATION_COPY_TERMS:
+    while (ctx->ix < ctx->num_pairs) {
+        Eterm* pair = tuple_val(CAR(list_val(ctx->list)));
+        ErlHeapFragment* frag;
+        erts_shcopy_t info;
+        Uint term_size;
+        Eterm* hp;
+
+        ctx->heap[0] = make_arityval(3);
+        ctx->heap[1] = pair[1];
+        ctx->heap[2] = pair[2];
+        ctx->heap[3] = NIL;
+        INITIALIZE_SHCOPY(info);
+        info.copy_literals = 1;
+        term_size = copy_shared_calculate(make_tuple(ctx->heap), &info);
+        frag = new_message_buffer(term_size);
+        hp = frag->mem;
+        ctx->tuples[ctx->ix] = copy_shared_perform(make_tuple(ctx->heap),
+                                                   term_size, &info, &hp,
+                                                   &frag->off_heap);
+        DESTROY_SHCOPY(info);
+        ctx->frags[ctx->ix] = frag;
+        ctx->hxs[ctx->ix] = make_internal_hash(pair[1], 0);
+        ctx->shards[SHARD_IX(ctx->hxs[ctx->ix])].num_pairs++;
+        ctx->area_size += term_size;
+        ctx->list = CDR(list_val(ctx->list));
+        ctx->ix++;
+        iterations_until_trap -= term_size;
+        if (iterations_until_trap <= 0 && ctx->ix < ctx->num_pairs) {
+            PUT_MANY_TRAP(PUT_MANY1_TRAP_LOCATION_COPY_TERMS);
+        }
+    }
+    ASSERT(is_nil(ctx->list));
+
+    /*
+     * Move the fragments into one literal area. The bignum at the
+     * start of it holds the number of entries referring to it.
+     */
+
+    literal_area = erts_alloc(ERTS_ALC_T_LITERAL,
+                              ERTS_LITERAL_AREA_ALLOC_SIZE(ctx->area_size));
+    literal_area->start[0] = make_pos_bignum_header(1);
+    erts_atomic_init_nob(BATCH_REFC(literal_area), 0);
+    literal_area->end = &literal_area->start[ctx->area_size];
+    literal_area->off_heap = NULL;
+    ctx->literal_area = literal_area;
+    ctx->area_top = &literal_area->start[BATCH_HEADER_WORDS];
+    ctx->area_ref = make_big(literal_area->start);
+    erts_set_literal_tag(&ctx->area_ref, literal_area->start,
+                         BATCH_HEADER_WORDS);
+    ERTS_INIT_OFF_HEAP(&ctx->code_off_heap);
+    ctx->ix = 0;
+
+ L_PUT_MANY1_TRAP_LOCATION_MOVE_TERMS:
+    while (ctx->ix < ctx->num_pairs) {
+        ErlHeapFragment* frag = ctx->frags[ctx->ix];
+
+        iterations_until_trap -= frag->used_size;
+        erts_move_multi_frags(&ctx->area_top, &ctx->code_off_heap, frag,
+                              &ctx->tuples[ctx->ix], 1, 1);
+        tuple_val(ctx->tuples[ctx->ix])[3] = ctx->area_ref;
+        free_message_buffer(frag);
+        ctx->frags[ctx->ix] = NULL;
+        ctx->ix++;
+        if (iterations_until_trap <= 0 && ctx->ix < ctx->num_pairs) {
+            PUT_MANY_TRAP(PUT_MANY1_TRAP_LOCATION_MOVE_TERMS);
+        }
+    }
+    ASSERT(ctx->area_top == ctx->literal_area->end);
+    ctx->literal_area->off_heap = ctx->code_off_heap.first;
+
+ L_PUT_MANY1_TRAP_LOCATION_SEIZE:
+    if (!try_seize_update_permission(BIF_P)) {
+        ctx->trap_location = PUT_MANY1_TRAP_LOCATION_SEIZE;
+        erts_set_gc_state(BIF_P, 0);
+	ERTS_BIF_YIELD1(bif_export[BIF_persistent_term_put_many_1],
+                        BIF_P, state_mref);
+    }
+    ctx->has_permission = 1;
+
+    /*
+     * Copy the hash tables of the shards involved, large enough to
+     * hold all new keys.
+     */
+
+    for (i = 0; i < num_shards; i++) {
+        ctx->shards[i].old_table = GET_TABLE(i);
+    }
+    for (ctx->ix = 0; ctx->ix < num_shards; ctx->ix++) {
+        HashTable* old_table = ctx->shards[ctx->ix].old_table;
+        Uint new_size = old_table->allocated;
+
+        if (ctx->shards[ctx->ix].num_pairs == 0) {
+            continue;
+        }
+        while (((Uint)100) * (old_table->num_entries +
+                              ctx->shards[ctx->ix].num_pairs) >=
+               LOAD_FACTOR * new_size) {
+            new_size *= 2;
+        }
+        ctx->cpy_ctx = (ErtsPersistentTermCpyTableCtx){
+            .old_table = old_table,
+            .new_size = new_size,
+            .copy_type = ERTS_PERSISTENT_TERM_CPY_NO_REHASH,
+            .location = ERTS_PERSISTENT_TERM_CPY_PLACE_START
+        };
+        for (;;) {
+            ctx->cpy_ctx.max_iterations = MAX(1, iterations_until_trap);
+            ctx->shards[ctx->ix].new_table = copy_table(&ctx->cpy_ctx);
+            iterations_until_trap -= ctx->cpy_ctx.total_iterations_done;
+            if (ctx->shards[ctx->ix].new_table != NULL) {
+                break;
+            }
+            PUT_MANY_TRAP(PUT_MANY1_TRAP_LOCATION_COPY_TABLES);
+        L_PUT_MANY1_TRAP_LOCATION_COPY_TABLES:
+            ;
+        }
+    }
+
+    /*
+     * Insert the terms in the original order. Nothing below traps.
+     */
+
+    literal_area = ctx->literal_area;
+    for (i = 0; i < ctx->num_pairs; i++) {
+        Eterm tuple = ctx->tuples[i];
+        PutManyShard* shard = &ctx->shards[SHARD_IX(ctx->hxs[i])];
+        HashTable* hash_table = shard->new_table;
+        Uint entry_index = lookup(hash_table, tuple_val(tuple)[1], ctx->hxs[i]);
+        Eterm old = hash_table->term[entry_index];
+
+        if (is_nil(old)) {
+            hash_table->num_entries++;
+        } else if (EQ(tuple_val(tuple)[2], tuple_val(old)[2])) {
+            /* Same value. No need to update anything. */
+            continue;
+        } else if (term_to_area(old) == literal_area) {
+            /* Stored by this call, the key occurs more than once. */
+            installed--;
+        } else {
+            HashTable* old_table = shard->old_table;
+            if (old_table->to_release == NULL) {
+                old_table->to_release =
+                    erts_alloc(ERTS_ALC_T_PERSISTENT_TERM,
+                               shard->num_pairs * sizeof(Eterm));
+            }
+            old_table->to_release[old_table->num_to_release++] = old;
+        }
+        hash_table->term[entry_index] = tuple;
+        shard->changed = 1;
+        installed++;
+    }
+    iterations_until_trap -= ctx->num_pairs;
+
+    for (i = 0; i < num_shards; i++) {
+        if (ctx->shards[i].changed) {
+            ctx->shards[i].new_table->update_next = new_tables;
+            new_tables = ctx->shards[i].new_table;
+        } else if (ctx->shards[i].new_table) {
+            erts_free(ERTS_ALC_T_PERSISTENT_TERM, ctx->shards[i].new_table);
+        }
+    }
+
+    /* Nothing is left for persistent_term_put_many_1_ctx_bin_dtor */
+    erts_free(ERTS_ALC_T_PERSISTENT_TERM_TMP, ctx->tuples);
+    ctx->tuples = NULL;
+    BUMP_REDS(BIF_P, (max_iterations - iterations_until_trap) / ITERATIONS_PER_RED);
+
+    if (installed == 0) {
+        /* All values were already stored. */
+        ASSERT(new_tables == NULL);
+        erts_release_literal_area(literal_area);
+        release_update_permission(0);
+        BIF_RET(am_ok);
+    }
+    erts_atomic_set_nob(BATCH_REFC(literal_area), (erts_aint_t)installed);
+    erts_schedule_thr_prgr_later_op(table_updater, new_tables, &thr_prog_op);
+    suspend_updater(BIF_P);
+    ERTS_BIF_YIELD_RETURN(BIF_P, am_ok);
+#undef PUT_MANY_TRAP
+}
+
 BIF_RETTYPE persistent_term_get_0(BIF_ALIST_0)
 {
-    HashTable* hash_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
     TrapData* trap_data;
     Eterm res = NIL;
     Eterm magic_ref;
     Binary* mbp;
+    Uint num_entries;
 
     magic_ref = alloc_trap_data(BIF_P);
     mbp = erts_magic_ref2bin(magic_ref);
     trap_data = ERTS_MAGIC_BIN_DATA(mbp);
-    trap_data->table = hash_table;
-    trap_data->idx = 0;
-    trap_data->remaining = hash_table->num_entries;
+    num_entries = snapshot_tables(trap_data);
     res = do_get_all(BIF_P, trap_data, res);
     if (trap_data->remaining == 0) {
-        BUMP_REDS(BIF_P, hash_table->num_entries);
-        trap_data->table = NULL; /* Prevent refc decrement */
+        BUMP_REDS(BIF_P, num_entries);
         BIF_RET(res);
     } else {
         /*
-         * Increment the ref counter to prevent an update operation (by put/2
-         * or erase/1) to delete this hash table.
+         * Increment the ref counters to prevent an update operation (by
+         * put/2 or erase/1) to delete these hash tables.
          */
-        erts_atomic_inc_nob(&hash_table->refc);
+        pin_tables(trap_data);
         BUMP_ALL_REDS(BIF_P);
         BIF_TRAP2(&persistent_term_get_all_export, BIF_P, magic_ref, res);
     }
@@ -444,14 +852,15 @@ BIF_RETTYPE persistent_term_get_0(BIF_ALIST_0)
 BIF_RETTYPE persistent_term_get_1(BIF_ALIST_1)
 {
     Eterm key = BIF_ARG_1;
-    HashTable* hash_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
+    Uint32 hx = make_internal_hash(key, 0);
+    HashTable* hash_table = GET_TABLE(SHARD_IX(hx));
     Uint entry_index;
     Eterm term;
 
-    entry_index = lookup(hash_table, key);
+    entry_index = lookup(hash_table, key, hx);
     term = hash_table->term[entry_index];
     if (is_boxed(term)) {
-        ASSERT(is_tuple_arity(term, 2));
+        ASSERT(is_tuple(term));
         BIF_RET(tuple_val(term)[2]);
     }
     BIF_ERROR(BIF_P, BADARG);
@@ -461,14 +870,15 @@ BIF_RETTYPE persistent_term_get_2(BIF_ALIST_2)
 {
     Eterm key = BIF_ARG_1;
     Eterm result = BIF_ARG_2;
-    HashTable* hash_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
+    Uint32 hx = make_internal_hash(key, 0);
+    HashTable* hash_table = GET_TABLE(SHARD_IX(hx));
     Uint entry_index;
     Eterm term;
 
-    entry_index = lookup(hash_table, key);
+    entry_index = lookup(hash_table, key, hx);
     term = hash_table->term[entry_index];
     if (is_boxed(term)) {
-        ASSERT(is_tuple_arity(term, 2));
+        ASSERT(is_tuple(term));
         result = tuple_val(term)[2];
     }
     BIF_RET(result);
@@ -547,8 +957,9 @@ BIF_RETTYPE persistent_term_erase_1(BIF_ALIST_1)
     }
 
     ctx->key = BIF_ARG_1;
-    ctx->old_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
-    ctx->entry_index = lookup(ctx->old_table, ctx->key);
+    ctx->hx = make_internal_hash(ctx->key, 0);
+    ctx->old_table = GET_TABLE(SHARD_IX(ctx->hx));
+    ctx->entry_index = lookup(ctx->old_table, ctx->key, ctx->hx);
     ctx->old_term = ctx->old_table->term[ctx->entry_index];
     if (is_boxed(ctx->old_term)) {
         Uint new_size;
@@ -561,7 +972,7 @@ BIF_RETTYPE persistent_term_erase_1(BIF_ALIST_1)
          * temporary table copy of the same size as the old one.
          */
 
-        ASSERT(is_tuple_arity(ctx->old_term, 2));
+        ASSERT(is_tuple(ctx->old_term));
         TRAPPING_COPY_TABLE_ERASE(ctx->tmp_table,
                                   ctx->old_table,
                                   ctx->old_table->allocated,
@@ -610,48 +1021,49 @@ BIF_RETTYPE persistent_term_erase_1(BIF_ALIST_1)
 
 BIF_RETTYPE erts_internal_erase_persistent_terms_0(BIF_ALIST_0)
 {
-    HashTable* old_table;
-    HashTable* new_table;
+    HashTable* new_tables = NULL;
+    Uint i;
 
     if (!try_seize_update_permission(BIF_P)) {
 	ERTS_BIF_YIELD0(bif_export[BIF_erts_internal_erase_persistent_terms_0],
                         BIF_P);
     }
-    old_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
-    old_table->first_to_delete = 0;
-    old_table->num_to_delete = old_table->allocated;
-    new_table = create_initial_table();
-    erts_schedule_thr_prgr_later_op(table_updater, new_table, &thr_prog_op);
+    for (i = 0; i < num_shards; i++) {
+        HashTable* old_table = GET_TABLE(i);
+        HashTable* new_table = create_initial_table(i);
+
+        old_table->first_to_delete = 0;
+        old_table->num_to_delete = old_table->allocated;
+        new_table->update_next = new_tables;
+        new_tables = new_table;
+    }
+    erts_schedule_thr_prgr_later_op(table_updater, new_tables, &thr_prog_op);
     suspend_updater(BIF_P);
     ERTS_BIF_YIELD_RETURN(BIF_P, am_true);
 }
 
 BIF_RETTYPE persistent_term_info_0(BIF_ALIST_0)
 {
-    HashTable* hash_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
     TrapData* trap_data;
     Eterm res = NIL;
     Eterm magic_ref;
     Binary* mbp;
+    Uint num_entries;
 
     magic_ref = alloc_trap_data(BIF_P);
     mbp = erts_magic_ref2bin(magic_ref);
     trap_data = ERTS_MAGIC_BIN_DATA(mbp);
-    trap_data->table = hash_table;
-    trap_data->idx = 0;
-    trap_data->remaining = hash_table->num_entries;
-    trap_data->memory = 0;
+    num_entries = snapshot_tables(trap_data);
     res = do_info(BIF_P, trap_data);
     if (trap_data->remaining == 0) {
-        BUMP_REDS(BIF_P, hash_table->num_entries);
-        trap_data->table = NULL; /* Prevent refc decrement */
+        BUMP_REDS(BIF_P, num_entries);
         BIF_RET(res);
     } else {
         /*
-         * Increment the ref counter to prevent an update operation (by put/2
-         * or erase/1) to delete this hash table.
+         * Increment the ref counters to prevent an update operation (by
+         * put/2 or erase/1) to delete these hash tables.
          */
-        erts_atomic_inc_nob(&hash_table->refc);
+        pin_tables(trap_data);
         BUMP_ALL_REDS(BIF_P);
         BIF_TRAP2(&persistent_term_info_export, BIF_P, magic_ref, res);
     }
@@ -660,32 +1072,77 @@ BIF_RETTYPE persistent_term_info_0(BIF_ALIST_0)
 Uint
 erts_persistent_term_count(void)
 {
-    HashTable* hash_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
-    return hash_table->num_entries;
+    Uint count = 0;
+    Uint i;
+
+    for (i = 0; i < num_shards; i++) {
+        count += GET_TABLE(i)->num_entries;
+    }
+    return count;
+}
+
+static int
+area_cmp(const void* a, const void* b)
+{
+    ErtsLiteralArea* const* area_a = a;
+    ErtsLiteralArea* const* area_b = b;
+
+    if (*area_a < *area_b) {
+        return -1;
+    } else if (*area_a > *area_b) {
+        return 1;
+    }
+    return 0;
 }
 
 void
 erts_init_persistent_dumping(void)
 {
-    HashTable* hash_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
     ErtsLiteralArea** area_p;
-    Uint i;
+    Uint i, j, n;
 
     /*
-     * Overwrite the array of Eterms in the current hash table
-     * with pointers to literal areas.
+     * With a single shard, overwrite the array of Eterms in the
+     * current hash table with pointers to literal areas.
      */
 
-    erts_persistent_areas = (ErtsLiteralArea **) hash_table->term;
-    erts_num_persistent_areas = hash_table->num_entries;
+    if (num_shards == 1) {
+        erts_persistent_areas = (ErtsLiteralArea **) GET_TABLE(0)->term;
+    } else {
+        n = erts_persistent_term_count();
+        erts_persistent_areas =
+            erts_alloc_fnf(ERTS_ALC_T_PERSISTENT_TERM_TMP,
+                           MAX(n, 1) * sizeof(ErtsLiteralArea *));
+        if (erts_persistent_areas == NULL) {
+            erts_num_persistent_areas = 0;
+            return;
+        }
+    }
     area_p = erts_persistent_areas;
-    for (i = 0; i < hash_table->allocated; i++) {
-        Eterm term = hash_table->term[i];
+    for (i = 0; i < num_shards; i++) {
+        HashTable* hash_table = GET_TABLE(i);
+
+        for (j = 0; j < hash_table->allocated; j++) {
+            Eterm term = hash_table->term[j];
+
+            if (is_boxed(term)) {
+                *area_p++ = term_to_area(term);
+            }
+        }
+    }
+    n = area_p - erts_persistent_areas;
 
-        if (is_boxed(term)) {
-            *area_p++ = term_to_area(term);
+    /*
+     * Terms stored by put_many/1 share their area, only list it once.
+     */
+
+    qsort(erts_persistent_areas, n, sizeof(ErtsLiteralArea *), area_cmp);
+    for (i = j = 0; i < n; i++) {
+        if (j == 0 || erts_persistent_areas[j-1] != erts_persistent_areas[i]) {
+            erts_persistent_areas[j++] = erts_persistent_areas[i];
         }
     }
+    erts_num_persistent_areas = j;
 }
 
 /*
@@ -693,7 +1150,7 @@ erts_init_persistent_dumping(void)
  */
 
 static HashTable*
-create_initial_table(void)
+create_initial_table(Uint shard_ix)
 {
     HashTable* hash_table;
     int i;
@@ -704,8 +1161,12 @@ create_initial_table(void)
     hash_table->allocated = INITIAL_SIZE;
     hash_table->num_entries = 0;
     hash_table->mask = INITIAL_SIZE-1;
+    hash_table->shard_ix = shard_ix;
     hash_table->first_to_delete = 0;
     hash_table->num_to_delete = 0;
+    hash_table->num_to_release = 0;
+    hash_table->to_release = NULL;
+    hash_table->update_next = NULL;
     erts_atomic_init_nob(&hash_table->refc, (erts_aint_t)1);
     for (i = 0; i < INITIAL_SIZE; i++) {
         hash_table->term[i] = NIL;
@@ -732,11 +1193,10 @@ persistent_term_get_all_trap(BIF_ALIST_2)
         BIF_TRAP2(&persistent_term_get_all_export, BIF_P, BIF_ARG_1, res);
     } else {
         /*
-         * Decrement ref count (and possibly delete the hash table
-         * and associated literal area).
+         * Decrement ref counts (and possibly delete the hash tables
+         * and associated literal areas).
          */
-        dec_table_refc(BIF_P, trap_data->table);
-        trap_data->table = NULL; /* Prevent refc decrement */
+        unpin_tables(BIF_P, trap_data);
         BUMP_REDS(BIF_P, bump_reds);
         BIF_RET(res);
     }
@@ -745,9 +1205,7 @@ persistent_term_get_all_trap(BIF_ALIST_2)
 static Eterm
 do_get_all(Process* c_p, TrapData* trap_data, Eterm res)
 {
-    HashTable* hash_table;
     Uint remaining;
-    Uint idx;
     Uint max_iter;
     Uint i;
     Eterm* hp;
@@ -757,8 +1215,6 @@ do_get_all(Process* c_p, TrapData* trap_data, Eterm res)
         Eterm* tuple_ptr;
     } *copy_data;
 
-    hash_table = trap_data->table;
-    idx = trap_data->idx;
 #if defined(DEBUG) || defined(VALGRIND)
     max_iter = 50;
 #else
@@ -774,23 +1230,19 @@ do_get_all(Process* c_p, TrapData* trap_data, Eterm res)
     i = 0;
     heap_size = (2 + 3) * remaining;
     while (remaining != 0) {
-        Eterm term = hash_table->term[idx];
-        if (is_tuple(term)) {
-            Uint key_size;
-            Eterm* tup_val;
-
-            ASSERT(is_tuple_arity(term, 2));
-            tup_val = tuple_val(term);
-            key_size = size_object(tup_val[1]);
-            copy_data[i].key_size = key_size;
-            copy_data[i].tuple_ptr = tup_val;
-            heap_size += key_size;
-            i++;
-            remaining--;
-        }
-        idx++;
+        Eterm term = next_term(trap_data);
+        Uint key_size;
+        Eterm* tup_val;
+
+        ASSERT(is_tuple(term));
+        tup_val = tuple_val(term);
+        key_size = size_object(tup_val[1]);
+        copy_data[i].key_size = key_size;
+        copy_data[i].tuple_ptr = tup_val;
+        heap_size += key_size;
+        i++;
+        remaining--;
     }
-    trap_data->idx = idx;
 
     hp = HAlloc(c_p, heap_size);
     remaining = i;
@@ -830,11 +1282,10 @@ persistent_term_info_trap(BIF_ALIST_1)
         BIF_TRAP1(&persistent_term_info_export, BIF_P, BIF_ARG_1);
     } else {
         /*
-         * Decrement ref count (and possibly delete the hash table
-         * and associated literal area).
+         * Decrement ref counts (and possibly delete the hash tables
+         * and associated literal areas).
          */
-        dec_table_refc(BIF_P, trap_data->table);
-        trap_data->table = NULL; /* Prevent refc decrement */
+        unpin_tables(BIF_P, trap_data);
         BUMP_REDS(BIF_P, bump_reds);
         ASSERT(is_map(res));
         BIF_RET(res);
@@ -846,13 +1297,9 @@ persistent_term_info_trap(BIF_ALIST_1)
 static Eterm
 do_info(Process* c_p, TrapData* trap_data)
 {
-    HashTable* hash_table;
     Uint remaining;
-    Uint idx;
     Uint max_iter;
 
-    hash_table = trap_data->table;
-    idx = trap_data->idx;
 #if defined(DEBUG) || defined(VALGRIND)
     max_iter = 50;
 #else
@@ -861,16 +1308,22 @@ do_info(Process* c_p, TrapData* trap_data)
     remaining = trap_data->remaining < max_iter ? trap_data->remaining : max_iter;
     trap_data->remaining -= remaining;
     while (remaining != 0) {
-        if (is_boxed(hash_table->term[idx])) {
+        Eterm term = next_term(trap_data);
+
+        if (is_tuple_arity(term, 3)) {
+            /*
+             * The area is shared with other terms stored by the
+             * same put_many/1 call, count this term only.
+             */
+            trap_data->memory += sizeof(Eterm) * size_shared(term);
+        } else {
             ErtsLiteralArea* area;
-            area = term_to_area(hash_table->term[idx]);
+            area = term_to_area(term);
             trap_data->memory += sizeof(ErtsLiteralArea) +
                 sizeof(Eterm) * (area->end - area->start - 1);
-            remaining--;
         }
-        idx++;
+        remaining--;
     }
-    trap_data->idx = idx;
     if (trap_data->remaining > 0) {
         return am_ok;           /* Dummy return value */
     } else {
@@ -878,15 +1331,21 @@ do_info(Process* c_p, TrapData* trap_data)
         Eterm count_term;
         Eterm memory_term;
         Eterm res;
-        Uint memory;
+        Uint num_entries = 0;
+        Uint memory = trap_data->memory;
         Uint hsz = MAP_SZ(2);
+        Uint i;
 
-        memory = sizeof(HashTable) + (trap_data->table->allocated-1) *
-            sizeof(Eterm) + trap_data->memory;
-        (void) erts_bld_uint(NULL, &hsz, hash_table->num_entries);
+        for (i = 0; i < num_shards; i++) {
+            HashTable* hash_table = trap_data->table[i];
+            num_entries += hash_table->num_entries;
+            memory += sizeof(HashTable) + (hash_table->allocated-1) *
+                sizeof(Eterm);
+        }
+        (void) erts_bld_uint(NULL, &hsz, num_entries);
         (void) erts_bld_uint(NULL, &hsz, memory);
         hp = HAlloc(c_p, hsz);
-	count_term = erts_bld_uint(&hp, NULL, hash_table->num_entries);
+	count_term = erts_bld_uint(&hp, NULL, num_entries);
 	memory_term = erts_bld_uint(&hp, NULL, memory);
         res = MAP2(hp, am_count, count_term, am_memory, memory_term);
         return res;
@@ -898,35 +1357,108 @@ do_info(Process* c_p, TrapData* trap_data)
 static Eterm
 alloc_trap_data(Process* c_p)
 {
-    Binary* mbp = erts_create_magic_binary(sizeof(TrapData),
+    Binary* mbp = erts_create_magic_binary(sizeof(TrapData) +
+                                           (num_shards - 1) *
+                                           sizeof(HashTable *),
                                            cleanup_trap_data);
+    TrapData* trap_data = ERTS_MAGIC_BIN_DATA(mbp);
     Eterm* hp;
 
+    trap_data->pinned = 0;
     hp = HAlloc(c_p, ERTS_MAGIC_REF_THING_SIZE);
     return erts_mk_magic_ref(&hp, &MSO(c_p), mbp);
 }
 
+/*
+ * Start an iteration over the current hash tables. Returns the total
+ * number of entries.
+ */
+
+static Uint
+snapshot_tables(TrapData* trap_data)
+{
+    Uint num_entries = 0;
+    Uint i;
+
+    for (i = 0; i < num_shards; i++) {
+        trap_data->table[i] = GET_TABLE(i);
+        num_entries += trap_data->table[i]->num_entries;
+    }
+    trap_data->table_ix = 0;
+    trap_data->idx = 0;
+    trap_data->remaining = num_entries;
+    trap_data->memory = 0;
+    return num_entries;
+}
+
+static void
+pin_tables(TrapData* trap_data)
+{
+    Uint i;
+
+    ASSERT(!trap_data->pinned);
+    for (i = 0; i < num_shards; i++) {
+        erts_atomic_inc_nob(&trap_data->table[i]->refc);
+    }
+    trap_data->pinned = 1;
+}
+
+static void
+unpin_tables(Process* c_p, TrapData* trap_data)
+{
+    Uint i;
+
+    ASSERT(trap_data->pinned);
+    trap_data->pinned = 0;
+    for (i = 0; i < num_shards; i++) {
+        dec_table_refc(c_p, trap_data->table[i]);
+    }
+}
+
+/*
+ * Return the next stored term of the iteration. Must only be called
+ * when there are terms remaining.
+ */
+
+static Eterm
+next_term(TrapData* trap_data)
+{
+    for (;;) {
+        HashTable* hash_table = trap_data->table[trap_data->table_ix];
+
+        while (trap_data->idx < hash_table->allocated) {
+            Eterm term = hash_table->term[trap_data->idx++];
+            if (is_boxed(term)) {
+                return term;
+            }
+        }
+        ASSERT(trap_data->table_ix < num_shards - 1);
+        trap_data->table_ix++;
+        trap_data->idx = 0;
+    }
+}
+
 static int
 cleanup_trap_data(Binary *bp)
 {
     TrapData* trap_data = ERTS_MAGIC_BIN_DATA(bp);
 
-    if (trap_data->table) {
+    if (trap_data->pinned) {
         /*
          * The process has been killed and is now exiting.
-         * Decrement the reference counter for the table.
+         * Decrement the reference counters for the tables.
          */
-        dec_table_refc(NULL, trap_data->table);
+        unpin_tables(NULL, trap_data);
     }
     return 1;
 }
 
 static Uint
-lookup(HashTable* hash_table, Eterm key)
+lookup(HashTable* hash_table, Eterm key, Uint32 hx)
 {
     Uint mask = hash_table->mask;
     Eterm* table = hash_table->term;
-    Uint32 idx = make_internal_hash(key, 0);
+    Uint32 idx = hx;
     Eterm term;
 
     do {
@@ -1010,7 +1542,8 @@ copy_table(ErtsPersistentTermCpyTableCtx* ctx)
              i++) {
             if (is_tuple(ctx->old_table->term[i])) {
                 Eterm key = tuple_val(ctx->old_table->term[i])[1];
-                Uint entry_index = lookup(ctx->new_table, key);
+                Uint32 hx = make_internal_hash(key, 0);
+                Uint entry_index = lookup(ctx->new_table, key, hx);
                 ASSERT(is_nil(ctx->new_table->term[entry_index]));
                 ctx->new_table->term[entry_index] = ctx->old_table->term[i];
             }
@@ -1023,8 +1556,12 @@ copy_table(ErtsPersistentTermCpyTableCtx* ctx)
         }
         ctx->iterations_done = 0;
     }
+    ctx->new_table->shard_ix = ctx->old_table->shard_ix;
     ctx->new_table->first_to_delete = 0;
     ctx->new_table->num_to_delete = 0;
+    ctx->new_table->num_to_release = 0;
+    ctx->new_table->to_release = NULL;
+    ctx->new_table->update_next = NULL;
     erts_atomic_init_nob(&ctx->new_table->refc, (erts_aint_t)1);
     {
         HashTable* new_table = ctx->new_table;
@@ -1047,25 +1584,56 @@ mark_for_deletion(HashTable* hash_table, Uint entry_index)
 static ErtsLiteralArea*
 term_to_area(Eterm tuple)
 {
-    ASSERT(is_tuple_arity(tuple, 2));
-    return (ErtsLiteralArea *) (((char *) tuple_val(tuple)) -
+    Eterm* start = tuple_val(tuple);
+
+    if (is_tuple_arity(tuple, 3)) {
+        start = boxed_val(start[3]);
+    } else {
+        ASSERT(is_tuple_arity(tuple, 2));
+    }
+    return (ErtsLiteralArea *) (((char *) start) -
                                 offsetof(ErtsLiteralArea, start));
 }
 
+static void
+release_term(Process* c_p, Eterm term)
+{
+    ErtsLiteralArea* area = term_to_area(term);
+
+    if (is_tuple_arity(term, 3)) {
+        if (erts_atomic_dec_read_mb(BATCH_REFC(area)) == 0) {
+            erts_queue_release_literals(c_p, area);
+        }
+    } else if (is_immed(tuple_val(term)[2])) {
+        erts_release_literal_area(area);
+    } else {
+        erts_queue_release_literals(c_p, area);
+    }
+}
+
+/*
+ * Install a chain of new hash tables, linked through update_next.
+ */
+
 static void
 table_updater(void* data)
 {
-    HashTable* old_table;
-    HashTable* new_table;
+    HashTable* new_table = (HashTable *) data;
 
-    old_table = (HashTable *) erts_atomic_read_nob(&the_hash_table);
-    new_table = (HashTable *) data;
-    ASSERT(new_table->num_to_delete == 0);
-    erts_atomic_set_nob(&the_hash_table, (erts_aint_t)new_table);
-    append_to_delete_queue(old_table);
-    erts_schedule_thr_prgr_later_op(table_deleter,
-                                    old_table,
-                                    &old_table->thr_prog_op);
+    do {
+        erts_atomic_t* slot = &the_hash_tables[new_table->shard_ix];
+        HashTable* old_table = (HashTable *) erts_atomic_read_nob(slot);
+        HashTable* next = new_table->update_next;
+
+        ASSERT(new_table->num_to_delete == 0);
+        new_table->update_next = NULL;
+        erts_atomic_set_nob(slot, (erts_aint_t)new_table);
+        append_to_delete_queue(old_table);
+        erts_schedule_thr_prgr_later_op(table_deleter,
+                                        old_table,
+                                        &old_table->thr_prog_op);
+        new_table = next;
+    } while (new_table);
     release_update_permission(1);
 }
 
@@ -1106,22 +1674,24 @@ delete_table(Process* c_p, HashTable* table)
 
 #ifdef DEBUG
     if (n == 1) {
-        ASSERT(is_tuple_arity(table->term[idx], 2));
+        ASSERT(is_tuple(table->term[idx]));
     }
 #endif
 
     while (n > 0) {
         Eterm term = table->term[idx];
 
-        if (is_tuple_arity(term, 2)) {
-            if (is_immed(tuple_val(term)[2])) {
-                erts_release_literal_area(term_to_area(term));
-            } else {
-                erts_queue_release_literals(c_p, term_to_area(term));
-            }
+        if (is_tuple(term)) {
+            release_term(c_p, term);
         }
         idx++, n--;
     }
+    if (table->to_release) {
+        for (n = 0; n < table->num_to_release; n++) {
+            release_term(c_p, table->to_release[n]);
+        }
+        erts_free(ERTS_ALC_T_PERSISTENT_TERM, table->to_release);
+    }
     erts_free(ERTS_ALC_T_PERSISTENT_TERM, table);
 }
 
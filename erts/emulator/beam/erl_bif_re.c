@@ -27,6 +27,7 @@
 #include "erl_process.h"
 #include "error.h"
 #include "bif.h"
+#include "erl_map.h"
 #include "erl_binary.h"
 #include "big.h"
 #define ERLANG_INTEGRATION 1
@@ -36,6 +37,13 @@
 #define PCRE_DEFAULT_COMPILE_OPTS 0 
 #define PCRE_DEFAULT_EXEC_OPTS 0 
 #define LOOP_FACTOR 10
+/* Subject bytes that JIT compiled code is assumed to scan in the time
+   the interpreter executes one loop */
+#define JIT_SUBJECT_FACTOR 8
+/* Exec options that the JIT compiled code handles, other options make
+   erts_pcre_exec() fall back on the interpreter */
+#define JIT_EXEC_OPTS (PCRE_NOTBOL | PCRE_NOTEOL | PCRE_NOTEMPTY | \
+                       PCRE_NOTEMPTY_ATSTART | PCRE_NO_UTF8_CHECK)
 
 
 static const unsigned char *default_table;
@@ -90,6 +98,206 @@ stack_guard_upwards(void)
     return erts_check_above_limit(&c, limit - ERTS_PCRE_STACK_MARGIN);
 }
 
+/*
+ * Per scheduler cache of patterns compiled from textual regular
+ * expressions given directly to re:run/3. A cache is only accessed by
+ * its own scheduler, the counters are atomics so that
+ * erlang:system_info(re_cache) can read them from any thread.
+ */
+
+#define RE_CACHE_ENTRIES 32
+#define RE_CACHE_MAX_PATTERN 1024	/* Bytes of textual pattern */
+#define RE_CACHE_MAX_CODE (16*1024)	/* Bytes of compiled code */
+
+typedef struct {
+    char *pattern;		/* Also holds the compiled code */
+    ErlDrvSizeT pattern_len;
+    pcre *code;
+    size_t code_size;
+    Uint64 last_used;
+    Uint32 hash;
+    int options;
+} ReCacheEntry;
+
+typedef struct {
+    ReCacheEntry entries[RE_CACHE_ENTRIES];
+    Uint64 clock;
+    erts_atomic_t used;
+    erts_atomic_t hits;
+    erts_atomic_t misses;
+    erts_atomic_t evictions;
+} ReCache;
+
+typedef union {
+    ReCache c;
+    char align[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(sizeof(ReCache))];
+} ReCacheAligned;
+
+static ReCacheAligned *re_caches;
+
+static void init_re_caches(void)
+{
+    Uint i;
+    re_caches = erts_alloc_permanent_cache_aligned(ERTS_ALC_T_RE_CACHE,
+						   erts_no_schedulers *
+						   sizeof(ReCacheAligned));
+    for (i = 0; i < erts_no_schedulers; i++) {
+	ReCache *cache = &re_caches[i].c;
+	sys_memzero(cache->entries, sizeof(cache->entries));
+	cache->clock = 0;
+	erts_atomic_init_nob(&cache->used, 0);
+	erts_atomic_init_nob(&cache->hits, 0);
+	erts_atomic_init_nob(&cache->misses, 0);
+	erts_atomic_init_nob(&cache->evictions, 0);
+    }
+}
+
+static ERTS_INLINE ReCache *get_re_cache(void)
+{
+    ErtsSchedulerData *esdp = erts_get_scheduler_data();
+    if (esdp == NULL || ERTS_SCHEDULER_IS_DIRTY(esdp)) {
+	return NULL;
+    }
+    return &re_caches[esdp->no - 1].c;
+}
+
+static Uint32 re_cache_hash(const char *pattern, ErlDrvSizeT len, int options)
+{
+    /* FNV-1a */
+    Uint32 hash = 2166136261U ^ (Uint32) options;
+    ErlDrvSizeT i;
+    for (i = 0; i < len; i++) {
+	hash ^= (byte) pattern[i];
+	hash *= 16777619U;
+    }
+    return hash;
+}
+
+static void re_cache_insert(ReCache *cache, Uint32 hash, const char *pattern,
+			    ErlDrvSizeT len, int options,
+			    const pcre *code, size_t code_size)
+{
+    ReCacheEntry *entry = NULL;
+    int i;
+
+    if (len > RE_CACHE_MAX_PATTERN || code_size > RE_CACHE_MAX_CODE) {
+	return;
+    }
+    for (i = 0; i < RE_CACHE_ENTRIES; i++) {
+	ReCacheEntry *e = &cache->entries[i];
+	if (e->pattern == NULL) {
+	    entry = e;
+	    erts_atomic_inc_nob(&cache->used);
+	    break;
+	}
+	if (entry == NULL || e->last_used < entry->last_used) {
+	    entry = e;
+	}
+    }
+    if (entry->pattern != NULL) {
+	/* Evict the least recently used entry */
+	erts_free(ERTS_ALC_T_RE_CACHE, entry->code);
+	erts_atomic_inc_nob(&cache->evictions);
+    }
+    /* The code is placed first to keep it word aligned */
+    entry->code = erts_alloc(ERTS_ALC_T_RE_CACHE, code_size + len);
+    entry->pattern = ((char *) entry->code) + code_size;
+    sys_memcpy(entry->code, code, code_size);
+    sys_memcpy(entry->pattern, pattern, len);
+    entry->pattern_len = len;
+    entry->code_size = code_size;
+    entry->hash = hash;
+    entry->options = options;
+    entry->last_used = ++cache->clock;
+}
+
+/*
+ * Compile a textual regular expression, or copy the code of an earlier
+ * compilation from the scheduler's cache. The code is returned in a
+ * block of allocator type alc_type.
+ */
+static pcre *
+compile_textual_re(const char *pattern, ErlDrvSizeT len, int options,
+		   ErtsAlcType_t alc_type, size_t *code_size,
+		   int *errcode, const char **errstr, int *errofset)
+{
+    ReCache *cache = get_re_cache();
+    Uint32 hash = 0;
+    pcre *result;
+    pcre *code;
+    int i;
+
+    if (cache != NULL && len <= RE_CACHE_MAX_PATTERN) {
+	hash = re_cache_hash(pattern, len, options);
+	for (i = 0; i < RE_CACHE_ENTRIES; i++) {
+	    ReCacheEntry *e = &cache->entries[i];
+	    if (e->pattern != NULL && e->hash == hash &&
+		e->options == options && e->pattern_len == len &&
+		sys_memcmp(e->pattern, pattern, len) == 0) {
+		e->last_used = ++cache->clock;
+		erts_atomic_inc_nob(&cache->hits);
+		code = erts_alloc(alc_type, e->code_size);
+		sys_memcpy(code, e->code, e->code_size);
+		*code_size = e->code_size;
+		return code;
+	    }
+	}
+	erts_atomic_inc_nob(&cache->misses);
+    }
+
+    /* pattern is NUL terminated by the caller */
+    result = erts_pcre_compile2(pattern, options, errcode,
+				errstr, errofset, default_table);
+    if (!result) {
+	return NULL;
+    }
+    erts_pcre_fullinfo(result, NULL, PCRE_INFO_SIZE, code_size);
+    if (cache != NULL && len <= RE_CACHE_MAX_PATTERN) {
+	re_cache_insert(cache, hash, pattern, len, options,
+			result, *code_size);
+    }
+    if (alc_type == ERTS_ALC_T_RE_HEAP) {
+	return result;
+    }
+    code = erts_alloc(alc_type, *code_size);
+    sys_memcpy(code, result, *code_size);
+    erts_pcre_free(result);
+    return code;
+}
+
+Eterm erts_re_cache_info(Process *c_p)
+{
+    Uint entries = 0, evictions = 0, hits = 0, misses = 0;
+    Uint max_entries = erts_no_schedulers * RE_CACHE_ENTRIES;
+    Eterm entries_term, evictions_term, hits_term, misses_term;
+    Eterm max_entries_term;
+    Uint hsz = MAP_SZ(5);
+    Eterm *hp;
+    Uint i;
+
+    for (i = 0; i < erts_no_schedulers; i++) {
+	ReCache *cache = &re_caches[i].c;
+	entries += (Uint) erts_atomic_read_nob(&cache->used);
+	evictions += (Uint) erts_atomic_read_nob(&cache->evictions);
+	hits += (Uint) erts_atomic_read_nob(&cache->hits);
+	misses += (Uint) erts_atomic_read_nob(&cache->misses);
+    }
+    (void) erts_bld_uint(NULL, &hsz, entries);
+    (void) erts_bld_uint(NULL, &hsz, evictions);
+    (void) erts_bld_uint(NULL, &hsz, hits);
+    (void) erts_bld_uint(NULL, &hsz, max_entries);
+    (void) erts_bld_uint(NULL, &hsz, misses);
+    hp = HAlloc(c_p, hsz);
+    entries_term = erts_bld_uint(&hp, NULL, entries);
+    evictions_term = erts_bld_uint(&hp, NULL, evictions);
+    hits_term = erts_bld_uint(&hp, NULL, hits);
+    max_entries_term = erts_bld_uint(&hp, NULL, max_entries);
+    misses_term = erts_bld_uint(&hp, NULL, misses);
+    return MAP5(hp, am_entries, entries_term, am_evictions, evictions_term,
+		am_hits, hits_term, am_max_entries, max_entries_term,
+		am_misses, misses_term);
+}
+
 void erts_init_bif_re(void)
 {
     char c;
@@ -103,6 +311,7 @@ void erts_init_bif_re(void)
         erts_pcre_stack_guard = stack_guard_upwards;
     default_table = NULL; /* ISO8859-1 default, forced into pcre */
     max_loop_limit = CONTEXT_REDS * LOOP_FACTOR;
+    init_re_caches();
 
     erts_init_trap_export(&re_exec_trap_export, am_erlang, am_re_run_trap, 3,
 			  &re_exec_trap);
@@ -215,6 +424,7 @@ static Eterm make_signed_integer(int x, Process *p)
 #define PARSE_FLAG_REPORT_ERRORS 64
 #define PARSE_FLAG_MATCH_LIMIT 128
 #define PARSE_FLAG_MATCH_LIMIT_RECURSION 256
+#define PARSE_FLAG_JIT 512
 
 #define CAPSPEC_VALUES 0
 #define CAPSPEC_TYPE 1
@@ -402,6 +612,9 @@ parse_options(Eterm listp, /* in */
 		    copt |= PCRE_UNGREEDY; 
 		    fl |= PARSE_FLAG_UNIQUE_COMPILE_OPT;
 		    break;
+		case am_jit:
+		    fl |= (PARSE_FLAG_UNIQUE_COMPILE_OPT | PARSE_FLAG_JIT);
+		    break;
 		case am_ucp:
 		    copt |= PCRE_UCP; 
 		    fl |= PARSE_FLAG_UNIQUE_COMPILE_OPT;
@@ -450,12 +663,64 @@ parse_options(Eterm listp, /* in */
     return 0;
 }
 
+/*
+ * A pattern compiled with the jit option can not keep its code in an
+ * ordinary binary, as the machine code lives outside of it. It is
+ * instead kept in a magic binary together with the compiled pattern.
+ */
+
+typedef struct {
+    pcre *code;
+    size_t code_size;
+    erts_pcre_extra *jit_extra;
+} JitPattern;
+
+static int cleanup_jit_pattern_bin(Binary *bp)
+{
+    JitPattern *jp = ERTS_MAGIC_BIN_DATA(bp);
+    if (jp->jit_extra != NULL) {
+	erts_pcre_free_study(jp->jit_extra);
+	jp->jit_extra = NULL;
+    }
+    if (jp->code != NULL) {
+	erts_pcre_free(jp->code);
+	jp->code = NULL;
+    }
+    return 1;
+}
+
+/*
+ * Get the compiled code from the last element of an re_pattern
+ * tuple. *jpp is set if the pattern has been JIT compiled.
+ */
+static const pcre *
+get_pattern_code(Eterm code_term, size_t *code_size,
+		 byte **temp_alloc, JitPattern **jpp)
+{
+    *jpp = NULL;
+    *temp_alloc = NULL;
+    if (is_internal_magic_ref(code_term)) {
+	Binary *bp = erts_magic_ref2bin(code_term);
+	if (ERTS_MAGIC_BIN_DESTRUCTOR(bp) != cleanup_jit_pattern_bin) {
+	    return NULL;
+	}
+	*jpp = ERTS_MAGIC_BIN_DATA(bp);
+	*code_size = (*jpp)->code_size;
+	return (*jpp)->code;
+    }
+    if (is_not_binary(code_term)) {
+	return NULL;
+    }
+    *code_size = binary_size(code_term);
+    return (const pcre *) erts_get_aligned_binary_bytes(code_term, temp_alloc);
+}
+
 /*
  * Build Erlang term result from compilation
  */
 
 static Eterm 
-build_compile_result(Process *p, Eterm error_tag, pcre *result, int errcode, const char *errstr, int errofset, int unicode, int with_ok, Eterm extra_err_tag) 
+build_compile_result(Process *p, Eterm error_tag, pcre *result, int errcode, const char *errstr, int errofset, int unicode, int with_ok, Eterm extra_err_tag, int jit) 
 {
     Eterm *hp;
     Eterm ret;
@@ -490,10 +755,33 @@ build_compile_result(Process *p, Eterm error_tag, pcre *result, int errcode, con
 	use_crlf = (options == PCRE_NEWLINE_ANY ||
 		    options == PCRE_NEWLINE_CRLF ||
 		    options == PCRE_NEWLINE_ANYCRLF);
-	/* XXX: Optimize - keep in offheap binary to allow this to 
-	   be kept across traps w/o need of copying */
-	ret = new_binary(p, (byte *) result, pattern_size);
-	erts_pcre_free(result);
+	ret = THE_NON_VALUE;
+	if (jit) {
+	    /* If the JIT is not supported or fails, the pattern
+	       is silently kept in an ordinary binary */
+	    const char *study_err = NULL;
+	    erts_pcre_extra *extra = erts_pcre_study(result,
+						     PCRE_STUDY_JIT_COMPILE,
+						     &study_err);
+	    if (extra != NULL && (extra->flags & PCRE_EXTRA_EXECUTABLE_JIT)) {
+		Binary *mbp = erts_create_magic_binary(sizeof(JitPattern),
+						       cleanup_jit_pattern_bin);
+		JitPattern *jp = ERTS_MAGIC_BIN_DATA(mbp);
+		jp->code = result;
+		jp->code_size = pattern_size;
+		jp->jit_extra = extra;
+		hp = HAlloc(p, ERTS_MAGIC_REF_THING_SIZE);
+		ret = erts_mk_magic_ref(&hp, &MSO(p), mbp);
+	    } else if (extra != NULL) {
+		erts_pcre_free_study(extra);
+	    }
+	}
+	if (is_non_value(ret)) {
+	    /* XXX: Optimize - keep in offheap binary to allow this to 
+	       be kept across traps w/o need of copying */
+	    ret = new_binary(p, (byte *) result, pattern_size);
+	    erts_pcre_free(result);
+	}
 	hp = HAlloc(p, (with_ok) ? (3+6) : 6);
 	ret = TUPLE5(hp,am_re_pattern, make_small(capture_count), make_small(unicode),make_small(use_crlf),ret);
 	if (with_ok) {
@@ -561,7 +849,8 @@ re_compile(Process* p, Eterm arg1, Eterm arg2)
 			   &errstr, &errofset, default_table);
 
     ret = build_compile_result(p, am_error, result, errcode,
-			       errstr, errofset, unicode, 1, NIL);
+			       errstr, errofset, unicode, 1, NIL,
+			       (pflags & PARSE_FLAG_JIT) ? 1 : 0);
     erts_free(ERTS_ALC_T_RE_TMP_BUF, expr);
     BIF_RET(ret);
 }
@@ -1090,6 +1379,45 @@ build_capture(Eterm capture_spec[CAPSPEC_SIZE], const pcre *code)
 }    
 
 
+/*
+ * Run a JIT compiled pattern. The JIT compiled code can not yield, so
+ * it is only used when the subject is short enough to be scanned
+ * within the reductions left, and its match limit is set from the
+ * reductions left. If that limit is hit, or the JIT stack is
+ * exhausted, PCRE_ERROR_LOOP_LIMIT is returned and the caller starts
+ * over in the interpreter.
+ */
+static int
+re_jit_exec(Process *p, JitPattern *jp, RestartContext *restartp,
+	    ErlDrvSizeT slength, int startoffset, int options, int ovsize,
+	    int match_limit)
+{
+    erts_pcre_extra extra = *jp->jit_extra;
+    unsigned long jit_limit = restartp->extra.loop_limit / 2 + 1;
+    int own_limit = 1;
+    Sint scanned;
+    int rc;
+
+    if (match_limit >= 0 && (unsigned long) match_limit <= jit_limit) {
+	jit_limit = match_limit;
+	own_limit = 0;
+    }
+    extra.flags |= PCRE_EXTRA_MATCH_LIMIT;
+    extra.match_limit = jit_limit;
+
+    rc = erts_pcre_exec(jp->code, &extra, restartp->subject, slength,
+			startoffset, options, restartp->ovector, ovsize);
+
+    if ((rc == PCRE_ERROR_MATCHLIMIT && own_limit) ||
+	rc == PCRE_ERROR_JIT_STACKLIMIT) {
+	BUMP_REDS(p, jit_limit / LOOP_FACTOR);
+	return PCRE_ERROR_LOOP_LIMIT;
+    }
+    scanned = (rc > 0 ? restartp->ovector[1] : (Sint) slength) - startoffset;
+    BUMP_REDS(p, scanned / (LOOP_FACTOR * JIT_SUBJECT_FACTOR) + 1);
+    return rc;
+}
+
 /*
  * The actual re:run/2,3 BIFs
  */
@@ -1114,6 +1442,7 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
     int is_list_cap;
     int match_limit = 0;
     int match_limit_recursion = 0;
+    JitPattern *jit_pattern = NULL;
 
     if (parse_options(arg3,&comp_options,&options,&pflags,&startoffset,capture,
 		      &match_limit,&match_limit_recursion)
@@ -1151,8 +1480,12 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 	    ASSERT(buffres >= 0); (void)buffres;
 
 	    expr[slen]='\0';
-	    result = erts_pcre_compile2(expr, comp_options, &errcode, 
-				   &errstr, &errofset, default_table);
+	    result = compile_textual_re(expr, slen, comp_options,
+					((pflags & PARSE_FLAG_GLOBAL) ?
+					 ERTS_ALC_T_RE_HEAP :
+					 ERTS_ALC_T_RE_SUBJECT),
+					&code_size, &errcode,
+					&errstr, &errofset);
 	    if (!result) {
 		/* Compilation error gives badarg except in the compile 
 		   function or if we have PARSE_FLAG_REPORT_ERRORS */
@@ -1161,7 +1494,7 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 					       errstr, errofset, 
 					       (pflags & 
 						PARSE_FLAG_UNICODE) ? 1 : 0, 
-					       1, am_compile);
+					       1, am_compile, 0);
 		    erts_free(ERTS_ALC_T_RE_TMP_BUF, expr);
 		    BIF_RET(res);
 		} else {
@@ -1176,7 +1509,8 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 					 errstr, errofset, 
 					 (pflags & 
 					  PARSE_FLAG_UNICODE) ? 1 : 0,
-					 0, NIL);
+					 0, NIL,
+					 (pflags & PARSE_FLAG_JIT) ? 1 : 0);
 		Eterm *hp,r;
 		erts_free(ERTS_ALC_T_RE_TMP_BUF, expr);
 		hp = HAlloc(p,4);
@@ -1188,12 +1522,9 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 		BIF_TRAP3(grun_trap_exportp, p, arg1, precompiled, r);
 	    }
 
-	    erts_pcre_fullinfo(result, NULL, PCRE_INFO_SIZE, &code_size);
 	    erts_pcre_fullinfo(result, NULL, PCRE_INFO_CAPTURECOUNT, &capture_count);
 	    ovsize = 3*(capture_count+1);
-	    restart.code = erts_alloc(ERTS_ALC_T_RE_SUBJECT, code_size);
-	    sys_memcpy(restart.code, result, code_size);
-	    erts_pcre_free(result);
+	    restart.code = result;
 	    erts_free(ERTS_ALC_T_RE_TMP_BUF, expr);
 	    /*unicode = (pflags & PARSE_FLAG_UNICODE) ? 1 : 0;*/
 	} else {  
@@ -1207,7 +1538,7 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 	tp = tuple_val(arg2);
 	if (tp[1] != am_re_pattern || is_not_small(tp[2]) || 
 	    is_not_small(tp[3]) || is_not_small(tp[4]) || 
-	    is_not_binary(tp[5])) {
+	    (is_not_binary(tp[5]) && !is_internal_magic_ref(tp[5]))) {
 	    BIF_ERROR(p,BADARG);
 	}
 
@@ -1227,8 +1558,7 @@ re_run(Process *p, Eterm arg1, Eterm arg2, Eterm arg3)
 	}
 
 	ovsize = 3*(unsigned_val(tp[2])+1);
-	code_size = binary_size(tp[5]);
-	code_tmp = (const pcre *) erts_get_aligned_binary_bytes(tp[5], &temp_alloc);
+	code_tmp = get_pattern_code(tp[5], &code_size, &temp_alloc, &jit_pattern);
 	if (code_tmp == NULL || code_size < 4) {
 	    erts_free_aligned_binary_bytes(temp_alloc);
 	    BIF_ERROR(p, BADARG);
@@ -1319,6 +1649,24 @@ handle_iolist:
 	restart.flags |= RESTART_FLAG_REPORT_MATCH_LIMIT;
     }
 
+    if (jit_pattern != NULL && (options & ~JIT_EXEC_OPTS) == 0 &&
+	(Sint) slength - startoffset <=
+	(Sint) (restart.extra.loop_limit * JIT_SUBJECT_FACTOR)) {
+	rc = re_jit_exec(p, jit_pattern, &restart, slength, startoffset,
+			 options, ovsize,
+			 (pflags & PARSE_FLAG_MATCH_LIMIT) ? match_limit : -1);
+	if (rc != PCRE_ERROR_LOOP_LIMIT) {
+	    res = build_exec_return(p, rc, &restart, arg1);
+	    cleanup_restart_context(&restart);
+	    BIF_RET(res);
+	}
+	/* Continue in the interpreter, which can yield */
+	restart.extra.loop_limit = ERTS_BIF_REDS_LEFT(p) * LOOP_FACTOR;
+	if (restart.extra.loop_limit > loop_limit_tmp) {
+	    restart.extra.loop_limit = loop_limit_tmp;
+	}
+    }
+
 #ifdef DEBUG
     loop_count = 0xFFFFFFFF;
 #endif
@@ -1435,21 +1783,22 @@ re_inspect_2(BIF_ALIST_2)
     const pcre *code;
     byte *temp_alloc = NULL;
     int infores;    
+    size_t code_size;
+    JitPattern *jit_pattern;
 
     if (is_not_tuple(BIF_ARG_1) || (arityval(*tuple_val(BIF_ARG_1)) != 5)) {
 	goto error;
     }
     tp = tuple_val(BIF_ARG_1);
     if (tp[1] != am_re_pattern || is_not_small(tp[2]) || 
-	is_not_small(tp[3]) || is_not_small(tp[4]) || 
-	is_not_binary(tp[5])) {
+	is_not_small(tp[3]) || is_not_small(tp[4])) {
 	goto error;
     }
     if (BIF_ARG_2 != am_namelist) {
 	goto error;
     }
-    if ((code = (const pcre *) 
-	 erts_get_aligned_binary_bytes(tp[5], &temp_alloc)) == NULL) {
+    if ((code = get_pattern_code(tp[5], &code_size, &temp_alloc,
+				 &jit_pattern)) == NULL) {
 	goto error;
     }
 
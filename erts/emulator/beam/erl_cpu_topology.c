@@ -437,6 +437,47 @@ processor_order_cmp(const void *vx, const void *vy)
     return 0;
 }
 
+/*
+ * NUMA node of a logical processor according to the cpu topology
+ * used for binding, or -1 if unknown.
+ */
+static int
+cpu_numa_node(int logical)
+{
+    erts_cpu_topology_t *cpudata;
+    int ix, size;
+
+    ERTS_LC_ASSERT(erts_lc_rwmtx_is_rlocked(&cpuinfo_rwmtx)
+		   || erts_lc_rwmtx_is_rwlocked(&cpuinfo_rwmtx));
+
+    if (logical < 0)
+	return -1;
+
+    if (user_cpudata) {
+	cpudata = user_cpudata;
+	size = user_cpudata_size;
+    }
+    else {
+	cpudata = system_cpudata;
+	size = system_cpudata_size;
+    }
+
+    for (ix = 0; ix < size; ix++) {
+	if (cpudata[ix].logical == logical)
+	    return (cpudata[ix].node >= 0
+		    ? cpudata[ix].node
+		    : cpudata[ix].processor_node);
+    }
+    return -1;
+}
+
+static ERTS_INLINE void
+update_numa_node(ErtsSchedulerData *esdp)
+{
+    erts_atomic32_set_nob(&esdp->run_queue->numa_node,
+			  (erts_aint32_t) cpu_numa_node(esdp->cpu_id));
+}
+
 void
 erts_sched_check_cpu_bind_prep_suspend(ErtsSchedulerData *esdp)
 {
@@ -451,6 +492,7 @@ erts_sched_check_cpu_bind_prep_suspend(ErtsSchedulerData *esdp)
 	&& erts_unbind_from_cpu(cpuinfo) == 0) {
 	esdp->cpu_id = scheduler2cpu_map[esdp->no].bound_id = -1;
     }
+    update_numa_node(esdp);
 
     cgcc = erts_alloc(ERTS_ALC_T_TMP,
 		      (no_cpu_groups_callbacks
@@ -530,6 +572,8 @@ erts_sched_check_cpu_bind(ErtsSchedulerData *esdp)
 	}
     }
 
+    update_numa_node(esdp);
+
     cgcc = erts_alloc(ERTS_ALC_T_TMP,
 		      (no_cpu_groups_callbacks
 		       * sizeof(erts_cpu_groups_callback_call_t)));
@@ -381,6 +381,16 @@ static BIF_RETTYPE ets_select_replace_1(BIF_ALIST_1);
 static BIF_RETTYPE ets_select_trap_1(BIF_ALIST_1);
 static BIF_RETTYPE ets_delete_trap(BIF_ALIST_1);
 static Eterm table_info(Process* p, DbTable* tb, Eterm What);
+static Eterm hash_stats_info(Process* p, DbTable* tb, Eterm What,
+                             DbHashStatsCtx* ctx);
+static BIF_RETTYPE ets_info_hash_stats(Process* p, DbTable* tb, Eterm What,
+                                       Binary* ctx_bin);
+static BIF_RETTYPE ets_info_stats_trap_1(BIF_ALIST_1);
+static BIF_RETTYPE ets_get_many(Process* p, DbTable* tb, Eterm keys, Eterm acc,
+                                Eterm what);
+static BIF_RETTYPE ets_get_many_trap_1(BIF_ALIST_1);
+static BIF_RETTYPE ets_info_many(Process* p, Eterm tabs, Eterm item, Eterm acc);
+static BIF_RETTYPE ets_info_many_trap_1(BIF_ALIST_1);
 
 static BIF_RETTYPE ets_select1(Process* p, int bif_ix, Eterm arg1);
 static BIF_RETTYPE ets_select2(Process* p, DbTable*, Eterm tid, Eterm ms);
@@ -399,6 +409,9 @@ Export ets_select_continue_exp;
  * Static traps
  */
 static Export ets_delete_continue_exp;
+static Export ets_info_stats_continue_exp;
+static Export ets_get_many_continue_exp;
+static Export ets_info_many_continue_exp;
 	
 static void
 free_dbtable(void *vtb)
@@ -410,6 +423,9 @@ free_dbtable(void *vtb)
 
     erts_rwmtx_destroy(&tb->common.rwlock);
     erts_mtx_destroy(&tb->common.fixlock);
+    erts_mtx_destroy(&tb->common.literal_mtx);
+    ASSERT(tb->common.literal_chunk == NULL);
+    ASSERT(tb->common.literal_sparse == NULL);
     ASSERT(is_immed(tb->common.heir_data));
 
     if (tb->common.btid)
@@ -597,6 +613,8 @@ static ERTS_INLINE void db_init_lock(DbTable* tb, int use_frequent_read_lock)
         tb->common.the_name, ERTS_LOCK_FLAGS_CATEGORY_DB);
     erts_mtx_init(&tb->common.fixlock, "db_tab_fix",
         tb->common.the_name, ERTS_LOCK_FLAGS_CATEGORY_DB);
+    erts_mtx_init(&tb->common.literal_mtx, "db_tab_literal",
+        tb->common.the_name, ERTS_LOCK_FLAGS_CATEGORY_DB);
     tb->common.is_thread_safe = !(tb->common.status & DB_FINE_LOCKED);
 }
 
@@ -661,6 +679,39 @@ static ERTS_INLINE int db_is_exclusive(DbTable* tb, db_lock_kind_t kind)
     return kind != LCK_READ && tb->common.is_thread_safe;
 }
 
+static void
+resize_aux_work(void *vtb)
+{
+    DbTable *tb = (DbTable *) vtb;
+    int more = 0;
+
+    if (is_table_alive(tb)) {
+        db_lock(tb, LCK_WRITE_REC);
+        more = db_resize_aux_work_hash(&tb->hash,
+                                       tb->common.status & (DB_DELETE|DB_BUSY));
+        db_unlock(tb, LCK_WRITE_REC);
+    }
+    if (more)
+        erts_schedule_misc_aux_work((int) erts_get_scheduler_id(),
+                                    resize_aux_work, vtb);
+    else
+        table_dec_refc(tb, 0);
+}
+
+/*
+ * Resize a hash table as aux work of the current scheduler,
+ * see schedule_resize() in erl_db_hash.c
+ */
+void
+erts_db_schedule_resize(DbTable *tb)
+{
+    ASSERT(IS_HASH_TABLE(tb->common.type));
+    ASSERT(erts_get_scheduler_id());
+    erts_refc_inc(&tb->common.refc, 1);
+    erts_schedule_misc_aux_work((int) erts_get_scheduler_id(),
+                                resize_aux_work, (void *) tb);
+}
+
 static DbTable* handle_lacking_permission(Process* p, DbTable* tb,
                                           db_lock_kind_t kind,
                                           Uint* freason_p)
@@ -1601,6 +1652,49 @@ fail:
 }
 
 
+/* Hash table load factor option as fixed point, see erl_db_hash.h */
+static int get_load_factor(Eterm term, int *load_factor)
+{
+    double lf;
+
+    if (is_small(term))
+        lf = (double) signed_val(term);
+    else if (is_float(term)) {
+        FloatDef f;
+        GET_DOUBLE(term, f);
+        lf = f.fd;
+    }
+    else
+        return 0;
+
+    lf *= DB_HASH_LOAD_FACTOR_DEFAULT;
+    if (!(lf >= DB_HASH_LOAD_FACTOR_MIN && lf <= DB_HASH_LOAD_FACTOR_MAX))
+        return 0;
+    *load_factor = (int) lf;
+    return 1;
+}
+
+/* CA tree {JoinLimit, SplitLimit} option, see erl_db_catree.h */
+static int get_contention_limits(Eterm term, Sint *join_limit,
+                                 Sint *split_limit)
+{
+    Eterm *tp;
+
+    if (!is_tuple_arity(term, 2))
+        return 0;
+    tp = tuple_val(term);
+    if (!is_small(tp[1]) || !is_small(tp[2]))
+        return 0;
+    if (!(signed_val(tp[1]) < 0
+          && signed_val(tp[1]) > -DB_CATREE_CONTENTION_LIMIT_MAX
+          && signed_val(tp[2]) > 0
+          && signed_val(tp[2]) < DB_CATREE_CONTENTION_LIMIT_MAX))
+        return 0;
+    *join_limit = signed_val(tp[1]);
+    *split_limit = signed_val(tp[2]);
+    return 1;
+}
+
 /* 
 ** The create table BIF     
 ** Args: (Name, Properties) 
@@ -1618,6 +1712,9 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
     Sint keypos;
     int is_named, is_compressed;
     int is_fine_locked, frequent_read;
+    int load_factor, incremental_resize;
+    Sint join_limit, split_limit;
+    int shared_literal;
     int cret;
     DbTableMethod* meth;
 
@@ -1633,6 +1730,11 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
     is_named = 0;
     is_fine_locked = 0;
     frequent_read = 0;
+    load_factor = DB_HASH_LOAD_FACTOR_DEFAULT;
+    incremental_resize = 0;
+    join_limit = DB_CATREE_JOIN_LIMIT_DEFAULT;
+    split_limit = DB_CATREE_SPLIT_LIMIT_DEFAULT;
+    shared_literal = 0;
     heir = am_none;
     heir_data = (UWord) am_undefined;
     is_compressed = erts_ets_always_compress;
@@ -1674,6 +1776,28 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
 		    } else break;
 		    
 		}
+		else if (tp[1] == am_load_factor) {
+		    if (!get_load_factor(tp[2], &load_factor))
+			break;
+		}
+		else if (tp[1] == am_incremental_resize) {
+		    if (tp[2] == am_true) {
+			incremental_resize = 1;
+		    } else if (tp[2] == am_false) {
+			incremental_resize = 0;
+		    } else break;
+		}
+		else if (tp[1] == am_contention_limits) {
+		    if (!get_contention_limits(tp[2], &join_limit, &split_limit))
+			break;
+		}
+		else if (tp[1] == am_read_mode) {
+		    if (tp[2] == am_shared_literal) {
+			shared_literal = 1;
+		    } else if (tp[2] == am_copy) {
+			shared_literal = 0;
+		    } else break;
+		}
 		else if (tp[1] == am_heir && tp[2] == am_none) {
 		    heir = am_none;
 		    heir_data = am_undefined;
@@ -1764,12 +1888,24 @@ BIF_RETTYPE ets_new_2(BIF_ALIST_2)
 
     tb->common.fixing_procs = NULL;
     tb->common.compress = is_compressed;
+    /* Only uncompressed hash tables share objects, others copy */
+    tb->common.shared_literal = 0;
+    tb->common.literal_chunk = NULL;
+    tb->common.literal_sparse = NULL;
+#ifdef DB_HAVE_SHARED_LITERAL
+    if (shared_literal && IS_HASH_TABLE(status) && !is_compressed)
+        tb->common.shared_literal = 1;
+#endif
 #ifdef ETS_DBG_FORCE_TRAP
     erts_atomic_init_nob(&tb->common.dbg_force_trap, erts_ets_dbg_force_trap);
 #endif
 
     cret = meth->db_create(BIF_P, tb);
     ASSERT(cret == DB_ERROR_NONE); (void)cret;
+    if (IS_HASH_TABLE(status))
+        db_set_resize_params_hash(&tb->hash, load_factor, incremental_resize);
+    else if (IS_CATREE_TABLE(status))
+        db_set_contention_limits_catree(&tb->catree, join_limit, split_limit);
 
     make_btid(tb);
 
@@ -1889,6 +2025,116 @@ BIF_RETTYPE ets_member_2(BIF_ALIST_2)
 
 }
 
+/*
+** The lookup_many and member_many BIFs
+** Keys are handed to the table method in batches, the results are
+** accumulated in reverse order and the BIF traps when out of reductions.
+*/
+BIF_RETTYPE ets_lookup_many_2(BIF_ALIST_2)
+{
+    DbTable* tb;
+
+    CHECK_TABLES();
+
+    DB_BIF_GET_TABLE(tb, DB_READ, LCK_READ, BIF_ets_lookup_many_2);
+
+    return ets_get_many(BIF_P, tb, BIF_ARG_2, NIL, am_lookup);
+}
+
+BIF_RETTYPE ets_member_many_2(BIF_ALIST_2)
+{
+    DbTable* tb;
+
+    CHECK_TABLES();
+
+    DB_BIF_GET_TABLE(tb, DB_READ, LCK_READ, BIF_ets_member_many_2);
+
+    return ets_get_many(BIF_P, tb, BIF_ARG_2, NIL, am_member);
+}
+
+/* Called with the table read locked */
+static BIF_RETTYPE
+ets_get_many(Process* p, DbTable* tb, Eterm keys, Eterm acc, Eterm what)
+{
+    Eterm key_vec[DB_GET_MANY_MAX_KEYS];
+    Eterm res_vec[DB_GET_MANY_MAX_KEYS];
+    SWord initial_reds = ERTS_BIF_REDS_LEFT(p);
+    SWord reds = initial_reds;
+    int is_first = (acc == NIL);
+    Uint count = 0;
+    Eterm* hp;
+    Uint i, n;
+    int cret;
+
+    do {
+        for (n = 0; n < DB_GET_MANY_MAX_KEYS && is_list(keys); n++) {
+            Eterm* cons = list_val(keys);
+            key_vec[n] = CAR(cons);
+            keys = CDR(cons);
+        }
+        if (is_not_list(keys) && is_not_nil(keys)) {
+            db_unlock(tb, LCK_READ);
+            BIF_ERROR(p, BADARG);
+        }
+        cret = tb->common.meth->db_get_many(p, tb, key_vec, n,
+                                            what == am_member, res_vec);
+        if (cret != DB_ERROR_NONE) {
+            db_unlock(tb, LCK_READ);
+            BIF_ERROR(p, cret == DB_ERROR_SYSRES ? SYSTEM_LIMIT : BADARG);
+        }
+        hp = HAlloc(p, 2*n);
+        for (i = 0; i < n; i++) {
+            acc = CONS(hp, res_vec[i], acc);
+            hp += 2;
+        }
+        count += n;
+        reds -= n;
+    } while (is_list(keys) && reds > 0);
+
+    if (is_list(keys)) {
+        Eterm cont;
+
+        hp = HAlloc(p, ERTS_MAGIC_REF_THING_SIZE + 5);
+        cont = erts_mk_magic_ref(&hp, &MSO(p), tb->common.btid);
+        cont = TUPLE4(hp, cont, what, keys, acc);
+        db_unlock(tb, LCK_READ);
+        BUMP_ALL_REDS(p);
+        BIF_TRAP1(&ets_get_many_continue_exp, p, cont);
+    }
+    db_unlock(tb, LCK_READ);
+    BUMP_REDS(p, initial_reds - reds);
+
+    if (!is_first) {
+        /* Too long to reverse here */
+        BIF_TRAP2(bif_export[BIF_lists_reverse_2], p, acc, NIL);
+    }
+    else {
+        Eterm ret = NIL;
+
+        hp = HAlloc(p, 2*count);
+        for (; is_list(acc); acc = CDR(list_val(acc))) {
+            ret = CONS(hp, CAR(list_val(acc)), ret);
+            hp += 2;
+        }
+        BIF_RET(ret);
+    }
+}
+
+/* Trap here from: ets_lookup_many_2 and ets_member_many_2 */
+static BIF_RETTYPE ets_get_many_trap_1(BIF_ALIST_1)
+{
+    Eterm* tptr = tuple_val(BIF_ARG_1);
+    DbTable* tb;
+
+    CHECK_TABLES();
+
+    ASSERT(arityval(*tptr) == 4);
+    DB_TRAP_GET_TABLE(tb, tptr[1], DB_READ, LCK_READ,
+                      &ets_get_many_continue_exp);
+
+    return ets_get_many(BIF_P, tb, tptr[3], tptr[4], tptr[2]);
+}
+
 /* 
 ** Get an element from a term
 ** get_element_3(Tab, Key, Index)
@@ -3433,6 +3679,10 @@ BIF_RETTYPE ets_info_2(BIF_ALIST_2)
             r = (Sint) ((r + sizeof(Sint) - 1) / sizeof(Sint));
             ret = erts_make_integer(r, BIF_P);
         }
+    } else if ((BIF_ARG_2 == am_stats
+                || BIF_ARG_2 == am_chain_length_histogram)
+               && IS_HASH_TABLE(tb->common.status)) {
+        return ets_info_hash_stats(BIF_P, tb, BIF_ARG_2, NULL);
     } else {
         ret = table_info(BIF_P, tb, BIF_ARG_2);
     }
@@ -3443,6 +3693,111 @@ BIF_RETTYPE ets_info_2(BIF_ALIST_2)
     BIF_RET(ret);
 }
 
+/*
+ * BIF to extract the same information item from many tables.
+ *
+ * Unlike ets:info/2, size and memory are read with
+ * erts_flxctr_read_approx() so tables with decentralized counters
+ * are neither snapshotted nor is the caller suspended waiting for
+ * thread progress. The tables are visited one at a time with only
+ * the table read lock held and the BIF traps when out of reductions.
+ */
+
+BIF_RETTYPE ets_info_many_2(BIF_ALIST_2)
+{
+    if (is_not_atom(BIF_ARG_2)
+        || BIF_ARG_2 == am_stats
+        || BIF_ARG_2 == am_chain_length_histogram) {
+        /* Items that need to traverse the tables */
+        BIF_ERROR(BIF_P, BADARG);
+    }
+    return ets_info_many(BIF_P, BIF_ARG_1, BIF_ARG_2, NIL);
+}
+
+static BIF_RETTYPE
+ets_info_many(Process* p, Eterm tabs, Eterm item, Eterm acc)
+{
+    SWord initial_reds = ERTS_BIF_REDS_LEFT(p);
+    SWord reds = initial_reds;
+    int is_first = (acc == NIL);
+    Uint count = 0;
+    Eterm* hp;
+
+    while (is_list(tabs)) {
+        Eterm* cons = list_val(tabs);
+        Eterm tab = CAR(cons);
+        Eterm res;
+        DbTable* tb;
+        Uint freason;
+
+        if (reds <= 0) {
+            Eterm cont;
+
+            hp = HAlloc(p, 4);
+            cont = TUPLE3(hp, tabs, item, acc);
+            BUMP_ALL_REDS(p);
+            BIF_TRAP1(&ets_info_many_continue_exp, p, cont);
+        }
+
+        tb = db_get_table(p, tab, DB_INFO, LCK_READ, &freason);
+        if (tb) {
+            res = table_info(p, tb, item);
+            db_unlock(tb, LCK_READ);
+            if (is_non_value(res)) {
+                BIF_ERROR(p, BADARG);
+            }
+        }
+        else if (freason == TRAP) {
+            /* The table is busy; continue with it after the trap */
+            Eterm cont;
+
+            hp = HAlloc(p, 4);
+            cont = TUPLE3(hp, tabs, item, acc);
+            BUMP_ALL_REDS(p);
+            BIF_TRAP1(&ets_info_many_continue_exp, p, cont);
+        }
+        else if (freason == BADARG && (is_atom(tab) || is_ref(tab))) {
+            res = am_undefined;
+        }
+        else {
+            BIF_ERROR(p, freason);
+        }
+
+        hp = HAlloc(p, 2);
+        acc = CONS(hp, res, acc);
+        count++;
+        reds--;
+        tabs = CDR(cons);
+    }
+    if (is_not_nil(tabs)) {
+        BIF_ERROR(p, BADARG);
+    }
+    BUMP_REDS(p, initial_reds - reds);
+
+    if (!is_first) {
+        /* Too long to reverse here */
+        BIF_TRAP2(bif_export[BIF_lists_reverse_2], p, acc, NIL);
+    }
+    else {
+        Eterm ret = NIL;
+
+        hp = HAlloc(p, 2*count);
+        for (; is_list(acc); acc = CDR(list_val(acc))) {
+            ret = CONS(hp, CAR(list_val(acc)), ret);
+            hp += 2;
+        }
+        BIF_RET(ret);
+    }
+}
+
+/* Trap here from: ets_info_many_2 */
+static BIF_RETTYPE ets_info_many_trap_1(BIF_ALIST_1)
+{
+    Eterm* tptr = tuple_val(BIF_ARG_1);
+
+    ASSERT(arityval(*tptr) == 3);
+    return ets_info_many(BIF_P, tptr[1], tptr[2], tptr[3]);
+}
 
 BIF_RETTYPE ets_is_compiled_ms_1(BIF_ALIST_1)
 {
@@ -3628,6 +3983,21 @@ void init_db(ErtsDbSpinCount db_spin_count)
     erts_init_trap_export(&ets_delete_continue_exp,
 			  am_ets, ERTS_MAKE_AM("delete_trap"), 1,
 			  &ets_delete_trap);
+
+    /* Non visual BIF to trap to. */
+    erts_init_trap_export(&ets_info_stats_continue_exp,
+			  am_ets, ERTS_MAKE_AM("info_stats_trap"), 1,
+			  &ets_info_stats_trap_1);
+
+    /* Non visual BIF to trap to. */
+    erts_init_trap_export(&ets_get_many_continue_exp,
+			  am_ets, ERTS_MAKE_AM("get_many_trap"), 1,
+			  &ets_get_many_trap_1);
+
+    /* Non visual BIF to trap to. */
+    erts_init_trap_export(&ets_info_many_continue_exp,
+			  am_ets, ERTS_MAKE_AM("info_many_trap"), 1,
+			  &ets_info_many_trap_1);
 }
 
 void
@@ -4253,6 +4623,79 @@ static Eterm table_info(Process* p, DbTable* tb, Eterm What)
 	ret = tb->common.compress ? am_true : am_false;
     } else if (What == am_id) {
         ret = make_tid(p, tb);
+    } else if (What == am_load_factor) {
+        if (IS_HASH_TABLE(tb->common.status)) {
+            Eterm* hp = HAlloc(p, FLOAT_SIZE_OBJECT);
+            FloatDef f;
+            f.fd = ((double) tb->hash.load_factor
+                    / DB_HASH_LOAD_FACTOR_DEFAULT);
+            ret = make_float(hp);
+            PUT_DOUBLE(f, hp);
+        }
+        else
+            ret = am_false;
+    } else if (What == am_read_mode) {
+        ret = tb->common.shared_literal ? am_shared_literal : am_copy;
+    } else if (What == am_incremental_resize) {
+        ret = (IS_HASH_TABLE(tb->common.status)
+               && tb->hash.incremental_resize) ? am_true : am_false;
+    } else if (What == am_contention_limits) {
+        if (IS_CATREE_TABLE(tb->common.status)) {
+            Eterm* hp = HAlloc(p, 3);
+            ret = TUPLE2(hp, make_small(tb->catree.join_limit),
+                         make_small(tb->catree.split_limit));
+        }
+        else
+            ret = am_false;
+    } else if (What == am_adaptation) {
+        if (IS_CATREE_TABLE(tb->common.status)) {
+            DbCATreeAdaptInfo info;
+            Eterm atoms[3];
+            UWord vals[3];
+            Uint sz = 0;
+            Uint* hp;
+
+            db_get_adapt_info_catree(&tb->catree, &info);
+            atoms[0] = am_splits;      vals[0] = info.splits;
+            atoms[1] = am_joins;       vals[1] = info.joins;
+            atoms[2] = am_lock_waits;  vals[2] = info.lock_waits;
+            erts_bld_atom_uword_2tup_list(NULL, &sz, 3, atoms, vals);
+            hp = HAlloc(p, sz);
+            ret = erts_bld_atom_uword_2tup_list(&hp, NULL, 3, atoms, vals);
+        }
+        else
+            ret = am_false;
+    } else if (What == am_resize) {
+        if (IS_HASH_TABLE(tb->common.status)) {
+            DbHashResizeInfo info;
+            Eterm atoms[6];
+            UWord vals[6];
+            Uint sz = 0;
+            Uint* hp;
+
+            db_get_resize_info_hash(&tb->hash, &info);
+            atoms[0] = am_buckets;         vals[0] = info.buckets;
+            atoms[1] = am_target_buckets;  vals[1] = info.target_buckets;
+            atoms[2] = am_slots;           vals[2] = info.slots;
+            atoms[3] = am_splits;          vals[3] = info.splits;
+            atoms[4] = am_joins;           vals[4] = info.joins;
+            atoms[5] = am_aux_jobs;        vals[5] = info.aux_jobs;
+            erts_bld_atom_uword_2tup_list(NULL, &sz, 6, atoms, vals);
+            hp = HAlloc(p, sz);
+            ret = erts_bld_atom_uword_2tup_list(&hp, NULL, 6, atoms, vals);
+        }
+        else
+            ret = am_false;
+    } else if (What == am_chain_length_histogram) {
+        if (IS_HASH_TABLE(tb->common.status)) {
+            DbHashStatsCtx ctx;
+
+            db_calc_stats_hash_init(&ctx);
+            db_calc_stats_hash_continue(&tb->hash, &ctx, NULL);
+            ret = hash_stats_info(p, tb, What, &ctx);
+        }
+        else
+            ret = am_false;
     }
 
     /*
@@ -4313,34 +4756,13 @@ static Eterm table_info(Process* p, DbTable* tb, Eterm What)
 	    ret = am_false;
 	}
 	erts_mtx_unlock(&tb->common.fixlock);
-    } else if (ERTS_IS_ATOM_STR("stats",What)) {
+    } else if (What == am_stats) {
 	if (IS_HASH_TABLE(tb->common.status)) {
-	    FloatDef f;
-	    DbHashStats stats;
-	    Eterm avg, std_dev_real, std_dev_exp;
-	    Eterm* hp;
-
-	    db_calc_stats_hash(&tb->hash, &stats);
-	    hp = HAlloc(p, 1 + 7 + FLOAT_SIZE_OBJECT*3);
-	    f.fd = stats.avg_chain_len;
-	    avg = make_float(hp);
-	    PUT_DOUBLE(f, hp);
-	    hp += FLOAT_SIZE_OBJECT;
-
-	    f.fd = stats.std_dev_chain_len;
-	    std_dev_real = make_float(hp);
-	    PUT_DOUBLE(f, hp);
-	    hp += FLOAT_SIZE_OBJECT;
-	    
-	    f.fd = stats.std_dev_expected;
-	    std_dev_exp = make_float(hp);
-	    PUT_DOUBLE(f, hp);
-	    hp += FLOAT_SIZE_OBJECT;
-	    ret = TUPLE7(hp, make_small(erts_atomic_read_nob(&tb->hash.nactive)),
-			 avg, std_dev_real, std_dev_exp,
-			 make_small(stats.min_chain_len),
-			 make_small(stats.max_chain_len),
-			 make_small(stats.kept_items));
+            DbHashStatsCtx ctx;
+
+            db_calc_stats_hash_init(&ctx);
+            db_calc_stats_hash_continue(&tb->hash, &ctx, NULL);
+            ret = hash_stats_info(p, tb, What, &ctx);
 	}
 	else if (IS_CATREE_TABLE(tb->common.status)) {
             DbCATreeStats stats;
@@ -4360,6 +4782,145 @@ static Eterm table_info(Process* p, DbTable* tb, Eterm What)
     return ret;
 }
 
+static Eterm hash_stats_info(Process* p, DbTable* tb, Eterm What,
+                             DbHashStatsCtx* ctx)
+{
+    Eterm ret;
+    Uint sz = 0;
+    Uint* hp;
+    int i;
+
+    if (What == am_chain_length_histogram) {
+        for (i = 0; i < DB_HASH_CHAIN_HIST_SIZE; i++)
+            erts_bld_cons(NULL, &sz, erts_bld_uword(NULL, &sz, ctx->hist[i]),
+                          NIL);
+        hp = HAlloc(p, sz);
+        ret = NIL;
+        for (i = DB_HASH_CHAIN_HIST_SIZE - 1; i >= 0; i--)
+            ret = erts_bld_cons(&hp, NULL,
+                                erts_bld_uword(&hp, NULL, ctx->hist[i]), ret);
+    }
+    else {
+        FloatDef f;
+        DbHashStats stats;
+        Uint contention[DB_HASH_LOCK_CNT];
+        int nlocks;
+        Eterm avg, std_dev_real, std_dev_exp, bytes_per_obj, locks;
+
+        ASSERT(What == am_stats);
+        db_calc_stats_hash_result(ctx, &stats);
+        nlocks = db_lock_contention_hash(&tb->hash, contention);
+        for (i = 0; i < nlocks; i++)
+            erts_bld_cons(NULL, &sz, erts_bld_uword(NULL, &sz, contention[i]),
+                          NIL);
+        hp = HAlloc(p, sz + 1 + 9 + FLOAT_SIZE_OBJECT*4);
+        locks = NIL;
+        for (i = nlocks - 1; i >= 0; i--)
+            locks = erts_bld_cons(&hp, NULL,
+                                  erts_bld_uword(&hp, NULL, contention[i]),
+                                  locks);
+
+        f.fd = stats.avg_chain_len;
+        avg = make_float(hp);
+        PUT_DOUBLE(f, hp);
+        hp += FLOAT_SIZE_OBJECT;
+
+        f.fd = stats.std_dev_chain_len;
+        std_dev_real = make_float(hp);
+        PUT_DOUBLE(f, hp);
+        hp += FLOAT_SIZE_OBJECT;
+
+        f.fd = stats.std_dev_expected;
+        std_dev_exp = make_float(hp);
+        PUT_DOUBLE(f, hp);
+        hp += FLOAT_SIZE_OBJECT;
+
+        f.fd = stats.bytes_per_object;
+        bytes_per_obj = make_float(hp);
+        PUT_DOUBLE(f, hp);
+        hp += FLOAT_SIZE_OBJECT;
+
+        ret = erts_bld_tuple(&hp, NULL, 9,
+                             make_small(erts_atomic_read_nob(&tb->hash.nactive)),
+                             avg, std_dev_real, std_dev_exp,
+                             make_small(stats.min_chain_len),
+                             make_small(stats.max_chain_len),
+                             make_small(stats.kept_items),
+                             bytes_per_obj, locks);
+    }
+    return ret;
+}
+
+static int
+hash_stats_ctx_destructor(Binary *unused)
+{
+    return 1;
+}
+
+/*
+ * ets:info/2 items that walk all buckets of a hash table. Called with
+ * the table read locked, yields to ets_info_stats_trap_1 when out of
+ * reductions.
+ */
+static BIF_RETTYPE
+ets_info_hash_stats(Process* p, DbTable* tb, Eterm What, Binary* ctx_bin)
+{
+    DbHashStatsCtx local_ctx;
+    DbHashStatsCtx* ctx;
+    SWord initial_reds = ERTS_BIF_REDS_LEFT(p);
+    SWord reds = initial_reds;
+    Eterm ret;
+
+    if (ctx_bin)
+        ctx = ERTS_MAGIC_BIN_DATA(ctx_bin);
+    else {
+        ctx = &local_ctx;
+        db_calc_stats_hash_init(ctx);
+    }
+
+    if (!db_calc_stats_hash_continue(&tb->hash, ctx, &reds)) {
+        Eterm* hp;
+        Eterm tid, ctx_ref, cont;
+
+        if (!ctx_bin) {
+            ctx_bin = erts_create_magic_binary(sizeof(DbHashStatsCtx),
+                                               hash_stats_ctx_destructor);
+            sys_memcpy(ERTS_MAGIC_BIN_DATA(ctx_bin), ctx,
+                       sizeof(DbHashStatsCtx));
+        }
+        hp = HAlloc(p, 2*ERTS_MAGIC_REF_THING_SIZE + 4);
+        tid = erts_mk_magic_ref(&hp, &MSO(p), tb->common.btid);
+        ctx_ref = erts_mk_magic_ref(&hp, &MSO(p), ctx_bin);
+        cont = TUPLE3(hp, tid, What, ctx_ref);
+        db_unlock(tb, LCK_READ);
+        BUMP_ALL_REDS(p);
+        BIF_TRAP1(&ets_info_stats_continue_exp, p, cont);
+    }
+    ret = hash_stats_info(p, tb, What, ctx);
+    db_unlock(tb, LCK_READ);
+    BUMP_REDS(p, initial_reds - reds);
+    BIF_RET(ret);
+}
+
+/* Trap here from: ets_info_2 */
+static BIF_RETTYPE ets_info_stats_trap_1(BIF_ALIST_1)
+{
+    Eterm* tptr = tuple_val(BIF_ARG_1);
+    DbTable* tb;
+    Uint freason;
+
+    ASSERT(arityval(*tptr) == 3);
+    tb = db_get_table(BIF_P, tptr[1], DB_INFO, LCK_READ, &freason);
+    if (!tb) {
+        if (freason == BADARG)
+            BIF_RET(am_undefined);
+        return db_bif_fail(BIF_P, freason, 0, &ets_info_stats_continue_exp);
+    }
+    ASSERT(IS_HASH_TABLE(tb->common.status));
+    return ets_info_hash_stats(BIF_P, tb, tptr[2],
+                               erts_magic_ref2bin(tptr[3]));
+}
+
 static void print_table(fmtfn_t to, void *to_arg, int show,  DbTable* tb)
 {
     Eterm tid;
@@ -4515,9 +5076,12 @@ void erts_lcnt_enable_db_lock_count(DbTable *tb, int enable) {
             tb->common.the_name, ERTS_LOCK_TYPE_RWMUTEX | ERTS_LOCK_FLAGS_CATEGORY_DB);
         erts_lcnt_install_new_lock_info(&tb->common.fixlock.lcnt, "db_tab_fix",
             tb->common.the_name, ERTS_LOCK_TYPE_MUTEX | ERTS_LOCK_FLAGS_CATEGORY_DB);
+        erts_lcnt_install_new_lock_info(&tb->common.literal_mtx.lcnt, "db_tab_literal",
+            tb->common.the_name, ERTS_LOCK_TYPE_MUTEX | ERTS_LOCK_FLAGS_CATEGORY_DB);
     } else {
         erts_lcnt_uninstall(&tb->common.rwlock.lcnt);
         erts_lcnt_uninstall(&tb->common.fixlock.lcnt);
+        erts_lcnt_uninstall(&tb->common.literal_mtx.lcnt);
     }
 
     if(IS_HASH_TABLE(tb->common.status)) {
@@ -134,6 +134,7 @@ int erts_ets_force_split(Eterm tid, int on);
 int erts_ets_debug_random_split_join(Eterm tid, int on);
 Uint erts_db_get_max_tabs(void);
 Eterm erts_db_make_tid(Process *c_p, DbTableCommon *tb);
+void erts_db_schedule_resize(DbTable *tb);
 
 #ifdef ERTS_ENABLE_LOCK_COUNT
 void erts_lcnt_enable_db_lock_count(DbTable *tb, int enable);
@@ -108,6 +108,8 @@ static int db_put_catree(DbTable *tbl, Eterm obj, int key_clash_fail);
 static int db_get_catree(Process *p, DbTable *tbl,
                          Eterm key,  Eterm *ret);
 static int db_member_catree(DbTable *tbl, Eterm key, Eterm *ret);
+static int db_get_many_catree(Process *p, DbTable *tbl, Eterm *keys,
+                              Uint nkeys, int member, Eterm *ret);
 static int db_get_element_catree(Process *p, DbTable *tbl,
                                  Eterm key,int ndex,
                                  Eterm *ret);
@@ -191,6 +193,7 @@ DbTableMethod db_catree =
     db_get_catree,
     db_get_element_catree,
     db_member_catree,
+    db_get_many_catree,
     db_erase_catree,
     db_erase_object_catree,
     db_slot_catree,
@@ -224,11 +227,9 @@ DbTableMethod db_catree =
 #define ERL_DB_CATREE_LOCK_GRAVITY_CONTRIBUTION (-500)
 #define ERL_DB_CATREE_LOCK_GRAVITY_PATTERN (0xFF800000)
 #define ERL_DB_CATREE_LOCK_MORE_THAN_ONE_CONTRIBUTION (-10)
-#define ERL_DB_CATREE_HIGH_CONTENTION_LIMIT 1000
-#define ERL_DB_CATREE_LOW_CONTENTION_LIMIT (-1000)
 #define ERL_DB_CATREE_MAX_ROUTE_NODE_LAYER_HEIGHT 16
-#define ERL_DB_CATREE_LOCK_LOW_NO_CONTRIBUTION_LIMIT (-20000)
-#define ERL_DB_CATREE_LOCK_HIGH_NO_CONTRIBUTION_LIMIT (20000)
+#define ERL_DB_CATREE_LOCK_LOW_NO_CONTRIBUTION_LIMIT (-DB_CATREE_CONTENTION_LIMIT_MAX)
+#define ERL_DB_CATREE_LOCK_HIGH_NO_CONTRIBUTION_LIMIT DB_CATREE_CONTENTION_LIMIT_MAX
 
 /*
  * Internal CA tree related helper functions and macros
@@ -687,10 +688,10 @@ static void dbg_provoke_random_splitjoin(DbTableCATree* tb,
 
     switch (dbg_fastrand() % 8) {
     case 1:
-        BASE_NODE_STAT_ADD(base_node, 1+ERL_DB_CATREE_HIGH_CONTENTION_LIMIT);
+        BASE_NODE_STAT_ADD(base_node, 1+tb->split_limit);
         break;
     case 2:
-        BASE_NODE_STAT_SUB(base_node, -1+ERL_DB_CATREE_LOW_CONTENTION_LIMIT);
+        BASE_NODE_STAT_SUB(base_node, -1+tb->join_limit);
         break;
     }
 }
@@ -716,8 +717,7 @@ void do_random_join(DbTableCATree* tb, Uint rand)
     }
     BASE_NODE_STAT_SUB(node, ERL_DB_CATREE_LOCK_GRAVITY_CONTRIBUTION);
     stat = BASE_NODE_STAT_READ(node);
-    if (stat >= ERL_DB_CATREE_LOW_CONTENTION_LIMIT &&
-        stat <= ERL_DB_CATREE_HIGH_CONTENTION_LIMIT) {
+    if (stat >= tb->join_limit && stat <= tb->split_limit) {
         return; /* No adaptation */
     }
     if (parent != NULL && !try_wlock_base_node(&node->u.base)) {
@@ -761,13 +761,14 @@ void wlock_base_node_no_stats(DbTableCATreeNode *base_node)
  * the lock was contended or not
  */
 static ERTS_INLINE
-void wlock_base_node(DbTableCATreeNode *base_node)
+void wlock_base_node(DbTableCATree *tb, DbTableCATreeNode *base_node)
 {
     ASSERT(base_node->is_base_node);
     if (try_wlock_base_node(&base_node->u.base)) {
         /* The lock is contended */
         wlock_base_node_no_stats(base_node);
         BASE_NODE_STAT_ADD(base_node, ERL_DB_CATREE_LOCK_FAILURE_CONTRIBUTION);
+        erts_atomic_inc_nob(&tb->nr_of_lock_waits);
     } else {
         BASE_NODE_STAT_SUB(base_node, ERL_DB_CATREE_LOCK_SUCCESS_CONTRIBUTION);
     }
@@ -789,10 +790,10 @@ void wunlock_adapt_base_node(DbTableCATree* tb,
     dbg_provoke_random_splitjoin(tb,node);
     if ((!node->u.base.root && parent && !(tb->common.status
                                            & DB_CATREE_FORCE_SPLIT))
-        || base_node_lock_stat < ERL_DB_CATREE_LOW_CONTENTION_LIMIT) {
+        || base_node_lock_stat < tb->join_limit) {
         join_catree(tb, node, parent);
     }
-    else if (base_node_lock_stat > ERL_DB_CATREE_HIGH_CONTENTION_LIMIT
+    else if (base_node_lock_stat > tb->split_limit
         && current_level < ERL_DB_CATREE_MAX_ROUTE_NODE_LAYER_HEIGHT) {
         split_catree(tb, node, parent);
     }
@@ -802,12 +803,13 @@ void wunlock_adapt_base_node(DbTableCATree* tb,
 }
 
 static ERTS_INLINE
-void rlock_base_node(DbTableCATreeNode *base_node)
+void rlock_base_node(DbTableCATree *tb, DbTableCATreeNode *base_node)
 {
     ASSERT(base_node->is_base_node);
     if (EBUSY == erts_rwmtx_tryrlock(&base_node->u.base.lock)) {
         /* The lock is contended */
         BASE_NODE_STAT_ADD(base_node, ERL_DB_CATREE_LOCK_FAILURE_CONTRIBUTION);
+        erts_atomic_inc_nob(&tb->nr_of_lock_waits);
         erts_rwmtx_rlock(&base_node->u.base.lock);
     }
 }
@@ -889,9 +891,9 @@ void lock_iter_base_node(CATreeRootIterator* iter,
 {
     ASSERT(!iter->locked_bnode);
     if (iter->read_only)
-        rlock_base_node(base_node);
+        rlock_base_node(iter->tb, base_node);
     else {
-        wlock_base_node(base_node);
+        wlock_base_node(iter->tb, base_node);
         iter->bnode_parent = parent;
         iter->bnode_level = current_level;
     }
@@ -960,7 +962,7 @@ DbTableCATreeNode* find_rlock_valid_base_node(DbTableCATree* tb, Eterm key)
 
     while (1) {
         base_node = find_base_node(tb, key, NULL);
-        rlock_base_node(base_node);
+        rlock_base_node(tb, base_node);
         if (base_node->u.base.is_valid)
             break;
         runlock_base_node_no_rand(base_node);
@@ -976,7 +978,7 @@ DbTableCATreeNode* find_wlock_valid_base_node(DbTableCATree* tb, Eterm key,
 
     while (1) {
         base_node = find_base_node(tb, key, fbn);
-        wlock_base_node(base_node);
+        wlock_base_node(tb, base_node);
         if (base_node->u.base.is_valid)
             break;
         wunlock_base_node(base_node);
@@ -1291,6 +1293,11 @@ static void join_catree(DbTableCATree *tb,
             }
         }
     }
+    /* Start half way to the join limit, so that the joined node does not
+     * split again on the first signs of contention */
+    if (!(tb->common.status & DB_CATREE_FORCE_SPLIT))
+        BASE_NODE_STAT_SET(new_neighbor, tb->join_limit / 2);
+    erts_atomic_inc_nob(&tb->nr_of_joins);
     /* Link in new neighbor and free nodes that are no longer in the tree */
     if (neighbor_parent == NULL) {
         SET_ROOT_RELB(tb, new_neighbor);
@@ -1342,6 +1349,13 @@ static void split_catree(DbTableCATree *tb,
 
         new_left = create_base_node(tb, left_tree);
         new_right = create_base_node(tb, right_tree);
+        /* Start half way to the split limit, so that the halves are not
+         * joined again as soon as contention drops */
+        if (!(tb->common.status & DB_CATREE_FORCE_SPLIT)) {
+            BASE_NODE_STAT_SET(new_left, tb->split_limit / 2);
+            BASE_NODE_STAT_SET(new_right, tb->split_limit / 2);
+        }
+        erts_atomic_inc_nob(&tb->nr_of_splits);
         new_route = create_route_node(tb,
                                       new_left,
                                       new_right,
@@ -1496,6 +1510,11 @@ int db_create_catree(Process *p, DbTable *tbl)
     tb->deletion = 0;
     tb->base_nodes_to_free_list = NULL;
     tb->nr_of_deleted_items = 0;
+    tb->join_limit = DB_CATREE_JOIN_LIMIT_DEFAULT;
+    tb->split_limit = DB_CATREE_SPLIT_LIMIT_DEFAULT;
+    erts_atomic_init_nob(&tb->nr_of_splits, 0);
+    erts_atomic_init_nob(&tb->nr_of_joins, 0);
+    erts_atomic_init_nob(&tb->nr_of_lock_waits, 0);
 #ifdef DEBUG
     tbl->common.status |= DB_CATREE_DEBUG_RANDOM_SPLIT_JOIN;
 #endif
@@ -1897,6 +1916,61 @@ static int db_member_catree(DbTable *tbl, Eterm key, Eterm *ret)
     return result;
 }
 
+typedef struct {
+    Eterm key;
+    Uint ix;                    /* index in 'keys' */
+} DbCATreeGetManyKey;
+
+static int get_many_cmp_key(const void *a, const void *b)
+{
+    Sint res = CMP(((DbCATreeGetManyKey*)a)->key,
+                   ((DbCATreeGetManyKey*)b)->key);
+    return res < 0 ? -1 : (res > 0 ? 1 : 0);
+}
+
+/*
+ * Keys are sorted so that keys routed to the same base node are looked
+ * up with one acquisition of its lock.
+ */
+static int db_get_many_catree(Process *p, DbTable *tbl, Eterm *keys,
+                              Uint nkeys, int member, Eterm *ret)
+{
+    DbTableCATree *tb = &tbl->catree;
+    DbCATreeGetManyKey mk[DB_GET_MANY_MAX_KEYS];
+    Eterm sorted_keys[DB_GET_MANY_MAX_KEYS];
+    Eterm sorted_ret[DB_GET_MANY_MAX_KEYS];
+    Uint i, end;
+
+    ASSERT(nkeys <= DB_GET_MANY_MAX_KEYS);
+    for (i = 0; i < nkeys; i++) {
+        mk[i].key = keys[i];
+        mk[i].ix = i;
+    }
+    if (nkeys > 1)
+        qsort(mk, nkeys, sizeof(DbCATreeGetManyKey), get_many_cmp_key);
+    for (i = 0; i < nkeys; i++)
+        sorted_keys[i] = mk[i].key;
+
+    i = 0;
+    while (i < nkeys) {
+        DbTableCATreeNode* node = find_rlock_valid_base_node(tb,
+                                                             sorted_keys[i]);
+        /* A read locked base node can neither be split nor joined */
+        end = i + 1;
+        while (end < nkeys
+               && find_base_node(tb, sorted_keys[end], NULL) == node)
+            end++;
+        db_get_many_tree_common(p, &tb->common, node->u.base.root,
+                                &sorted_keys[i], end - i, member,
+                                &sorted_ret[i], NULL);
+        runlock_base_node(node, tb);
+        i = end;
+    }
+    for (i = 0; i < nkeys; i++)
+        ret[mk[i].ix] = sorted_ret[i];
+    return DB_ERROR_NONE;
+}
+
 static int db_get_element_catree(Process *p, DbTable *tbl,
 			       Eterm key, int ndex, Eterm *ret)
 {
@@ -2358,6 +2432,22 @@ void db_catree_debug_random_split_join(DbTableCATree* tb, int on)
         tb->common.status &= ~DB_CATREE_DEBUG_RANDOM_SPLIT_JOIN;
 }
 
+void db_set_contention_limits_catree(DbTableCATree* tb, Sint join_limit,
+                                     Sint split_limit)
+{
+    ASSERT(join_limit < 0 && join_limit > -DB_CATREE_CONTENTION_LIMIT_MAX);
+    ASSERT(split_limit > 0 && split_limit < DB_CATREE_CONTENTION_LIMIT_MAX);
+    tb->join_limit = join_limit;
+    tb->split_limit = split_limit;
+}
+
+void db_get_adapt_info_catree(DbTableCATree* tb, DbCATreeAdaptInfo* info)
+{
+    info->splits = erts_atomic_read_nob(&tb->nr_of_splits);
+    info->joins = erts_atomic_read_nob(&tb->nr_of_joins);
+    info->lock_waits = erts_atomic_read_nob(&tb->nr_of_lock_waits);
+}
+
 void db_calc_stats_catree(DbTableCATree* tb, DbCATreeStats* stats)
 {
     DbTableCATreeNode* stack[ERL_DB_CATREE_MAX_ROUTE_NODE_LAYER_HEIGHT];
@@ -91,6 +91,16 @@ typedef struct db_table_catree {
        select_delete(DeleteAll)*/
     Uint nr_of_deleted_items;
     Binary* nr_of_deleted_items_wb;
+
+    /* Base nodes are joined when their lock statistics drop below
+     * join_limit and split above split_limit. New nodes start half way
+     * to the limit they were not created by, see split_catree() and
+     * join_catree(). */
+    Sint join_limit;
+    Sint split_limit;
+    erts_atomic_t nr_of_splits;
+    erts_atomic_t nr_of_joins;
+    erts_atomic_t nr_of_lock_waits; /* contended base node lock attempts */
 } DbTableCATree;
 
 typedef struct {
@@ -104,6 +114,11 @@ typedef struct {
 } CATreeRootIterator;
 
 
+/* Limits of the base node lock statistics */
+#define DB_CATREE_JOIN_LIMIT_DEFAULT  (-1000)
+#define DB_CATREE_SPLIT_LIMIT_DEFAULT 1000
+#define DB_CATREE_CONTENTION_LIMIT_MAX 20000
+
 void db_initialize_catree(void);
 
 int db_create_catree(Process *p, DbTable *tbl);
@@ -133,5 +148,15 @@ typedef struct {
 } DbCATreeStats;
 void db_calc_stats_catree(DbTableCATree*, DbCATreeStats*);
 
+typedef struct {
+    Uint splits;
+    Uint joins;
+    Uint lock_waits;
+} DbCATreeAdaptInfo;
+
+void db_set_contention_limits_catree(DbTableCATree*, Sint join_limit,
+                                     Sint split_limit);
+void db_get_adapt_info_catree(DbTableCATree*, DbCATreeAdaptInfo*);
+
 
 #endif /* _DB_CATREE_H */
@@ -96,8 +96,17 @@
 /* 
  * The following symbols can be manipulated to "tune" the linear hash array 
  */
-#define GROW_LIMIT(NACTIVE) ((NACTIVE)*1)
-#define SHRINK_LIMIT(NACTIVE) ((NACTIVE) / 2)
+#define GROW_LIMIT(TB,NACTIVE)                                          \
+    ((Sint)(((Sint64)(NACTIVE) * (TB)->load_factor)                     \
+            >> DB_HASH_LOAD_FACTOR_SHIFT))
+#define SHRINK_LIMIT(TB,NACTIVE) (GROW_LIMIT(TB,NACTIVE) / 2)
+
+/* Cost of the chain walk done by ets:info(T, stats) */
+#define STATS_BUCKETS_PER_REDUCTION 8
+#define STATS_OBJECTS_PER_BUCKET 4
+
+/* Number of grow()/shrink() calls done by one resize aux work job */
+#define RESIZE_AUX_WORK_CALLS 20
 
 /*
 ** We want the first mandatory segment to be small (to reduce minimal footprint)
@@ -224,19 +233,36 @@ static ERTS_INLINE int is_pseudo_deleted(HashDbTerm* p)
       make_internal_hash(term, 0)) & MAX_HASH_MASK)
 
 #  define DB_HASH_LOCK_MASK (DB_HASH_LOCK_CNT-1)
-#  define GET_LOCK(tb,hval) (&(tb)->locks->lck_vec[(hval) & DB_HASH_LOCK_MASK].lck)
+#  define GET_LOCK_SLOT(tb,hval) (&(tb)->locks->lck_vec[(hval) & DB_HASH_LOCK_MASK].lck_slot)
+#  define GET_LOCK(tb,hval) (&GET_LOCK_SLOT(tb,hval)->lck)
 #  define GET_LOCK_MAYBE(tb,hval) ((tb)->common.is_thread_safe ? NULL : GET_LOCK(tb,hval))
 
+#define DB_USING_LOCKFREE_READ(TB) \
+    ((TB)->lockfree_read && !(TB)->common.is_thread_safe)
+
+/* Objects are replaced rather than updated in place when lock-free
+ * readers may be copying them or when lookups may have returned them
+ * as shared literals */
+#define DB_COPY_ON_UPDATE(TB) \
+    (DB_USING_LOCKFREE_READ(TB) || (TB)->common.shared_literal)
+
+/* Heap needed to return an object in a lookup result list */
+#define LOOKUP_HEAP_SIZE(TB, P) \
+    (((TB)->common.shared_literal ? 0 : (P)->dbterm.size) + 2)
+
 /* Fine grained read lock */
 static ERTS_INLINE erts_rwmtx_t* RLOCK_HASH(DbTableHash* tb, HashValue hval)
 {
     if (tb->common.is_thread_safe) {
 	return NULL;
     } else {
-	erts_rwmtx_t* lck = GET_LOCK(tb,hval);
+	DbTableHashFineLockSlot* slot = GET_LOCK_SLOT(tb,hval);
 	ASSERT(tb->common.type & DB_FINE_LOCKED);
-	erts_rwmtx_rlock(lck);
-	return lck;
+	if (erts_rwmtx_tryrlock(&slot->lck) == EBUSY) {
+	    erts_atomic_inc_nob(&slot->contended);
+	    erts_rwmtx_rlock(&slot->lck);
+	}
+	return &slot->lck;
     }
 }
 /* Fine grained write lock */
@@ -245,10 +271,16 @@ static ERTS_INLINE erts_rwmtx_t* WLOCK_HASH(DbTableHash* tb, HashValue hval)
     if (tb->common.is_thread_safe) {
 	return NULL;
     } else {
-	erts_rwmtx_t* lck = GET_LOCK(tb,hval);
+	DbTableHashFineLockSlot* slot = GET_LOCK_SLOT(tb,hval);
 	ASSERT(tb->common.type & DB_FINE_LOCKED);
-	erts_rwmtx_rwlock(lck);
-	return lck;
+	if (erts_rwmtx_tryrwlock(&slot->lck) == EBUSY) {
+	    erts_atomic_inc_nob(&slot->contended);
+	    erts_rwmtx_rwlock(&slot->lck);
+	}
+	/* Make lock-free readers of these buckets back off (seq odd) */
+	erts_atomic_set_nob(&slot->seq, erts_atomic_read_nob(&slot->seq) + 1);
+	ERTS_THR_WRITE_MEMORY_BARRIER;
+	return &slot->lck;
     }
 }
 
@@ -262,6 +294,9 @@ static ERTS_INLINE void RUNLOCK_HASH(erts_rwmtx_t* lck)
 static ERTS_INLINE void WUNLOCK_HASH(erts_rwmtx_t* lck)
 {
     if (lck != NULL) {
+	DbTableHashFineLockSlot* slot =
+	    ErtsContainerStruct(lck, DbTableHashFineLockSlot, lck);
+	erts_atomic_set_relb(&slot->seq, erts_atomic_read_nob(&slot->seq) + 1);
 	erts_rwmtx_rwunlock(lck);
     }
 }
@@ -307,13 +342,76 @@ static ERTS_INLINE Sint next_slot_w(DbTableHash* tb, Uint ix,
 
 
 
+/* Objects unlinked while lock-free readers may still be traversing them
+ * are kept alive until thread progress has been made.
+ */
+struct later_free_terms {
+    ErtsThrPrgrLaterOp lop;
+    HashDbTerm* list;
+};
+
+static ERTS_INLINE Uint sizeof_hash_dbterm(HashDbTerm* p)
+{
+    return (offsetof(HashDbTerm, dbterm) + offsetof(DbTerm, tpl)
+            + p->dbterm.size * sizeof(Eterm));
+}
+
+static void do_free_term_list(void* vlater)
+{
+    struct later_free_terms* later = (struct later_free_terms*) vlater;
+    HashDbTerm* p = later->list;
+
+    while (p) {
+        HashDbTerm* next = p->next;
+        ErlOffHeap tmp_oh;
+        tmp_oh.first = p->dbterm.first_oh;
+        erts_cleanup_offheap(&tmp_oh);
+        erts_free(ERTS_ALC_T_DB_TERM, p);
+        p = next;
+    }
+    erts_free(ERTS_ALC_T_DB_TERM_LATER, later);
+}
+
+/* Schedule deallocation of a NULL terminated list of objects */
+static void schedule_free_term_list(DbTableHash *tb, HashDbTerm* list)
+{
+    struct later_free_terms* later;
+    HashDbTerm* p;
+    Uint size = 0;
+
+    ASSERT(!tb->common.compress);
+    for (p = list; p; p = p->next) {
+        Uint sz = sizeof_hash_dbterm(p);
+        ASSERT(sz == ERTS_ALC_DBG_BLK_SZ(p));
+        size += sz;
+    }
+    /* Table may be gone when the objects are finally freed */
+    ERTS_DB_ALC_MEM_UPDATE_((DbTable*)tb, size, 0);
+
+    later = erts_alloc(ERTS_ALC_T_DB_TERM_LATER,
+                       sizeof(struct later_free_terms));
+    later->list = list;
+    erts_schedule_thr_prgr_later_cleanup_op(do_free_term_list, later,
+                                            &later->lop, size);
+}
+
 static ERTS_INLINE void free_term(DbTableHash *tb, HashDbTerm* p)
 {
-    db_free_term((DbTable*)tb, p, offsetof(HashDbTerm, dbterm));
+    if (DB_USING_LOCKFREE_READ(tb)) {
+        p->next = NULL;
+        schedule_free_term_list(tb, p);
+    }
+    else
+        db_free_term((DbTable*)tb, p, offsetof(HashDbTerm, dbterm));
 }
 
 static ERTS_INLINE void free_term_list(DbTableHash *tb, HashDbTerm* p)
 {
+    if (DB_USING_LOCKFREE_READ(tb)) {
+        if (p)
+            schedule_free_term_list(tb, p);
+        return;
+    }
     while (p) {
         HashDbTerm* next = p->next;
         free_term(tb, p);
@@ -343,6 +441,7 @@ struct mp_info {
 
 /* A table segment */
 struct segment {
+    ErtsThrPrgrLaterOp lop;  /* Used when freed under lock-free readers */
     HashDbTerm* buckets[1];
 };
 #define SIZEOF_SEGMENT(N) \
@@ -386,6 +485,8 @@ static void shrink(DbTableHash* tb, int nitems);
 static void grow(DbTableHash* tb, int nitems);
 static Eterm build_term_list(Process* p, HashDbTerm* ptr1, HashDbTerm* ptr2,
 			   Uint sz, DbTableHash*);
+static Eterm copy_term_list(Process* p, HashDbTerm* ptr1, HashDbTerm* ptr2,
+                            Eterm** hpp, DbTableHash*);
 static int analyze_pattern(DbTableHash *tb, Eterm pattern,
                            extra_match_validator_t extra_validator, /* Optional callback */
                            struct mp_info *mpi);
@@ -404,6 +505,9 @@ static int db_next_hash(Process *p,
 
 static int db_member_hash(DbTable *tbl, Eterm key, Eterm *ret);
 
+static int db_get_many_hash(Process *p, DbTable *tbl, Eterm *keys,
+                            Uint nkeys, int member, Eterm *ret);
+
 static int db_get_element_hash(Process *p, DbTable *tbl, 
 			       Eterm key, int ndex, Eterm *ret);
 
@@ -469,15 +573,52 @@ db_lookup_dbterm_hash(Process *p, DbTable *tbl, Eterm key, Eterm obj,
 static void
 db_finalize_dbterm_hash(int cret, DbUpdateHandle* handle);
 
+static ERTS_INLINE int need_grow(DbTableHash* tb, int nitems, int nactive)
+{
+    return nitems > GROW_LIMIT(tb, nactive);
+}
+
+static ERTS_INLINE int need_shrink(DbTableHash* tb, int nitems, int nactive)
+{
+    return nactive > FIRST_SEGSZ && nitems < SHRINK_LIMIT(tb, nactive);
+}
+
+/* Let the current scheduler resize the table as aux work.
+** Returns 0 if not possible from this thread.
+*/
+static int schedule_resize(DbTableHash* tb)
+{
+    if (erts_atomic32_read_nob(&tb->resize_scheduled))
+        return 1;
+    if (!erts_get_scheduler_id())
+        return 0;
+    if (!erts_atomic32_xchg_mb(&tb->resize_scheduled, 1))
+        erts_db_schedule_resize((DbTable*)tb);
+    return 1;
+}
+
+static ERTS_INLINE void try_grow(DbTableHash* tb, int nitems)
+{
+    int nactive = NACTIVE(tb);
+    if (need_grow(tb, nitems, nactive) && !IS_FIXED(tb)) {
+        /* Help out if the aux work has fallen far behind */
+        if (!tb->incremental_resize
+            || !schedule_resize(tb)
+            || nitems > 2*GROW_LIMIT(tb, nactive)) {
+            grow(tb, nitems);
+        }
+    }
+}
+
 static ERTS_INLINE void try_shrink(DbTableHash* tb)
 {
     int nactive = NACTIVE(tb);
     int nitems = NITEMS(tb);
-    if (nactive > FIRST_SEGSZ && nitems < SHRINK_LIMIT(nactive)
-	&& !IS_FIXED(tb)) {
-	shrink(tb, nitems);
+    if (need_shrink(tb, nitems, nactive) && !IS_FIXED(tb)) {
+        if (!tb->incremental_resize || !schedule_resize(tb))
+            shrink(tb, nitems);
     }
-}	
+}
 
 /* Is this a live object (not pseodo-deleted) with the specified key? 
 */
@@ -507,6 +648,17 @@ static ERTS_INLINE int has_key(DbTableHash* tb, HashDbTerm* b,
     }
 }
 
+/* Link a new object into a bucket. With lock-free readers its fields
+ * must be visible before the object itself.
+ */
+static ERTS_INLINE void link_dbterm(DbTableHash* tb, HashDbTerm** bp,
+                                    HashDbTerm* p)
+{
+    if (tb->lockfree_read)
+        ERTS_THR_WRITE_MEMORY_BARRIER;
+    *bp = p;
+}
+
 static ERTS_INLINE HashDbTerm* new_dbterm(DbTableHash* tb, Eterm obj)
 {
     HashDbTerm* p;
@@ -524,7 +676,15 @@ static ERTS_INLINE HashDbTerm* replace_dbterm(DbTableHash* tb, HashDbTerm* old,
 {
     HashDbTerm* ret;
     ASSERT(old != NULL);
-    if (tb->common.compress) {
+    if (DB_COPY_ON_UPDATE(tb)) {
+        /* Never overwrite an object that readers may be using */
+        ret = new_dbterm(tb, obj);
+        ret->hvalue = old->hvalue;
+        ret->pseudo_deleted = old->pseudo_deleted;
+        ret->next = old->next;
+        free_term(tb, old);
+    }
+    else if (tb->common.compress) {
 	ret = db_store_term_comp(&tb->common, &(old->dbterm), offsetof(HashDbTerm,dbterm), obj);
     }
     else {
@@ -533,6 +693,40 @@ static ERTS_INLINE HashDbTerm* replace_dbterm(DbTableHash* tb, HashDbTerm* old,
     return ret;
 }
 
+/* Move the objects still in a sparsely used literal chunk to the open
+ * chunk, so that the sparse one can be released, see
+ * db_take_sparse_literal_chunk(). */
+static void compact_literal_chunk(DbTableHash* tb)
+{
+    DbLiteralChunk* chunk = db_take_sparse_literal_chunk((DbTable*)tb);
+    Eterm* pos = NULL;
+    HashDbTerm* b;
+
+    if (!chunk)
+        return;
+    while ((b = db_next_literal_object(chunk, &pos)) != NULL) {
+        /* A freed object is still readable but no longer in a bucket */
+        HashValue hval = b->hvalue;
+        erts_rwmtx_t* lck = WLOCK_HASH(tb, hval);
+        HashDbTerm** bp = &BUCKET(tb, hash_to_ix(tb, hval));
+
+        while (*bp && *bp != b)
+            bp = &(*bp)->next;
+        if (*bp) {
+            HashDbTerm* q = replace_dbterm(tb, b, make_tuple(b->dbterm.tpl));
+            link_dbterm(tb, bp, q);
+        }
+        WUNLOCK_HASH(lck);
+    }
+    db_done_sparse_literal_chunk((DbTable*)tb, chunk);
+}
+
+static ERTS_INLINE void try_compact_literals(DbTableHash* tb)
+{
+    if (tb->common.shared_literal && !IS_FIXED(tb))
+        compact_literal_chunk(tb);
+}
+
 
 
 /*
@@ -549,6 +743,7 @@ DbTableMethod db_hash =
     db_get_hash,
     db_get_element_hash,
     db_member_hash,
+    db_get_many_hash,
     db_erase_hash,
     db_erase_object_hash,
     db_slot_hash,
@@ -674,7 +869,12 @@ restart:
         work++;
     }
 
-    /* ToDo: Maybe try grow/shrink the table as well */
+    if (tb->incremental_resize && !IS_FIXED(tb)) {
+        int nactive = NACTIVE(tb);
+        int nitems = NITEMS(tb);
+        if (need_grow(tb, nitems, nactive) || need_shrink(tb, nitems, nactive))
+            schedule_resize(tb);
+    }
 
     return work;
 }
@@ -696,19 +896,37 @@ int db_create_hash(Process *p, DbTable *tbl)
     sys_memset(tb->first_segtab[0], 0, SIZEOF_SEGMENT(FIRST_SEGSZ));
 
     erts_atomic_init_nob(&tb->is_resizing, 0);
+    tb->lockfree_read = 0;
+    tb->load_factor = DB_HASH_LOAD_FACTOR_DEFAULT;
+    tb->incremental_resize = 0;
+    erts_atomic32_init_nob(&tb->resize_scheduled, 0);
+    erts_atomic_init_nob(&tb->nsplits, 0);
+    erts_atomic_init_nob(&tb->njoins, 0);
+    erts_atomic_init_nob(&tb->nresize_jobs, 0);
     if (tb->common.type & DB_FINE_LOCKED) {
 	erts_rwmtx_opt_t rwmtx_opt = ERTS_RWMTX_OPT_DEFAULT_INITER;
 	int i;
-	if (tb->common.type & DB_FREQ_READ)
-	    rwmtx_opt.type = ERTS_RWMTX_TYPE_FREQUENT_READ;
+	if (tb->common.type & DB_FREQ_READ) {
+	    /* Readers validate against the lock slot sequence counters
+	     * instead of read locking. Not for compressed tables as those
+	     * cannot cheaply copy-on-write objects for update_counter etc,
+	     * nor for shared literal tables as their lookups do not copy
+	     * and return references handed out under the lock. */
+	    if (!tb->common.compress && !tb->common.shared_literal)
+		tb->lockfree_read = 1;
+	    else
+		rwmtx_opt.type = ERTS_RWMTX_TYPE_FREQUENT_READ;
+	}
 	if (erts_ets_rwmtx_spin_count >= 0)
 	    rwmtx_opt.main_spincount = erts_ets_rwmtx_spin_count;
 	tb->locks = (DbTableHashFineLocks*) erts_db_alloc(ERTS_ALC_T_DB_SEG, /* Other type maybe? */
                                                           (DbTable *) tb,
                                                           sizeof(DbTableHashFineLocks));
 	for (i=0; i<DB_HASH_LOCK_CNT; ++i) {
-            erts_rwmtx_init_opt(&tb->locks->lck_vec[i].lck, &rwmtx_opt,
+            erts_rwmtx_init_opt(GET_LOCK(tb,i), &rwmtx_opt,
                 "db_hash_slot", tb->common.the_name, ERTS_LOCK_FLAGS_CATEGORY_DB);
+            erts_atomic_init_nob(&GET_LOCK_SLOT(tb,i)->seq, 0);
+            erts_atomic_init_nob(&GET_LOCK_SLOT(tb,i)->contended, 0);
 	}
 	/* This important property is needed to guarantee the two buckets
     	 * involved in a grow/shrink operation it protected by the same lock:
@@ -832,7 +1050,7 @@ int db_put_hash(DbTable *tbl, Eterm obj, int key_clash_fail)
 	q = replace_dbterm(tb, b, obj);
 	q->next = bnext;
 	ASSERT(q->hvalue == hval);
-	*bp = q;
+	link_dbterm(tb, bp, q);
 	goto Ldone;
     }
     else if (key_clash_fail) { /* && (DB_BAG || DB_DUPLICATE_BAG) */
@@ -873,38 +1091,48 @@ Lnew:
     q->hvalue = hval;
     q->pseudo_deleted = 0;
     q->next = b;
-    *bp = q;
+    link_dbterm(tb, bp, q);
     nitems = INC_NITEMS(tb);
     WUNLOCK_HASH(lck);
-    {
-	int nactive = NACTIVE(tb);       
-	if (nitems > GROW_LIMIT(nactive) && !IS_FIXED(tb)) {
-	    grow(tb, nitems);
-	}
-    }
+    try_grow(tb, nitems);
+    try_compact_literals(tb);
     return DB_ERROR_NONE;
 
 Ldone:
     WUNLOCK_HASH(lck);	
+    try_compact_literals(tb);
     return ret;
 }
 
-static Eterm
-get_term_list(Process *p, DbTableHash *tb, Eterm key, HashValue hval,
-              HashDbTerm *b1, HashDbTerm **bend)
+/* Find the end of the objects with the same key as the live object 'b1'
+ * and the heap size needed to copy them as a list. */
+static HashDbTerm*
+term_list_end(DbTableHash *tb, Eterm key, HashValue hval,
+              HashDbTerm *b1, Uint *szp)
 {
     HashDbTerm* b2 = b1->next;
-    Eterm copy;
-    Uint sz = b1->dbterm.size + 2;
+    Uint sz = LOOKUP_HEAP_SIZE(tb, b1);
 
     if (tb->common.status & (DB_BAG | DB_DUPLICATE_BAG)) {
         while (b2 && has_key(tb, b2, key, hval)) {
 	    if (!is_pseudo_deleted(b2))
-		sz += b2->dbterm.size + 2;
+		sz += LOOKUP_HEAP_SIZE(tb, b2);
 
             b2 = b2->next;
         }
     }
+    *szp = sz;
+    return b2;
+}
+
+static Eterm
+get_term_list(Process *p, DbTableHash *tb, Eterm key, HashValue hval,
+              HashDbTerm *b1, HashDbTerm **bend)
+{
+    Uint sz;
+    HashDbTerm* b2 = term_list_end(tb, key, hval, b1, &sz);
+    Eterm copy;
+
     copy = build_term_list(p, b1, b2, sz, tb);
     if (bend) {
         *bend = b2;
@@ -912,6 +1140,98 @@ get_term_list(Process *p, DbTableHash *tb, Eterm key, HashValue hval,
     return copy;
 }
 
+/* Max number of objects with the same key that a lock-free lookup
+ * collects before falling back on read locking */
+#define LOCKFREE_LOOKUP_MAX_OBJS 16
+
+/* Optimistic lookup without taking the bucket lock. Objects are found
+ * and counted, the lock slot sequence counter is validated to make sure
+ * no writer was active meanwhile and then the (immutable and not yet
+ * freed) objects are copied. Returns 0 if the caller must retry with
+ * the lock held.
+ */
+static int lockfree_get_hash(Process *p, DbTableHash *tb, Eterm key,
+                             HashValue hval, Eterm *ret)
+{
+    erts_atomic_t* seqp = &GET_LOCK_SLOT(tb,hval)->seq;
+    HashDbTerm* objs[LOCKFREE_LOOKUP_MAX_OBJS];
+    erts_aint_t seq;
+    HashDbTerm* b;
+    Uint ix, sz = 0;
+    int n = 0;
+
+    seq = erts_atomic_read_acqb(seqp);
+    if (seq & 1)
+        return 0;
+
+    ix = hash_to_ix(tb, hval);
+    ERTS_THR_READ_MEMORY_BARRIER; /* segment of a new 'nactive' is written */
+    b = BUCKET(tb, ix);
+    while (b != NULL && !has_live_key(tb, b, key, hval))
+        b = b->next;
+
+    if (b != NULL) {
+        do {
+            if (!is_pseudo_deleted(b)) {
+                if (n == LOCKFREE_LOOKUP_MAX_OBJS)
+                    return 0;
+                objs[n++] = b;
+                sz += b->dbterm.size + 2;
+            }
+            b = b->next;
+        } while ((tb->common.status & (DB_BAG | DB_DUPLICATE_BAG))
+                 && b != NULL && has_key(tb, b, key, hval));
+    }
+
+    ERTS_THR_READ_MEMORY_BARRIER;
+    if (erts_atomic_read_nob(seqp) != seq)
+        return 0;
+
+    if (n == 0)
+        *ret = NIL;
+    else {
+        Eterm list = NIL;
+        Eterm *hp = HAlloc(p, sz);
+        int i;
+
+        for (i = 0; i < n; i++) {
+            Eterm copy = db_copy_object_from_ets(&tb->common, &objs[i]->dbterm,
+                                                 &hp, &MSO(p));
+            list = CONS(hp, copy, list);
+            hp += 2;
+        }
+        *ret = list;
+    }
+    return 1;
+}
+
+/* Same as lockfree_get_hash() but for ets:member */
+static int lockfree_member_hash(DbTableHash *tb, Eterm key, HashValue hval,
+                                Eterm *ret)
+{
+    erts_atomic_t* seqp = &GET_LOCK_SLOT(tb,hval)->seq;
+    erts_aint_t seq;
+    HashDbTerm* b;
+    Uint ix;
+
+    seq = erts_atomic_read_acqb(seqp);
+    if (seq & 1)
+        return 0;
+
+    ix = hash_to_ix(tb, hval);
+    ERTS_THR_READ_MEMORY_BARRIER; /* segment of a new 'nactive' is written */
+    b = BUCKET(tb, ix);
+    while (b != NULL && !has_live_key(tb, b, key, hval))
+        b = b->next;
+
+    ERTS_THR_READ_MEMORY_BARRIER;
+    if (erts_atomic_read_nob(seqp) != seq)
+        return 0;
+
+    *ret = b != NULL ? am_true : am_false;
+    return 1;
+}
+
 int db_get_hash(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
 {
     DbTableHash *tb = &tbl->hash;
@@ -921,6 +1241,8 @@ int db_get_hash(Process *p, DbTable *tbl, Eterm key, Eterm *ret)
     erts_rwmtx_t* lck;
 
     hval = MAKE_HASH(key);
+    if (DB_USING_LOCKFREE_READ(tb) && lockfree_get_hash(p, tb, key, hval, ret))
+        return DB_ERROR_NONE;
     lck = RLOCK_HASH(tb,hval);
     ix = hash_to_ix(tb, hval);
     b = BUCKET(tb, ix);
@@ -947,8 +1269,10 @@ static int db_member_hash(DbTable *tbl, Eterm key, Eterm *ret)
     erts_rwmtx_t* lck;
 
     hval = MAKE_HASH(key);
-    ix = hash_to_ix(tb, hval);
+    if (DB_USING_LOCKFREE_READ(tb) && lockfree_member_hash(tb, key, hval, ret))
+        return DB_ERROR_NONE;
     lck = RLOCK_HASH(tb, hval);
+    ix = hash_to_ix(tb, hval);
     b1 = BUCKET(tb, ix);
 
     while(b1 != 0) {
@@ -964,6 +1288,112 @@ done:
     return DB_ERROR_NONE;
 }
     
+typedef struct {
+    HashValue hval;
+    Uint ix;                    /* index in 'keys' */
+    HashDbTerm* first;          /* first live object with the key */
+    HashDbTerm* end;            /* first object after the key */
+} DbHashGetManyKey;
+
+static int get_many_cmp_lock(const void *a, const void *b)
+{
+    HashValue la = ((DbHashGetManyKey*)a)->hval & DB_HASH_LOCK_MASK;
+    HashValue lb = ((DbHashGetManyKey*)b)->hval & DB_HASH_LOCK_MASK;
+    return la < lb ? -1 : (la > lb ? 1 : 0);
+}
+
+/*
+ * Keys are sorted by lock slot so that each bucket lock is taken once
+ * for all keys it protects. The objects found under one lock are copied
+ * into a single heap allocation.
+ */
+static int db_get_many_hash(Process *p, DbTable *tbl, Eterm *keys,
+                            Uint nkeys, int member, Eterm *ret)
+{
+    DbTableHash *tb = &tbl->hash;
+    DbHashGetManyKey mk[DB_GET_MANY_MAX_KEYS];
+    Uint i, j, n = 0;
+
+    ASSERT(nkeys <= DB_GET_MANY_MAX_KEYS);
+    for (i = 0; i < nkeys; i++) {
+        HashValue hval = MAKE_HASH(keys[i]);
+
+        if (DB_USING_LOCKFREE_READ(tb)
+            && (member ? lockfree_member_hash(tb, keys[i], hval, &ret[i])
+                       : lockfree_get_hash(p, tb, keys[i], hval, &ret[i])))
+            continue;
+        mk[n].hval = hval;
+        mk[n].ix = i;
+        n++;
+    }
+    if (n > 1 && !tb->common.is_thread_safe)
+        qsort(mk, n, sizeof(DbHashGetManyKey), get_many_cmp_lock);
+
+    i = 0;
+    while (i < n) {
+        erts_rwmtx_t* lck = RLOCK_HASH(tb, mk[i].hval);
+        Uint end = i + 1;
+        Uint sz = 0;
+
+        if (!tb->common.is_thread_safe) {
+            while (end < n && ((mk[end].hval & DB_HASH_LOCK_MASK)
+                               == (mk[i].hval & DB_HASH_LOCK_MASK)))
+                end++;
+        }
+        else
+            end = n;
+
+        for (j = i; j < end; j++) {
+            Eterm key = keys[mk[j].ix];
+            HashDbTerm* b = BUCKET(tb, hash_to_ix(tb, mk[j].hval));
+
+            while (b != NULL && !has_live_key(tb, b, key, mk[j].hval))
+                b = b->next;
+            mk[j].first = b;
+            if (b != NULL && !member) {
+                Uint obj_sz;
+                mk[j].end = term_list_end(tb, key, mk[j].hval, b, &obj_sz);
+                sz += obj_sz;
+            }
+        }
+
+        if (member) {
+            for (j = i; j < end; j++)
+                ret[mk[j].ix] = mk[j].first ? am_true : am_false;
+        }
+        else {
+            Eterm *hp = sz ? HAlloc(p, sz) : NULL;
+            Eterm *hend = hp + sz;
+
+            for (j = i; j < end; j++) {
+                if (mk[j].first)
+                    ret[mk[j].ix] = copy_term_list(p, mk[j].first, mk[j].end,
+                                                   &hp, tb);
+                else
+                    ret[mk[j].ix] = NIL;
+            }
+            HRelease(p, hend, hp);
+        }
+        RUNLOCK_HASH(lck);
+        i = end;
+    }
+    return DB_ERROR_NONE;
+}
+
+/* Element of an object for ets:lookup_element, see db_copy_element_from_ets */
+static ERTS_INLINE Eterm get_element(Process *p, DbTableHash *tb,
+                                     HashDbTerm *b, int ndex,
+                                     Eterm **hpp, Uint extra)
+{
+    if (tb->common.shared_literal && is_not_immed(b->dbterm.tpl[ndex])) {
+        Eterm obj = db_share_literal_object(b, offsetof(HashDbTerm,dbterm));
+        *hpp = HAlloc(p, extra);
+        return tuple_val(obj)[ndex];
+    }
+    return db_copy_element_from_ets(&tb->common, p, &b->dbterm, ndex,
+                                    hpp, extra);
+}
+
 static int db_get_element_hash(Process *p, DbTable *tbl, 
 			       Eterm key,
 			       int ndex, 
@@ -1005,8 +1435,7 @@ static int db_get_element_hash(Process *p, DbTable *tbl,
 		while(b != b2) {
 		    if (!is_pseudo_deleted(b)) {
 			Eterm *hp;
-			Eterm copy = db_copy_element_from_ets(&tb->common, p,
-							      &b->dbterm, ndex, &hp, 2);
+			Eterm copy = get_element(p, tb, b, ndex, &hp, 2);
 			elem_list = CONS(hp, copy, elem_list);
 		    }
 		    b = b->next;
@@ -1015,7 +1444,7 @@ static int db_get_element_hash(Process *p, DbTable *tbl,
 	    }
 	    else {
 		Eterm* hp;
-		*ret = db_copy_element_from_ets(&tb->common, p, &b1->dbterm, ndex, &hp, 0);
+		*ret = get_element(p, tb, b1, ndex, &hp, 0);
 	    }
 	    retval = DB_ERROR_NONE;
 	    goto done;
@@ -1076,6 +1505,7 @@ int db_erase_hash(DbTable *tbl, Eterm key, Eterm *ret)
 	try_shrink(tb);
     }
     free_term_list(tb, free_us);
+    try_compact_literals(tb);
     *ret = am_true;
     return DB_ERROR_NONE;
 }    
@@ -1137,6 +1567,7 @@ static int db_erase_object_hash(DbTable *tbl, Eterm object, Eterm *ret)
 	try_shrink(tb);
     }
     free_term_list(tb, free_us);
+    try_compact_literals(tb);
     *ret = am_true;
     return DB_ERROR_NONE;
 }    
@@ -2181,7 +2612,7 @@ static int select_replace_on_match_res(traverse_context_t* ctx, Sint slot_ix,
         new->hvalue = hval;
         new->pseudo_deleted = 0;
         free_term(tb, **current_ptr_ptr);
-        **current_ptr_ptr = new; /* replace 'next' pointer in previous object */
+        link_dbterm(tb, *current_ptr_ptr, new); /* replace 'next' pointer in previous object */
         *current_ptr_ptr = &((**current_ptr_ptr)->next); /* advance to next object */
         return 1;
     }
@@ -2484,6 +2915,8 @@ static SWord db_free_table_continue_hash(DbTable *tbl, SWord reds)
 		     (void*)tb->locks, sizeof(DbTableHashFineLocks));
 	tb->locks = NULL;
     }
+    if (tb->common.shared_literal)
+        db_close_literal_chunk(tbl);
     ASSERT(sizeof(DbTable) == erts_flxctr_read_approx(&tb->common.counters,
                                                       ERTS_DB_TABLE_MEM_COUNTER_ID));
     return reds;			/* Done */
@@ -2693,6 +3126,11 @@ static void dealloc_ext_segtab(void* lop_data)
     erts_free(ERTS_ALC_T_DB_SEG, est);
 }
 
+static void dealloc_seg(void* lop_data)
+{
+    erts_free(ERTS_ALC_T_DB_SEG, lop_data);
+}
+
 /* Shrink table by freeing the top segment
 ** free_records: 1=free any records in segment, 0=assume segment is empty 
 */
@@ -2715,7 +3153,7 @@ static int free_seg(DbTableHash *tb, int free_records)
 	    while(p != 0) {		
 		HashDbTerm* nxt = p->next;
 		ASSERT(free_records); /* segment not empty as assumed? */
-		free_term(tb, p);
+		db_free_term((DbTable*)tb, p, offsetof(HashDbTerm, dbterm));
 		p = nxt;
 		++nrecords;
 	    }
@@ -2748,7 +3186,14 @@ static int free_seg(DbTableHash *tb, int free_records)
         }
     }
     seg_sz = (seg_ix == 0) ? FIRST_SEGSZ : EXT_SEGSZ;
-    erts_db_free(ERTS_ALC_T_DB_SEG, (DbTable *)tb, segp, SIZEOF_SEGMENT(seg_sz));
+    if (!free_records && DB_USING_LOCKFREE_READ(tb)) {
+        /* Lock-free readers may still index the segment with a stale
+         * 'nactive', it must survive until thread progress. */
+        erts_schedule_db_free(&tb->common, dealloc_seg, segp, &segp->lop,
+                              SIZEOF_SEGMENT(seg_sz));
+    }
+    else
+        erts_db_free(ERTS_ALC_T_DB_SEG, (DbTable *)tb, segp, SIZEOF_SEGMENT(seg_sz));
     
 #ifdef DEBUG
     if (seg_ix < tb->nsegs)
@@ -2770,33 +3215,48 @@ static Eterm build_term_list(Process* p, HashDbTerm* ptr1, HashDbTerm* ptr2,
 			     Uint sz, DbTableHash* tb)
 {
     HashDbTerm* ptr;
-    Eterm list = NIL;
-    Eterm copy;
+    Eterm list;
     Eterm *hp, *hend;
 
     if (!sz) {
 	ptr = ptr1;
 	while(ptr != ptr2) {
 	    if (!is_pseudo_deleted(ptr))
-		sz += ptr->dbterm.size + 2;
+		sz += LOOKUP_HEAP_SIZE(tb, ptr);
 	    ptr = ptr->next;
 	}
     }
 
     hp = HAlloc(p, sz);
     hend = hp + sz;
+    list = copy_term_list(p, ptr1, ptr2, &hp, tb);
+    HRelease(p,hend,hp);
+
+    return list;
+}
+
+static Eterm copy_term_list(Process* p, HashDbTerm* ptr1, HashDbTerm* ptr2,
+                            Eterm** hpp, DbTableHash* tb)
+{
+    HashDbTerm* ptr;
+    Eterm list = NIL;
+    Eterm copy;
+    Eterm *hp = *hpp;
 
     ptr = ptr1;
     while(ptr != ptr2) {
 	if (!is_pseudo_deleted(ptr)) {
-	    copy = db_copy_object_from_ets(&tb->common, &ptr->dbterm, &hp, &MSO(p));
+            if (tb->common.shared_literal)
+                copy = db_share_literal_object(ptr, offsetof(HashDbTerm,dbterm));
+            else
+                copy = db_copy_object_from_ets(&tb->common, &ptr->dbterm,
+                                               &hp, &MSO(p));
 	    list = CONS(hp, copy, list);
 	    hp  += 2;
 	}
 	ptr = ptr->next;
     }
-    HRelease(p,hend,hp);
-
+    *hpp = hp;
     return list;
 }
 
@@ -2835,7 +3295,7 @@ static void grow(DbTableHash* tb, int nitems)
         if (!begin_resizing(tb))
             return; /* already in progress */
         nactive = NACTIVE(tb);
-        if (nitems <= GROW_LIMIT(nactive)) {
+        if (!need_grow(tb, nitems, nactive)) {
             goto abort; /* already done (race) */
         }
 
@@ -2901,8 +3361,9 @@ static void grow(DbTableHash* tb, int nitems)
         }
         *to_pnext = NULL;
         WUNLOCK_HASH(lck);
+        erts_atomic_inc_nob(&tb->nsplits);
 
-    }while (--loop_limit && nitems > GROW_LIMIT(nactive));
+    }while (--loop_limit && need_grow(tb, nitems, nactive));
 
     return;
    
@@ -2928,7 +3389,7 @@ static void shrink(DbTableHash* tb, int nitems)
         if (!begin_resizing(tb))
             return; /* already in progress */
         nactive = NACTIVE(tb);
-        if (!(nactive > FIRST_SEGSZ && nitems < SHRINK_LIMIT(nactive))) {
+        if (!need_shrink(tb, nitems, nactive)) {
             goto abort; /* already done (race) */
         }
         src_ix = nactive - 1;
@@ -2976,10 +3437,10 @@ static void shrink(DbTableHash* tb, int nitems)
         if (tb->nslots - src_ix >= EXT_SEGSZ) {
             free_seg(tb, 0);
         }
+        erts_atomic_inc_nob(&tb->njoins);
         done_resizing(tb);
 
-    } while (--loop_limit
-             && nactive > FIRST_SEGSZ && nitems < SHRINK_LIMIT(nactive));
+    } while (--loop_limit && need_shrink(tb, nitems, nactive));
     return;
 
 abort:
@@ -3039,6 +3500,7 @@ db_lookup_dbterm_hash(Process *p, DbTable *tbl, Eterm key, Eterm obj,
     DbTableHash *tb = &tbl->hash;
     HashValue hval;
     HashDbTerm **bp, *b;
+    HashDbTerm *replaced = NULL;
     erts_rwmtx_t* lck;
     int flags = 0;
 
@@ -3080,7 +3542,23 @@ db_lookup_dbterm_hash(Process *p, DbTable *tbl, Eterm key, Eterm obj,
         htop[tb->common.keypos] = key;
         obj = make_tuple(htop);
 
-        if (b == NULL) {
+        if (DB_COPY_ON_UPDATE(tb)) {
+            /* Linked in by db_finalize_dbterm_hash() when complete */
+            HashDbTerm *q = new_dbterm(tb, obj);
+
+            q->hvalue = hval;
+            q->pseudo_deleted = 0;
+            if (b == NULL) {
+                q->next = NULL;
+                flags |= DB_INC_TRY_GROW;
+            } else {
+                ASSERT(is_pseudo_deleted(b));
+                q->next = b->next;
+                INC_NITEMS(tb);
+            }
+            replaced = b;
+            b = q;
+        } else if (b == NULL) {
             HashDbTerm *q = new_dbterm(tb, obj);
 
             q->hvalue = hval;
@@ -3106,7 +3584,26 @@ db_lookup_dbterm_hash(Process *p, DbTable *tbl, Eterm key, Eterm obj,
 
 Ldone:
     handle->tb = tbl;
-    handle->bp = (void **)bp;
+    if (DB_COPY_ON_UPDATE(tb)) {
+        /* Readers may be using the object, update a copy */
+        if (!(flags & DB_NEW_OBJECT)) {
+            HashDbTerm *q = new_dbterm(tb, make_tuple(b->dbterm.tpl));
+
+            q->hvalue = b->hvalue;
+            q->pseudo_deleted = 0;
+            q->next = b->next;
+            replaced = b;
+            b = q;
+        }
+        handle->u.hash.publish_bp = (void **)bp;
+        handle->u.hash.replaced = replaced;
+        handle->u.hash.copy = b;
+        handle->bp = &handle->u.hash.copy;
+    }
+    else {
+        handle->u.hash.publish_bp = NULL;
+        handle->bp = (void **)bp;
+    }
     handle->dbterm = &b->dbterm;
     handle->flags = flags;
     handle->new_size = b->dbterm.size;
@@ -3114,6 +3611,50 @@ Ldone:
     return 1;
 }
 
+/* Finalize an update of a private copy, see db_lookup_dbterm_hash() */
+static void
+finalize_dbterm_copy_hash(int cret, DbUpdateHandle* handle)
+{
+    DbTableHash *tb = &handle->tb->hash;
+    HashDbTerm **publish_bp = (HashDbTerm **) handle->u.hash.publish_bp;
+    HashDbTerm *replaced = (HashDbTerm *) handle->u.hash.replaced;
+    HashDbTerm *b = (HashDbTerm *) handle->u.hash.copy;
+    erts_rwmtx_t* lck = handle->u.hash.lck;
+
+    ERTS_LC_ASSERT(IS_HASH_WLOCKED(tb, lck));
+    ASSERT(handle->bp == &handle->u.hash.copy);
+
+    if (handle->flags & DB_NEW_OBJECT && cret != DB_ERROR_NONE) {
+        /* Never linked in; a resurrected object is still pseudo deleted */
+        WUNLOCK_HASH(lck);
+        db_free_term((DbTable*)tb, b, offsetof(HashDbTerm, dbterm));
+        DEC_NITEMS(tb);
+        try_shrink(tb);
+        return;
+    }
+
+    if (handle->flags & DB_MUST_RESIZE) {
+        db_finalize_resize(handle, offsetof(HashDbTerm,dbterm));
+        db_free_term((DbTable*)tb, b, offsetof(HashDbTerm, dbterm));
+        b = (HashDbTerm *) handle->u.hash.copy;
+    }
+    ASSERT(b->next == (replaced ? replaced->next : NULL));
+    link_dbterm(tb, publish_bp, b);
+    if (replaced)
+        free_term(tb, replaced);
+
+    if (handle->flags & DB_INC_TRY_GROW) {
+        int nitems = INC_NITEMS(tb);
+        WUNLOCK_HASH(lck);
+        try_grow(tb, nitems);
+    } else {
+        WUNLOCK_HASH(lck);
+    }
+#ifdef DEBUG
+    handle->dbterm = 0;
+#endif
+}
+
 /* Must be called after call to db_lookup_dbterm
 */
 static void
@@ -3128,6 +3669,11 @@ db_finalize_dbterm_hash(int cret, DbUpdateHandle* handle)
 
     ERTS_LC_ASSERT(IS_HASH_WLOCKED(tb, lck));  /* locked by db_lookup_dbterm_hash */
 
+    if (handle->u.hash.publish_bp) {
+        finalize_dbterm_copy_hash(cret, handle);
+        return;
+    }
+
     ASSERT((&b->dbterm == handle->dbterm) == !(tb->common.compress && handle->flags & DB_MUST_RESIZE));
 
     if (handle->flags & DB_NEW_OBJECT && cret != DB_ERROR_NONE) {
@@ -3148,14 +3694,9 @@ db_finalize_dbterm_hash(int cret, DbUpdateHandle* handle)
             free_me = b;
         }
         if (handle->flags & DB_INC_TRY_GROW) {
-            int nactive;
             int nitems = INC_NITEMS(tb);
             WUNLOCK_HASH(lck);
-            nactive = NACTIVE(tb);
-
-            if (nitems > GROW_LIMIT(nactive) && !IS_FIXED(tb)) {
-                grow(tb, nitems);
-            }
+            try_grow(tb, nitems);
         } else {
             WUNLOCK_HASH(lck);
         }
@@ -3222,38 +3763,189 @@ void db_foreach_offheap_hash(DbTable *tbl,
 }
 
 void db_calc_stats_hash(DbTableHash* tb, DbHashStats* stats)
+{
+    DbHashStatsCtx ctx;
+
+    db_calc_stats_hash_init(&ctx);
+    db_calc_stats_hash_continue(tb, &ctx, NULL);
+    db_calc_stats_hash_result(&ctx, stats);
+}
+
+void db_calc_stats_hash_init(DbHashStatsCtx* ctx)
+{
+    sys_memset(ctx, 0, sizeof(*ctx));
+    ctx->min_chain_len = INT_MAX;
+}
+
+/* Walk chains until done (returns 1) or out of reductions (returns 0),
+** no limit if 'reds' is NULL. Buckets are visited lock by lock as by
+** next_slot(), the result is only approximate if the table is resized
+** between calls.
+*/
+int db_calc_stats_hash_continue(DbTableHash* tb, DbHashStatsCtx* ctx,
+                                SWord* reds)
 {
     HashDbTerm* b;
     erts_rwmtx_t* lck;
-    int sum = 0;
-    int sq_sum = 0;
-    int kept_items = 0;
-    int ix;
+    SWord loops = reds ? *reds * STATS_BUCKETS_PER_REDUCTION : ERTS_SWORD_MAX;
+    Sint ix = ctx->ix;
     int len;
-    
-    stats->min_chain_len = INT_MAX;
-    stats->max_chain_len = 0;
-    ix = 0;
+
     lck = RLOCK_HASH(tb,ix);
+    if (ix >= NACTIVE(tb)) { /* shrunk while yielding */
+        ASSERT(ix >= DB_HASH_LOCK_CNT);
+        RUNLOCK_HASH(lck);
+        ix = (ix + 1) & DB_HASH_LOCK_MASK;
+        if (ix == 0)
+            goto done;
+        lck = RLOCK_HASH(tb,ix);
+    }
     do {
+        if (loops <= 0 && reds) {
+            RUNLOCK_HASH(lck);
+            ctx->ix = ix;
+            *reds = 0;
+            return 0;
+        }
 	len = 0;
 	for (b = BUCKET(tb,ix); b!=NULL; b=b->next) {
 	    len++;
             if (is_pseudo_deleted(b))
-                ++kept_items;
+                ++ctx->kept_items;
+            ctx->bytes += db_alloced_size_term((DbTable*)tb, b,
+                                               offsetof(HashDbTerm, dbterm));
 	}
-	sum += len;
-	sq_sum += len*len;
-	if (len < stats->min_chain_len) stats->min_chain_len = len;
-	if (len > stats->max_chain_len) stats->max_chain_len = len;
+	ctx->nbuckets++;
+	ctx->sum += len;
+	ctx->sq_sum += (double)len*len;
+	if (len < ctx->min_chain_len) ctx->min_chain_len = len;
+	if (len > ctx->max_chain_len) ctx->max_chain_len = len;
+	ctx->hist[len < DB_HASH_CHAIN_HIST_SIZE
+                  ? len : DB_HASH_CHAIN_HIST_SIZE - 1]++;
+        loops -= 1 + len / STATS_OBJECTS_PER_BUCKET;
 	ix = next_slot(tb,ix,&lck);
     }while (ix);
-    stats->avg_chain_len = (float)sum / NACTIVE(tb);	
-    stats->std_dev_chain_len = sqrt((sq_sum - stats->avg_chain_len*sum) / NACTIVE(tb));
+
+done:
+    ctx->ix = 0;
+    if (reds)
+        *reds = loops / STATS_BUCKETS_PER_REDUCTION;
+    return 1;
+}
+
+void db_calc_stats_hash_result(DbHashStatsCtx* ctx, DbHashStats* stats)
+{
+    double nbuckets = ctx->nbuckets ? ctx->nbuckets : 1;
+
+    stats->min_chain_len = ctx->nbuckets ? ctx->min_chain_len : 0;
+    stats->max_chain_len = ctx->max_chain_len;
+    stats->avg_chain_len = ctx->sum / nbuckets;
+    stats->std_dev_chain_len = sqrt((ctx->sq_sum - stats->avg_chain_len*ctx->sum)
+                                    / nbuckets);
     /* Expected	standard deviation from a good uniform hash function, 
        ie binomial distribution (not taking the linear hashing into acount) */
-    stats->std_dev_expected = sqrt(stats->avg_chain_len * (1 - 1.0/NACTIVE(tb)));
-    stats->kept_items = kept_items;
+    stats->std_dev_expected = sqrt(stats->avg_chain_len * (1 - 1.0/nbuckets));
+    stats->kept_items = ctx->kept_items;
+    stats->bytes_per_object = ctx->sum ? (double)ctx->bytes / ctx->sum : 0.0;
+}
+
+/* Number of times each lock slot had to be waited for, returns the
+** number of slots (none for tables without fine grained locking).
+*/
+int db_lock_contention_hash(DbTableHash* tb, Uint counts[DB_HASH_LOCK_CNT])
+{
+    int i;
+
+    if (!tb->locks)
+        return 0;
+    for (i = 0; i < DB_HASH_LOCK_CNT; i++)
+        counts[i] = erts_atomic_read_nob(&GET_LOCK_SLOT(tb,i)->contended);
+    return DB_HASH_LOCK_CNT;
+}
+
+void db_set_resize_params_hash(DbTableHash* tb, int load_factor,
+                               int incremental)
+{
+    ASSERT(load_factor >= DB_HASH_LOAD_FACTOR_MIN
+           && load_factor <= DB_HASH_LOAD_FACTOR_MAX);
+    tb->load_factor = load_factor;
+    tb->incremental_resize = incremental;
+}
+
+/* Allocate the next segment ahead of time when the table is about to
+** grow into it, so that grow() does not have to do it.
+*/
+static void prealloc_seg(DbTableHash* tb)
+{
+    int nactive;
+
+    if (!begin_resizing(tb))
+        return;
+    nactive = NACTIVE(tb);
+    if (tb->nslots - nactive < EXT_SEGSZ
+        && NITEMS(tb) > (GROW_LIMIT(tb, nactive) / 4) * 3) {
+        alloc_seg(tb);
+    }
+    done_resizing(tb);
+}
+
+/* Scheduled by schedule_resize() and called as scheduler aux work with
+** the table locked as for record write (or 'cancel' set if the table is
+** busy). Returns non-zero if the job should be rescheduled.
+*/
+int db_resize_aux_work_hash(DbTableHash* tb, int cancel)
+{
+    int nactive;
+    int nitems;
+    int i;
+
+    ASSERT(erts_atomic32_read_nob(&tb->resize_scheduled));
+    if (cancel) {
+        erts_atomic32_set_relb(&tb->resize_scheduled, 0);
+        return 0;
+    }
+    erts_atomic_inc_nob(&tb->nresize_jobs);
+
+    for (i = 0; i < RESIZE_AUX_WORK_CALLS && !IS_FIXED(tb); i++) {
+        nactive = NACTIVE(tb);
+        nitems = NITEMS(tb);
+        if (need_grow(tb, nitems, nactive))
+            grow(tb, nitems);
+        else if (need_shrink(tb, nitems, nactive))
+            shrink(tb, nitems);
+        else
+            break;
+    }
+    if (i == RESIZE_AUX_WORK_CALLS)
+        return 1;
+
+    if (!IS_FIXED(tb))
+        prealloc_seg(tb);
+
+    /* Inserters that saw the flag set did not schedule, recheck */
+    erts_atomic32_set_mb(&tb->resize_scheduled, 0);
+    nactive = NACTIVE(tb);
+    nitems = NITEMS(tb);
+    if (IS_FIXED(tb)
+        || !(need_grow(tb, nitems, nactive) || need_shrink(tb, nitems, nactive)))
+        return 0;
+    return !erts_atomic32_xchg_mb(&tb->resize_scheduled, 1);
+}
+
+void db_get_resize_info_hash(DbTableHash* tb, DbHashResizeInfo* info)
+{
+    Sint nitems = NITEMS(tb);
+
+    info->buckets = NACTIVE(tb);
+    info->target_buckets = nitems > 0
+        ? ((Uint) nitems << DB_HASH_LOAD_FACTOR_SHIFT) / tb->load_factor
+        : 0;
+    if (info->target_buckets < FIRST_SEGSZ)
+        info->target_buckets = FIRST_SEGSZ;
+    info->slots = tb->nslots;
+    info->splits = erts_atomic_read_nob(&tb->nsplits);
+    info->joins = erts_atomic_read_nob(&tb->njoins);
+    info->aux_jobs = erts_atomic_read_nob(&tb->nresize_jobs);
 }
 
 /* For testing only */
@@ -3262,6 +3954,11 @@ Eterm erts_ets_hash_sizeof_ext_segtab(void)
     return make_small(((SIZEOF_EXT_SEGTAB(0)-1) / sizeof(UWord)) + 1);
 }
 
+Eterm erts_ets_hash_sizeof_segment_header(void)
+{
+    return make_small(((SIZEOF_SEGMENT(0)-1) / sizeof(UWord)) + 1);
+}
+
 #ifdef ERTS_ENABLE_LOCK_COUNT
 void erts_lcnt_enable_db_hash_lock_count(DbTableHash *tb, int enable) {
     int i;
@@ -3271,7 +3968,7 @@ void erts_lcnt_enable_db_hash_lock_count(DbTableHash *tb, int enable) {
     }
 
     for(i = 0; i < DB_HASH_LOCK_CNT; i++) {
-        erts_lcnt_ref_t *ref = &tb->locks->lck_vec[i].lck.lcnt;
+        erts_lcnt_ref_t *ref = &GET_LOCK(tb,i)->lcnt;
 
         if(enable) {
             erts_lcnt_install_new_lock_info(ref, "db_hash_slot", tb->common.the_name,
@@ -53,10 +53,28 @@ typedef struct hash_db_term {
 #define DB_HASH_LOCK_CNT 64
 #endif
 
+/* Load factors (objects per bucket) are fixed point numbers */
+#define DB_HASH_LOAD_FACTOR_SHIFT   8
+#define DB_HASH_LOAD_FACTOR_DEFAULT (1 << DB_HASH_LOAD_FACTOR_SHIFT)
+#define DB_HASH_LOAD_FACTOR_MIN     (DB_HASH_LOAD_FACTOR_DEFAULT / 4)
+#define DB_HASH_LOAD_FACTOR_MAX     (DB_HASH_LOAD_FACTOR_DEFAULT * 16)
+
+/* Number of counters in a chain length histogram, the last one
+ * counts all chains of that length or longer */
+#define DB_HASH_CHAIN_HIST_SIZE 16
+
+typedef struct {
+    erts_rwmtx_t lck;
+    /* Bumped when write locking and again when unlocking, that is,
+     * odd while a writer may be modifying the buckets of this lock */
+    erts_atomic_t seq;
+    erts_atomic_t contended; /* lock attempts that had to wait */
+} DbTableHashFineLockSlot;
+
 typedef struct db_table_hash_fine_locks {
     union {
-	erts_rwmtx_t lck;
-	byte _cache_line_alignment[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(sizeof(erts_rwmtx_t))];
+	DbTableHashFineLockSlot lck_slot;
+	byte _cache_line_alignment[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(sizeof(DbTableHashFineLockSlot))];
     }lck_vec[DB_HASH_LOCK_CNT];
 } DbTableHashFineLocks;
 
@@ -78,6 +96,22 @@ typedef struct db_table_hash {
     erts_atomic_t fixdel;  /* (FixedDeletion*) */
     erts_atomic_t is_resizing; /* grow/shrink in progress */
     DbTableHashFineLocks* locks;
+
+    /* Lookups may bypass the fine grained locks and validate against
+     * the lock slot sequence counter instead. Objects and segments are
+     * then never modified in place and only freed after thread progress. */
+    int lockfree_read;
+
+    /* Grow when the number of objects exceeds load_factor*nactive and
+     * shrink below half of that */
+    int load_factor;
+    /* Let scheduler aux work split/join buckets and allocate segments
+     * ahead of time instead of the inserting/deleting process */
+    int incremental_resize;
+    erts_atomic32_t resize_scheduled; /* aux work job pending */
+    erts_atomic_t nsplits;     /* buckets split by grow() */
+    erts_atomic_t njoins;      /* buckets joined by shrink() */
+    erts_atomic_t nresize_jobs; /* aux work jobs run */
 } DbTableHash;
 
 
@@ -106,10 +140,43 @@ typedef struct {
     int max_chain_len;
     int min_chain_len;
     int kept_items;
+    float bytes_per_object;
 }DbHashStats;
 
+/* State of a chain walk that may yield between calls */
+typedef struct {
+    Sint ix;                /* next bucket, lock by lock */
+    Uint nbuckets;
+    Uint sum;
+    double sq_sum;
+    int max_chain_len;
+    int min_chain_len;
+    Uint kept_items;
+    Uint bytes;
+    Uint hist[DB_HASH_CHAIN_HIST_SIZE];
+}DbHashStatsCtx;
+
 void db_calc_stats_hash(DbTableHash* tb, DbHashStats*);
+void db_calc_stats_hash_init(DbHashStatsCtx*);
+int db_calc_stats_hash_continue(DbTableHash* tb, DbHashStatsCtx*, SWord* reds);
+void db_calc_stats_hash_result(DbHashStatsCtx*, DbHashStats*);
+int db_lock_contention_hash(DbTableHash* tb, Uint counts[DB_HASH_LOCK_CNT]);
+
+typedef struct {
+    Uint buckets;
+    Uint target_buckets;
+    Uint slots;
+    Uint splits;
+    Uint joins;
+    Uint aux_jobs;
+} DbHashResizeInfo;
+
+void db_set_resize_params_hash(DbTableHash* tb, int load_factor,
+                               int incremental);
+int db_resize_aux_work_hash(DbTableHash* tb, int cancel);
+void db_get_resize_info_hash(DbTableHash* tb, DbHashResizeInfo*);
 Eterm erts_ets_hash_sizeof_ext_segtab(void);
+Eterm erts_ets_hash_sizeof_segment_header(void);
 
 #ifdef ERTS_ENABLE_LOCK_COUNT
 void erts_lcnt_enable_db_hash_lock_count(DbTableHash *tb, int enable);
@@ -351,7 +351,7 @@ static enum ms_key_boundness key_boundness(DbTableCommon *tb,
                                            Eterm pattern, Eterm *keyp);
 static Sint do_cmp_partly_bound(Eterm a, Eterm b, int *done);
 
-static int analyze_pattern(DbTableCommon *tb, Eterm pattern,
+static int analyze_pattern(Process *p, DbTableCommon *tb, Eterm pattern,
                            extra_match_validator_t extra_validator, /* Optional callback */
                            struct mp_info *mpi);
 static int doit_select(DbTableCommon *tb,
@@ -400,6 +400,8 @@ static int db_put_tree(DbTable *tbl, Eterm obj, int key_clash_fail);
 static int db_get_tree(Process *p, DbTable *tbl, 
 		       Eterm key,  Eterm *ret);
 static int db_member_tree(DbTable *tbl, Eterm key, Eterm *ret);
+static int db_get_many_tree(Process *p, DbTable *tbl, Eterm *keys,
+                            Uint nkeys, int member, Eterm *ret);
 static int db_get_element_tree(Process *p, DbTable *tbl, 
 			       Eterm key,int ndex,
 			       Eterm *ret);
@@ -479,6 +481,7 @@ DbTableMethod db_tree =
     db_get_tree,
     db_get_element_tree,
     db_member_tree,
+    db_get_many_tree,
     db_erase_tree,
     db_erase_object_tree,
     db_slot_tree,
@@ -819,6 +822,53 @@ static int db_member_tree(DbTable *tbl, Eterm key, Eterm *ret)
     return db_member_tree_common(&tb->common, tb->root, key, ret, tb);
 }
 
+/*
+ * Lookup a batch of keys. All found objects are copied into one heap
+ * allocation.
+ */
+int db_get_many_tree_common(Process *p, DbTableCommon *tb, TreeDbTerm *root,
+                            Eterm *keys, Uint nkeys, int member, Eterm *ret,
+                            DbTableTree *stack_container)
+{
+    TreeDbTerm *found[DB_GET_MANY_MAX_KEYS];
+    Eterm *hp, *hend;
+    Uint i, sz = 0;
+
+    ASSERT(nkeys <= DB_GET_MANY_MAX_KEYS);
+    for (i = 0; i < nkeys; i++) {
+        found[i] = find_node(tb, root, keys[i], stack_container);
+        if (member)
+            ret[i] = found[i] ? am_true : am_false;
+        else if (found[i])
+            sz += found[i]->dbterm.size + 2;
+    }
+    if (member)
+        return DB_ERROR_NONE;
+
+    hp = sz ? HAlloc(p, sz) : NULL;
+    hend = hp + sz;
+    for (i = 0; i < nkeys; i++) {
+        if (found[i]) {
+            Eterm copy = db_copy_object_from_ets(tb, &found[i]->dbterm,
+                                                 &hp, &MSO(p));
+            ret[i] = CONS(hp, copy, NIL);
+            hp += 2;
+        }
+        else
+            ret[i] = NIL;
+    }
+    HRelease(p, hend, hp);
+    return DB_ERROR_NONE;
+}
+
+static int db_get_many_tree(Process *p, DbTable *tbl, Eterm *keys,
+                            Uint nkeys, int member, Eterm *ret)
+{
+    DbTableTree *tb = &tbl->tree;
+    return db_get_many_tree_common(p, &tb->common, tb->root, keys, nkeys,
+                                   member, ret, tb);
+}
+
 int db_get_element_tree_common(Process *p, DbTableCommon *tb, TreeDbTerm *root, Eterm key,
                                int ndex, Eterm *ret, DbTableTree *stack_container)
 {
@@ -1231,7 +1281,7 @@ int db_select_tree_common(Process *p, DbTable *tb,
     sc.got = 0;
     sc.chunk_size = 0;
 
-    if ((errcode = analyze_pattern(&tb->common, pattern, NULL, &mpi)) != DB_ERROR_NONE) {
+    if ((errcode = analyze_pattern(p, &tb->common, pattern, NULL, &mpi)) != DB_ERROR_NONE) {
 	RET_TO_BIF(NIL,errcode);
     }
 
@@ -1479,7 +1529,7 @@ int db_select_count_tree_common(Process *p, DbTable *tb,
     sc.keypos = tb->common.keypos;
     sc.got = 0;
 
-    if ((errcode = analyze_pattern(&tb->common, pattern, NULL, &mpi)) != DB_ERROR_NONE) {
+    if ((errcode = analyze_pattern(p, &tb->common, pattern, NULL, &mpi)) != DB_ERROR_NONE) {
 	RET_TO_BIF(NIL,errcode);
     }
 
@@ -1601,7 +1651,7 @@ int db_select_chunk_tree_common(Process *p, DbTable *tb,
     sc.got = 0;
     sc.chunk_size = chunk_size;
 
-    if ((errcode = analyze_pattern(&tb->common, pattern, NULL, &mpi)) != DB_ERROR_NONE) {
+    if ((errcode = analyze_pattern(p, &tb->common, pattern, NULL, &mpi)) != DB_ERROR_NONE) {
 	RET_TO_BIF(NIL,errcode);
     }
 
@@ -1892,7 +1942,7 @@ int db_select_delete_tree_common(Process *p, DbTable *tbl,
     sc.tb = &tbl->common;
     sc.stack = stack;
     
-    if ((errcode = analyze_pattern(&tbl->common, pattern, NULL, &mpi)) != DB_ERROR_NONE) {
+    if ((errcode = analyze_pattern(p, &tbl->common, pattern, NULL, &mpi)) != DB_ERROR_NONE) {
 	RET_TO_BIF(0,errcode);
     }
 
@@ -2127,7 +2177,7 @@ int db_select_replace_tree_common(Process *p, DbTable *tbl,
     sc.keypos = tbl->common.keypos;
     sc.replaced = 0;
 
-    if ((errcode = analyze_pattern(&tbl->common, pattern, db_match_keeps_key, &mpi)) != DB_ERROR_NONE) {
+    if ((errcode = analyze_pattern(p, &tbl->common, pattern, db_match_keeps_key, &mpi)) != DB_ERROR_NONE) {
         RET_TO_BIF(NIL,errcode);
     }
 
@@ -2503,9 +2553,11 @@ static TreeDbTerm *linkout_object_tree(DbTableCommon *tb,  TreeDbTerm **root,
 
 /*
 ** For the select functions, analyzes the pattern and determines which
-** part of the tree should be searched. Also compiles the match program
+** part of the tree should be searched. Comparison guards on variables
+** in the key narrow the searched part further (see db_match_key_range).
+** Also compiles the match program
 */
-static int analyze_pattern(DbTableCommon *tb, Eterm pattern,
+static int analyze_pattern(Process *p, DbTableCommon *tb, Eterm pattern,
                            extra_match_validator_t extra_validator, /* Optional callback */
                            struct mp_info *mpi)
 {
@@ -2542,7 +2594,8 @@ static int analyze_pattern(DbTableCommon *tb, Eterm pattern,
         Eterm match;
         Eterm guard;
         Eterm body;
-        Eterm key;
+        Eterm key = THE_NON_VALUE;
+        Eterm low, high;
 
 	ttpl = CAR(list_val(lst));
 	if (!is_tuple(ttpl)) {
@@ -2575,15 +2628,21 @@ static int analyze_pattern(DbTableCommon *tb, Eterm pattern,
 	++i;
 
         boundness = key_boundness(tb, tpl, &key);
+        low = high = key;
+        if (boundness < MS_KEY_BOUND && is_value(key) &&
+            db_match_key_range(p, key, guard, &low, &high)) {
+            /* Comparison guards on key variables narrow the key range */
+            boundness = MS_KEY_PARTIALLY_BOUND;
+        }
 	switch (boundness)
         {
         case MS_KEY_BOUND:
         case MS_KEY_PARTIALLY_BOUND:
-            if (is_non_value(least) || partly_bound_can_match_lesser(key,least)) {
-                least = key;
+            if (is_non_value(least) || partly_bound_can_match_lesser(low,least)) {
+                least = low;
             }
-            if (is_non_value(most) || partly_bound_can_match_greater(key,most)) {
-                most = key;
+            if (is_non_value(most) || partly_bound_can_match_greater(high,most)) {
+                most = high;
             }
             break;
         case MS_KEY_IMPOSSIBLE:
@@ -3493,6 +3552,8 @@ static enum ms_key_boundness key_boundness(DbTableCommon *tb,
 
 	*keyp = key;
         return MS_KEY_PARTIALLY_BOUND;
+    } else if (db_is_variable(key) >= 0) {
+        *keyp = key;    /* Guards may still bound it */
     }
 	
     return MS_KEY_UNBOUND;
@@ -102,6 +102,9 @@ int db_get_element_tree_common(Process *p, DbTableCommon *tb, TreeDbTerm *root,
                                int ndex, Eterm *ret, DbTableTree *stack_container);
 int db_member_tree_common(DbTableCommon *tb, TreeDbTerm *root, Eterm key, Eterm *ret,
                           DbTableTree *stack_container);
+int db_get_many_tree_common(Process *p, DbTableCommon *tb, TreeDbTerm *root,
+                            Eterm *keys, Uint nkeys, int member, Eterm *ret,
+                            DbTableTree *stack_container);
 int db_erase_tree_common(DbTable *tbl, TreeDbTerm **root, Eterm key, Eterm *ret,
                          DbTreeStack *stack /* NULL if no static stack */);
 int db_erase_object_tree_common(DbTable *tbl, TreeDbTerm **root, Eterm object,
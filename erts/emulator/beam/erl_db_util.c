@@ -275,9 +275,23 @@ typedef enum {
     matchSilent,
     matchSetSeqTokenFake,
     matchTrace2,
-    matchTrace3
+    matchTrace3,
+    matchSkipN, /* Skip n elements */
+    matchTupleEq /* matchTuple, skip up to element k and matchEq it */
 } MatchOps;
 
+#ifndef NO_JUMP_TABLE
+/*
+** Label addresses of the instructions in db_prog_match(), used to
+** convert a compiled program into direct threaded code.
+*/
+static void * const *dmc_jump_table;
+static Uint dmc_num_ops;
+static int dmc_threaded = 1;
+
+static void dmc_thread_text(UWord *text, Uint size);
+#endif
+
 /*
 ** Guard bif's
 */
@@ -1508,6 +1522,25 @@ void db_initialize_util(void){
 	  (int (*)(const void *, const void *)) &cmp_guard_bif);
     match_pseudo_process_init();
     erts_atomic32_init_nob(&trace_control_word, 0);
+#ifndef NO_JUMP_TABLE
+    /* Fetch the label addresses */
+    db_prog_match(NULL, NULL, NULL, NIL, NULL, 0, 0, NULL);
+#endif
+}
+
+/*
+** Select if new match programs are compiled into direct threaded code
+** or interpreted with a switch (for benchmarks). Returns 0 if threaded
+** code is not supported.
+*/
+int db_match_set_threaded(int on)
+{
+#ifndef NO_JUMP_TABLE
+    dmc_threaded = on;
+    return 1;
+#else
+    return 0;
+#endif
 }
 
 
@@ -1544,6 +1577,8 @@ Binary *db_match_compile(Eterm *matchexpr,
     Eterm t;
     Uint i;
     Uint num_iters;
+    Uint skip;
+    Sint tuple_start;
     int structure_checked;
     DMCRet res;
     int current_try_label;
@@ -1695,17 +1730,45 @@ restart:
 		    goto simple_term;
 		}
 		num_iters = arityval(*tuple_val(t));
+		tuple_start = -1;
 		if (!structure_checked) { /* i.e. we did not 
 					     pop it */
+		    tuple_start = DMC_STACK_NUM(text);
 		    DMC_PUSH2(text, matchTuple, num_iters);
 		}
 		structure_checked = 0;
+		skip = 0;
 		for (i = 1; i <= num_iters; ++i) {
+		    Eterm elem = tuple_val(t)[i];
+
+		    /* Skips are emitted lazily, trailing ones not at all */
+		    if (elem == am_Underscore) {
+			++skip;
+			continue;
+		    }
+		    if (tuple_start >= 0 && !(flags & DCOMP_TRACE)
+			&& is_immed(elem) && db_is_variable(elem) < 0) {
+			/* The first element checked is a constant, replace
+			   matchTuple, matchSkip... matchEq */
+			DMC_STACK_NUM(text) = tuple_start;
+			DMC_PUSH2(text, matchTupleEq, num_iters);
+			DMC_PUSH2(text, i, elem);
+			tuple_start = -1;
+			skip = 0;
+			continue;
+		    }
+		    tuple_start = -1;
+		    if (skip == 1) {
+			DMC_PUSH(text, matchSkip);
+		    } else if (skip > 1) {
+			DMC_PUSH2(text, matchSkipN, skip);
+		    }
+		    skip = 0;
 		    if ((res = dmc_one_term(&context, 
 					    &heap, 
 					    &stack, 
 					    &text, 
-					    tuple_val(t)[i]))
+					    elem))
 			!= retOk) {
 			if (res == retRestart) {
 			    goto restart; /* restart the 
@@ -1893,6 +1956,13 @@ restart:
 #ifdef DMC_DEBUG
     ret->prog_end = ret->text + DMC_STACK_NUM(text);
 #endif
+    ret->threaded = 0;
+#ifndef NO_JUMP_TABLE
+    if (dmc_threaded) {
+        dmc_thread_text(ret->text, DMC_STACK_NUM(text));
+        ret->threaded = 1;
+    }
+#endif
 
     /* 
      * Fall through to cleanup code, but context.save should not be free'd
@@ -1912,6 +1982,80 @@ error: /* Here is were we land when compilation failed. */
     return bp;
 }
 
+#ifndef NO_JUMP_TABLE
+
+/*
+** Size in words of the instruction at 't', including operands
+*/
+static Uint dmc_instr_size(const UWord *t)
+{
+    switch (*t) {
+    case matchPushL:
+    case matchPop:
+    case matchSwap:
+    case matchList:
+    case matchSkip:
+    case matchConsA:
+    case matchConsB:
+    case matchPushExpr:
+    case matchPushArrayAsList:
+    case matchPushArrayAsListU:
+    case matchTrue:
+    case matchSelf:
+    case matchWaste:
+    case matchReturn:
+    case matchProcessDump:
+    case matchDisplay:
+    case matchIsSeqTrace:
+    case matchSetSeqToken:
+    case matchGetSeqToken:
+    case matchSetReturnTrace:
+    case matchSetExceptionTrace:
+    case matchCatch:
+    case matchEnableTrace:
+    case matchDisableTrace:
+    case matchEnableTrace2:
+    case matchDisableTrace2:
+    case matchCaller:
+    case matchHalt:
+    case matchSilent:
+    case matchSetSeqTokenFake:
+    case matchTrace2:
+    case matchTrace3:
+	return 1;
+    case matchEqFloat:
+	return 1 + TermWords(2);
+    case matchEqRef:
+	return 1 + TermWords(thing_arityval(t[1]) + 1);
+    case matchEqBig:
+	return 1 + TermWords(BIG_ARITY(&t[1]) + 1);
+    case matchTupleEq:
+	return 4;
+    default:
+	ASSERT(*t <= matchTupleEq);
+	return 2;
+    }
+}
+
+/*
+** Replace the instructions of a compiled program with the addresses of
+** their labels in db_prog_match()
+*/
+static void dmc_thread_text(UWord *text, Uint size)
+{
+    UWord *t = text;
+    UWord *end = text + size;
+
+    while (t < end) {
+	Uint sz = dmc_instr_size(t);
+	*t = (UWord) dmc_jump_table[*t];
+	t += sz;
+    }
+    ASSERT(t == end);
+}
+
+#endif /* !NO_JUMP_TABLE */
+
 /*
 ** Free a match program (in a binary)
 */
@@ -1963,6 +2107,24 @@ static Eterm dpm_array_to_list(Process *psp, Eterm *arr, int arity)
     return ret;
 }
 
+/*
+** Instruction labels and dispatch of db_prog_match(). Unless the compiler
+** lacks computed goto, a program compiled into direct threaded code jumps
+** straight to the next instruction. Debug builds always pass the fence
+** checks at the top of the loop.
+*/
+#ifdef NO_JUMP_TABLE
+#  define DMC_OP(Op) case Op
+#  define DMC_NEXT break
+#else
+#  define DMC_OP(Op) case Op: lb_##Op
+#  ifdef DMC_DEBUG
+#    define DMC_NEXT break
+#  else
+#    define DMC_NEXT { if (threaded) goto *(void *) *pc++; break; }
+#  endif
+#endif
+
 /*
 ** Execution of the match program, this is Pam.
 ** May return THE_NON_VALUE, which is a bailout.
@@ -1978,13 +2140,13 @@ Eterm db_prog_match(Process *c_p,
 		    enum erts_pam_run_flags in_flags,
 		    Uint32 *return_flags)
 {
-    MatchProg *prog = Binary2MatchProg(bprog);
+    MatchProg *prog;
     const Eterm *ep, *tp, **sp;
     Eterm t;
     Eterm *esp;
     MatchVariable* variables;
     ErtsCodeMFA *cp;
-    const UWord *pc = prog->text;
+    const UWord *pc;
     Eterm *ehp;
     Eterm ret;
     Uint n;
@@ -2004,6 +2166,87 @@ Eterm db_prog_match(Process *c_p,
     Uint *stack_fence;
     Uint save_op;
 #endif /* DMC_DEBUG */
+#ifndef NO_JUMP_TABLE
+    static void * const jump_table[] = {
+	[matchArray] = &&lb_matchArray,
+	[matchArrayBind] = &&lb_matchArrayBind,
+	[matchTuple] = &&lb_matchTuple,
+	[matchPushT] = &&lb_matchPushT,
+	[matchPushL] = &&lb_matchPushL,
+	[matchPushM] = &&lb_matchPushM,
+	[matchPop] = &&lb_matchPop,
+	[matchSwap] = &&lb_matchSwap,
+	[matchBind] = &&lb_matchBind,
+	[matchCmp] = &&lb_matchCmp,
+	[matchEqBin] = &&lb_matchEqBin,
+	[matchEqFloat] = &&lb_matchEqFloat,
+	[matchEqBig] = &&lb_matchEqBig,
+	[matchEqRef] = &&lb_matchEqRef,
+	[matchEq] = &&lb_matchEq,
+	[matchList] = &&lb_matchList,
+	[matchMap] = &&lb_matchMap,
+	[matchKey] = &&lb_matchKey,
+	[matchSkip] = &&lb_matchSkip,
+	[matchPushC] = &&lb_matchPushC,
+	[matchConsA] = &&lb_matchConsA,
+	[matchConsB] = &&lb_matchConsB,
+	[matchMkTuple] = &&lb_matchMkTuple,
+	[matchMkFlatMap] = &&lb_matchMkFlatMap,
+	[matchMkHashMap] = &&lb_matchMkHashMap,
+	[matchCall0] = &&lb_matchCall0,
+	[matchCall1] = &&lb_matchCall1,
+	[matchCall2] = &&lb_matchCall2,
+	[matchCall3] = &&lb_matchCall3,
+	[matchPushV] = &&lb_matchPushV,
+	[matchPushVResult] = &&lb_matchPushVResult,
+	[matchPushExpr] = &&lb_matchPushExpr,
+	[matchPushArrayAsList] = &&lb_matchPushArrayAsList,
+	[matchPushArrayAsListU] = &&lb_matchPushArrayAsListU,
+	[matchTrue] = &&lb_matchTrue,
+	[matchOr] = &&lb_matchOr,
+	[matchAnd] = &&lb_matchAnd,
+	[matchOrElse] = &&lb_matchOrElse,
+	[matchAndAlso] = &&lb_matchAndAlso,
+	[matchJump] = &&lb_matchJump,
+	[matchSelf] = &&lb_matchSelf,
+	[matchWaste] = &&lb_matchWaste,
+	[matchReturn] = &&lb_matchReturn,
+	[matchProcessDump] = &&lb_matchProcessDump,
+	[matchDisplay] = &&lb_matchDisplay,
+	[matchIsSeqTrace] = &&lb_matchIsSeqTrace,
+	[matchSetSeqToken] = &&lb_matchSetSeqToken,
+	[matchGetSeqToken] = &&lb_matchGetSeqToken,
+	[matchSetReturnTrace] = &&lb_matchSetReturnTrace,
+	[matchSetExceptionTrace] = &&lb_matchSetExceptionTrace,
+	[matchCatch] = &&lb_matchCatch,
+	[matchEnableTrace] = &&lb_matchEnableTrace,
+	[matchDisableTrace] = &&lb_matchDisableTrace,
+	[matchEnableTrace2] = &&lb_matchEnableTrace2,
+	[matchDisableTrace2] = &&lb_matchDisableTrace2,
+	[matchTryMeElse] = &&lb_matchTryMeElse,
+	[matchCaller] = &&lb_matchCaller,
+	[matchHalt] = &&lb_matchHalt,
+	[matchSilent] = &&lb_matchSilent,
+	[matchSetSeqTokenFake] = &&lb_matchSetSeqTokenFake,
+	[matchTrace2] = &&lb_matchTrace2,
+	[matchTrace3] = &&lb_matchTrace3,
+	[matchSkipN] = &&lb_matchSkipN,
+	[matchTupleEq] = &&lb_matchTupleEq,
+    };
+    int threaded;
+
+    if (!bprog) {
+        dmc_jump_table = jump_table;
+        dmc_num_ops = sizeof(jump_table) / sizeof(jump_table[0]);
+        return THE_NON_VALUE;
+    }
+#endif
+
+    prog = Binary2MatchProg(bprog);
+    pc = prog->text;
+#ifndef NO_JUMP_TABLE
+    threaded = prog->threaded;
+#endif
 
     ERTS_UNDEF(n,0);
     ERTS_UNDEF(current_scheduled,NULL);
@@ -2073,24 +2316,28 @@ restart:
 	}
 	save_op = *pc;
     #endif
+#ifndef NO_JUMP_TABLE
+	if (threaded)
+	    goto *(void *) *pc++;
+#endif
 	switch (*pc++) {
-	case matchTryMeElse:
+	DMC_OP(matchTryMeElse):
 	    ASSERT(fail_label == -1);
 	    fail_label = *pc++;
-	    break;
-	case matchArray: /* only when DCOMP_TRACE, is always first
+	    DMC_NEXT;
+	DMC_OP(matchArray): /* only when DCOMP_TRACE, is always first
 			    instruction. */
 	    n = *pc++;
 	    if ((int) n != arity)
 		FAIL();
 	    ep = termp;
-	    break;
-	case matchArrayBind: /* When the array size is unknown. */
+	    DMC_NEXT;
+	DMC_OP(matchArrayBind): /* When the array size is unknown. */
 	    ASSERT(termp || arity==0);
 	    n = *pc++;
 	    variables[n].term = dpm_array_to_list(psp, termp, arity);
-	    break;
-	case matchTuple: /* *ep is a tuple of arity n */
+	    DMC_NEXT;
+	DMC_OP(matchTuple): /* *ep is a tuple of arity n */
 	    if (!is_tuple(*ep))
 		FAIL();
 	    ep = tuple_val(*ep);
@@ -2098,8 +2345,8 @@ restart:
 	    if (arityval(*ep) != n)
 		FAIL();
 	    ++ep;
-	    break;
-	case matchPushT: /* *ep is a tuple of arity n, 
+	    DMC_NEXT;
+	DMC_OP(matchPushT): /* *ep is a tuple of arity n, 
 			    push ptr to first element */
 	    if (!is_tuple(*ep))
 		FAIL();
@@ -2109,19 +2356,19 @@ restart:
 		FAIL();
 	    *sp++ = tp + 1;
 	    ++ep;
-	    break;
-	case matchList:
+	    DMC_NEXT;
+	DMC_OP(matchList):
 	    if (!is_list(*ep))
 		FAIL();
 	    ep = list_val(*ep);
-	    break;
-	case matchPushL:
+	    DMC_NEXT;
+	DMC_OP(matchPushL):
 	    if (!is_list(*ep))
 		FAIL();
 	    *sp++ = list_val(*ep);
 	    ++ep;
-	    break;
-        case matchMap:
+	    DMC_NEXT;
+        DMC_OP(matchMap):
             if (!is_map(*ep)) {
                 FAIL();
             }
@@ -2137,8 +2384,8 @@ restart:
 		}
 	    }
             ep = flatmap_val(*ep);
-            break;
-        case matchPushM:
+            DMC_NEXT;
+        DMC_OP(matchPushM):
             if (!is_map(*ep)) {
                 FAIL();
             }
@@ -2154,8 +2401,8 @@ restart:
 		}
 	    }
             *sp++ = flatmap_val(*ep++);
-            break;
-        case matchKey:
+            DMC_NEXT;
+        DMC_OP(matchKey):
             t = (Eterm) *pc++;
             tp = erts_maps_get(t, make_boxed(ep));
             if (!tp) {
@@ -2163,40 +2410,40 @@ restart:
             }
             *sp++ = ep;
             ep = tp;
-            break;
-	case matchPop:
+            DMC_NEXT;
+	DMC_OP(matchPop):
 	    ep = *(--sp);
-	    break;
-        case matchSwap:
+	    DMC_NEXT;
+        DMC_OP(matchSwap):
             tp = sp[-1];
             sp[-1] = sp[-2];
             sp[-2] = tp;
-            break;
-	case matchBind:
+            DMC_NEXT;
+	DMC_OP(matchBind):
 	    n = *pc++;
 	    variables[n].term = *ep++;
-	    break;
-	case matchCmp:
+	    DMC_NEXT;
+	DMC_OP(matchCmp):
 	    n = *pc++;
 	    if (!EQ(variables[n].term, *ep))
 		FAIL();
 	    ++ep;
-	    break;
-	case matchEqBin:
+	    DMC_NEXT;
+	DMC_OP(matchEqBin):
 	    t = (Eterm) *pc++;
 	    if (!EQ(t,*ep))
 		FAIL();
 	    ++ep;
-	    break;
-	case matchEqFloat:
+	    DMC_NEXT;
+	DMC_OP(matchEqFloat):
 	    if (!is_float(*ep))
 		FAIL();
 	    if (sys_memcmp(float_val(*ep) + 1, pc, sizeof(double)))
 		FAIL();
 	    pc += TermWords(2);
 	    ++ep;
-	    break;
-	case matchEqRef: {
+	    DMC_NEXT;
+	DMC_OP(matchEqRef): {
 	    Eterm* epc = (Eterm*)pc;
 	    if (!is_ref(*ep))
 		FAIL();
@@ -2206,9 +2453,9 @@ restart:
 	    i = thing_arityval(*epc);
 	    pc += TermWords(i+1);
 	    ++ep;
-	    break;
+	    DMC_NEXT;
 	}
-	case matchEqBig:
+	DMC_OP(matchEqBig):
 	    if (!is_big(*ep))
 		FAIL();
 	    tp = big_val(*ep);
@@ -2225,20 +2472,33 @@ restart:
 		}
 	    }
 	    ++ep;
-	    break;
-	case matchEq:
+	    DMC_NEXT;
+	DMC_OP(matchEq):
 	    t = (Eterm) *pc++;
 	    ASSERT(is_immed(t));
 	    if (t != *ep++)
 		FAIL();
-	    break;
-	case matchSkip:
+	    DMC_NEXT;
+	DMC_OP(matchSkip):
 	    ++ep;
-	    break;
+	    DMC_NEXT;
+	DMC_OP(matchSkipN):
+	    ep += *pc++;
+	    DMC_NEXT;
+	DMC_OP(matchTupleEq): /* *ep is a tuple of arity pc[0] with the
+				 immediate pc[2] as element pc[1] */
+	    if (!is_tuple(*ep))
+		FAIL();
+	    ep = tuple_val(*ep);
+	    if (arityval(*ep) != pc[0] || ep[pc[1]] != (Eterm) pc[2])
+		FAIL();
+	    ep += pc[1] + 1;
+	    pc += 3;
+	    DMC_NEXT;
 	/* 
 	 * Here comes guard & body instructions
 	 */
-	case matchPushC: /* Push constant */
+	DMC_OP(matchPushC): /* Push constant */
 	    if ((in_flags & ERTS_PAM_COPY_RESULT)
 		&& do_catch && !is_immed(*pc)) {
 		*esp++ = copy_object(*pc++, c_p);
@@ -2246,20 +2506,20 @@ restart:
 	    else {
 		*esp++ = *pc++;
 	    }
-	    break;
-	case matchConsA:
+	    DMC_NEXT;
+	DMC_OP(matchConsA):
 	    ehp = HAllocX(build_proc, 2, HEAP_XTRA);
 	    CDR(ehp) = *--esp;
 	    CAR(ehp) = esp[-1];
 	    esp[-1] = make_list(ehp);
-	    break;
-	case matchConsB:
+	    DMC_NEXT;
+	DMC_OP(matchConsB):
 	    ehp = HAllocX(build_proc, 2, HEAP_XTRA);
 	    CAR(ehp) = *--esp;
 	    CDR(ehp) = esp[-1];
 	    esp[-1] = make_list(ehp);
-	    break;
-	case matchMkTuple:
+	    DMC_NEXT;
+	DMC_OP(matchMkTuple):
 	    n = *pc++;
 	    ehp = HAllocX(build_proc, n+1, HEAP_XTRA);
 	    t = make_tuple(ehp);
@@ -2268,8 +2528,8 @@ restart:
 		*ehp++ = *--esp;
 	    }
 	    *esp++ = t;
-	    break;
-        case matchMkFlatMap:
+	    DMC_NEXT;
+        DMC_OP(matchMkFlatMap):
             n = *pc++;
             ehp = HAllocX(build_proc, MAP_HEADER_FLATMAP_SZ + n, HEAP_XTRA);
             t = *--esp;
@@ -2285,8 +2545,8 @@ restart:
                 *ehp++ = *--esp;
             }
             *esp++ = t;
-            break;
-        case matchMkHashMap:
+            DMC_NEXT;
+        DMC_OP(matchMkHashMap):
             n = *pc++;
             esp -= 2*n;
             ehp = HAllocX(build_proc, 2*n, HEAP_XTRA);
@@ -2301,8 +2561,8 @@ restart:
                 erts_factory_close(&factory);
             }
             *esp++ = t;
-            break;
-	case matchCall0:
+            DMC_NEXT;
+	DMC_OP(matchCall0):
 	    bif = (Eterm (*)(Process*, ...)) *pc++;
 	    t = (*bif)(build_proc, bif_args);
 	    if (is_non_value(t)) {
@@ -2312,8 +2572,8 @@ restart:
 		    FAIL();
 	    }
 	    *esp++ = t;
-	    break;
-	case matchCall1:
+	    DMC_NEXT;
+	DMC_OP(matchCall1):
 	    bif = (Eterm (*)(Process*, ...)) *pc++;
 	    t = (*bif)(build_proc, esp-1);
 	    if (is_non_value(t)) {
@@ -2323,8 +2583,8 @@ restart:
 		    FAIL();
 	    }
 	    esp[-1] = t;
-	    break;
-	case matchCall2:
+	    DMC_NEXT;
+	DMC_OP(matchCall2):
 	    bif = (Eterm (*)(Process*, ...)) *pc++;
 	    bif_args[0] = esp[-1];
 	    bif_args[1] = esp[-2];
@@ -2337,8 +2597,8 @@ restart:
 	    }
 	    --esp;
 	    esp[-1] = t;
-	    break;
-	case matchCall3:
+	    DMC_NEXT;
+	DMC_OP(matchCall3):
 	    bif = (Eterm (*)(Process*, ...)) *pc++;
 	    bif_args[0] = esp[-1];
 	    bif_args[1] = esp[-2];
@@ -2352,8 +2612,8 @@ restart:
 	    }
 	    esp -= 2;
 	    esp[-1] = t;
-	    break;
-	case matchPushVResult:
+	    DMC_NEXT;
+	DMC_OP(matchPushVResult):
 	    if (!(in_flags & ERTS_PAM_COPY_RESULT)) goto case_matchPushV;
 	    /* Build copy on callers heap */
 	    n = *pc++;
@@ -2364,14 +2624,14 @@ restart:
 	    #ifdef DEBUG
 	    variables[n].proc = c_p;
 	    #endif
-	    break;
-	case matchPushV:
+	    DMC_NEXT;
+	DMC_OP(matchPushV):
 	case_matchPushV:
 	    n = *pc++;
 	    ASSERT(is_value(variables[n].term));
 	    *esp++ = variables[n].term;
-	    break;
-	case matchPushExpr:
+	    DMC_NEXT;
+	DMC_OP(matchPushExpr):
 	    if (in_flags & ERTS_PAM_COPY_RESULT) {
 		Uint sz;
 		Eterm* top;
@@ -2388,8 +2648,8 @@ restart:
 	    else {
 		*esp++ = term;
 	    }
-	    break;
-	case matchPushArrayAsList:
+	    DMC_NEXT;
+	DMC_OP(matchPushArrayAsList):
 	    n = arity; /* Only happens when 'term' is an array */
 	    tp = termp;
 	    ehp = HAllocX(build_proc, n*2, HEAP_XTRA);
@@ -2402,16 +2662,16 @@ restart:
 			  had written here has undefined behaviour. */
 	    }
 	    ehp[-1] = NIL;
-	    break;
-	case matchPushArrayAsListU:
+	    DMC_NEXT;
+	DMC_OP(matchPushArrayAsListU):
 	    /* This instruction is NOT efficient. */
 	    *esp++  = dpm_array_to_list(build_proc, termp, arity);
-	    break;
-	case matchTrue:
+	    DMC_NEXT;
+	DMC_OP(matchTrue):
 	    if (*--esp != am_true)
 		FAIL();
-	    break;
-	case matchOr:
+	    DMC_NEXT;
+	DMC_OP(matchOr):
 	    n = *pc++;
 	    t = am_false;
 	    while (n--) {
@@ -2428,8 +2688,8 @@ restart:
 		}
 	    }
 	    *esp++ = t;
-	    break;
-	case matchAnd:
+	    DMC_NEXT;
+	DMC_OP(matchAnd):
 	    n = *pc++;
 	    t = am_true;
 	    while (n--) {
@@ -2446,8 +2706,8 @@ restart:
 		}
 	    }
 	    *esp++ = t;
-	    break;
-	case matchOrElse:
+	    DMC_NEXT;
+	DMC_OP(matchOrElse):
 	    n = *pc++;
 	    if (*--esp == am_true) {
 		++esp;
@@ -2460,8 +2720,8 @@ restart:
 		    FAIL();
 		}
 	    }
-	    break;
-	case matchAndAlso:
+	    DMC_NEXT;
+	DMC_OP(matchAndAlso):
 	    n = *pc++;
 	    if (*--esp == am_false) {
 		esp++;
@@ -2474,49 +2734,49 @@ restart:
 		    FAIL();
 		}
 	    }
-	    break;
-	case matchJump:
+	    DMC_NEXT;
+	DMC_OP(matchJump):
 	    n = *pc++;
 	    pc += n;
-	    break;
-	case matchSelf:
+	    DMC_NEXT;
+	DMC_OP(matchSelf):
 	    *esp++ = self->common.id;
-	    break;
-	case matchWaste:
+	    DMC_NEXT;
+	DMC_OP(matchWaste):
 	    --esp;
-	    break;
-	case matchReturn:
+	    DMC_NEXT;
+	DMC_OP(matchReturn):
 	    ret = *--esp;
-	    break;
-	case matchProcessDump: {
+	    DMC_NEXT;
+	DMC_OP(matchProcessDump): {
 	    erts_dsprintf_buf_t *dsbufp = erts_create_tmp_dsbuf(0);
             ASSERT(c_p == self);
 	    print_process_info(ERTS_PRINT_DSBUF, (void *) dsbufp, c_p, ERTS_PROC_LOCK_MAIN);
 	    *esp++ = new_binary(build_proc, (byte *)dsbufp->str,
 				dsbufp->str_len);
 	    erts_destroy_tmp_dsbuf(dsbufp);
-	    break;
+	    DMC_NEXT;
 	}
-	case matchDisplay: /* Debugging, not for production! */
+	DMC_OP(matchDisplay): /* Debugging, not for production! */
 	    erts_printf("%T\n", esp[-1]);
 	    esp[-1] = am_true;
-	    break;
-	case matchSetReturnTrace:
+	    DMC_NEXT;
+	DMC_OP(matchSetReturnTrace):
 	    *return_flags |= MATCH_SET_RETURN_TRACE;
 	    *esp++ = am_true;
-	    break;
-	case matchSetExceptionTrace:
+	    DMC_NEXT;
+	DMC_OP(matchSetExceptionTrace):
 	    *return_flags |= MATCH_SET_EXCEPTION_TRACE;
 	    *esp++ = am_true;
-	    break;
-        case matchIsSeqTrace:
+	    DMC_NEXT;
+        DMC_OP(matchIsSeqTrace):
             ASSERT(c_p == self);
             if (have_seqtrace(SEQ_TRACE_TOKEN(c_p)))
 		*esp++ = am_true;
 	    else
 		*esp++ = am_false;
-	    break;
-	case matchSetSeqToken:
+	    DMC_NEXT;
+	DMC_OP(matchSetSeqToken):
             ASSERT(c_p == self);
             t = erts_seq_trace(c_p, esp[-1], esp[-2], 0);
 	    if (is_non_value(t)) {
@@ -2525,8 +2785,8 @@ restart:
 		esp[-2] = t;
 	    }
 	    --esp;
-	    break;
-        case matchSetSeqTokenFake:
+	    DMC_NEXT;
+        DMC_OP(matchSetSeqTokenFake):
             ASSERT(c_p == self);
 	    t = seq_trace_fake(c_p, esp[-1]);
 	    if (is_non_value(t)) {
@@ -2535,8 +2795,8 @@ restart:
 		esp[-2] = t;
 	    }
 	    --esp;
-	    break;
-        case matchGetSeqToken:
+	    DMC_NEXT;
+        DMC_OP(matchGetSeqToken):
             ASSERT(c_p == self);
             if (have_no_seqtrace(SEQ_TRACE_TOKEN(c_p)))
 		*esp++ = NIL;
@@ -2555,8 +2815,8 @@ restart:
                 ehp = HAllocX(build_proc, token_sz, HEAP_XTRA);
                 *esp++ = copy_struct(token, token_sz, &ehp, &MSO(build_proc));
 	    }
-	    break;
-        case matchEnableTrace:
+	    DMC_NEXT;
+        DMC_OP(matchEnableTrace):
             ASSERT(c_p == self);
 	    if ( (n = erts_trace_flag2bit(esp[-1]))) {
                 erts_proc_lock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
@@ -2566,8 +2826,8 @@ restart:
 	    } else {
 		esp[-1] = FAIL_TERM;
 	    }
-	    break;
-        case matchEnableTrace2:
+	    DMC_NEXT;
+        DMC_OP(matchEnableTrace2):
             ASSERT(c_p == self);
 	    n = erts_trace_flag2bit((--esp)[-1]);
 	    esp[-1] = FAIL_TERM;
@@ -2582,8 +2842,8 @@ restart:
                     esp[-1] = am_true;
 		}
 	    }
-	    break;
-        case matchDisableTrace:
+	    DMC_NEXT;
+        DMC_OP(matchDisableTrace):
             ASSERT(c_p == self);
 	    if ( (n = erts_trace_flag2bit(esp[-1]))) {
                 erts_proc_lock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
@@ -2593,8 +2853,8 @@ restart:
 	    } else {
 		esp[-1] = FAIL_TERM;
 	    }
-	    break;
-        case matchDisableTrace2:
+	    DMC_NEXT;
+        DMC_OP(matchDisableTrace2):
             ASSERT(c_p == self);
 	    n = erts_trace_flag2bit((--esp)[-1]);
 	    esp[-1] = FAIL_TERM;
@@ -2609,8 +2869,8 @@ restart:
                     esp[-1] = am_true;
 		}
 	    }
-	    break;
-        case matchCaller:
+	    DMC_NEXT;
+        DMC_OP(matchCaller):
             ASSERT(c_p == self);
 	    if (!(c_p->cp) || !(cp = find_function_from_pc(c_p->cp))) {
  		*esp++ = am_undefined;
@@ -2622,12 +2882,12 @@ restart:
 		ehp[2] = cp->function;
 		ehp[3] = make_small((Uint) cp->arity);
 	    }
-	    break;
-        case matchSilent:
+	    DMC_NEXT;
+        DMC_OP(matchSilent):
             ASSERT(c_p == self);
 	    --esp;
 	    if (in_flags & ERTS_PAM_IGNORE_TRACE_SILENT)
-	      break;
+	      DMC_NEXT;
 	    if (*esp == am_true) {
 		erts_proc_lock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
 		ERTS_TRACE_FLAGS(c_p) |= F_TRACE_SILENT;
@@ -2638,8 +2898,8 @@ restart:
 		ERTS_TRACE_FLAGS(c_p) &= ~F_TRACE_SILENT;
 		erts_proc_unlock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
 	    }
-	    break;
-        case matchTrace2:
+	    DMC_NEXT;
+        DMC_OP(matchTrace2):
             ASSERT(c_p == self);
 	    {
 		/*    disable         enable                                */
@@ -2663,7 +2923,7 @@ restart:
 		    cputs ) {
 		    (--esp)[-1] = FAIL_TERM;
                     ERTS_TRACER_CLEAR(&tracer);
-		    break;
+		    DMC_NEXT;
 		}
 		erts_proc_lock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
 		(--esp)[-1] = set_match_trace(c_p, FAIL_TERM, tracer,
@@ -2671,8 +2931,8 @@ restart:
 		erts_proc_unlock(c_p, ERTS_PROC_LOCKS_ALL_MINOR);
                 ERTS_TRACER_CLEAR(&tracer);
 	    }
-	    break;
-        case matchTrace3:
+	    DMC_NEXT;
+        DMC_OP(matchTrace3):
             ASSERT(c_p == self);
 	    {
 		/*    disable         enable                                */
@@ -2693,7 +2953,7 @@ restart:
 				       tracee, ERTS_PROC_LOCKS_ALL))) {
 		    (--esp)[-1] = FAIL_TERM;
                     ERTS_TRACER_CLEAR(&tracer);
-		    break;
+		    DMC_NEXT;
 		}
 		if (tmpp == c_p) {
 		    (--esp)[-1] = set_match_trace(c_p, FAIL_TERM, tracer,
@@ -2708,16 +2968,16 @@ restart:
 		}
                 ERTS_TRACER_CLEAR(&tracer);
 	    }
-	    break;
-	case matchCatch:  /* Match success, now build result */
+	    DMC_NEXT;
+	DMC_OP(matchCatch):  /* Match success, now build result */
 	    do_catch = 1;
 	    if (in_flags & ERTS_PAM_COPY_RESULT) {
 		build_proc = c_p;
                 if (esdp)
                     esdp->current_process = c_p;
 	    }
-	    break;
-	case matchHalt:
+	    DMC_NEXT;
+	DMC_OP(matchHalt):
 	    goto success;
 	default:
 	    erts_exit(ERTS_ERROR_EXIT, "Internal error: unexpected opcode in match program.");
@@ -2754,6 +3014,8 @@ success:
 #undef FAIL
 #undef FAIL_TERM
 }
+#undef DMC_OP
+#undef DMC_NEXT
 
 
 DMCErrInfo *db_new_dmc_err_info(void) 
@@ -2985,10 +3247,353 @@ static ERTS_INLINE Uint db_alloced_size_comp(DbTerm* obj)
     return obj->tpl[arityval(*obj->tpl) + 1];
 }
 
+/*
+** Objects of tables in shared_literal read mode are kept in literal
+** areas so that lookups can return them by reference. Small objects are
+** packed into chunks, areas shared by the objects of a table, and large
+** objects get an area of their own. The space of a freed object is never
+** reused. An area is released when its last object is freed, through the
+** literal collector if a lookup has returned any of its objects, like an
+** erased persistent term. Chunks grow from DB_LITERAL_CHUNK_MIN_WORDS up
+** to DB_LITERAL_CHUNK_MAX_WORDS, so a table uses at most one collector
+** pass per chunk.
+**
+** A closed chunk whose live objects take less than 1/DB_LITERAL_SPARSE_RATIO
+** of it is queued on the table, and the table moves its remaining objects
+** to the open chunk (see db_take_sparse_literal_chunk()), so a few live
+** objects cannot keep many mostly empty chunks alive.
+**
+** The literal area collector walks an area as a heap, so the control
+** block of a chunk and the prefix of each object are preceded by thing
+** words that make them look like the data of bignums. The prefix holds
+** the chunk of the object and a flag telling if a lookup has returned
+** it, followed by the table specific header (offset) and the DbTerm
+** header.
+*/
+#define DB_LITERAL_PREFIX_WORDS 3
+#define DB_LITERAL_CHUNK_MIN_WORDS 512
+#define DB_LITERAL_CHUNK_MAX_WORDS 8192
+#define DB_LITERAL_LARGE_WORDS (DB_LITERAL_CHUNK_MAX_WORDS / 8)
+#define DB_LITERAL_SPARSE_RATIO 4
+
+typedef enum {
+    DB_LITERAL_CHUNK_DENSE,
+    DB_LITERAL_CHUNK_QUEUED,     /* in tb->literal_sparse */
+    DB_LITERAL_CHUNK_COMPACTING  /* taken by db_take_sparse_literal_chunk */
+} DbLiteralChunkState;
+
+struct db_literal_chunk {
+    Eterm* top;               /* first free word */
+    Eterm* limit;             /* end of the allocated area */
+    Uint live;                /* objects not freed, +1 while open or
+                                 compacting */
+    Uint live_words;          /* words of the objects not freed */
+    int shared;               /* a freed object had been returned */
+    DbLiteralChunkState state;
+    struct db_literal_chunk* sparse_next;
+    struct erl_off_heap_header* off_heap; /* of freed shared objects */
+};
+
+#define DB_LITERAL_CHUNK_WORDS \
+    (1 + (sizeof(DbLiteralChunk) + sizeof(Eterm) - 1) / sizeof(Eterm))
+
+static ERTS_INLINE ErtsLiteralArea* db_literal_chunk_area(DbLiteralChunk* chunk)
+{
+    return (ErtsLiteralArea*) ((byte*)chunk - sizeof(Eterm)
+                               - offsetof(ErtsLiteralArea, start));
+}
+
+static ERTS_INLINE Eterm* db_literal_prefix(void* basep)
+{
+    return (Eterm*)basep - DB_LITERAL_PREFIX_WORDS;
+}
+
+static ERTS_INLINE DbLiteralChunk* db_literal_chunk(void* basep)
+{
+    return (DbLiteralChunk*) db_literal_prefix(basep)[1];
+}
+
+static ERTS_INLINE erts_atomic_t* db_literal_shared(void* basep)
+{
+    return (erts_atomic_t*) &db_literal_prefix(basep)[2];
+}
+
+static DbLiteralChunk* db_new_literal_chunk(DbTable* tb, Uint words)
+{
+    Uint alloc_sz = ERTS_LITERAL_AREA_ALLOC_SIZE(DB_LITERAL_CHUNK_WORDS + words);
+    ErtsLiteralArea* area = erts_alloc(ERTS_ALC_T_LITERAL, alloc_sz);
+    DbLiteralChunk* chunk = (DbLiteralChunk*) &area->start[1];
+
+    area->start[0] = make_pos_bignum_header(DB_LITERAL_CHUNK_WORDS - 1);
+    area->end = &area->start[DB_LITERAL_CHUNK_WORDS + words];
+    area->off_heap = NULL;
+    chunk->top = &area->start[DB_LITERAL_CHUNK_WORDS];
+    chunk->limit = area->end;
+    chunk->live = 0;
+    chunk->live_words = 0;
+    chunk->shared = 0;
+    chunk->state = DB_LITERAL_CHUNK_DENSE;
+    chunk->sparse_next = NULL;
+    chunk->off_heap = NULL;
+    ERTS_DB_ALC_MEM_UPDATE_(tb, 0, alloc_sz);
+    return chunk;
+}
+
+/* Called when the last object of the chunk has been freed */
+static void db_release_literal_chunk(DbTable* tb, DbLiteralChunk* chunk)
+{
+    ErtsLiteralArea* area = db_literal_chunk_area(chunk);
+
+    ASSERT(chunk->live == 0);
+    ERTS_DB_ALC_MEM_UPDATE_(tb, ERTS_LITERAL_AREA_ALLOC_SIZE(chunk->limit
+                                                             - area->start),
+                            0);
+    if (chunk->shared) {
+        /* Only the used part is a heap for the collector to walk */
+        area->end = chunk->top;
+        area->off_heap = chunk->off_heap;
+        erts_queue_release_literals(NULL, area);
+    }
+    else {
+        ASSERT(chunk->off_heap == NULL);
+        erts_free(ERTS_ALC_T_LITERAL, area);
+    }
+}
+
+/* Queue a closed chunk for compaction if it has become sparse. Called
+ * with literal_mtx locked. */
+static void db_check_sparse_literal_chunk(DbTableCommon* tb,
+                                          DbLiteralChunk* chunk)
+{
+    ErtsLiteralArea* area = db_literal_chunk_area(chunk);
+
+    ASSERT(chunk->live > 0);
+    if (chunk->state == DB_LITERAL_CHUNK_DENSE
+        && chunk != tb->literal_chunk
+        && (chunk->live_words * DB_LITERAL_SPARSE_RATIO
+            < chunk->limit - &area->start[DB_LITERAL_CHUNK_WORDS])) {
+        chunk->state = DB_LITERAL_CHUNK_QUEUED;
+        chunk->sparse_next = tb->literal_sparse;
+        tb->literal_sparse = chunk;
+    }
+}
+
+/* Remove a chunk whose last object has been freed from the sparse
+ * queue. Called with literal_mtx locked. */
+static void db_unqueue_literal_chunk(DbTableCommon* tb,
+                                     DbLiteralChunk* chunk)
+{
+    DbLiteralChunk** pp = &tb->literal_sparse;
+
+    while (*pp != chunk) {
+        ASSERT(*pp != NULL);
+        pp = &(*pp)->sparse_next;
+    }
+    *pp = chunk->sparse_next;
+    chunk->state = DB_LITERAL_CHUNK_DENSE;
+}
+
+static byte* db_alloc_term_literal(DbTableCommon* tb, Uint offset, Uint size)
+{
+    Uint hdr_words = (offset + offsetof(DbTerm,tpl)) / sizeof(Eterm);
+    Uint words = DB_LITERAL_PREFIX_WORDS + hdr_words + size;
+    DbLiteralChunk* chunk;
+    DbLiteralChunk* closed = NULL;
+    Eterm* prefix;
+
+    ERTS_CT_ASSERT(sizeof(erts_atomic_t) == sizeof(Eterm));
+    ASSERT(tb->shared_literal);
+    ASSERT(hdr_words * sizeof(Eterm) == offset + offsetof(DbTerm,tpl));
+
+    erts_mtx_lock(&tb->literal_mtx);
+    if (words > DB_LITERAL_LARGE_WORDS) {
+        chunk = db_new_literal_chunk((DbTable*)tb, words);
+    }
+    else {
+        chunk = tb->literal_chunk;
+        if (!chunk || chunk->limit - chunk->top < words) {
+            Uint chunk_words = DB_LITERAL_CHUNK_MIN_WORDS;
+            if (chunk) {
+                ErtsLiteralArea* area = db_literal_chunk_area(chunk);
+                chunk_words = 2 * (chunk->limit
+                                   - &area->start[DB_LITERAL_CHUNK_WORDS]);
+                if (chunk_words > DB_LITERAL_CHUNK_MAX_WORDS)
+                    chunk_words = DB_LITERAL_CHUNK_MAX_WORDS;
+                tb->literal_chunk = NULL;
+                if (--chunk->live == 0)
+                    closed = chunk;
+                else
+                    db_check_sparse_literal_chunk(tb, chunk);
+            }
+            chunk = db_new_literal_chunk((DbTable*)tb, chunk_words);
+            chunk->live = 1;
+            tb->literal_chunk = chunk;
+        }
+    }
+    prefix = chunk->top;
+    chunk->top += words;
+    chunk->live++;
+    chunk->live_words += words;
+    erts_mtx_unlock(&tb->literal_mtx);
+
+    if (closed)
+        db_release_literal_chunk((DbTable*)tb, closed);
+
+    prefix[0] = make_pos_bignum_header(DB_LITERAL_PREFIX_WORDS - 1 + hdr_words);
+    prefix[1] = (Eterm) chunk;
+    erts_atomic_init_nob((erts_atomic_t*) &prefix[2], 0);
+    return (byte*) &prefix[DB_LITERAL_PREFIX_WORDS];
+}
+
+static void db_free_term_literal(DbTable *tb, void* basep, Uint offset)
+{
+    DbTerm* db = (DbTerm*) ((byte*)basep + offset);
+    DbLiteralChunk* chunk = db_literal_chunk(basep);
+    struct erl_off_heap_header* oh = db->first_oh;
+    int shared = erts_atomic_read_nob(db_literal_shared(basep));
+    Uint words = (DB_LITERAL_PREFIX_WORDS
+                  + (offset + offsetof(DbTerm,tpl)) / sizeof(Eterm)
+                  + db->size);
+    int release;
+
+    if (!shared) {
+        /* Nobody refers to it, its off heap data can go now */
+        ErlOffHeap tmp_oh;
+        tmp_oh.first = oh;
+        erts_cleanup_offheap(&tmp_oh);
+        oh = NULL;
+    }
+
+    erts_mtx_lock(&tb->common.literal_mtx);
+    if (oh) {
+        struct erl_off_heap_header* last = oh;
+        while (last->next)
+            last = last->next;
+        last->next = chunk->off_heap;
+        chunk->off_heap = oh;
+    }
+    if (shared)
+        chunk->shared = 1;
+    ASSERT(chunk->live > 0 && chunk->live_words >= words);
+    chunk->live_words -= words;
+    release = (--chunk->live == 0);
+    if (!release)
+        db_check_sparse_literal_chunk(&tb->common, chunk);
+    else if (chunk->state == DB_LITERAL_CHUNK_QUEUED)
+        db_unqueue_literal_chunk(&tb->common, chunk);
+    erts_mtx_unlock(&tb->common.literal_mtx);
+
+    if (release)
+        db_release_literal_chunk(tb, chunk);
+}
+
+/* Take a sparse chunk to move the objects out of, or NULL. The chunk
+ * is kept until db_done_sparse_literal_chunk(). */
+DbLiteralChunk* db_take_sparse_literal_chunk(DbTable *tb)
+{
+    DbLiteralChunk* chunk;
+
+    erts_mtx_lock(&tb->common.literal_mtx);
+    chunk = tb->common.literal_sparse;
+    if (chunk) {
+        ASSERT(chunk->state == DB_LITERAL_CHUNK_QUEUED);
+        tb->common.literal_sparse = chunk->sparse_next;
+        chunk->state = DB_LITERAL_CHUNK_COMPACTING;
+        chunk->live++;
+    }
+    erts_mtx_unlock(&tb->common.literal_mtx);
+    return chunk;
+}
+
+/* Step through the objects of a chunk taken by
+ * db_take_sparse_literal_chunk(), starting with *posp == NULL. Freed
+ * objects are included, the caller must check that an object is still
+ * in the table before moving it. */
+void* db_next_literal_object(DbLiteralChunk* chunk, Eterm** posp)
+{
+    Eterm* prefix = *posp;
+    DbTerm* db;
+
+    ASSERT(chunk->state == DB_LITERAL_CHUNK_COMPACTING);
+    if (!prefix)
+        prefix = &db_literal_chunk_area(chunk)->start[DB_LITERAL_CHUNK_WORDS];
+    if (prefix >= chunk->top)
+        return NULL;
+    db = (DbTerm*) ((byte*)&prefix[1 + thing_arityval(prefix[0])]
+                    - offsetof(DbTerm,tpl));
+    *posp = &db->tpl[db->size];
+    return &prefix[DB_LITERAL_PREFIX_WORDS];
+}
+
+void db_done_sparse_literal_chunk(DbTable *tb, DbLiteralChunk* chunk)
+{
+    int release;
+
+    erts_mtx_lock(&tb->common.literal_mtx);
+    ASSERT(chunk->state == DB_LITERAL_CHUNK_COMPACTING);
+    chunk->state = DB_LITERAL_CHUNK_DENSE;
+    release = (--chunk->live == 0);
+    erts_mtx_unlock(&tb->common.literal_mtx);
+
+    if (release)
+        db_release_literal_chunk(tb, chunk);
+}
+
+/* Release the chunk objects are currently allocated from, once the
+ * table has been emptied */
+void db_close_literal_chunk(DbTable *tb)
+{
+    DbLiteralChunk* chunk;
+    int release = 0;
+
+    erts_mtx_lock(&tb->common.literal_mtx);
+    chunk = tb->common.literal_chunk;
+    tb->common.literal_chunk = NULL;
+    if (chunk)
+        release = (--chunk->live == 0);
+    erts_mtx_unlock(&tb->common.literal_mtx);
+
+    if (release)
+        db_release_literal_chunk(tb, chunk);
+}
+
+static void* db_store_term_literal(DbTableCommon *tb, Uint offset, Eterm obj)
+{
+    Uint size = size_object(obj);
+    byte* basep = db_alloc_term_literal(tb, offset, size);
+    DbTerm* newp = (DbTerm*) (basep + offset);
+    Eterm* top = newp->tpl;
+    ErlOffHeap tmp_offheap;
+
+    newp->size = size;
+    tmp_offheap.first = NULL;
+    copy_struct(obj, size, &top, &tmp_offheap);
+    newp->first_oh = tmp_offheap.first;
+#ifdef DEBUG_CLONE
+    newp->debug_clone = NULL;
+#endif
+    return basep;
+}
+
+/* Return a stored object by reference. Called with the object's
+ * lock held, which orders the flag before any later free. */
+Eterm db_share_literal_object(void* basep, Uint offset)
+{
+    erts_atomic_t* shared = db_literal_shared(basep);
+
+    if (!erts_atomic_read_nob(shared))
+        erts_atomic_set_nob(shared, 1);
+    return make_tuple(((DbTerm*) ((byte*)basep + offset))->tpl);
+}
+
 void db_free_term(DbTable *tb, void* basep, Uint offset)
 {
     DbTerm* db = (DbTerm*) ((byte*)basep + offset);
     Uint size;
+    if (tb->common.shared_literal) {
+        db_free_term_literal(tb, basep, offset);
+        return;
+    }
     if (tb->common.compress) {
 	db_cleanup_offheap_comp(db);
 	size = db_alloced_size_comp(db);
@@ -3002,6 +3607,19 @@ void db_free_term(DbTable *tb, void* basep, Uint offset)
     erts_db_free(ERTS_ALC_T_DB_TERM, tb, basep, size);
 }
 
+/* Size of the block that db_free_term would free */
+Uint db_alloced_size_term(DbTable *tb, void* basep, Uint offset)
+{
+    DbTerm* db = (DbTerm*) ((byte*)basep + offset);
+    if (tb->common.shared_literal)
+        return (DB_LITERAL_PREFIX_WORDS*sizeof(Eterm)
+                + offset + offsetof(DbTerm,tpl) + db->size*sizeof(Eterm));
+    if (tb->common.compress)
+	return db_alloced_size_comp(db);
+    else
+	return offset + offsetof(DbTerm,tpl) + db->size*sizeof(Eterm);
+}
+
 static ERTS_INLINE Uint align_up(Uint value, Uint pow2)
 {
     ASSERT((pow2 & (pow2-1)) == 0);
@@ -3098,9 +3716,15 @@ void* db_store_term(DbTableCommon *tb, DbTerm* old, Uint offset, Eterm obj)
     byte* basep;
     DbTerm* newp;
     Eterm* top;
-    int size = size_object(obj);
+    int size;
     ErlOffHeap tmp_offheap;
 
+    if (tb->shared_literal) {
+        /* Never updated in place, see replace_dbterm() in erl_db_hash.c */
+        ASSERT(old == NULL);
+        return db_store_term_literal(tb, offset, obj);
+    }
+    size = size_object(obj);
     if (old != 0) {
 	basep = ((byte*) old) - offset;
 	tmp_offheap.first  = old->first_oh;
@@ -3178,7 +3802,9 @@ void db_finalize_resize(DbUpdateHandle* handle, Uint offset)
 	(tbl->common.compress ?
 	 db_size_dbterm_comp(&tbl->common, make_tuple(handle->dbterm->tpl)) :
 	 sizeof(DbTerm)+sizeof(Eterm)*(handle->new_size-1));
-    byte* newp = erts_db_alloc(ERTS_ALC_T_DB_TERM, tbl, alloc_sz);
+    byte* newp = (tbl->common.shared_literal ?
+                  db_alloc_term_literal(&tbl->common, offset, handle->new_size) :
+                  erts_db_alloc(ERTS_ALC_T_DB_TERM, tbl, alloc_sz));
     byte* oldp = *(handle->bp);
 
     sys_memcpy(newp, oldp, offset);  /* copy only hash/tree header */
@@ -3464,6 +4090,217 @@ int db_has_variable(Eterm node) {
     return 0;
 }
 
+
+/*
+** Key range extraction for ordered tables.
+**
+** Comparison guards like {'>=', '$1', Low} and {'<', '$1', High}, on
+** variables in the key of a match head, restrict the keys that can
+** match. Substituting the bounds for the variables gives partially bound
+** keys that are lower and upper bounds of the matching keys, as every
+** matching key is element-wise at least (at most) the substituted key.
+** The bounds are only used to limit tree traversal; the match program
+** still evaluates all guards.
+*/
+
+#define DB_KEY_RANGE_MAX_VARS  8
+#define DB_KEY_RANGE_MAX_DEPTH 8
+
+typedef struct {
+    Eterm var;
+    Eterm low;      /* THE_NON_VALUE if unbounded */
+    Eterm high;     /* THE_NON_VALUE if unbounded */
+} DbKeyRangeVar;
+
+typedef struct {
+    DbKeyRangeVar vars[DB_KEY_RANGE_MAX_VARS];
+    int num_vars;
+} DbKeyRange;
+
+/* Constant operand of a guard comparison, not containing variables */
+static int key_range_const(Eterm c, Eterm *valp)
+{
+    if (is_atom(c)) {
+        if (c == am_DollarUnderscore || c == am_DollarDollar ||
+            db_is_variable(c) >= 0) {
+            return 0;
+        }
+    } else if (is_tuple(c)) {
+        Eterm *tp = tuple_val(c);
+        if (arityval(*tp) != 2 || tp[1] != am_const) {
+            return 0;
+        }
+        c = tp[2];
+    } else if (is_list(c) || is_map(c)) {
+        return 0;
+    }
+    *valp = c;
+    return 1;
+}
+
+static void key_range_add(DbKeyRange *kr, Eterm var, Eterm op, Eterm c)
+{
+    DbKeyRangeVar *v;
+    int i;
+
+    for (i = 0; i < kr->num_vars && kr->vars[i].var != var; i++)
+        ;
+    if (i == kr->num_vars) {
+        if (i == DB_KEY_RANGE_MAX_VARS)
+            return;
+        kr->vars[i].var = var;
+        kr->vars[i].low = THE_NON_VALUE;
+        kr->vars[i].high = THE_NON_VALUE;
+        kr->num_vars++;
+    }
+    v = &kr->vars[i];
+    if (op != am_Lt && op != am_Le) {
+        /* >, >=, ==, =:= */
+        if (is_non_value(v->low) || CMP(c, v->low) > 0)
+            v->low = c;
+    }
+    if (op != am_Gt && op != am_Ge) {
+        /* <, =<, ==, =:= */
+        if (is_non_value(v->high) || CMP(c, v->high) < 0)
+            v->high = c;
+    }
+}
+
+static void key_range_guard(DbKeyRange *kr, Eterm guard, int depth)
+{
+    Eterm *tp;
+    Eterm op, c;
+    Uint arity, i;
+
+    if (!is_tuple(guard) || depth > DB_KEY_RANGE_MAX_DEPTH)
+        return;
+    tp = tuple_val(guard);
+    arity = arityval(*tp);
+    if (arity == 0)
+        return;
+    switch (tp[1]) {
+    case am_and:
+    case am_andalso:
+        for (i = 2; i <= arity; i++)
+            key_range_guard(kr, tp[i], depth + 1);
+        return;
+    case am_Lt: case am_Le: case am_Gt: case am_Ge:
+    case am_Eq: case am_Eqeq:
+        if (arity != 3)
+            return;
+        op = tp[1];
+        if (db_is_variable(tp[2]) >= 0 && key_range_const(tp[3], &c)) {
+            key_range_add(kr, tp[2], op, c);
+        } else if (db_is_variable(tp[3]) >= 0 && key_range_const(tp[2], &c)) {
+            /* Constant on the left, mirror the comparison */
+            switch (op) {
+            case am_Lt: op = am_Gt; break;
+            case am_Le: op = am_Ge; break;
+            case am_Gt: op = am_Lt; break;
+            case am_Ge: op = am_Le; break;
+            }
+            key_range_add(kr, tp[3], op, c);
+        }
+        return;
+    default:
+        return;
+    }
+}
+
+/*
+** Copy tuples and lists of the key, replacing bounded variables. Does
+** not allocate more than size_object(key) words.
+*/
+static Eterm key_range_subst(DbKeyRange *kr, Eterm key, int high,
+                             Eterm **hpp, int depth, int *changed)
+{
+    int i;
+
+    if (is_atom(key)) {
+        for (i = 0; i < kr->num_vars; i++) {
+            if (kr->vars[i].var == key) {
+                Eterm bound = high ? kr->vars[i].high : kr->vars[i].low;
+                if (is_value(bound)) {
+                    *changed = 1;
+                    return bound;
+                }
+                break;
+            }
+        }
+        return key;
+    }
+    if (depth > DB_KEY_RANGE_MAX_DEPTH) {
+        /* Leaving variables in place only widens the range */
+        return key;
+    }
+    if (is_tuple(key)) {
+        Eterm *tp = tuple_val(key);
+        Uint arity = arityval(*tp);
+        Eterm *hp = *hpp;
+        Uint j;
+
+        *hpp += arity + 1;
+        hp[0] = tp[0];
+        for (j = 1; j <= arity; j++)
+            hp[j] = key_range_subst(kr, tp[j], high, hpp, depth + 1, changed);
+        return make_tuple(hp);
+    }
+    if (is_list(key)) {
+        Eterm res;
+        Eterm *tailp = &res;
+
+        while (is_list(key)) {
+            Eterm *cons = list_val(key);
+            Eterm *hp = *hpp;
+
+            *hpp += 2;
+            *tailp = make_list(hp);
+            hp[0] = key_range_subst(kr, CAR(cons), high, hpp, depth + 1,
+                                    changed);
+            tailp = &hp[1];
+            key = CDR(cons);
+        }
+        *tailp = key_range_subst(kr, key, high, hpp, depth + 1, changed);
+        return res;
+    }
+    return key;
+}
+
+/*
+** Narrows the (partially bound or variable) key of a match head using
+** the comparison guards of the same head. Returns 1 with the bounds in
+** *lowp and *highp, allocated on the heap of p, if any variable in the
+** key is restricted, otherwise 0.
+*/
+int db_match_key_range(Process *p, Eterm key, Eterm guards,
+                       Eterm *lowp, Eterm *highp)
+{
+    DbKeyRange kr;
+    Eterm low, high;
+    Eterm *hp, *hend;
+    Uint sz;
+    int changed = 0;
+
+    kr.num_vars = 0;
+    for (; is_list(guards); guards = CDR(list_val(guards)))
+        key_range_guard(&kr, CAR(list_val(guards)), 0);
+    if (kr.num_vars == 0)
+        return 0;
+
+    sz = size_object(key);
+    hp = HAlloc(p, 2 * sz);
+    hend = hp + 2 * sz;
+    low = key_range_subst(&kr, key, 0, &hp, 0, &changed);
+    high = key_range_subst(&kr, key, 1, &hp, 0, &changed);
+    ASSERT(hp <= hend);
+    HRelease(p, hend, hp);
+    if (!changed)
+        return 0;
+    *lowp = low;
+    *highp = high;
+    return 1;
+}
+
 /* 
 ** Local (static) utilities.
 */
@@ -5381,6 +6218,22 @@ Eterm db_match_dbterm(DbTableCommon* tb, Process* c_p, Binary* bprog,
 /*
 ** Disassemble match program
 */
+/* The instruction of a (possibly direct threaded) program */
+static UWord dmc_dis_op(MatchProg *prog, UWord instr)
+{
+#ifndef NO_JUMP_TABLE
+    Uint op;
+
+    if (prog->threaded) {
+	for (op = 0; op < dmc_num_ops; op++) {
+	    if ((UWord) dmc_jump_table[op] == instr)
+		return op;
+	}
+    }
+#endif
+    return instr;
+}
+
 void db_match_dis(Binary *bp)
 {
     MatchProg *prog = Binary2MatchProg(bp);
@@ -5391,7 +6244,7 @@ void db_match_dis(Binary *bp)
     ErlHeapFragment *tmp;
 
     while (t < prog->prog_end) {
-	switch (*t) {
+	switch (dmc_dis_op(prog, *t)) {
 	case matchTryMeElse:
 	    ++t;
 	    n = *t;
@@ -5555,6 +6408,19 @@ void db_match_dis(Binary *bp)
 	    ++t;
 	    erts_printf("Skip\n");
 	    break;
+	case matchSkipN:
+	    ++t;
+	    n = *t;
+	    ++t;
+	    erts_printf("SkipN\t%beu\n", n);
+	    break;
+	case matchTupleEq:
+	    ++t;
+	    n = *t;
+	    ++t;
+	    erts_printf("TupleEq\t%beu\t%beu\t%T\n", n, t[0], (Eterm) t[1]);
+	    t += 2;
+	    break;
 	case matchPushC:
 	    ++t;
 	    p = (Eterm) *t;
@@ -56,6 +56,15 @@
 				     is broken.*/
 #define DB_ERROR_UNSPEC   -10    /* Unspecified error */
 
+/* Max number of keys passed to db_get_many in one call */
+#define DB_GET_MANY_MAX_KEYS 64
+
+/* Objects can only be shared as literals where those are recognized
+ * by address, see erts_is_literal() */
+#ifdef ERTS_HAVE_IS_IN_LITERAL_RANGE
+#  define DB_HAVE_SHARED_LITERAL
+#endif
+
 /*#define DEBUG_CLONE*/
 
 /*
@@ -75,6 +84,10 @@ typedef struct db_term {
        the start of the data, tagged as headers.
        The allocated size of the dbterm in bytes is stored at tpl[arity+1].
      */
+
+    /* Shared literal: the object lies in a literal area, see
+       db_alloc_term_literal() in erl_db_util.c.
+     */
 } DbTerm;
 
 #define DB_MUST_RESIZE 1
@@ -93,6 +106,11 @@ typedef struct {
     union {
         struct {
             erts_rwmtx_t* lck;
+            /* Tables with lock-free reads update a private copy that
+             * is linked in at 'publish_bp' by db_finalize_dbterm */
+            void** publish_bp;
+            void* copy;
+            void* replaced;
         } hash;
         struct {
             struct DbTableCATreeNode* base_node;
@@ -143,6 +161,14 @@ typedef struct db_table_method
     int (*db_member)(DbTable* tb, /* [in out] */ 
 		     Eterm key, 
 		     Eterm* ret);
+    /* Lookup (or check membership of) up to DB_GET_MANY_MAX_KEYS keys,
+    ** the result for keys[i] is stored in ret[i]. */
+    int (*db_get_many)(Process* p,
+                       DbTable* tb, /* [in out] */
+                       Eterm* keys,
+                       Uint nkeys,
+                       int member,
+                       Eterm* ret);
     int (*db_erase)(DbTable* tb,  /* [in out] */ 
 		    Eterm key, 
 		    Eterm* ret);
@@ -265,6 +291,9 @@ typedef struct {
 #define ERTS_DB_TABLE_NITEMS_COUNTER_ID 0
 #define ERTS_DB_TABLE_MEM_COUNTER_ID 1
 
+/* Literal area holding objects of a shared_literal table */
+typedef struct db_literal_chunk DbLiteralChunk;
+
 /*
  * This structure contains data for all different types of database
  * tables. Note that these fields must match the same fields
@@ -304,6 +333,10 @@ typedef struct db_table_common {
     Uint32 status;            /* bit masks defined  below */
     int keypos;               /* defaults to 1 */
     int compress;
+    int shared_literal;       /* objects in literal areas, see DbTerm */
+    DbLiteralChunk* literal_chunk; /* chunk shared literals are put in */
+    DbLiteralChunk* literal_sparse; /* closed chunks to compact */
+    erts_mtx_t literal_mtx;   /* Protects literal chunks */
 
 #ifdef ETS_DBG_FORCE_TRAP
     erts_atomic_t dbg_force_trap;  /* &1 force enabled, &2 trap this call */
@@ -414,13 +447,21 @@ void db_initialize_util(void);
 Eterm db_getkey(int keypos, Eterm obj);
 void db_cleanup_offheap_comp(DbTerm* p);
 void db_free_term(DbTable *tb, void* basep, Uint offset);
+Uint db_alloced_size_term(DbTable *tb, void* basep, Uint offset);
 void* db_store_term(DbTableCommon *tb, DbTerm* old, Uint offset, Eterm obj);
 void* db_store_term_comp(DbTableCommon *tb, DbTerm* old, Uint offset, Eterm obj);
+Eterm db_share_literal_object(void* basep, Uint offset);
+void db_close_literal_chunk(DbTable *tb);
+DbLiteralChunk* db_take_sparse_literal_chunk(DbTable *tb);
+void* db_next_literal_object(DbLiteralChunk* chunk, Eterm** posp);
+void db_done_sparse_literal_chunk(DbTable *tb, DbLiteralChunk* chunk);
 Eterm db_copy_element_from_ets(DbTableCommon* tb, Process* p, DbTerm* obj,
 			       Uint pos, Eterm** hpp, Uint extra);
 int db_has_map(Eterm obj);
 int db_has_variable(Eterm obj);
 int db_is_variable(Eterm obj);
+int db_match_key_range(Process *p, Eterm key, Eterm guards,
+                       Eterm *lowp, Eterm *highp);
 void db_do_update_element(DbUpdateHandle* handle,
 			  Sint position,
 			  Eterm newval);
@@ -431,6 +472,7 @@ Binary *db_match_set_compile(Process *p, Eterm matchexpr,
 			     Uint flags);
 int db_match_keeps_key(int keypos, Eterm match, Eterm guard, Eterm body);
 int erts_db_match_prog_destructor(Binary *);
+int db_match_set_threaded(int on);
 
 typedef struct match_prog {
     ErlHeapFragment *term_save; /* Only if needed, a list of message 
@@ -444,6 +486,7 @@ typedef struct match_prog {
     Eterm saved_program;
     Uint heap_size;          /* size of: heap + eheap + stack */
     Uint stack_offset;
+    int threaded;            /* Instructions are label addresses */
 #ifdef DMC_DEBUG
     UWord* prog_end;		/* End of program */
 #endif
@@ -46,6 +46,16 @@ typedef enum {
     ERTS_FLXCTR_SNAPSHOT_ONGOING_TP_THREAD_DO_FREE = 2
 } erts_flxctr_snapshot_status;
 
+static void
+thr_prg_free_snapshot_array(void* bin_p)
+{
+    Binary* bin = bin_p;
+    DecentralizedReadSnapshotInfo* info = ERTS_MAGIC_BIN_DATA(bin);
+    /* No approximate reader can still be reading the old array */
+    erts_free(info->alloc_type, info->array->block_start);
+    erts_bin_release(bin);
+}
+
 static void
 thr_prg_wake_up_and_count(void* bin_p)
 {
@@ -66,6 +76,9 @@ thr_prg_wake_up_and_count(void* bin_p)
                 erts_atomic_read_nob(&array->array[sched].counters[i]);
         }
     }
+    /* Make approximate readers stop adding the values of the old
+       array before they are moved to the next array */
+    erts_atomic_set_mb(&next->snapshot_prev, (erts_aint_t)NULL);
     /* Update the next decentralized counter array */
     for (i = 0; i < info->nr_of_counters; i++) {
         erts_atomic_add_nob(&next->array[0].counters[i], info->result[i]);
@@ -85,11 +98,14 @@ thr_prg_wake_up_and_count(void* bin_p)
     if (!ERTS_PROC_IS_EXITING(p)) {
         erts_resume(p, ERTS_PROC_LOCK_STATUS);
     }
-    /* Free the memory that is no longer needed */
-    erts_free(info->alloc_type, array->block_start);
     erts_proc_unlock(p, ERTS_PROC_LOCK_STATUS);
     erts_proc_dec_refc(p);
-    erts_bin_release(bin);
+    /* Approximate readers that loaded snapshot_prev before it was
+       cleared may still be summing the old array; free it after
+       another thread progress */
+    erts_schedule_thr_prgr_later_op(thr_prg_free_snapshot_array,
+                                    bin,
+                                    &info->later_op);
 }
 
 typedef struct {
@@ -166,6 +182,7 @@ create_decentralized_ctr_array(ErtsAlcType_t alloc_type, Uint nr_of_counters) {
     ASSERT(((Uint)array - (Uint)block_start) <= ERTS_CACHE_LINE_SIZE);
     /* Initialize fields */
     erts_atomic_init_nob(&array->snapshot_status, ERTS_FLXCTR_SNAPSHOT_ONGOING);
+    erts_atomic_init_nob(&array->snapshot_prev, (erts_aint_t)NULL);
     for (sched = 0; sched < ERTS_FLXCTR_DECENTRALIZED_NO_SLOTS; sched++) {
         for (i = 0; i < nr_of_counters; i++) {
             erts_atomic_init_nob(&array->array[sched].counters[i], 0);
@@ -248,7 +265,9 @@ erts_flxctr_snapshot(ErtsFlxCtr* c,
             DecentralizedReadSnapshotInfo* info;
             ErtsFlxCtrDecentralizedCtrArray* new_array =
                 create_decentralized_ctr_array(alloc_type, c->nr_of_counters);
-            int success =
+            int success;
+            erts_atomic_init_nob(&new_array->snapshot_prev, (erts_aint_t)array);
+            success =
                 ((Sint)array) == erts_atomic_cmpxchg_mb(&c->u.counters_ptr,
                                                         (Sint)new_array,
                                                         (Sint)array);
@@ -315,17 +334,48 @@ int erts_flxctr_is_snapshot_result(Eterm term)
     } else return 0;
 }
 
+static ERTS_INLINE Sint
+sum_decentralized_ctr(ErtsFlxCtrDecentralizedCtrArray* counter,
+                      Uint counter_nr)
+{
+    Sint sum = 0;
+    int sched;
+    for (sched = 0; sched < ERTS_FLXCTR_DECENTRALIZED_NO_SLOTS; sched++) {
+        sum = sum + erts_atomic_read_nob(&counter->array[sched].counters[counter_nr]);
+    }
+    return sum;
+}
+
 Sint erts_flxctr_read_approx(ErtsFlxCtr* c,
                              Uint counter_nr)
 {
     if (c->is_decentralized) {
         ErtsFlxCtrDecentralizedCtrArray* counter = ERTS_FLXCTR_GET_CTR_ARRAY_PTR(c);
-        Sint sum = 0;
-        int sched;
-        for (sched = 0; sched < ERTS_FLXCTR_DECENTRALIZED_NO_SLOTS; sched++) {
-            sum = sum + erts_atomic_read_nob(&counter->array[sched].counters[counter_nr]);
+        while (1) {
+            ErtsFlxCtrDecentralizedCtrArray* prev =
+                (ErtsFlxCtrDecentralizedCtrArray*)
+                erts_atomic_read_acqb(&counter->snapshot_prev);
+            Sint sum;
+            if (prev == NULL) {
+                if (ERTS_FLXCTR_SNAPSHOT_NOT_ONGOING ==
+                    erts_atomic_read_acqb(&counter->snapshot_status)) {
+                    return sum_decentralized_ctr(counter, counter_nr);
+                }
+                /* The thread progress operation is moving the values
+                   of the previous array into this one; it only takes
+                   a few instructions */
+                ERTS_SPIN_BODY;
+                continue;
+            }
+            /* A snapshot is ongoing. The previous array is freed
+               only after thread progress has been passed once more
+               after snapshot_prev has been cleared. */
+            sum = sum_decentralized_ctr(prev, counter_nr) +
+                sum_decentralized_ctr(counter, counter_nr);
+            if ((erts_aint_t)prev == erts_atomic_read_mb(&counter->snapshot_prev)) {
+                return sum;
+            }
         }
-        return sum;
     } else {
         return erts_flxctr_read_centralized(c, counter_nr);
     }
@@ -135,7 +135,12 @@ void erts_flxctr_dec(ErtsFlxCtr* c,
  * @brief This function tries to return the current value of the
  * specified counter but may return an incorrect result if the counter
  * is decentralized and other threads are accessing the counter
- * concurrently.
+ * concurrently. The error is bounded by the updates that are done
+ * concurrently with the read. The function never waits for thread
+ * progress and also gives a proper estimate while a snapshot
+ * (initiated with erts_flxctr_snapshot) is ongoing. The caller needs
+ * to be a managed thread as the counter array that is being replaced
+ * by an ongoing snapshot may be read.
  *
  * @param c The ErtsFlxCtr instance to operate on
  * @param counter_nr The number of the counter within c to operate on
@@ -306,6 +311,9 @@ typedef union {
 typedef struct ErtsFlxCtrDecentralizedCtrArray {
     void* block_start;
     erts_atomic_t snapshot_status;
+    /* The array that is being summed up by an ongoing snapshot or
+       NULL */
+    erts_atomic_t snapshot_prev;
     ErtsFlxCtrDecentralizedCtrArrayElem array[];
 } ErtsFlxCtrDecentralizedCtrArray;
 
@@ -114,6 +114,72 @@ typedef struct {
     int num_roots;		/* Number of root arrays. */
 } Rootset;
 
+/*
+ * State for multi-age tenuring, see process_flag(tenure_age, N). Only
+ * allocated for processes that have set a tenure age larger than one.
+ *
+ * Live data in the young heap is kept ordered by age (the number of
+ * minor collections survived), oldest data at the lowest addresses.
+ * Data of age k (0 < k < N) resides in [bound(k), bound(k-1)) where
+ * bound(k) is HEAP_START + age_mark[k] for k < N-1 and bound(N-1) is
+ * the high water mark. Data of age 0 resides in [bound(0), HEAP_TOP)
+ * and in heap fragments. Data below the high water mark has survived
+ * N minor collections and is promoted by the next one.
+ */
+typedef struct erts_gc_aging {
+    Uint tenure_age;
+    Uint age_mark[ERTS_GC_MAX_TENURE_AGE-1];
+    Uint64 survived[ERTS_GC_MAX_TENURE_AGE+1]; /* words, per age */
+} ErtsGcAging;
+
+/*
+ * State of an incremental major collection, see
+ * process_flag(major_gc_slice, Words).
+ *
+ * Data on the old heap is never modified by the process, so the old
+ * heap can be marked and its live data copied to a new old heap in
+ * slices while the process keeps executing. The marking starts from a
+ * snapshot of all references into the old heap taken right after a
+ * minor collection; since no data is promoted while the collection is
+ * in progress, anything reachable later was reachable from the
+ * snapshot. The forwarding address of a live object is derived from
+ * the live bitmap, so nothing is ever written into the old heap and the
+ * collection can be abandoned at any time. It is finished by a minor
+ * collection that redirects all references from the young generation
+ * to the new old heap.
+ */
+#define ERTS_INCR_GC_START      1       /* Waiting for snapshot */
+#define ERTS_INCR_GC_MARK       2
+#define ERTS_INCR_GC_FORWARD    3       /* Counting live words per block */
+#define ERTS_INCR_GC_COPY       4
+#define ERTS_INCR_GC_DONE       5       /* Waiting for final minor gc */
+
+typedef struct {
+    Eterm *v;
+    Uint sp;
+    Uint size;
+} ErtsIncrGcStack;
+
+typedef struct erts_incr_major_gc {
+    Uint slice;                 /* Words of work per slice */
+    int phase;
+    Eterm *from;                /* Old heap being collected */
+    Eterm *from_top;
+    Uint64 *live;               /* One bit per live word in from space */
+    Uint *fwd;                  /* Live words before each 64 word block */
+    Uint nblocks;
+    Uint block;                 /* Next block to count */
+    Uint nlive;                 /* Live words in counted blocks */
+    Eterm *scan;                /* Next from space word to copy */
+    Eterm *to;                  /* New old heap */
+    Eterm *to_top;
+    Eterm *to_end;
+    ErtsIncrGcStack mark;       /* Terms left to mark */
+    ErtsIncrGcStack fixup;      /* Copied objects that may be mutated */
+    Uint old_live;              /* Old heap words after last collection */
+    Uint young_words;           /* Words minor collected since then */
+} ErtsIncrMajorGc;
+
 static Uint setup_rootset(Process*, Eterm*, int, Rootset*);
 static void cleanup_rootset(Rootset *rootset);
 static Eterm *full_sweep_heaps(Process *p,
@@ -134,6 +200,19 @@ static int minor_collection(Process* p, ErlHeapFragment *live_hf_end,
 static void do_minor(Process *p, ErlHeapFragment *live_hf_end,
 		     char *mature, Uint mature_size,
 		     Uint new_sz, Eterm* objv, int nobj);
+static void do_minor_aging(Process *p, ErlHeapFragment *live_hf_end,
+			   ErtsGcAging *aging,
+			   char *mature, Uint mature_size,
+			   Uint new_sz, Eterm* objv, int nobj);
+static void reset_gc_ages(Process *p);
+static int incr_major_gc_wanted(Process *p, Uint ygen_usage);
+static int incr_major_gc_begin(Process *p, Uint ygen_usage, int paced);
+static void incr_major_gc_count_minor(Process *p, Uint words);
+static int incr_major_gc_after_minor(Process *p, Eterm *objv, int nobj,
+                                     Uint *recl);
+static void incr_major_gc_abort(Process *p);
+static Uint incr_to_space_size(Process *p);
+static void release_off_heap_thing(struct erl_off_heap_header *ptr);
 static Eterm *sweep_new_heap(Eterm *n_hp, Eterm *n_htop,
 			     char* old_heap, Uint old_heap_size);
 static Eterm *sweep_heaps(Eterm *n_hp, Eterm *n_htop,
@@ -146,6 +225,10 @@ static Eterm* sweep_literals_to_old_heap(Eterm* heap_ptr, Eterm* heap_end, Eterm
 static Eterm* collect_live_heap_frags(Process* p, ErlHeapFragment *live_hf_end,
 				      Eterm* htop);
 static int adjust_after_fullsweep(Process *p, int need, Eterm *objv, int nobj);
+static void heap_sizing_sample_alloc(Process *p, Uint ygen_usage, int fcalls);
+static Uint heap_sizing_sample_live(Process *p, Uint need_after);
+static Uint heap_sizing_shrink(Process *p, Uint wanted, Uint predicted,
+                               Uint need_after);
 static void shrink_new_heap(Process *p, Uint new_sz, Eterm *objv, int nobj);
 static void grow_new_heap(Process *p, Uint new_sz, Eterm* objv, int nobj);
 static void sweep_off_heap(Process *p, int fullsweep);
@@ -176,6 +259,8 @@ static int num_heap_sizes;	/* Number of heap sizes. */
 
 Uint erts_test_long_gc_sleep; /* Only used for testing... */
 
+int erts_heap_sizing = ERTS_HEAP_SIZING_LAST;
+
 typedef struct {
     Process *proc;
     Eterm ref;
@@ -342,6 +427,81 @@ next_heap_size(Process* p, Uint size, Uint offset)
     return size < p->min_heap_size ? p->min_heap_size : size;
 }
 
+/*
+ * Heap size prediction (+hsp ewma).
+ *
+ * Sizing the young heap from the last collection alone makes a
+ * process whose live data alternates between small and large keep
+ * growing and shrinking its heap, paying for a reallocation and an
+ * offset pass of the heap each time. The weighted policy keeps two
+ * estimates per process: the live data after a collection, which
+ * follows increases at once but decays slowly, and the number of
+ * words allocated per reduction. The heap is only shrunk as far as
+ * the live estimate allows, and never below what the process would
+ * fill again within one time slice.
+ */
+
+#define ERTS_HEAP_SIZING_LIVE_DECAY     8       /* 1/8 of the difference per GC */
+#define ERTS_HEAP_SIZING_RATE_WEIGHT    4       /* 1/4 weight to a new sample */
+
+static void
+heap_sizing_sample_alloc(Process *p, Uint ygen_usage, int fcalls)
+{
+    Eterm *heap = p->abandoned_heap ? p->abandoned_heap : p->heap;
+    Uint survived = HIGH_WATER(p) - heap;
+    Uint allocated = ygen_usage > survived ? ygen_usage - survived : 0;
+    Uint reds = p->reds;
+    Sint elapsed;
+    Uint64 sample;
+
+    if (!ERTS_SCHEDULER_IS_DIRTY(erts_proc_sched_data(p)))
+        reds += CONTEXT_REDS - ERTS_REDS_LEFT(p, fcalls);
+    elapsed = (Sint) (reds - p->gc_reds);
+    if (elapsed <= 0)
+        elapsed = 1;
+    p->gc_reds = reds;
+
+    sample = ((Uint64) allocated * 1000) / elapsed;
+    if (sample > ERTS_UWORD_MAX)
+        sample = ERTS_UWORD_MAX;
+    if (sample >= p->alloc_rate)
+        p->alloc_rate += ((Uint) sample - p->alloc_rate) / ERTS_HEAP_SIZING_RATE_WEIGHT;
+    else
+        p->alloc_rate -= (p->alloc_rate - (Uint) sample) / ERTS_HEAP_SIZING_RATE_WEIGHT;
+}
+
+/* Returns the live estimate to size the heap after */
+static Uint
+heap_sizing_sample_live(Process *p, Uint need_after)
+{
+    if (need_after >= p->live_estimate)
+        p->live_estimate = need_after;
+    else
+        p->live_estimate -= (p->live_estimate - need_after) / ERTS_HEAP_SIZING_LIVE_DECAY;
+    return p->live_estimate;
+}
+
+/*
+ * wanted is the size to shrink the heap to after the last collection
+ * alone and predicted the size after the live estimate, 0 meaning
+ * no shrink. Returns the size to shrink to, or 0.
+ */
+static Uint
+heap_sizing_shrink(Process *p, Uint wanted, Uint predicted, Uint need_after)
+{
+    if (predicted) {
+        /* Leave room for what the process allocates in a time slice */
+        Uint64 sz = need_after + ((Uint64) p->alloc_rate) * CONTEXT_REDS / 1000;
+        if (sz > predicted)
+            predicted = sz < HEAP_SIZE(p) ? next_heap_size(p, (Uint) sz, 0) : 0;
+        if (predicted && predicted < HEAP_SIZE(p))
+            return predicted;
+    }
+    if (wanted)
+        p->resizes_avoided++;
+    return 0;
+}
+
 Eterm
 erts_heap_sizes(Process* p)
 {
@@ -648,6 +808,9 @@ check_for_possibly_long_gc(Process *p, Uint ygen_usage)
     Uint sz;
 
     major = (p->flags & F_NEED_FULLSWEEP) || GEN_GCS(p) >= MAX_GEN_GCS(p);
+    if (major && !(p->flags & F_NEED_FULLSWEEP)
+        && incr_major_gc_wanted(p, ygen_usage))
+        major = 0;
 
     sz = ygen_usage;
     sz += p->hend - p->stop;
@@ -734,11 +897,15 @@ garbage_collect(Process* p, ErlHeapFragment *live_hf_end,
         dtrace_proc_str(p, pidbuf);
     }
 #endif
+    if (erts_heap_sizing == ERTS_HEAP_SIZING_EWMA)
+        heap_sizing_sample_alloc(p, ygen_usage, fcalls);
+
     /*
      * Test which type of GC to do.
      */
 
-    if (GEN_GCS(p) < MAX_GEN_GCS(p) && !(FLAGS(p) & F_NEED_FULLSWEEP)) {
+    if ((GEN_GCS(p) < MAX_GEN_GCS(p) && !(FLAGS(p) & F_NEED_FULLSWEEP))
+        || incr_major_gc_begin(p, ygen_usage, 1)) {
         if (IS_TRACED_FL(p, F_TRACE_GC)) {
             trace_gc(p, am_gc_minor_start, need, THE_NON_VALUE);
         }
@@ -758,6 +925,8 @@ garbage_collect(Process* p, ErlHeapFragment *live_hf_end,
 	    }
             goto do_major_collection;
         }
+        if (p->flags & F_INCR_MAJOR_GC)
+            reds += incr_major_gc_after_minor(p, objv, nobj, &reclaimed_now);
         if (ERTS_SCHEDULER_IS_DIRTY(esdp))
             p->flags &= ~F_DIRTY_MINOR_GC;
         gc_trace_end_tag = am_gc_minor_end;
@@ -928,6 +1097,8 @@ garbage_collect_hibernate(Process* p, int check_long_gc)
 	}
 	p->flags = flags;
     }
+    incr_major_gc_abort(p);
+
     /*
      * Preliminaries.
      */
@@ -1005,6 +1176,7 @@ garbage_collect_hibernate(Process* p, int check_long_gc)
     p->htop = heap + actual_size;
     p->heap = heap;
     p->heap_sz = heap_size;
+    reset_gc_ages(p);
 
 
 #ifdef CHECK_FOR_HOLES
@@ -1345,6 +1517,45 @@ erts_garbage_collect_literals(Process* p, Eterm* literals,
     return (int) reds;
 }
 
+/*
+ * Excessively large heaps should be shrunk, but
+ * don't even bother on reasonable small heaps.
+ *
+ * The reason for this is that after tenuring, we often
+ * use a really small portion of new heap, therefore, unless
+ * the heap size is substantial, we don't want to shrink.
+ *
+ * Returns the size to shrink the heap to after a minor collection,
+ * or 0 if it should not be shrunk.
+ */
+static Uint
+minor_shrink_size(Process *p, Uint need_after)
+{
+    if ((HEAP_SIZE(p) > 3000) && (4 * need_after < HEAP_SIZE(p)) &&
+        ((HEAP_SIZE(p) > 8000) ||
+         (HEAP_SIZE(p) > (OLD_HEND(p) - OLD_HEAP(p))))) {
+        Uint wanted = 3 * need_after;
+        Uint old_heap_sz = OLD_HEND(p) - OLD_HEAP(p);
+
+        /*
+         * Additional test to make sure we don't make the heap too small
+         * compared to the size of the older generation heap.
+         */
+        if (wanted*9 < old_heap_sz) {
+            Uint new_wanted = old_heap_sz / 8;
+            if (new_wanted > wanted) {
+                wanted = new_wanted;
+            }
+        }
+
+        wanted = wanted < MIN_HEAP_SIZE(p) ? MIN_HEAP_SIZE(p)
+                                           : next_heap_size(p, wanted, 0);
+        if (wanted < HEAP_SIZE(p))
+            return wanted;
+    }
+    return 0;
+}
+
 static int
 minor_collection(Process* p, ErlHeapFragment *live_hf_end,
 		 int need, Eterm* objv, int nobj,
@@ -1357,6 +1568,20 @@ minor_collection(Process* p, ErlHeapFragment *live_hf_end,
     Uint debug_tmp = 0;
 #endif
 
+    /*
+     * Nothing is promoted while an incremental major collection is
+     * in progress. Instead of failing for lack of room on the old
+     * heap or old virtual heap, start one if the process wants it.
+     */
+
+    if (!(p->flags & F_INCR_MAJOR_GC)
+        && ((mature_size && OLD_HEAP(p)
+             && mature_size > OLD_HEND(p) - OLD_HTOP(p))
+            || BIN_OLD_VHEAP_SZ(p) <= BIN_OLD_VHEAP(p)))
+        (void) incr_major_gc_begin(p, ygen_usage, 0);
+    if (p->flags & F_INCR_MAJOR_GC)
+        mature_size = 0;
+
     /*
      * Check if we have gone past the max heap size limit
      */
@@ -1376,6 +1601,10 @@ minor_collection(Process* p, ErlHeapFragment *live_hf_end,
         } else if (OLD_HEAP(p))
             heap_size += OLD_HEND(p) - OLD_HEAP(p);
 
+        /* Add the new old heap of an incremental major collection */
+        if (p->flags & F_INCR_MAJOR_GC)
+            heap_size += incr_to_space_size(p);
+
         /* Add potential new young heap size */
         extra_heap_size = next_heap_size(p, stack_size + size_before, 0);
         heap_size += extra_heap_size;
@@ -1414,17 +1643,32 @@ minor_collection(Process* p, ErlHeapFragment *live_hf_end,
 
     if (OLD_HEAP(p) &&
 	((mature_size <= OLD_HEND(p) - OLD_HTOP(p)) &&
-	 ((BIN_OLD_VHEAP_SZ(p) > BIN_OLD_VHEAP(p))) ) ) {
+	 ((p->flags & F_INCR_MAJOR_GC)
+	  || (BIN_OLD_VHEAP_SZ(p) > BIN_OLD_VHEAP(p))) ) ) {
 	Eterm *prev_old_htop;
+	ErtsGcAging *aging;
 	Uint stack_size, size_after, adjust_size, need_after, new_sz, new_mature;
+        Uint wanted;
 
 	stack_size = p->hend - p->stop;
 	new_sz = stack_size + size_before;
         new_sz = next_heap_size(p, new_sz, 0);
 
 	prev_old_htop = p->old_htop;
-        do_minor(p, live_hf_end, (char *) mature, mature_size*sizeof(Eterm),
-		 new_sz, objv, nobj);
+        aging = ERTS_PROC_GET_GC_AGING(p);
+#ifdef HIPE
+        if (p->hipe.nstack)
+            aging = NULL; /* Native stack scanning assumes a single age */
+#endif
+        if (aging && !p->abandoned_heap && !(p->flags & F_INCR_MAJOR_GC))
+            do_minor_aging(p, live_hf_end, aging,
+                           (char *) mature, mature_size*sizeof(Eterm),
+                           new_sz, objv, nobj);
+        else {
+            do_minor(p, live_hf_end, (char *) mature, mature_size*sizeof(Eterm),
+                     new_sz, objv, nobj);
+            reset_gc_ages(p);
+        }
 
 	if (p->flags & F_ON_HEAP_MSGQ)
 	    move_msgs_to_heap(p);
@@ -1438,45 +1682,25 @@ minor_collection(Process* p, ErlHeapFragment *live_hf_end,
 	ErtsGcQuickSanityCheck(p);
 
         GEN_GCS(p)++;
+        if (!(p->flags & F_INCR_MAJOR_GC))
+            incr_major_gc_count_minor(p, size_before);
         need_after = ((HEAP_TOP(p) - HEAP_START(p))
                       + need
                       + stack_size);
-	
-        /*
-         * Excessively large heaps should be shrunk, but
-         * don't even bother on reasonable small heaps.
-         *
-         * The reason for this is that after tenuring, we often
-         * use a really small portion of new heap, therefore, unless
-         * the heap size is substantial, we don't want to shrink.
-         */
 
 	adjust_size = 0;
 
-        if ((HEAP_SIZE(p) > 3000) && (4 * need_after < HEAP_SIZE(p)) &&
-            ((HEAP_SIZE(p) > 8000) ||
-             (HEAP_SIZE(p) > (OLD_HEND(p) - OLD_HEAP(p))))) {
-	    Uint wanted = 3 * need_after;
-	    Uint old_heap_sz = OLD_HEND(p) - OLD_HEAP(p);
-
-	    /*
-	     * Additional test to make sure we don't make the heap too small
-	     * compared to the size of the older generation heap.
-	     */
-	    if (wanted*9 < old_heap_sz) {
-		Uint new_wanted = old_heap_sz / 8;
-		if (new_wanted > wanted) {
-		    wanted = new_wanted;
-		}
-	    }
-
-	    wanted = wanted < MIN_HEAP_SIZE(p) ? MIN_HEAP_SIZE(p)
-					       : next_heap_size(p, wanted, 0);
-            if (wanted < HEAP_SIZE(p)) {
-                shrink_new_heap(p, wanted, objv, nobj);
-		adjust_size = p->htop - p->heap;
-            }
+        wanted = minor_shrink_size(p, need_after);
+        if (erts_heap_sizing == ERTS_HEAP_SIZING_EWMA) {
+            Uint predicted = heap_sizing_sample_live(p, need_after);
+            wanted = heap_sizing_shrink(p, wanted,
+                                        minor_shrink_size(p, predicted),
+                                        need_after);
+        }
 
+        if (wanted) {
+            shrink_new_heap(p, wanted, objv, nobj);
+            adjust_size = p->htop - p->heap;
         }
         else if (need_after > HEAP_SIZE(p)) {
             grow_new_heap(p, next_heap_size(p, need_after, 0), objv, nobj);
@@ -1718,6 +1942,248 @@ do_minor(Process *p, ErlHeapFragment *live_hf_end,
     HEAP_END(p) = n_heap + new_sz;
 }
 
+/*
+ * Minor collection keeping survivors in the young heap until they have
+ * survived aging->tenure_age minor collections. Data of age k is copied
+ * into region k+1 of the new heap. The regions are laid out from the
+ * oldest to the youngest, each one as large as the area it is copied
+ * from, and the unused tail of each region is filled with a dummy
+ * bignum header so that the new heap remains walkable.
+ */
+
+typedef struct {
+    char *mature;
+    Uint mature_size;
+    char *oh;
+    Uint oh_size;
+    Uint n;
+    Eterm *bound[ERTS_GC_MAX_TENURE_AGE];
+    Eterm *top[ERTS_GC_MAX_TENURE_AGE+1];
+    Eterm *old_htop;
+} ErtsGcAgingCopy;
+
+static ERTS_INLINE Eterm **
+aging_dest(ErtsGcAgingCopy *ac, Eterm *ptr)
+{
+    if (ErtsInArea(ptr, ac->mature, ac->mature_size))
+        return &ac->old_htop;
+    if (ac->bound[ac->n-1] <= ptr && ptr < ac->bound[0]) {
+        Uint age = ac->n - 1;
+        while (ptr >= ac->bound[age-1])
+            age--;
+        return &ac->top[age+1];
+    }
+    return &ac->top[1];
+}
+
+static ERTS_INLINE void
+aging_move(ErtsGcAgingCopy *ac, Eterm *g_ptr)
+{
+    Eterm gval = *g_ptr;
+    Eterm *ptr;
+    Eterm val;
+
+    switch (primary_tag(gval)) {
+    case TAG_PRIMARY_BOXED:
+        ptr = boxed_val(gval);
+        val = *ptr;
+        if (IS_MOVED_BOXED(val)) {
+            ASSERT(is_boxed(val));
+            *g_ptr = val;
+        } else if (ErtsInYoungGen(gval, ptr, ac->oh, ac->oh_size)) {
+            move_boxed(ptr, val, aging_dest(ac, ptr), g_ptr);
+        }
+        break;
+    case TAG_PRIMARY_LIST:
+        ptr = list_val(gval);
+        val = *ptr;
+        if (IS_MOVED_CONS(val)) {
+            *g_ptr = ptr[1];
+        } else if (ErtsInYoungGen(gval, ptr, ac->oh, ac->oh_size)) {
+            move_cons(ptr, val, aging_dest(ac, ptr), g_ptr);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static Eterm *
+aging_scan(ErtsGcAgingCopy *ac, Eterm *n_hp, Uint region)
+{
+    while (n_hp != ac->top[region]) {
+        Eterm gval = *n_hp;
+        ASSERT(n_hp < ac->top[region]);
+        switch (primary_tag(gval)) {
+        case TAG_PRIMARY_BOXED:
+        case TAG_PRIMARY_LIST:
+            aging_move(ac, n_hp++);
+            break;
+        case TAG_PRIMARY_HEADER:
+            if (!header_is_thing(gval))
+                n_hp++;
+            else {
+                if (header_is_bin_matchstate(gval)) {
+                    ErlBinMatchState *ms = (ErlBinMatchState*) n_hp;
+                    ErlBinMatchBuffer *mb = &(ms->mb);
+                    Eterm orig = mb->orig;
+                    aging_move(ac, &mb->orig);
+                    if (mb->orig != orig)
+                        mb->base = binary_bytes(mb->orig);
+                }
+                n_hp += (thing_arityval(gval)+1);
+            }
+            break;
+        default:
+            n_hp++;
+            break;
+        }
+    }
+    return n_hp;
+}
+
+static void
+do_minor_aging(Process *p, ErlHeapFragment *live_hf_end,
+               ErtsGcAging *aging,
+               char *mature, Uint mature_size,
+               Uint new_sz, Eterm* objv, int nobj)
+{
+    Rootset rootset;
+    Roots* roots;
+    ErtsGcAgingCopy ac;
+    Eterm *start[ERTS_GC_MAX_TENURE_AGE+1];
+    Eterm *scan[ERTS_GC_MAX_TENURE_AGE+1];
+    Eterm *n_heap, *n_htop;
+    Uint n, k, progress;
+
+    ac.n = aging->tenure_age;
+    ASSERT(1 < ac.n && ac.n <= ERTS_GC_MAX_TENURE_AGE);
+    ac.mature = mature;
+    ac.mature_size = mature_size;
+    ac.oh = (char *) OLD_HEAP(p);
+    ac.oh_size = (char *) OLD_HTOP(p) - ac.oh;
+    ac.old_htop = OLD_HTOP(p);
+
+    /* Age bounds in the current heap, clamped to be monotonic */
+    ac.bound[ac.n-1] = HIGH_WATER(p);
+    for (k = ac.n - 1; k > 0; k--) {
+        Eterm *b = HEAP_START(p) + aging->age_mark[k-1];
+        if (b < ac.bound[k])
+            b = ac.bound[k];
+        else if (b > HEAP_TOP(p))
+            b = HEAP_TOP(p);
+        ac.bound[k-1] = b;
+    }
+
+    n_heap = (Eterm*) ERTS_HEAP_ALLOC(ERTS_ALC_T_HEAP, sizeof(Eterm)*new_sz);
+
+    /* Region k+1 receives the data of age k; the oldest region goes first */
+    start[ac.n] = n_heap;
+    for (k = ac.n; k > 1; k--)
+        start[k-1] = start[k] + (ac.bound[k-2] - ac.bound[k-1]);
+    for (k = 1; k <= ac.n; k++)
+        scan[k] = ac.top[k] = start[k];
+
+    n = setup_rootset(p, objv, nobj, &rootset);
+    roots = rootset.roots;
+
+    if (live_hf_end != ERTS_INVALID_HFRAG_PTR)
+	ac.top[1] = collect_live_heap_frags(p, live_hf_end, ac.top[1]);
+
+    while (n--) {
+        Eterm* g_ptr = roots->v;
+        Uint g_sz = roots->sz;
+
+	roots++;
+        for ( ; g_sz--; g_ptr++)
+            aging_move(&ac, g_ptr);
+    }
+
+    cleanup_rootset(&rootset);
+
+    do {
+        progress = 0;
+        for (k = 1; k <= ac.n; k++) {
+            if (scan[k] != ac.top[k]) {
+                scan[k] = aging_scan(&ac, scan[k], k);
+                progress = 1;
+            }
+        }
+    } while (progress);
+
+    if (OLD_HTOP(p) < ac.old_htop)
+	ac.old_htop = sweep_new_heap(OLD_HTOP(p), ac.old_htop,
+                                     ac.oh, ac.oh_size);
+
+    for (k = ac.n; k > 1; k--) {
+        Uint gap = start[k-1] - ac.top[k];
+        ASSERT(ac.top[k] <= start[k-1]);
+        if (gap)
+            *ac.top[k] = make_pos_bignum_header(gap-1);
+    }
+    n_htop = ac.top[1];
+
+    for (k = 1; k <= ac.n; k++)
+        aging->survived[k-1] += ac.top[k] - start[k];
+    aging->survived[ac.n] += ac.old_htop - OLD_HTOP(p);
+
+    aging->age_mark[0] = n_htop - n_heap;
+    for (k = 1; k < ac.n - 1; k++)
+        aging->age_mark[k] = start[k] - n_heap;
+
+    OLD_HTOP(p) = ac.old_htop;
+    HIGH_WATER(p) = start[ac.n-1];
+
+    if (MSO(p).first) {
+	sweep_off_heap(p, 0);
+    }
+
+#ifdef HARDDEBUG
+    disallow_heap_frag_ref_in_old_heap(p);
+#endif
+
+    /* Copy stack to end of new heap */
+    n = p->hend - p->stop;
+    ASSERT(n_htop <= n_heap + new_sz - n);
+    sys_memcpy(n_heap + new_sz - n, p->stop, n * sizeof(Eterm));
+    p->stop = n_heap + new_sz - n;
+
+#ifdef USE_VM_PROBES
+    if (HEAP_SIZE(p) != new_sz && DTRACE_ENABLED(process_heap_grow)) {
+        DTRACE_CHARBUF(pidbuf, DTRACE_TERM_BUF_SIZE);
+
+        dtrace_proc_str(p, pidbuf);
+        DTRACE3(process_heap_grow, pidbuf, HEAP_SIZE(p), new_sz);
+    }
+#endif
+
+#ifdef HARDDEBUG
+    disallow_heap_frag_ref_in_heap(p, n_heap, n_htop);
+#endif
+
+    erts_deallocate_young_generation(p);
+
+    HEAP_START(p) = n_heap;
+    HEAP_TOP(p) = n_htop;
+    HEAP_SIZE(p) = new_sz;
+    HEAP_END(p) = n_heap + new_sz;
+}
+
+/*
+ * Everything above the high water mark is considered to be of age 0
+ * after a collection that did not keep track of ages.
+ */
+static void
+reset_gc_ages(Process *p)
+{
+    ErtsGcAging *aging = ERTS_PROC_GET_GC_AGING(p);
+    if (aging) {
+        Uint k, hwm = HIGH_WATER(p) - HEAP_START(p);
+        for (k = 0; k < aging->tenure_age - 1; k++)
+            aging->age_mark[k] = hwm;
+    }
+}
+
 /*
  * Major collection. DISCARD the old heap.
  */
@@ -1738,6 +2204,8 @@ major_collection(Process* p, ErlHeapFragment *live_hf_end,
     VERBOSE(DEBUG_SHCOPY, ("[pid=%T] MAJOR GC: %p %p %p %p\n", p->common.id,
                            HEAP_START(p), HEAP_END(p), OLD_HEAP(p), OLD_HEND(p)));
 
+    incr_major_gc_abort(p);
+
     /*
      * Do a fullsweep GC. First figure out the size of the heap
      * to receive all live data.
@@ -1810,6 +2278,7 @@ major_collection(Process* p, ErlHeapFragment *live_hf_end,
     GEN_GCS(p) = 0;
 
     HIGH_WATER(p) = HEAP_TOP(p);
+    reset_gc_ages(p);
 
     if (p->flags & F_ON_HEAP_MSGQ)
 	move_msgs_to_heap(p);
@@ -1932,11 +2401,33 @@ full_sweep_heaps(Process *p,
     return n_htop;
 }
 
+/*
+ * Returns the size to shrink the heap to after a fullsweep, or 0 if
+ * it should not be shrunk.
+ */
+static Uint
+fullsweep_shrink_size(Process *p, Uint need_after)
+{
+    if (4 * need_after < HEAP_SIZE(p) && HEAP_SIZE(p) > H_MIN_SIZE){
+        /* We need less than 25% of the current heap, shrink.*/
+        /* XXX - This is how it was done in the old GC:
+           wanted = 4 * need_after;
+           I think this is better as fullsweep is used mainly on
+           small memory systems, but I could be wrong... */
+        Uint wanted = 2 * need_after;
+        Uint sz = wanted < p->min_heap_size ? p->min_heap_size
+                                            : next_heap_size(p, wanted, 0);
+        if (sz < HEAP_SIZE(p))
+            return sz;
+    }
+    return 0;
+}
+
 static int
 adjust_after_fullsweep(Process *p, int need, Eterm *objv, int nobj)
 {
     int adjusted = 0;
-    Uint wanted, sz, need_after;
+    Uint sz, need_after, predicted = 0;
     Uint stack_size = STACK_SZ_ON_HEAP(p);
     
     /*
@@ -1944,6 +2435,8 @@ adjust_after_fullsweep(Process *p, int need, Eterm *objv, int nobj)
      */
     
     need_after = (HEAP_TOP(p) - HEAP_START(p)) + need + stack_size;
+    if (erts_heap_sizing == ERTS_HEAP_SIZING_EWMA)
+        predicted = heap_sizing_sample_live(p, need_after);
     if (HEAP_SIZE(p) < need_after) {
         /* Too small - grow to match requested need */
         sz = next_heap_size(p, need_after, 0);
@@ -1952,18 +2445,13 @@ adjust_after_fullsweep(Process *p, int need, Eterm *objv, int nobj)
     } else if (3 * HEAP_SIZE(p) < 4 * need_after){
         /* Need more than 75% of current, postpone to next GC.*/
         FLAGS(p) |= F_HEAP_GROW;
-    } else if (4 * need_after < HEAP_SIZE(p) && HEAP_SIZE(p) > H_MIN_SIZE){
-        /* We need less than 25% of the current heap, shrink.*/
-        /* XXX - This is how it was done in the old GC:
-           wanted = 4 * need_after;
-           I think this is better as fullsweep is used mainly on
-           small memory systems, but I could be wrong... */
-        wanted = 2 * need_after;
-	
-	sz = wanted < p->min_heap_size ? p->min_heap_size
-				       : next_heap_size(p, wanted, 0);
-
-        if (sz < HEAP_SIZE(p)) {
+    } else {
+        sz = fullsweep_shrink_size(p, need_after);
+        if (erts_heap_sizing == ERTS_HEAP_SIZING_EWMA)
+            sz = heap_sizing_shrink(p, sz,
+                                    fullsweep_shrink_size(p, predicted),
+                                    need_after);
+        if (sz) {
             shrink_new_heap(p, sz, objv, nobj);
 	    adjusted = 1;
         }
@@ -2816,6 +3304,39 @@ link_live_proc_bin(struct shrink_cand_data *shrink,
 #endif
 
 
+static void
+release_off_heap_thing(struct erl_off_heap_header *ptr)
+{
+    switch (thing_subtag(ptr->thing_word)) {
+    case REFC_BINARY_SUBTAG:
+	{
+	    Binary* bptr = ((ProcBin*)ptr)->val;
+	    erts_bin_release(bptr);
+	    break;
+	}
+    case FUN_SUBTAG:
+	{
+	    ErlFunEntry* fe = ((ErlFunThing*)ptr)->fe;
+	    if (erts_refc_dectest(&fe->refc, 0) == 0) {
+		erts_erase_fun_entry(fe);
+	    }
+	    break;
+	}
+    case REF_SUBTAG:
+	{
+	    ErtsMagicBinary *bptr;
+	    ASSERT(is_magic_ref_thing(ptr));
+	    bptr = ((ErtsMRefThing *) ptr)->mb;
+	    erts_bin_release((Binary *) bptr);
+	    break;
+	}
+    default:
+	ASSERT(is_external_header(ptr->thing_word));
+	erts_deref_node_entry(((ExternalThing*)ptr)->node,
+			      make_boxed(&ptr->thing_word));
+    }
+}
+
 static void
 sweep_off_heap(Process *p, int fullsweep)
 {
@@ -2889,34 +3410,7 @@ sweep_off_heap(Process *p, int fullsweep)
             break; /* and let old-heap loop continue */
         else {
 	    /* garbage */
-	    switch (thing_subtag(ptr->thing_word)) {
-	    case REFC_BINARY_SUBTAG:
-		{
-		    Binary* bptr = ((ProcBin*)ptr)->val;	
-                    erts_bin_release(bptr);
-		    break;
-		}
-	    case FUN_SUBTAG:
-		{
-		    ErlFunEntry* fe = ((ErlFunThing*)ptr)->fe;
-		    if (erts_refc_dectest(&fe->refc, 0) == 0) {
-			erts_erase_fun_entry(fe);
-		    }
-		    break;
-		}
-	    case REF_SUBTAG:
-		{
-		    ErtsMagicBinary *bptr;
-		    ASSERT(is_magic_ref_thing(ptr));
-		    bptr = ((ErtsMRefThing *) ptr)->mb;
-                    erts_bin_release((Binary *) bptr);
-		    break;
-		}
-	    default:
-		ASSERT(is_external_header(ptr->thing_word));
-		erts_deref_node_entry(((ExternalThing*)ptr)->node,
-                                      make_boxed(&ptr->thing_word));
-	    }
+	    release_off_heap_thing(ptr);
 	    *prev = ptr = ptr->next;
 	}
     }
@@ -3423,6 +3917,794 @@ erts_process_gc_info(Process *p, Uint *sizep, Eterm **hpp,
     return res;
 }
 
+Uint
+erts_get_tenure_age(Process *p)
+{
+    ErtsGcAging *aging = ERTS_PROC_GET_GC_AGING(p);
+    return aging ? aging->tenure_age : 1;
+}
+
+/*
+ * Set the number of minor collections that data has to survive before
+ * it is promoted to the old heap. Returns the previous tenure age, or
+ * THE_NON_VALUE if the argument is invalid.
+ */
+Eterm
+erts_set_tenure_age(Process *p, Eterm age)
+{
+    ErtsGcAging *aging = ERTS_PROC_GET_GC_AGING(p);
+    Uint old_age = aging ? aging->tenure_age : 1;
+    Sint new_age;
+
+    if (!is_small(age))
+        return THE_NON_VALUE;
+    new_age = signed_val(age);
+    if (new_age < 1 || new_age > ERTS_GC_MAX_TENURE_AGE)
+        return THE_NON_VALUE;
+
+    if (new_age == 1) {
+        if (aging) {
+            (void) ERTS_PROC_SET_GC_AGING(p, NULL);
+            erts_free(ERTS_ALC_T_GC_AGING, aging);
+        }
+    } else if (new_age != old_age) {
+        int k;
+        if (!aging) {
+            aging = erts_alloc(ERTS_ALC_T_GC_AGING, sizeof(ErtsGcAging));
+            (void) ERTS_PROC_SET_GC_AGING(p, aging);
+        }
+        aging->tenure_age = new_age;
+        for (k = 0; k <= ERTS_GC_MAX_TENURE_AGE; k++)
+            aging->survived[k] = 0;
+        reset_gc_ages(p);
+    }
+
+    return make_small(old_age);
+}
+
+/*
+ * Build a list with the number of words that have survived a minor
+ * collection at each age; the last element is the number of words
+ * promoted to the old heap. The list is empty if multi-age tenuring
+ * is not enabled for the process.
+ */
+Eterm
+erts_process_gc_age_survival(Process *p, Uint *sizep, Eterm **hpp)
+{
+    ErtsGcAging *aging = ERTS_PROC_GET_GC_AGING(p);
+    Eterm res = NIL;
+    int k;
+
+    if (!aging)
+        return NIL;
+
+    for (k = aging->tenure_age; k >= 0; k--) {
+        Eterm words = erts_bld_uint64(hpp, sizep, aging->survived[k]);
+        res = erts_bld_cons(hpp, sizep, words, res);
+    }
+    return res;
+}
+
+/*
+ * Prepend the heap size estimates of the process to tail.
+ */
+Eterm
+erts_process_gc_heap_sizing(Process *p, Uint *sizep, Eterm **hpp, Eterm tail)
+{
+    ERTS_DECL_AM(live_estimate);
+    ERTS_DECL_AM(alloc_rate);
+    ERTS_DECL_AM(resizes_avoided);
+    Eterm tags[] = {
+        AM_live_estimate,
+        AM_alloc_rate,
+        AM_resizes_avoided
+    };
+    UWord values[] = {
+        p->live_estimate,
+        p->alloc_rate,
+        p->resizes_avoided
+    };
+    Eterm res = tail;
+    int i;
+
+    for (i = sizeof(values)/sizeof(*values) - 1; i >= 0; i--) {
+        Eterm t = erts_bld_tuple(hpp, sizep, 2, tags[i],
+                                 erts_bld_uword(hpp, sizep, values[i]));
+        res = erts_bld_cons(hpp, sizep, t, res);
+    }
+    return res;
+}
+
+/*
+ * Incremental major collection.
+ */
+
+#define ERTS_INCR_GC_STACK_INIT_SIZE 256
+
+static ERTS_INLINE void
+incr_stack_push(ErtsIncrGcStack *s, Eterm term)
+{
+    if (s->sp == s->size) {
+        s->size = s->size ? 2*s->size : ERTS_INCR_GC_STACK_INIT_SIZE;
+        s->v = erts_realloc(ERTS_ALC_T_INCR_GC, s->v, s->size*sizeof(Eterm));
+    }
+    s->v[s->sp++] = term;
+}
+
+static ERTS_INLINE void
+incr_stack_free(ErtsIncrGcStack *s)
+{
+    if (s->v)
+        erts_free(ERTS_ALC_T_INCR_GC, s->v);
+    s->v = NULL;
+    s->sp = s->size = 0;
+}
+
+static ERTS_INLINE Uint
+incr_popcount64(Uint64 x)
+{
+    return hashmap_bitcount((Uint32) x) + hashmap_bitcount((Uint32) (x >> 32));
+}
+
+static ERTS_INLINE int
+incr_in_from_space(ErtsIncrMajorGc *igc, Eterm *ptr)
+{
+    return ErtsInArea(ptr, igc->from,
+                      (char *) igc->from_top - (char *) igc->from);
+}
+
+static ERTS_INLINE int
+incr_is_live(ErtsIncrMajorGc *igc, Eterm *ptr)
+{
+    Uint ix = ptr - igc->from;
+    return (int) ((igc->live[ix >> 6] >> (ix & 63)) & 1);
+}
+
+static void
+incr_set_live(ErtsIncrMajorGc *igc, Eterm *ptr, Uint sz)
+{
+    Uint ix = ptr - igc->from;
+    Uint end = ix + sz;
+
+    while (ix < end) {
+        Uint bit = ix & 63;
+        Uint n = 64 - bit;
+        Uint64 mask;
+        if (n > end - ix)
+            n = end - ix;
+        mask = n == 64 ? ~((Uint64) 0) : ((((Uint64) 1) << n) - 1) << bit;
+        igc->live[ix >> 6] |= mask;
+        ix += n;
+    }
+}
+
+/*
+ * Size in words of the heap object at ptr; same as what move_boxed()
+ * and move_cons() copy.
+ */
+static ERTS_INLINE Uint
+incr_object_size(Eterm *ptr)
+{
+    Eterm hdr = *ptr;
+    Uint sz;
+
+    if (!is_header(hdr))
+        return 2;
+    sz = header_arity(hdr) + 1;
+    switch (hdr & _HEADER_SUBTAG_MASK) {
+    case SUB_BINARY_SUBTAG:
+        sz++;
+        break;
+    case MAP_SUBTAG:
+        if (is_flatmap_header(hdr))
+            sz += flatmap_get_size(ptr) + 1;
+        else
+            sz += hashmap_bitcount(MAP_HEADER_VAL(hdr));
+        break;
+    case FUN_SUBTAG:
+        sz += ((ErlFunThing *) ptr)->num_free + 1;
+        break;
+    }
+    return sz;
+}
+
+/*
+ * Returns the first word of the heap object at ptr that holds a term,
+ * and sets *endp to the word after the last one.
+ */
+static ERTS_INLINE Eterm *
+incr_object_terms(Eterm *ptr, Eterm **endp)
+{
+    Eterm hdr = *ptr;
+
+    *endp = ptr + incr_object_size(ptr);
+    if (!is_header(hdr))
+        return ptr;
+    if (!header_is_thing(hdr))
+        return ptr + 1;
+    if (header_is_bin_matchstate(hdr)) {
+        Eterm *origp = &((ErlBinMatchState *) ptr)->mb.orig;
+        *endp = origp + 1;
+        return origp;
+    }
+    return ptr + thing_arityval(hdr) + 1;
+}
+
+static ERTS_INLINE Eterm *
+incr_forward_ptr(ErtsIncrMajorGc *igc, Eterm *ptr)
+{
+    Uint ix = ptr - igc->from;
+    Uint64 before = igc->live[ix >> 6] & ((((Uint64) 1) << (ix & 63)) - 1);
+
+    ASSERT(incr_is_live(igc, ptr));
+    return igc->to + igc->fwd[ix >> 6] + incr_popcount64(before);
+}
+
+/*
+ * Mark phase: push term if it refers into from space.
+ * Final phase: redirect term to its copy.
+ */
+static ERTS_INLINE void
+incr_visit_term(ErtsIncrMajorGc *igc, Eterm *tp, int translate)
+{
+    Eterm term = *tp;
+    Eterm *ptr;
+
+    switch (primary_tag(term)) {
+    case TAG_PRIMARY_BOXED:
+        ptr = boxed_val(term);
+        break;
+    case TAG_PRIMARY_LIST:
+        ptr = list_val(term);
+        break;
+    default:
+        return;
+    }
+    if (!incr_in_from_space(igc, ptr))
+        return;
+    if (translate)
+        *tp = offset_ptr(term, incr_forward_ptr(igc, ptr) - ptr);
+    else
+        incr_stack_push(&igc->mark, term);
+}
+
+static void
+incr_visit_object(ErtsIncrMajorGc *igc, Eterm *ptr, int translate)
+{
+    Eterm *tp, *end;
+
+    for (tp = incr_object_terms(ptr, &end); tp < end; tp++)
+        incr_visit_term(igc, tp, translate);
+}
+
+/*
+ * Redirect references of an object to copies in the new old heap
+ * when all data has been copied.
+ */
+static void
+incr_translate_object(ErtsIncrMajorGc *igc, Eterm *ptr)
+{
+    if (is_header(*ptr) && header_is_bin_matchstate(*ptr)) {
+        ErlBinMatchBuffer *mb = &((ErlBinMatchState *) ptr)->mb;
+        Eterm orig = mb->orig;
+        incr_visit_term(igc, &mb->orig, 1);
+        if (mb->orig != orig)
+            mb->base = binary_bytes(mb->orig);
+    }
+    else
+        incr_visit_object(igc, ptr, 1);
+}
+
+/*
+ * Visit all references from the rootset and the young generation
+ * into from space. Only used right after a minor collection, when the
+ * young heap is compact and there are no heap fragments.
+ */
+static Uint
+incr_visit_young(Process *p, ErtsIncrMajorGc *igc,
+                 Eterm *objv, int nobj, int translate)
+{
+    Rootset rootset;
+    Roots *roots;
+    Uint n, words = 0;
+    Eterm *hp;
+
+    ASSERT(!p->mbuf && !p->abandoned_heap);
+
+    n = setup_rootset(p, objv, nobj, &rootset);
+    roots = rootset.roots;
+    while (n--) {
+        Eterm *g_ptr = roots->v;
+        Uint g_sz = roots->sz;
+        roots++;
+        words += g_sz;
+        for ( ; g_sz--; g_ptr++)
+            incr_visit_term(igc, g_ptr, translate);
+    }
+    cleanup_rootset(&rootset);
+
+    hp = HEAP_START(p);
+    while (hp < HEAP_TOP(p)) {
+        if (translate)
+            incr_translate_object(igc, hp);
+        else
+            incr_visit_object(igc, hp, 0);
+        hp += incr_object_size(hp);
+    }
+    return words + (HEAP_TOP(p) - HEAP_START(p));
+}
+
+static void
+incr_free_state(ErtsIncrMajorGc *igc)
+{
+    if (igc->live)
+        erts_free(ERTS_ALC_T_INCR_GC, igc->live);
+    if (igc->fwd)
+        erts_free(ERTS_ALC_T_INCR_GC, igc->fwd);
+    if (igc->to)
+        ERTS_HEAP_FREE(ERTS_ALC_T_OLD_HEAP, igc->to,
+                       (igc->to_end - igc->to) * sizeof(Eterm));
+    incr_stack_free(&igc->mark);
+    incr_stack_free(&igc->fixup);
+    igc->live = NULL;
+    igc->fwd = NULL;
+    igc->to = igc->to_top = igc->to_end = NULL;
+    igc->from = igc->from_top = igc->scan = NULL;
+    igc->phase = 0;
+}
+
+/*
+ * Returns true if a major collection of the process should be done
+ * incrementally.
+ */
+static int
+incr_major_gc_wanted(Process *p, Uint ygen_usage)
+{
+    ErtsIncrMajorGc *igc;
+
+    if (p->flags & F_INCR_MAJOR_GC)
+        return 1;
+    if (!OLD_HEAP(p) || OLD_HTOP(p) == OLD_HEAP(p))
+        return 0;
+#ifdef HIPE
+    if (p->hipe.nstack)
+        return 0;
+#endif
+    igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+    return igc && (OLD_HTOP(p) - OLD_HEAP(p)) + ygen_usage > igc->slice;
+}
+
+/*
+ * Called instead of a major collection that was not explicitly
+ * requested. Returns true if the process has an incremental major
+ * collection in progress, has started one or, if paced, postpones
+ * one; the caller should then do a minor collection.
+ *
+ * A paced collection, one due to the number of minor collections, is
+ * postponed until the minor collections since the last one have
+ * handled as many words as were live on the old heap after it, so
+ * that a process with a small young heap and a large old heap does
+ * not spend most of its time marking the old heap.
+ */
+static int
+incr_major_gc_begin(Process *p, Uint ygen_usage, int paced)
+{
+    ErtsIncrMajorGc *igc;
+
+    if (p->flags & F_NEED_FULLSWEEP)
+        return 0;
+    if (p->flags & F_INCR_MAJOR_GC)
+        return 1;
+    if (!incr_major_gc_wanted(p, ygen_usage))
+        return 0;
+
+    igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+    if (paced && igc->young_words < igc->old_live)
+        return 1;
+    ASSERT(igc->phase == 0);
+    igc->phase = ERTS_INCR_GC_START;
+    igc->young_words = 0;
+    p->flags |= F_INCR_MAJOR_GC;
+    return 1;
+}
+
+static void
+incr_major_gc_count_minor(Process *p, Uint words)
+{
+    ErtsIncrMajorGc *igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+    if (igc)
+        igc->young_words += words;
+}
+
+static void
+incr_major_gc_abort(Process *p)
+{
+    if (p->flags & F_INCR_MAJOR_GC) {
+        incr_free_state(ERTS_PROC_GET_INCR_MAJOR_GC(p));
+        p->flags &= ~F_INCR_MAJOR_GC;
+    }
+}
+
+static Uint
+incr_snapshot(Process *p, ErtsIncrMajorGc *igc, Eterm *objv, int nobj)
+{
+    Uint nwords;
+
+    igc->from = OLD_HEAP(p);
+    igc->from_top = OLD_HTOP(p);
+    igc->nblocks = ((igc->from_top - igc->from) + 63) / 64;
+    nwords = igc->nblocks * sizeof(Uint64);
+    igc->live = erts_alloc(ERTS_ALC_T_INCR_GC, nwords);
+    sys_memzero(igc->live, nwords);
+
+    igc->phase = ERTS_INCR_GC_MARK;
+    return incr_visit_young(p, igc, objv, nobj, 0);
+}
+
+static Uint
+incr_mark(ErtsIncrMajorGc *igc, Uint budget)
+{
+    Uint work = 0;
+
+    while (igc->mark.sp && work < budget) {
+        Eterm term = igc->mark.v[--igc->mark.sp];
+        Eterm *ptr = is_boxed(term) ? boxed_val(term) : list_val(term);
+        Uint sz;
+
+        work++;
+        if (incr_is_live(igc, ptr))
+            continue;
+        sz = incr_object_size(ptr);
+        incr_set_live(igc, ptr, sz);
+        incr_visit_object(igc, ptr, 0);
+        work += sz;
+    }
+
+    if (!igc->mark.sp) {
+        incr_stack_free(&igc->mark);
+        igc->fwd = erts_alloc(ERTS_ALC_T_INCR_GC, igc->nblocks * sizeof(Uint));
+        igc->block = 0;
+        igc->nlive = 0;
+        igc->phase = ERTS_INCR_GC_FORWARD;
+    }
+    return work;
+}
+
+static Uint
+incr_forward(Process *p, ErtsIncrMajorGc *igc, Uint budget)
+{
+    Uint live = igc->nlive;
+    Uint start = igc->block;
+    Uint end = start + budget;
+
+    if (end > igc->nblocks)
+        end = igc->nblocks;
+    for (igc->block = start; igc->block < end; igc->block++) {
+        igc->fwd[igc->block] = live;
+        live += incr_popcount64(igc->live[igc->block]);
+    }
+    igc->nlive = live;
+
+    if (igc->block == igc->nblocks) {
+        if (live) {
+            /*
+             * Nothing is promoted until the collection is finished;
+             * leave room for the young generation to be promoted then.
+             */
+            Uint young = (p->htop - p->heap) + p->mbuf_sz;
+            Uint sz = erts_next_heap_size(live + young, 1);
+            igc->to = (Eterm *) ERTS_HEAP_ALLOC(ERTS_ALC_T_OLD_HEAP,
+                                                sizeof(Eterm)*sz);
+            igc->to_top = igc->to;
+            igc->to_end = igc->to + sz;
+        }
+        igc->scan = igc->from;
+        igc->phase = ERTS_INCR_GC_COPY;
+    }
+    return end - start;
+}
+
+static Uint
+incr_copy(ErtsIncrMajorGc *igc, Uint budget)
+{
+    Uint work = 0;
+    Eterm *scan = igc->scan;
+
+    while (work < budget) {
+        Uint ix = scan - igc->from;
+        Uint64 bits;
+        Eterm *to;
+        Uint sz;
+
+        /* Skip to the next live object using the bitmap */
+        if (ix >= (Uint) (igc->from_top - igc->from))
+            break;
+        bits = igc->live[ix >> 6] >> (ix & 63);
+        if (!bits) {
+            scan += 64 - (ix & 63);
+            work++;
+            continue;
+        }
+        while (!(bits & 1)) {
+            bits >>= 1;
+            scan++;
+        }
+
+        sz = incr_object_size(scan);
+        to = igc->to_top;
+        ASSERT(to == incr_forward_ptr(igc, scan));
+        sys_memcpy(to, scan, sz*sizeof(Eterm));
+        igc->to_top += sz;
+        incr_visit_object(igc, to, 1);
+
+        /* The process may update these in place; copy them again when finishing */
+        if (is_header(*scan)
+            && ((*scan & _HEADER_SUBTAG_MASK) == SUB_BINARY_SUBTAG
+                || header_is_bin_matchstate(*scan)))
+            incr_stack_push(&igc->fixup, make_boxed(scan));
+
+        scan += sz;
+        work += sz;
+    }
+
+    if (scan >= igc->from_top) {
+        scan = igc->from_top;
+        ASSERT(igc->to_top - igc->to == igc->nlive);
+        igc->phase = ERTS_INCR_GC_DONE;
+    }
+    igc->scan = scan;
+    return work;
+}
+
+/*
+ * Install the new old heap. Called right after a minor collection
+ * that did not promote anything.
+ */
+static Uint
+incr_finish(Process *p, ErtsIncrMajorGc *igc, Eterm *objv, int nobj,
+            Uint *recl)
+{
+    struct erl_off_heap_header **prev, *ptr;
+    Uint work, i;
+
+    ASSERT(OLD_HEAP(p) == igc->from && OLD_HTOP(p) == igc->from_top);
+
+    work = incr_visit_young(p, igc, objv, nobj, 1);
+
+    for (i = 0; i < igc->fixup.sp; i++) {
+        Eterm *from = boxed_val(igc->fixup.v[i]);
+        Eterm *to = incr_forward_ptr(igc, from);
+        Uint sz = incr_object_size(from);
+        sys_memcpy(to, from, sz*sizeof(Eterm));
+        incr_translate_object(igc, to);
+        work += sz;
+    }
+
+    /*
+     * Rebuild the off-heap list. Objects on the young heap come
+     * first and stay; live objects in from space are replaced by
+     * their copies, which may need to be refreshed since the process
+     * can update proc bins in place.
+     */
+    BIN_OLD_VHEAP(p) = 0;
+    prev = &MSO(p).first;
+    ptr = MSO(p).first;
+    while (ptr) {
+        struct erl_off_heap_header *next = ptr->next;
+        work++;
+        if (!incr_in_from_space(igc, (Eterm *) ptr)) {
+            *prev = ptr;
+            prev = &ptr->next;
+        }
+        else if (!incr_is_live(igc, (Eterm *) ptr)) {
+            release_off_heap_thing(ptr);
+        }
+        else {
+            struct erl_off_heap_header *copy;
+            copy = (struct erl_off_heap_header *) incr_forward_ptr(igc, (Eterm *) ptr);
+            switch (ptr->thing_word) {
+            case HEADER_PROC_BIN:
+                sys_memcpy(copy, ptr, PROC_BIN_SIZE*sizeof(Eterm));
+                BIN_OLD_VHEAP(p) += ptr->size / sizeof(Eterm);
+                break;
+            case ERTS_USED_MAGIC_REF_THING_HEADER__:
+                ASSERT(is_magic_ref_thing(ptr));
+                BIN_OLD_VHEAP(p) += (((Uint) ((ErtsMRefThing *) ptr)->mb->orig_size)
+                                     / sizeof(Eterm));
+                break;
+            default:
+                if (is_external_header(ptr->thing_word)) {
+                    erts_node_bookkeep(((ExternalThing*)ptr)->node,
+                                       make_boxed(&ptr->thing_word),
+                                       ERL_NODE_DEC);
+                    erts_node_bookkeep(((ExternalThing*)copy)->node,
+                                       make_boxed(&copy->thing_word),
+                                       ERL_NODE_INC);
+                }
+                break;
+            }
+            *prev = copy;
+            prev = &copy->next;
+        }
+        ptr = next;
+    }
+    *prev = NULL;
+    BIN_OLD_VHEAP_SZ(p) = next_vheap_size(p, BIN_OLD_VHEAP(p) + MSO(p).overhead,
+                                          BIN_OLD_VHEAP_SZ(p));
+
+    *recl += (igc->from_top - igc->from) - (igc->to_top - igc->to);
+    igc->old_live = igc->to_top - igc->to;
+
+    ERTS_HEAP_FREE(ERTS_ALC_T_OLD_HEAP, OLD_HEAP(p),
+                   (OLD_HEND(p) - OLD_HEAP(p)) * sizeof(Eterm));
+    OLD_HEAP(p) = igc->to;
+    OLD_HTOP(p) = igc->to_top;
+    OLD_HEND(p) = igc->to_end;
+    igc->to = igc->to_top = igc->to_end = NULL;
+
+    GEN_GCS(p) = 0;
+    p->flags &= ~F_INCR_MAJOR_GC;
+    incr_free_state(igc);
+
+    /*
+     * The young generation grew during the collection. If it does not
+     * fit on the new old heap when promoted, a major collection is
+     * needed rather than yet another incremental one that promotes
+     * nothing.
+     */
+    if (OLD_HEAP(p) && p->high_water - p->heap > OLD_HEND(p) - OLD_HTOP(p))
+        p->flags |= F_NEED_FULLSWEEP;
+    return work;
+}
+
+/*
+ * Called after each minor collection while an incremental major
+ * collection is in progress. Returns the cost in reductions.
+ */
+static int
+incr_major_gc_after_minor(Process *p, Eterm *objv, int nobj, Uint *recl)
+{
+    ErtsIncrMajorGc *igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+
+    ASSERT(igc && (p->flags & F_INCR_MAJOR_GC));
+#ifdef HIPE
+    if (p->hipe.nstack) {
+        /* Native stacks were not part of the snapshot */
+        incr_major_gc_abort(p);
+        return 0;
+    }
+#endif
+    switch (igc->phase) {
+    case ERTS_INCR_GC_START:
+        return gc_cost(incr_snapshot(p, igc, objv, nobj), 0);
+    case ERTS_INCR_GC_DONE:
+        return gc_cost(incr_finish(p, igc, objv, nobj, recl), 0);
+    default:
+        return 0;
+    }
+}
+
+/*
+ * Do one slice of work on the incremental major collection of the
+ * process; called when the process is scheduled in. Returns the cost
+ * in reductions.
+ */
+int
+erts_incr_major_gc_slice(Process *p, int fcalls)
+{
+    ErtsIncrMajorGc *igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+    Uint work = 0;
+    int reds;
+
+    ASSERT(igc && (p->flags & F_INCR_MAJOR_GC));
+
+    while (work < igc->slice) {
+        switch (igc->phase) {
+        case ERTS_INCR_GC_MARK:
+            work += incr_mark(igc, igc->slice - work);
+            continue;
+        case ERTS_INCR_GC_FORWARD:
+            /* One word of bitmap per block */
+            work += 64 * incr_forward(p, igc, (igc->slice - work + 63) / 64);
+            continue;
+        case ERTS_INCR_GC_COPY:
+            work += incr_copy(igc, igc->slice - work);
+            continue;
+        default:
+            break;
+        }
+        break;
+    }
+
+    reds = gc_cost(work, 0);
+    if (igc->phase == ERTS_INCR_GC_DONE && reds < fcalls)
+        reds += erts_garbage_collect_nobump(p, 0, p->arg_reg, p->arity,
+                                            fcalls - reds);
+    return reds;
+}
+
+/* Words allocated for the new old heap of the collection in progress */
+static Uint
+incr_to_space_size(Process *p)
+{
+    ErtsIncrMajorGc *igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+    ASSERT(igc && (p->flags & F_INCR_MAJOR_GC));
+    return igc->to_end - igc->to;
+}
+
+/*
+ * Bytes allocated for the incremental major collection in progress,
+ * if any, for process_info(memory).
+ */
+Uint
+erts_incr_major_gc_memory(Process *p)
+{
+    ErtsIncrMajorGc *igc;
+    Uint size;
+
+    if (!(p->flags & F_INCR_MAJOR_GC))
+        return 0;
+    igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+    size = incr_to_space_size(p) * sizeof(Eterm);
+    if (igc->live)
+        size += igc->nblocks * sizeof(Uint64);
+    if (igc->fwd)
+        size += igc->nblocks * sizeof(Uint);
+    size += (igc->mark.size + igc->fixup.size) * sizeof(Eterm);
+    return size;
+}
+
+Uint
+erts_get_major_gc_slice(Process *p)
+{
+    ErtsIncrMajorGc *igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+    return igc ? igc->slice : 0;
+}
+
+/*
+ * Set the amount of work, in words, done in each slice of an
+ * incremental major collection; zero disables incremental major
+ * collections. Returns the previous value, or THE_NON_VALUE if the
+ * argument is invalid.
+ */
+Eterm
+erts_set_major_gc_slice(Process *p, Eterm words)
+{
+    ErtsIncrMajorGc *igc = ERTS_PROC_GET_INCR_MAJOR_GC(p);
+    Uint old_slice = igc ? igc->slice : 0;
+    Sint slice;
+
+    if (!is_small(words))
+        return THE_NON_VALUE;
+    slice = signed_val(words);
+    if (slice < 0)
+        return THE_NON_VALUE;
+
+    if (slice == 0)
+        erts_free_incr_major_gc(p);
+    else {
+        if (!igc) {
+            igc = erts_alloc(ERTS_ALC_T_INCR_GC, sizeof(ErtsIncrMajorGc));
+            sys_memzero(igc, sizeof(ErtsIncrMajorGc));
+            (void) ERTS_PROC_SET_INCR_MAJOR_GC(p, igc);
+        }
+        igc->slice = slice;
+    }
+
+    return make_small(old_slice);
+}
+
+void
+erts_free_incr_major_gc(Process *p)
+{
+    ErtsIncrMajorGc *igc = ERTS_PROC_SET_INCR_MAJOR_GC(p, NULL);
+    if (igc) {
+        incr_free_state(igc);
+        p->flags &= ~F_INCR_MAJOR_GC;
+        erts_free(ERTS_ALC_T_INCR_GC, igc);
+    }
+}
+
 static int
 reached_max_heap_size(Process *p, Uint total_heap_size,
                       Uint extra_heap_size, Uint extra_old_heap_size)
@@ -149,6 +149,11 @@ ERTS_GLB_INLINE Eterm follow_moved(Eterm term, Eterm xptr_tag)
 
 extern Uint erts_test_long_gc_sleep;
 
+/* Heap sizing policies, see the +hsp emulator flag */
+#define ERTS_HEAP_SIZING_LAST   0       /* Size after the last collection */
+#define ERTS_HEAP_SIZING_EWMA   1       /* Size after weighted estimates */
+extern int erts_heap_sizing;
+
 typedef struct {
   Uint64 reclaimed;
   Uint64 garbage_cols;
@@ -161,6 +166,20 @@ typedef struct {
     (ERTS_PROCESS_GC_INFO_MAX_TERMS * (2/*cons*/ + 3/*2-tuple*/ + BIG_UINT_HEAP_SIZE))
 Eterm erts_process_gc_info(struct process*, Uint *, Eterm **, Uint, Uint);
 
+#define ERTS_GC_MAX_TENURE_AGE 8
+#define ERTS_GC_AGE_SURVIVAL_MAX_SIZE                                   \
+    (3/*2-tuple*/ + 2/*cons*/                                           \
+     + (ERTS_GC_MAX_TENURE_AGE + 1) * (2/*cons*/ + ERTS_MAX_UINT64_HEAP_SIZE))
+Uint erts_get_tenure_age(struct process*);
+Eterm erts_set_tenure_age(struct process*, Eterm);
+Eterm erts_process_gc_age_survival(struct process*, Uint *, Eterm **);
+Eterm erts_process_gc_heap_sizing(struct process*, Uint *, Eterm **, Eterm);
+Uint erts_get_major_gc_slice(struct process*);
+Eterm erts_set_major_gc_slice(struct process*, Eterm);
+int erts_incr_major_gc_slice(struct process*, int);
+Uint erts_incr_major_gc_memory(struct process*);
+void erts_free_incr_major_gc(struct process*);
+
 void erts_gc_info(ErtsGCInfo *gcip);
 void erts_init_gc(void);
 int erts_garbage_collect_nobump(struct process*, int, Eterm*, int, int);
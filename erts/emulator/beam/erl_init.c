@@ -151,7 +151,8 @@ static void erl_init(int ncpu,
 		     int time_correction,
 		     ErtsTimeWarpMode time_warp_mode,
 		     int node_tab_delete_delay,
-		     ErtsDbSpinCount db_spin_count);
+		     ErtsDbSpinCount db_spin_count,
+		     Uint persistent_term_shards);
 
 static erts_atomic_t exiting;
 
@@ -305,7 +306,8 @@ erl_init(int ncpu,
 	 int time_correction,
 	 ErtsTimeWarpMode time_warp_mode,
 	 int node_tab_delete_delay,
-	 ErtsDbSpinCount db_spin_count)
+	 ErtsDbSpinCount db_spin_count,
+	 Uint persistent_term_shards)
 {
     erts_monitor_link_init();
     erts_proc_sig_queue_init();
@@ -337,6 +339,7 @@ erl_init(int ncpu,
     init_module_table();
     init_register_table();
     init_message();
+    erts_init_par_copy();
     erts_bif_info_init();
     erts_ddll_init();
     init_emulator();
@@ -354,7 +357,7 @@ erl_init(int ncpu,
     erts_init_bif_chksum();
     erts_init_bif_binary();
     erts_init_bif_guard();
-    erts_init_bif_persistent_term();
+    erts_init_bif_persistent_term(persistent_term_shards);
     erts_init_bif_re();
     erts_init_unicode(); /* after RE to get access to PCRE unicode */
     erts_init_external();
@@ -607,6 +610,7 @@ void erts_usage(void)
 	       erts_pd_initial_size);
     erts_fprintf(stderr, "-hmqd  val     set default message queue data flag for processes,\n");
     erts_fprintf(stderr, "               valid values are: off_heap | on_heap\n");
+    erts_fprintf(stderr, "-hsp val       set heap sizing policy, valid values are: last | ewma\n");
     erts_fprintf(stderr, "-IOp number    set number of pollsets to be used to poll for I/O,\n");
     erts_fprintf(stderr, "               This value has to be equal or smaller than the\n");
     erts_fprintf(stderr, "               number of poll threads. If the current platform\n");
@@ -637,23 +641,29 @@ void erts_usage(void)
     erts_fprintf(stderr, "-sbt type      set scheduler bind type, valid types are:\n");
     erts_fprintf(stderr, "-stbt type     u|ns|ts|ps|s|nnts|nnps|tnnps|db\n");
     erts_fprintf(stderr, "-sbwt val      set scheduler busy wait threshold, valid values are:\n");
-    erts_fprintf(stderr, "               none|very_short|short|medium|long|very_long.\n");
+    erts_fprintf(stderr, "               none|very_short|short|medium|long|very_long|adaptive.\n");
     erts_fprintf(stderr, "-sbwtdcpu val  set dirty CPU scheduler busy wait threshold, valid values are:\n");
-    erts_fprintf(stderr, "               none|very_short|short|medium|long|very_long.\n");
+    erts_fprintf(stderr, "               none|very_short|short|medium|long|very_long|adaptive.\n");
     erts_fprintf(stderr, "-sbwtdio val   set dirty IO scheduler busy wait threshold, valid values are:\n");
-    erts_fprintf(stderr, "               none|very_short|short|medium|long|very_long.\n");
+    erts_fprintf(stderr, "               none|very_short|short|medium|long|very_long|adaptive.\n");
     erts_fprintf(stderr, "-scl bool      enable/disable compaction of scheduler load,\n");
     erts_fprintf(stderr, "               see the erl(1) documentation for more info.\n");
     erts_fprintf(stderr, "-sct cput      set cpu topology,\n");
     erts_fprintf(stderr, "               see the erl(1) documentation for more info.\n");
+    erts_fprintf(stderr, "-sdfq bool     enable/disable fair queuing of dirty work per module,\n");
+    erts_fprintf(stderr, "               see the erl(1) documentation for more info.\n");
     erts_fprintf(stderr, "-secio bool    enable/disable eager check I/O scheduling,\n");
     erts_fprintf(stderr, "               see the erl(1) documentation for more info.\n");
+    erts_fprintf(stderr, "-snuma bool    enable/disable NUMA aware scheduling and memory placement,\n");
+    erts_fprintf(stderr, "               see the erl(1) documentation for more info.\n");
 #if ERTS_HAVE_SCHED_UTIL_BALANCING_SUPPORT_OPT
     erts_fprintf(stderr, "-sub bool      enable/disable scheduler utilization balancing,\n");
 #else
     erts_fprintf(stderr, "-sub false     disable scheduler utilization balancing,\n");
 #endif
     erts_fprintf(stderr, "               see the erl(1) documentation for more info.\n");
+    erts_fprintf(stderr, "-sst val       set scheduler steal strategy, valid values are:\n");
+    erts_fprintf(stderr, "               default|random.\n");
     erts_fprintf(stderr, "-sws val       set scheduler wakeup strategy, valid values are:\n");
     erts_fprintf(stderr, "               default|legacy.\n");
     erts_fprintf(stderr, "-swct val      set scheduler wake cleanup threshold, valid values are:\n");
@@ -710,6 +720,15 @@ void erts_usage(void)
     erts_fprintf(stderr, "-zdntgc time   set delayed node table gc in seconds\n");
     erts_fprintf(stderr, "               valid values are infinity or intergers in the range [0-%d]\n",
 		 ERTS_NODE_TAB_DELAY_GC_MAX);
+    erts_fprintf(stderr, "-zmqbl limit   set how many times the message queue lock of a process is\n");
+    erts_fprintf(stderr, "               contended before it gets message buffers, 0 disables\n");
+    erts_fprintf(stderr, "-zms mode      set message sharing mode, valid values are:\n");
+    erts_fprintf(stderr, "               flat|adaptive\n");
+    erts_fprintf(stderr, "-zpcs size     copy terms of at least size words in parallel on\n");
+    erts_fprintf(stderr, "               idle dirty cpu schedulers, 0 disables\n");
+    erts_fprintf(stderr, "-zpts shards   set the number of persistent term hash tables\n");
+    erts_fprintf(stderr, "               valid values are powers of two in the range [1-%d]\n",
+		 ERTS_PERSISTENT_TERM_MAX_SHARDS);
 #if 0
     erts_fprintf(stderr, "-zebwt  val    set ets busy wait threshold, valid values are:\n");
     erts_fprintf(stderr, "               none|very_short|short|medium|long|very_long|extremely_long\n");
@@ -1273,6 +1292,7 @@ erl_start(int argc, char **argv)
     ErtsTimeWarpMode time_warp_mode;
     int node_tab_delete_delay = ERTS_NODE_TAB_DELAY_GC_DEFAULT;
     ErtsDbSpinCount db_spin_count = ERTS_DB_SPNCNT_NORMAL;
+    Uint persistent_term_shards = 1;
 
     set_default_time_adj(&time_correction,
 			 &time_warp_mode);
@@ -1481,6 +1501,7 @@ erl_start(int argc, char **argv)
 	     * h|mbs   - min_bin_vheap_size
 	     * h|pds   - erts_pd_initial_size
 	     * h|mqd   - message_queue_data
+	     * h|sp    - heap sizing policy
              * h|max   - max_heap_size
              * h|maxk  - max_heap_kill
              * h|maxel - max_heap_error_logger
@@ -1524,6 +1545,17 @@ erl_start(int argc, char **argv)
 				 "Invalid message_queue_data flag: %s\n", arg);
 		    erts_usage();
 		}
+            } else if (has_prefix("sp", sub_param)) {
+		arg = get_arg(sub_param+2, argv[i+1], &i);
+		if (sys_strcmp(arg, "last") == 0)
+		    erts_heap_sizing = ERTS_HEAP_SIZING_LAST;
+		else if (sys_strcmp(arg, "ewma") == 0)
+		    erts_heap_sizing = ERTS_HEAP_SIZING_EWMA;
+		else {
+		    erts_fprintf(stderr, "bad heap sizing policy %s\n", arg);
+		    erts_usage();
+		}
+		VERBOSE(DEBUG_SYSTEM, ("using heap sizing policy %s\n", arg));
             } else if (has_prefix("maxk", sub_param)) {
 		arg = get_arg(sub_param+4, argv[i+1], &i);
 		if (sys_strcmp(arg,"true") == 0) {
@@ -1821,10 +1853,36 @@ erl_start(int argc, char **argv)
 		    erts_usage();
 		}
 	    }
+	    else if (has_prefix("dfq", sub_param)) {
+		arg = get_arg(sub_param+3, argv[i+1], &i);
+		if (sys_strcmp(arg, "true") == 0)
+		    erts_sched_dirty_fair_queuing = 1;
+		else if (sys_strcmp(arg, "false") == 0)
+		    erts_sched_dirty_fair_queuing = 0;
+		else {
+		    erts_fprintf(stderr,
+				 "bad dirty fair queuing value %s\n",
+				 arg);
+		    erts_usage();
+		}
+	    }
             else if (has_prefix("ecio", sub_param)) {
                 /* ignore argument, eager check io no longer used */
                 arg = get_arg(sub_param+4, argv[i+1], &i);
             }
+	    else if (has_prefix("numa", sub_param)) {
+		arg = get_arg(sub_param+4, argv[i+1], &i);
+		if (sys_strcmp(arg, "true") == 0)
+		    erts_sched_numa_aware = 1;
+		else if (sys_strcmp(arg, "false") == 0)
+		    erts_sched_numa_aware = 0;
+		else {
+		    erts_fprintf(stderr,
+				 "bad NUMA aware scheduling value %s\n",
+				 arg);
+		    erts_usage();
+		}
+	    }
 	    else if (has_prefix("pp", sub_param)) {
 		arg = get_arg(sub_param+2, argv[i+1], &i);
 		if (sys_strcmp(arg, "true") == 0)
@@ -1838,6 +1896,16 @@ erl_start(int argc, char **argv)
 		    erts_usage();
 		}
 	    }
+	    else if (has_prefix("st", sub_param)) {
+		arg = get_arg(sub_param+2, argv[i+1], &i);
+		if (erts_sched_set_steal_type(arg) != 0) {
+		    erts_fprintf(stderr, "scheduler steal strategy: %s\n",
+				 arg);
+		    erts_usage();
+		}
+		VERBOSE(DEBUG_SYSTEM,
+			("scheduler steal strategy: %s\n", arg));
+	    }
 	    else if (has_prefix("tbt", sub_param)) {
 		arg = get_arg(sub_param+3, argv[i+1], &i);
 		res = erts_init_scheduler_bind_type_string(arg);
@@ -2176,6 +2244,54 @@ erl_start(int argc, char **argv)
 		}
 		node_tab_delete_delay = (int) secs;
 	    }
+	    else if (has_prefix("mqbl", sub_param)) {
+		char *endptr;
+		Sint limit;
+		arg = get_arg(sub_param+4, argv[i+1], &i);
+		errno = 0;
+		limit = ErtsStrToSint(arg, &endptr, 10);
+		if (errno != 0 || *arg == '\0' || *endptr != '\0'
+		    || limit < 0 || ERTS_AINT32_T_MAX < limit) {
+		    erts_fprintf(stderr, "Invalid message queue buffer limit: %s\n", arg);
+		    erts_usage();
+		}
+		erts_proc_sig_inq_buffer_limit = (Uint) limit;
+	    }
+	    else if (has_prefix("ms", sub_param)) {
+		arg = get_arg(sub_param+2, argv[i+1], &i);
+		if (sys_strcmp(arg, "flat") == 0)
+		    erts_message_sharing = ERTS_MSG_SHARING_FLAT;
+		else if (sys_strcmp(arg, "adaptive") == 0)
+		    erts_message_sharing = ERTS_MSG_SHARING_ADAPTIVE;
+		else {
+		    erts_fprintf(stderr, "Invalid message sharing mode: %s\n", arg);
+		    erts_usage();
+		}
+	    }
+	    else if (has_prefix("pcs", sub_param)) {
+		char *endptr;
+		Sint words;
+		arg = get_arg(sub_param+3, argv[i+1], &i);
+		errno = 0;
+		words = ErtsStrToSint(arg, &endptr, 10);
+		if (errno != 0 || *arg == '\0' || *endptr != '\0'
+		    || words < 0) {
+		    erts_fprintf(stderr, "Invalid parallel copy size: %s\n", arg);
+		    erts_usage();
+		}
+		erts_par_copy_threshold = (Uint) words;
+	    }
+	    else if (has_prefix("pts", sub_param)) {
+		int shards;
+		arg = get_arg(sub_param+3, argv[i+1], &i);
+		shards = atoi(arg);
+		if (shards < 1 || ERTS_PERSISTENT_TERM_MAX_SHARDS < shards
+		    || (shards & (shards - 1)) != 0) {
+		    erts_fprintf(stderr, "Invalid persistent term shards: %s\n", arg);
+		    erts_usage();
+		}
+		persistent_term_shards = (Uint) shards;
+	    }
 	    else if (has_prefix("ebwt", sub_param)) {
 		arg = get_arg(sub_param+4, argv[i+1], &i);
 		if (sys_strcmp(arg, "none") == 0)
@@ -2280,7 +2396,8 @@ erl_start(int argc, char **argv)
 	     time_correction,
 	     time_warp_mode,
 	     node_tab_delete_delay,
-	     db_spin_count);
+	     db_spin_count,
+	     persistent_term_shards);
 
     load_preloaded();
     erts_end_staging_code_ix();
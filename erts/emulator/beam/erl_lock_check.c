@@ -92,6 +92,7 @@ static erts_lc_lock_order_t erts_lock_order[] = {
     {	"db_tab",				"address"		},
     {	"db_tab_fix",				"address"		},
     {	"db_hash_slot",				"address"		},
+    {	"db_tab_literal",			"address"		},
     {	"erl_db_catree_base_node",		NULL		        },
     {	"erl_db_catree_route_node",		"index"		        },
     {	"resource_monitors",			"address"	        },
@@ -106,6 +107,7 @@ static erts_lc_lock_order_t erts_lock_order[] = {
     {	"purge_state",		      		NULL			},
     {	"proc_status",				"pid"			},
     {	"proc_trace",				"pid"			},
+    {	"proc_sig_inq_buffer",			"pid"			},
     {	"node_table",				NULL			},
     {	"dist_table",				NULL			},
     {	"sys_tracers",				NULL			},
@@ -122,6 +124,7 @@ static erts_lc_lock_order_t erts_lock_order[] = {
     {	"run_queue",				"address"		},
     {   "dirty_run_queue_sleep_list",		"address"		},
     {	"dirty_gc_info",			NULL			},
+    {	"par_copy_jobs",			NULL			},
     {	"dirty_break_point_index",		NULL			},
     {	"process_table",			NULL			},
     {	"cpu_info",				NULL			},
@@ -34,6 +34,7 @@
 #include "dtrace-wrapper.h"
 #include "beam_bp.h"
 #include "erl_proc_sig_queue.h"
+#include "erl_map.h"
 
 ERTS_SCHED_PREF_QUICK_ALLOC_IMPL(message_ref,
 				 ErtsMessageRef,
@@ -46,10 +47,20 @@ ERTS_SCHED_PREF_QUICK_ALLOC_IMPL(message_ref,
 #undef HARD_DEBUG
 #endif
 
+int erts_message_sharing = ERTS_MSG_SHARING_FLAT;
+
+static void init_send_many(void);
+
+static erts_atomic64_t msg_sharing_sends;
+static erts_atomic64_t msg_sharing_words_saved;
+
 void
 init_message(void)
 {
     init_message_ref_alloc();
+    erts_atomic64_init_nob(&msg_sharing_sends, 0);
+    erts_atomic64_init_nob(&msg_sharing_words_saved, 0);
+    init_send_many();
 }
 
 void *erts_alloc_message_ref(void)
@@ -370,7 +381,14 @@ queue_messages(Process* receiver,
     ERTS_LC_ASSERT((erts_proc_lc_my_proc_locks(receiver) & ERTS_PROC_LOCK_MSGQ)
                    == (receiver_locks & ERTS_PROC_LOCK_MSGQ));
 
-    if (!(receiver_locks & ERTS_PROC_LOCK_MSGQ)) {
+    if (!receiver_locks) {
+        if (last == &first->next
+            && erts_proc_sig_queue_try_enqueue_to_buffer(receiver, first))
+            return;
+        erts_proc_sig_queue_lock(receiver);
+	locked_msgq = 1;
+    }
+    else if (!(receiver_locks & ERTS_PROC_LOCK_MSGQ)) {
         erts_proc_lock(receiver, ERTS_PROC_LOCK_MSGQ);
 	locked_msgq = 1;
     }
@@ -618,6 +636,290 @@ erts_try_alloc_message_on_heap(Process *pp,
     return mp;
 }
 
+#ifndef SHCOPY_SEND
+
+/*
+ * A copy of a message is sharing-preserving only if the message is
+ * at least this many times as large when copied flat.
+ */
+#define ERTS_MSG_SHARING_PAYOFF 2
+
+typedef struct {
+    ErtsParCopy par;
+    erts_shcopy_t shared;
+    Uint flat_size;
+    int use_shared;
+} ErtsSendCopy;
+
+/*
+ * In the adaptive sharing mode the flat sizing of a message also
+ * looks for signs of internal sharing. Only when there are some is
+ * the size of a sharing-preserving copy calculated, and that copier
+ * is used only if it saves enough.
+ */
+static Uint
+send_copy_calculate(Eterm msg, ErtsSendCopy *scp, erts_literal_area_t *litopt)
+{
+    Uint sz;
+    int shared;
+
+    INITIALIZE_PAR_COPY(scp->par);
+    scp->use_shared = 0;
+
+    if (erts_message_sharing == ERTS_MSG_SHARING_FLAT || IS_CONST(msg))
+        return erts_par_copy_calculate(msg, &scp->par, litopt);
+
+    sz = erts_size_object_sharing_hint(msg, litopt, &shared);
+    if (!shared || size_shared(msg) * ERTS_MSG_SHARING_PAYOFF > sz) {
+        if (erts_par_copy_threshold && sz >= erts_par_copy_threshold)
+            return erts_par_copy_calculate(msg, &scp->par, litopt);
+        scp->par.litopt = litopt;
+        return sz;
+    }
+
+    scp->use_shared = 1;
+    scp->flat_size = sz;
+    INITIALIZE_SHCOPY(scp->shared);
+    return copy_shared_calculate(msg, &scp->shared);
+}
+
+static Eterm
+send_copy_perform(Eterm msg, Uint sz, ErtsSendCopy *scp, Eterm **hpp,
+                  ErlOffHeap *ohp)
+{
+    if (scp->use_shared) {
+        msg = copy_shared_perform(msg, sz, &scp->shared, hpp, ohp);
+        DESTROY_SHCOPY(scp->shared);
+        erts_atomic64_inc_nob(&msg_sharing_sends);
+        erts_atomic64_add_nob(&msg_sharing_words_saved,
+                              (erts_aint64_t) (scp->flat_size - sz));
+    }
+    else if (is_not_immed(msg)) {
+        msg = erts_par_copy_perform(msg, sz, &scp->par, hpp, ohp);
+    }
+    DESTROY_PAR_COPY(scp->par);
+    return msg;
+}
+
+#endif
+
+Eterm
+erts_message_sharing_info(Process *c_p)
+{
+    Uint64 sends = (Uint64) erts_atomic64_read_nob(&msg_sharing_sends);
+    Uint64 saved = (Uint64) erts_atomic64_read_nob(&msg_sharing_words_saved);
+    Eterm sends_term, saved_term;
+    Uint hsz = MAP_SZ(3);
+    Eterm *hp;
+
+    saved *= sizeof(Eterm);
+    (void) erts_bld_uint64(NULL, &hsz, sends);
+    (void) erts_bld_uint64(NULL, &hsz, saved);
+    hp = HAlloc(c_p, hsz);
+    sends_term = erts_bld_uint64(&hp, NULL, sends);
+    saved_term = erts_bld_uint64(&hp, NULL, saved);
+    return MAP3(hp, am_bytes_saved, saved_term,
+                am_mode, (erts_message_sharing == ERTS_MSG_SHARING_ADAPTIVE
+                          ? am_adaptive
+                          : am_flat),
+                am_shared_sends, sends_term);
+}
+
+/*
+ * erlang:send_many/2 copies its message once, into a literal area that
+ * the messages to all receivers refer to. Messages are packed into an
+ * arena per scheduler. An arena counts its users: the scheduler until
+ * the arena is full, has referred to ERTS_SEND_MANY_MAX_ARENA_BIN_BYTES
+ * of refc binaries or has been idle for ERTS_SEND_MANY_ARENA_IDLE_MSEC,
+ * and each send_many until it has enqueued its last message. When the
+ * count reaches zero the arena is handed to the literal area collector,
+ * which copies whatever the receivers still refer to into their own
+ * heaps before the arena is freed.
+ *
+ * Since the collector copies the message to every receiver that still
+ * holds it, messages larger than ERTS_SEND_MANY_MAX_MSG are sent with a
+ * copy per receiver instead, as are all messages while more than
+ * ERTS_SEND_MANY_MAX_AREAS arenas are in use or awaiting the collector.
+ */
+
+#define ERTS_SEND_MANY_ARENA_WORDS (64*1024)
+#define ERTS_SEND_MANY_MAX_MSG (ERTS_SEND_MANY_ARENA_WORDS / 8)
+#define ERTS_SEND_MANY_MAX_ARENA_BIN_BYTES (1024*1024)
+#define ERTS_SEND_MANY_ARENA_IDLE_MSEC 1000
+#define ERTS_SEND_MANY_MAX_AREAS 256
+#define ERTS_SEND_MANY_HEADER_WORDS 2
+
+#define SEND_MANY_REFC(Area) ((erts_atomic_t *) &(Area)->start[1])
+
+typedef struct {
+    ErtsLiteralArea *area;
+    Eterm *top;
+    Uint bin_bytes;		/* Bytes of refc binaries referred to */
+    int used;			/* Used since the idle timer last fired */
+    int timer;			/* Idle timer is running */
+} SendManyArena;
+
+typedef union {
+    SendManyArena a;
+    char align[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(sizeof(SendManyArena))];
+} SendManyArenaAligned;
+
+static SendManyArenaAligned *send_many_arenas;
+static erts_atomic_t send_many_areas;	/* Not yet handed to collector */
+
+static void
+init_send_many(void)
+{
+    Uint i;
+    send_many_arenas =
+        erts_alloc_permanent_cache_aligned(ERTS_ALC_T_SEND_MANY_ARENA,
+                                           erts_no_schedulers *
+                                           sizeof(SendManyArenaAligned));
+    for (i = 0; i < erts_no_schedulers; i++) {
+        send_many_arenas[i].a.area = NULL;
+        send_many_arenas[i].a.top = NULL;
+        send_many_arenas[i].a.bin_bytes = 0;
+        send_many_arenas[i].a.used = 0;
+        send_many_arenas[i].a.timer = 0;
+    }
+    erts_atomic_init_nob(&send_many_areas, 0);
+}
+
+static ErtsLiteralArea *
+send_many_alloc_area(Uint words)
+{
+    Uint alloc_words = ERTS_SEND_MANY_HEADER_WORDS + words;
+    ErtsLiteralArea *area =
+        erts_alloc(ERTS_ALC_T_LITERAL, ERTS_LITERAL_AREA_ALLOC_SIZE(alloc_words));
+
+    ERTS_CT_ASSERT(sizeof(erts_atomic_t) == sizeof(Eterm));
+    area->start[0] = make_pos_bignum_header(1);
+    erts_atomic_init_nob(SEND_MANY_REFC(area), 1);
+    area->end = &area->start[alloc_words];
+    area->off_heap = NULL;
+    erts_atomic_inc_nob(&send_many_areas);
+    return area;
+}
+
+void
+erts_send_many_release(Process *c_p, ErtsLiteralArea *area)
+{
+    if (erts_atomic_dec_read_mb(SEND_MANY_REFC(area)) == 0) {
+        erts_atomic_dec_nob(&send_many_areas);
+        erts_queue_release_literals(c_p, area);
+    }
+}
+
+static void
+send_many_close_arena(Process *c_p, SendManyArena *arena)
+{
+    /* Only the used part is a heap for the collector to walk */
+    arena->area->end = arena->top;
+    erts_send_many_release(c_p, arena->area);
+    arena->area = NULL;
+}
+
+/*
+ * Runs on the scheduler that owns the arena, so it does not race with
+ * erts_send_many_copy().
+ */
+static void
+send_many_arena_timeout(void *varena)
+{
+    SendManyArena *arena = (SendManyArena *) varena;
+
+    if (arena->area && arena->used) {
+        arena->used = 0;
+        erts_start_timer_callback(ERTS_SEND_MANY_ARENA_IDLE_MSEC,
+                                  send_many_arena_timeout, varena);
+        return;
+    }
+    if (arena->area)
+        send_many_close_arena(NULL, arena);
+    arena->timer = 0;
+}
+
+/*
+ * Return the size of msg if erts_send_many_copy() should copy it,
+ * otherwise zero.
+ */
+Uint
+erts_send_many_copy_size(Eterm msg)
+{
+    Uint sz;
+
+    if ((Uint) erts_atomic_read_nob(&send_many_areas)
+        + erts_literal_areas_pending_release() > ERTS_SEND_MANY_MAX_AREAS)
+        return 0;
+    sz = size_object(msg);
+    return sz <= ERTS_SEND_MANY_MAX_MSG ? sz : 0;
+}
+
+/*
+ * Copy msg of size sz, as returned by erts_send_many_copy_size(), into
+ * a literal area and return the area with a reference held for the
+ * caller. Must be called on the normal scheduler that c_p executes on.
+ */
+ErtsLiteralArea *
+erts_send_many_copy(Process *c_p, Eterm msg, Uint sz, Eterm *litp)
+{
+    ErtsSchedulerData *esdp = erts_proc_sched_data(c_p);
+    SendManyArena *arena = &send_many_arenas[esdp->no - 1].a;
+    struct erl_off_heap_header *ohh, *last = NULL;
+    ErtsLiteralArea *area;
+    ErlOffHeap oh;
+    Uint bin_bytes = 0;
+    Eterm *hp, *start;
+
+    ASSERT(!ERTS_SCHEDULER_IS_DIRTY(esdp));
+    ASSERT(sz == size_object(msg) && sz <= ERTS_SEND_MANY_MAX_MSG);
+
+    if (arena->area
+        && (arena->top + sz > arena->area->end
+            || arena->bin_bytes > ERTS_SEND_MANY_MAX_ARENA_BIN_BYTES))
+        send_many_close_arena(c_p, arena);
+    if (!arena->area) {
+        arena->area = send_many_alloc_area(ERTS_SEND_MANY_ARENA_WORDS);
+        arena->top = &arena->area->start[ERTS_SEND_MANY_HEADER_WORDS];
+        arena->bin_bytes = 0;
+        if (!arena->timer) {
+            arena->timer = 1;
+            erts_start_timer_callback(ERTS_SEND_MANY_ARENA_IDLE_MSEC,
+                                      send_many_arena_timeout,
+                                      (void *) arena);
+        }
+    }
+    area = arena->area;
+    arena->used = 1;
+    erts_atomic_inc_nob(SEND_MANY_REFC(area));
+    hp = arena->top;
+    arena->top += sz;
+
+    start = hp;
+    ERTS_INIT_OFF_HEAP(&oh);
+    *litp = copy_struct(msg, sz, &hp, &oh);
+    erts_set_literal_tag(litp, start, sz);
+
+    for (ohh = oh.first; ohh; ohh = ohh->next) {
+        if (ohh->thing_word == HEADER_PROC_BIN)
+            bin_bytes += ((ProcBin *) ohh)->size;
+        last = ohh;
+    }
+    if (last) {
+        last->next = area->off_heap;
+        area->off_heap = oh.first;
+    }
+    arena->bin_bytes += bin_bytes;
+
+    if (sz > ERTS_MSG_COPY_WORDS_PER_REDUCTION) {
+        Uint reds = sz / ERTS_MSG_COPY_WORDS_PER_REDUCTION;
+        if (reds > CONTEXT_REDS)
+            reds = CONTEXT_REDS;
+        BUMP_REDS(c_p, (int) reds);
+    }
+    return area;
+}
+
 /*
  * Send a local message when sender & receiver processes are known.
  */
@@ -645,6 +947,7 @@ erts_send_message(Process* sender,
     erts_shcopy_t info;
 #else
     erts_literal_area_t litarea;
+    ErtsSendCopy sc;
     INITIALIZE_LITERAL_PURGE_AREA(litarea);
 #endif
 
@@ -692,7 +995,7 @@ erts_send_message(Process* sender,
         INITIALIZE_SHCOPY(info);
         msize = copy_shared_calculate(message, &info);
 #else
-        msize = size_object_litopt(message, &litarea);
+        msize = send_copy_calculate(message, &sc, &litarea);
 #endif
         mp = erts_alloc_message_heap_state(receiver,
                                            &receiver_state,
@@ -710,8 +1013,7 @@ erts_send_message(Process* sender,
             message = copy_shared_perform(message, msize, &info, &hp, ohp);
         DESTROY_SHCOPY(info);
 #else
-	if (is_not_immed(message))
-            message = copy_struct_litopt(message, msize, &hp, ohp, &litarea);
+        message = send_copy_perform(message, msize, &sc, &hp, ohp);
 #endif
 	if (is_immed(stoken))
 	    token = stoken;
@@ -747,7 +1049,7 @@ erts_send_message(Process* sender,
             INITIALIZE_SHCOPY(info);
             msize = copy_shared_calculate(message, &info);
 #else
-            msize = size_object_litopt(message, &litarea);
+            msize = send_copy_calculate(message, &sc, &litarea);
 #endif
 	    mp = erts_alloc_message_heap_state(receiver,
 					       &receiver_state,
@@ -760,8 +1062,7 @@ erts_send_message(Process* sender,
                 message = copy_shared_perform(message, msize, &info, &hp, ohp);
             DESTROY_SHCOPY(info);
 #else
-            if (is_not_immed(message))
-                message = copy_struct_litopt(message, msize, &hp, ohp, &litarea);
+            message = send_copy_perform(message, msize, &sc, &hp, ohp);
 #endif
 	}
 #ifdef USE_VM_PROBES
@@ -298,6 +298,9 @@ typedef struct {
     /* Common for inner and middle queue */
     ErtsMessage **saved_last;	/* saved last pointer */
     Sint len; /* NOT message queue length (see above) */
+
+    /* Optional index of inner queue (process_flag(receive_index, _)) */
+    struct ErtsRecvIndex_ *recv_ix;
 } ErtsSignalPrivQueues;
 
 typedef struct {
@@ -378,6 +381,7 @@ typedef struct erl_trace_message_queue__ {
 #define LINK_MESSAGE(p, msg) \
     do {                                                                \
         ASSERT(ERTS_SIG_IS_MSG(msg));                                   \
+        erts_proc_sig_queue_flush_buffers((p));                         \
         ERTS_HDBG_CHECK_SIGNAL_IN_QUEUE__((p), "before");               \
         *(p)->sig_inq.last = (msg);                                     \
         (p)->sig_inq.last = &(msg)->next;                               \
@@ -390,6 +394,8 @@ typedef struct erl_trace_message_queue__ {
     do {                                                                \
         ErtsMessage *mp__ = (msgp)->next;                               \
         ERTS_HDBG_CHECK_SIGNAL_PRIV_QUEUE__((p), 0, "before");          \
+        if (ERTS_UNLIKELY((p)->sig_qs.recv_ix != NULL))                 \
+            erts_recv_index_remove((p), (msgp), (p)->sig_qs.save);      \
         *(p)->sig_qs.save = mp__;                                       \
         (p)->sig_qs.len--;                                              \
         if (mp__ == NULL)                                               \
@@ -440,7 +446,17 @@ typedef struct erl_trace_message_queue__ {
         MP->data.attached = NULL;                       \
     } while (0)
 
+#define ERTS_MSG_SHARING_FLAT 0
+#define ERTS_MSG_SHARING_ADAPTIVE 1
+
+extern int erts_message_sharing;
+
 void init_message(void);
+Eterm erts_message_sharing_info(Process *c_p);
+Uint erts_send_many_copy_size(Eterm msg);
+struct ErtsLiteralArea_ *erts_send_many_copy(Process *c_p, Eterm msg, Uint sz,
+                                             Eterm *litp);
+void erts_send_many_release(Process *c_p, struct ErtsLiteralArea_ *area);
 ErlHeapFragment* new_message_buffer(Uint);
 ErlHeapFragment* erts_resize_message_buffer(ErlHeapFragment *, Uint,
 					    Eterm *, Uint);
@@ -483,7 +483,10 @@ enqueue_signals(Process *rp, ErtsMessage *first,
                 erts_aint32_t in_state)
 {
     erts_aint32_t state = in_state;
-    ErtsMessage **this = rp->sig_inq.last;
+    ErtsMessage **this;
+
+    erts_proc_sig_queue_flush_buffers(rp);
+    this = rp->sig_inq.last;
 
     ERTS_HDBG_CHECK_SIGNAL_IN_QUEUE(rp);
 
@@ -790,8 +793,10 @@ erts_proc_sig_fetch__(Process *proc)
             proc->sig_qs.cont_last = proc->sig_inq.last;
         }
         else {
-            *proc->sig_qs.last = proc->sig_inq.first;
+            ErtsMessage **last = proc->sig_qs.last;
+            *last = proc->sig_inq.first;
             proc->sig_qs.last = proc->sig_inq.last;
+            erts_recv_index_add(proc, last);
         }
     }
     else {
@@ -2806,9 +2811,10 @@ handle_process_info(Process *c_p, ErtsSigRecvTracing *tracing,
             ASSERT(tracing);
 
             if (*next_nm_sig != &c_p->sig_qs.cont) {
+                ErtsMessage **last = c_p->sig_qs.last;
                 if (*next_nm_sig == tracing->messages.next)
                     tracing->messages.next = &c_p->sig_qs.cont;
-                *c_p->sig_qs.last = c_p->sig_qs.cont;
+                *last = c_p->sig_qs.cont;
                 c_p->sig_qs.last = *next_nm_sig;
 
                 c_p->sig_qs.cont = **next_nm_sig;
@@ -2816,6 +2822,7 @@ handle_process_info(Process *c_p, ErtsSigRecvTracing *tracing,
                     c_p->sig_qs.nmsigs.last = &c_p->sig_qs.cont;
                 *next_nm_sig = &c_p->sig_qs.cont;
                 *c_p->sig_qs.last = NULL;
+                erts_recv_index_add(c_p, last);
             }
 
 #ifdef ERTS_PROC_SIG_HARD_DEBUG_SIGQ_MSG_LEN
@@ -3642,13 +3649,15 @@ stop: {
             }
 
             if (tracing.messages.next != &c_p->sig_qs.cont) {
-                *c_p->sig_qs.last = c_p->sig_qs.cont;
+                ErtsMessage **last = c_p->sig_qs.last;
+                *last = c_p->sig_qs.cont;
                 c_p->sig_qs.last = tracing.messages.next;
 
                 c_p->sig_qs.cont = *tracing.messages.next;
                 if (!c_p->sig_qs.cont)
                     c_p->sig_qs.cont_last = &c_p->sig_qs.cont;
                 *c_p->sig_qs.last = NULL;
+                erts_recv_index_add(c_p, last);
             }
 
             res = !c_p->sig_qs.cont;
@@ -3662,7 +3671,8 @@ stop: {
              */
             ASSERT(**next_nm_sig);
             if (*next_nm_sig != &c_p->sig_qs.cont) {
-                *c_p->sig_qs.last = c_p->sig_qs.cont;
+                ErtsMessage **last = c_p->sig_qs.last;
+                *last = c_p->sig_qs.cont;
                 c_p->sig_qs.last = *next_nm_sig;
 
                 c_p->sig_qs.cont = **next_nm_sig;
@@ -3670,6 +3680,7 @@ stop: {
                     c_p->sig_qs.nmsigs.last = &c_p->sig_qs.cont;
                 *next_nm_sig = &c_p->sig_qs.cont;
                 *c_p->sig_qs.last = NULL;
+                erts_recv_index_add(c_p, last);
             }
 
             ASSERT(c_p->sig_qs.cont);
@@ -3688,13 +3699,15 @@ stop: {
             c_p->sig_qs.nmsigs.last = NULL;
 
             if (c_p->sig_qs.cont_last != &c_p->sig_qs.cont) {
-                ASSERT(!*c_p->sig_qs.last);
-                *c_p->sig_qs.last = c_p->sig_qs.cont;
+                ErtsMessage **last = c_p->sig_qs.last;
+                ASSERT(!*last);
+                *last = c_p->sig_qs.cont;
                 c_p->sig_qs.last = c_p->sig_qs.cont_last;
                 ASSERT(!*c_p->sig_qs.last);
 
                 c_p->sig_qs.cont_last = &c_p->sig_qs.cont;
                 c_p->sig_qs.cont = NULL;
+                erts_recv_index_add(c_p, last);
             }
 
             ASSERT(!c_p->sig_qs.cont);
@@ -4475,6 +4488,8 @@ erts_proc_sig_prep_msgq_for_inspection(Process *c_p,
 
 		ASSERT(*mpp == bad_mp);
 
+                if (rp->sig_qs.recv_ix)
+                    erts_recv_index_remove(rp, mp, mpp);
                 remove_iq_m_sig(rp, mp, mpp);
 
                 mp = *mpp;
@@ -4759,6 +4774,697 @@ erts_proc_sig_debug_foreach_sig(Process *c_p,
     }
 }
 
+/*
+ * --- Receive index ---
+ *
+ * A process that has enabled process_flag(receive_index, true) keeps
+ * an index of the messages in its inner signal queue. Every message
+ * has an entry, found by message pointer in a hash table. Entries of
+ * messages that are tuples with an atom as first element are also
+ * linked, in queue order, into a list per tag and arity. Messages on
+ * external format have not been decoded yet, so their tag is not
+ * known. Their entries are linked into a list of their own, and are
+ * moved to the list of their tag once found to have been decoded.
+ *
+ * Each entry also records the next pointer that points to its
+ * message. The loader emits an i_recv_tagged instruction after
+ * loop_rec when the first clause of a receive matches a tuple with a
+ * known tag and all messages not matching it are skipped. When the
+ * process has an index, this instruction moves the save pointer
+ * straight to the next message that can match, instead of inspecting
+ * every message in between.
+ */
+
+#define ERTS_RECV_IX_MIN_ENTRIES 64
+#define ERTS_RECV_IX_MIN_KEYS 16
+
+typedef struct ErtsRecvIxKey_ ErtsRecvIxKey;
+typedef struct ErtsRecvIxEntry_ ErtsRecvIxEntry;
+
+struct ErtsRecvIxEntry_ {
+    ErtsRecvIxEntry *hnext;     /* Next in hash bucket */
+    ErtsRecvIxEntry *prev;      /* Previous message with same key */
+    ErtsRecvIxEntry *next;      /* Next message with same key */
+    ErtsRecvIxKey *key;         /* NULL if not a tagged tuple */
+    ErtsMessage *msg;
+    ErtsMessage **slot;         /* Next pointer pointing to msg */
+    Uint64 seq;                 /* Order in queue */
+};
+
+struct ErtsRecvIxKey_ {
+    ErtsRecvIxKey *hnext;
+    Eterm tag;
+    Eterm arityval;
+    ErtsRecvIxEntry *first;
+    ErtsRecvIxEntry *last;
+    ErtsRecvIxEntry *cursor;    /* Last entry skipped past, or NULL */
+};
+
+typedef struct ErtsRecvIndex_ {
+    Uint64 seq;
+    Uint no_entries;
+    Uint entries_mask;
+    ErtsRecvIxEntry **entries;
+    Uint no_keys;
+    Uint keys_mask;
+    ErtsRecvIxKey **keys;
+    ErtsRecvIxKey unknown;      /* Messages not yet decoded */
+} ErtsRecvIndex;
+
+static ERTS_INLINE Uint
+recv_ix_msg_hash(ErtsMessage *mp)
+{
+    UWord x = ((UWord) mp) >> 3;
+    return (Uint) (x ^ (x >> 13));
+}
+
+static ERTS_INLINE Uint
+recv_ix_key_hash(Eterm tag, Eterm arityval)
+{
+    return (Uint) (atom_val(tag) * 31 + arityval(arityval));
+}
+
+static void *
+recv_ix_alloc_table(Uint size)
+{
+    void **tab = erts_alloc(ERTS_ALC_T_RECV_INDEX, size * sizeof(void *));
+    sys_memzero(tab, size * sizeof(void *));
+    return tab;
+}
+
+static void
+recv_ix_resize_entries(ErtsRecvIndex *ix, Uint size)
+{
+    ErtsRecvIxEntry **tab = recv_ix_alloc_table(size);
+    Uint i;
+
+    for (i = 0; i <= ix->entries_mask; i++) {
+        ErtsRecvIxEntry *e = ix->entries[i];
+        while (e) {
+            ErtsRecvIxEntry *next = e->hnext;
+            Uint h = recv_ix_msg_hash(e->msg) & (size - 1);
+            e->hnext = tab[h];
+            tab[h] = e;
+            e = next;
+        }
+    }
+
+    erts_free(ERTS_ALC_T_RECV_INDEX, ix->entries);
+    ix->entries = tab;
+    ix->entries_mask = size - 1;
+}
+
+static void
+recv_ix_resize_keys(ErtsRecvIndex *ix, Uint size)
+{
+    ErtsRecvIxKey **tab = recv_ix_alloc_table(size);
+    Uint i;
+
+    for (i = 0; i <= ix->keys_mask; i++) {
+        ErtsRecvIxKey *k = ix->keys[i];
+        while (k) {
+            ErtsRecvIxKey *next = k->hnext;
+            Uint h = recv_ix_key_hash(k->tag, k->arityval) & (size - 1);
+            k->hnext = tab[h];
+            tab[h] = k;
+            k = next;
+        }
+    }
+
+    erts_free(ERTS_ALC_T_RECV_INDEX, ix->keys);
+    ix->keys = tab;
+    ix->keys_mask = size - 1;
+}
+
+static ERTS_INLINE ErtsRecvIxEntry *
+recv_ix_lookup(ErtsRecvIndex *ix, ErtsMessage *mp)
+{
+    ErtsRecvIxEntry *e = ix->entries[recv_ix_msg_hash(mp) & ix->entries_mask];
+    while (e && e->msg != mp)
+        e = e->hnext;
+    return e;
+}
+
+static ErtsRecvIxKey *
+recv_ix_key(ErtsRecvIndex *ix, Eterm tag, Eterm arityval, int create)
+{
+    ErtsRecvIxKey **bucket, *k;
+
+    bucket = &ix->keys[recv_ix_key_hash(tag, arityval) & ix->keys_mask];
+    for (k = *bucket; k; k = k->hnext) {
+        if (k->tag == tag && k->arityval == arityval)
+            return k;
+    }
+
+    if (!create)
+        return NULL;
+
+    k = erts_alloc(ERTS_ALC_T_RECV_INDEX, sizeof(ErtsRecvIxKey));
+    k->tag = tag;
+    k->arityval = arityval;
+    k->first = k->last = k->cursor = NULL;
+    k->hnext = *bucket;
+    *bucket = k;
+
+    if (++ix->no_keys > ix->keys_mask)
+        recv_ix_resize_keys(ix, 2 * (ix->keys_mask + 1));
+
+    return k;
+}
+
+static void
+recv_ix_remove_key(ErtsRecvIndex *ix, ErtsRecvIxKey *key)
+{
+    ErtsRecvIxKey **kp;
+
+    kp = &ix->keys[recv_ix_key_hash(key->tag, key->arityval) & ix->keys_mask];
+    while (*kp != key)
+        kp = &(*kp)->hnext;
+    *kp = key->hnext;
+    ix->no_keys--;
+    erts_free(ERTS_ALC_T_RECV_INDEX, key);
+}
+
+static ErtsRecvIxKey *
+recv_ix_msg_key(ErtsRecvIndex *ix, ErtsMessage *mp)
+{
+    Eterm msg, *tp;
+
+    if (ERTS_SIG_IS_EXTERNAL_MSG(mp))
+        return &ix->unknown;
+
+    msg = ERL_MESSAGE_TERM(mp);
+    if (is_not_tuple(msg))
+        return NULL;
+    tp = tuple_val(msg);
+    if (tp[0] == make_arityval(0) || is_not_atom(tp[1]))
+        return NULL;
+    return recv_ix_key(ix, tp[1], tp[0], !0);
+}
+
+static void
+recv_ix_link(ErtsRecvIxKey *key, ErtsRecvIxEntry *e)
+{
+    ErtsRecvIxEntry *prev = key->last;
+
+    /* Messages are almost always linked in last... */
+    while (prev && prev->seq > e->seq)
+        prev = prev->prev;
+
+    e->key = key;
+    e->prev = prev;
+    e->next = prev ? prev->next : key->first;
+    if (e->next)
+        e->next->prev = e;
+    else
+        key->last = e;
+    if (prev)
+        prev->next = e;
+    else
+        key->first = e;
+}
+
+static void
+recv_ix_unlink(ErtsRecvIndex *ix, ErtsRecvIxEntry *e)
+{
+    ErtsRecvIxKey *key = e->key;
+
+    if (key->cursor == e)
+        key->cursor = e->prev;
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        key->first = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        key->last = e->prev;
+    e->key = NULL;
+
+    if (!key->first && key != &ix->unknown)
+        recv_ix_remove_key(ix, key);
+}
+
+static void
+recv_ix_insert(ErtsRecvIndex *ix, ErtsMessage *mp, ErtsMessage **slot)
+{
+    ErtsRecvIxEntry *e, **bucket;
+    ErtsRecvIxKey *key;
+
+    ASSERT(ERTS_SIG_IS_MSG(mp));
+
+    e = erts_alloc(ERTS_ALC_T_RECV_INDEX, sizeof(ErtsRecvIxEntry));
+    e->msg = mp;
+    e->slot = slot;
+    e->seq = ix->seq++;
+
+    bucket = &ix->entries[recv_ix_msg_hash(mp) & ix->entries_mask];
+    e->hnext = *bucket;
+    *bucket = e;
+
+    key = recv_ix_msg_key(ix, mp);
+    if (key)
+        recv_ix_link(key, e);
+    else {
+        e->key = NULL;
+        e->prev = e->next = NULL;
+    }
+
+    if (++ix->no_entries > ix->entries_mask)
+        recv_ix_resize_entries(ix, 2 * (ix->entries_mask + 1));
+}
+
+void
+erts_recv_index_add__(Process *c_p, ErtsMessage **slot)
+{
+    ErtsRecvIndex *ix = c_p->sig_qs.recv_ix;
+
+    while (slot != c_p->sig_qs.last) {
+        ErtsMessage *mp = *slot;
+        recv_ix_insert(ix, mp, slot);
+        slot = &mp->next;
+    }
+}
+
+void
+erts_recv_index_remove(Process *c_p, ErtsMessage *mp, ErtsMessage **slot)
+{
+    ErtsRecvIndex *ix = c_p->sig_qs.recv_ix;
+    ErtsRecvIxEntry **ep, *e;
+
+    ASSERT(*slot == mp);
+
+    ep = &ix->entries[recv_ix_msg_hash(mp) & ix->entries_mask];
+    while (*ep && (*ep)->msg != mp)
+        ep = &(*ep)->hnext;
+
+    e = *ep;
+    ASSERT(e && e->slot == slot);
+    if (e) {
+        *ep = e->hnext;
+        if (e->key)
+            recv_ix_unlink(ix, e);
+        erts_free(ERTS_ALC_T_RECV_INDEX, e);
+        ix->no_entries--;
+    }
+
+    /* The next message will be pointed to by slot... */
+    if (mp->next) {
+        e = recv_ix_lookup(ix, mp->next);
+        ASSERT(e && e->slot == &mp->next);
+        if (e)
+            e->slot = slot;
+    }
+
+    if (ix->entries_mask >= ERTS_RECV_IX_MIN_ENTRIES
+        && ix->no_entries < (ix->entries_mask + 1) / 4)
+        recv_ix_resize_entries(ix, (ix->entries_mask + 1) / 2);
+}
+
+/*
+ * Return the first entry of key that may come after the message with
+ * sequence number seq. Skips normally move forward through the queue,
+ * so the walk resumes after the entry where the previous skip stopped
+ * unless the save pointer has been moved back since then.
+ */
+static ERTS_INLINE ErtsRecvIxEntry *
+recv_ix_key_start(ErtsRecvIxKey *key, Uint64 seq)
+{
+    if (key->cursor && key->cursor->seq <= seq)
+        return key->cursor->next;
+    key->cursor = NULL;
+    return key->first;
+}
+
+int
+erts_recv_index_skip(Process *c_p, Eterm tag, Eterm arityval)
+{
+    ErtsRecvIndex *ix = c_p->sig_qs.recv_ix;
+    ErtsMessage *mp = PEEK_MESSAGE(c_p);
+    ErtsRecvIxEntry *e, *cand;
+    ErtsRecvIxKey *key;
+    Uint64 seq;
+    int reds = 1;
+
+    ASSERT(ix && mp);
+
+    e = recv_ix_lookup(ix, mp);
+    ASSERT(e);
+    if (!e)
+        return 0;
+    seq = e->seq;
+
+    /*
+     * Move messages that have been decoded since they were
+     * indexed to their actual key. The first message after
+     * the current one that still is on external format may
+     * match...
+     */
+    cand = NULL;
+    e = recv_ix_key_start(&ix->unknown, seq);
+    while (e) {
+        ErtsRecvIxEntry *next = e->next;
+        if (ERTS_SIG_IS_EXTERNAL_MSG(e->msg)) {
+            if (e->seq > seq) {
+                cand = e;
+                break;
+            }
+            ix->unknown.cursor = e;
+        }
+        else {
+            recv_ix_unlink(ix, e);
+            key = recv_ix_msg_key(ix, e->msg);
+            if (key)
+                recv_ix_link(key, e);
+        }
+        reds++;
+        e = next;
+    }
+
+    key = recv_ix_key(ix, tag, arityval, 0);
+    if (key && key->last->seq > seq) {
+        for (e = recv_ix_key_start(key, seq); e->seq <= seq; e = e->next) {
+            key->cursor = e;
+            reds++;
+        }
+        if (!cand || e->seq < cand->seq)
+            cand = e;
+    }
+
+    /* No candidate; continue with new messages when they arrive... */
+    c_p->sig_qs.save = cand ? cand->slot : c_p->sig_qs.last;
+
+    return reds;
+}
+
+void
+erts_recv_index_destroy(Process *c_p)
+{
+    ErtsRecvIndex *ix = c_p->sig_qs.recv_ix;
+    Uint i;
+
+    if (!ix)
+        return;
+
+    for (i = 0; i <= ix->entries_mask; i++) {
+        ErtsRecvIxEntry *e = ix->entries[i];
+        while (e) {
+            ErtsRecvIxEntry *next = e->hnext;
+            erts_free(ERTS_ALC_T_RECV_INDEX, e);
+            e = next;
+        }
+    }
+    for (i = 0; i <= ix->keys_mask; i++) {
+        ErtsRecvIxKey *k = ix->keys[i];
+        while (k) {
+            ErtsRecvIxKey *next = k->hnext;
+            erts_free(ERTS_ALC_T_RECV_INDEX, k);
+            k = next;
+        }
+    }
+    erts_free(ERTS_ALC_T_RECV_INDEX, ix->entries);
+    erts_free(ERTS_ALC_T_RECV_INDEX, ix->keys);
+    erts_free(ERTS_ALC_T_RECV_INDEX, ix);
+
+    c_p->sig_qs.recv_ix = NULL;
+}
+
+Eterm
+erts_proc_sig_set_receive_index(Process *c_p, Eterm value)
+{
+    Eterm old_value = c_p->sig_qs.recv_ix ? am_true : am_false;
+
+    if (value == am_true) {
+        if (!c_p->sig_qs.recv_ix) {
+            ErtsRecvIndex *ix = erts_alloc(ERTS_ALC_T_RECV_INDEX,
+                                           sizeof(ErtsRecvIndex));
+            ix->seq = 0;
+            ix->no_entries = 0;
+            ix->entries_mask = ERTS_RECV_IX_MIN_ENTRIES - 1;
+            ix->entries = recv_ix_alloc_table(ERTS_RECV_IX_MIN_ENTRIES);
+            ix->no_keys = 0;
+            ix->keys_mask = ERTS_RECV_IX_MIN_KEYS - 1;
+            ix->keys = recv_ix_alloc_table(ERTS_RECV_IX_MIN_KEYS);
+            ix->unknown.hnext = NULL;
+            ix->unknown.tag = NIL;
+            ix->unknown.arityval = make_arityval(0);
+            ix->unknown.first = ix->unknown.last = NULL;
+            ix->unknown.cursor = NULL;
+            c_p->sig_qs.recv_ix = ix;
+
+            erts_recv_index_add__(c_p, &c_p->sig_qs.first);
+        }
+    }
+    else if (value == am_false)
+        erts_recv_index_destroy(c_p);
+    else
+        return THE_NON_VALUE;
+
+    return old_value;
+}
+
+/*
+ * In-queue buffers.
+ *
+ * A process whose msgq lock is found to be contended gets an
+ * array of buffers. Senders not holding any locks on the
+ * receiver put single messages in the buffer selected by a
+ * hash of the sender while only holding the lock of that
+ * buffer, so different senders seldom contend with each
+ * other. All messages from one sender go into the same
+ * buffer, and the buffers are moved into the outer queue
+ * before anything else is enqueued there, which preserves
+ * signal order between each pair of processes.
+ *
+ * Buffers are installed while holding the msgq lock of the
+ * receiver and stay until the process is freed.
+ */
+
+#define ERTS_PROC_SIG_INQ_BUFFERS_BITS 5
+#define ERTS_PROC_SIG_INQ_BUFFERS (1 << ERTS_PROC_SIG_INQ_BUFFERS_BITS)
+
+Uint ERTS_WRITE_UNLIKELY(erts_proc_sig_inq_buffer_limit);
+
+typedef struct {
+    erts_mtx_t lock;
+    ErtsMessage *first;
+    ErtsMessage **last;
+    Uint len;
+} ErtsSigInQBuffer;
+
+typedef struct {
+    union {
+        struct {
+            erts_atomic32_t nonempty;   /* Bit per non-empty buffer */
+            void *block;                /* Start of allocated block */
+        } hdr;
+        char align__[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(sizeof(erts_atomic32_t)
+                                                    + sizeof(void *))];
+    } u;
+    union {
+        ErtsSigInQBuffer buf;
+        char align__[ERTS_ALC_CACHE_LINE_ALIGN_SIZE(sizeof(ErtsSigInQBuffer))];
+    } slot[ERTS_PROC_SIG_INQ_BUFFERS];
+} ErtsSigInQBuffers;
+
+static ERTS_INLINE int
+sig_inq_buffer_index(Eterm from)
+{
+    UWord key;
+
+    if (is_internal_pid(from))
+        key = (UWord) internal_pid_data(from);
+    else
+        key = ((UWord) from) >> _TAG_IMMED1_SIZE;
+
+    key ^= key >> ERTS_PROC_SIG_INQ_BUFFERS_BITS;
+    return (int) (key & (ERTS_PROC_SIG_INQ_BUFFERS - 1));
+}
+
+void
+erts_proc_sig_queue_install_buffers(Process *rp)
+{
+    ErtsSigInQBuffers *bufs;
+    void *block;
+    int i;
+
+    ERTS_LC_ASSERT(ERTS_PROC_LOCK_MSGQ & erts_proc_lc_my_proc_locks(rp));
+
+    if (erts_atomic_read_nob(&rp->sig_inq_buffers))
+        return;
+
+    block = erts_alloc_fnf(ERTS_ALC_T_SIG_INQ_BUFFERS,
+                           sizeof(ErtsSigInQBuffers) + ERTS_CACHE_LINE_SIZE);
+    if (!block)
+        return;
+
+    bufs = (ErtsSigInQBuffers *) ((((UWord) block) + ERTS_CACHE_LINE_MASK)
+                                  & ~((UWord) ERTS_CACHE_LINE_MASK));
+    bufs->u.hdr.block = block;
+    erts_atomic32_init_nob(&bufs->u.hdr.nonempty, 0);
+    for (i = 0; i < ERTS_PROC_SIG_INQ_BUFFERS; i++) {
+        ErtsSigInQBuffer *buf = &bufs->slot[i].buf;
+        erts_mtx_init(&buf->lock, "proc_sig_inq_buffer", rp->common.id,
+                      ERTS_LOCK_FLAGS_CATEGORY_PROCESS);
+        buf->first = NULL;
+        buf->last = &buf->first;
+        buf->len = 0;
+    }
+
+    erts_atomic_set_relb(&rp->sig_inq_buffers, (erts_aint_t) bufs);
+}
+
+void
+erts_proc_sig_queue_lock(Process *rp)
+{
+    erts_aint32_t cnt;
+
+    /* A process sending to itself holds its main lock */
+    ERTS_LC_ASSERT(!(erts_proc_lc_my_proc_locks(rp) & ~ERTS_PROC_LOCK_MAIN));
+
+    if (!erts_proc_sig_inq_buffer_limit) {
+        erts_proc_lock(rp, ERTS_PROC_LOCK_MSGQ);
+        return;
+    }
+
+    if (erts_proc_trylock(rp, ERTS_PROC_LOCK_MSGQ) != EBUSY) {
+        if (erts_atomic32_read_nob(&rp->sig_inq_contention) > 0)
+            erts_atomic32_dec_nob(&rp->sig_inq_contention);
+        return;
+    }
+
+    erts_proc_lock(rp, ERTS_PROC_LOCK_MSGQ);
+
+    if (erts_atomic_read_nob(&rp->sig_inq_buffers))
+        return;
+
+    cnt = erts_atomic32_inc_read_nob(&rp->sig_inq_contention);
+    if ((Uint) cnt >= erts_proc_sig_inq_buffer_limit)
+        erts_proc_sig_queue_install_buffers(rp);
+}
+
+int
+erts_proc_sig_queue_enqueue_to_buffer__(Process *rp, ErtsMessage *msg)
+{
+    ErtsSigInQBuffers *bufs;
+    ErtsSigInQBuffer *buf;
+    erts_aint32_t state;
+    int ix;
+
+    ASSERT(ERTS_SIG_IS_MSG(msg));
+    ASSERT(!msg->next);
+    ERTS_LC_ASSERT(!(erts_proc_lc_my_proc_locks(rp) & ~ERTS_PROC_LOCK_MAIN));
+
+    bufs = (ErtsSigInQBuffers *) erts_atomic_read_acqb(&rp->sig_inq_buffers);
+    ASSERT(bufs);
+
+    state = erts_atomic32_read_nob(&rp->state);
+    if (state & ERTS_PSFLG_EXITING) {
+        /* Drop message if receiver is exiting or has a pending exit... */
+        erts_cleanup_messages(msg);
+        return 1;
+    }
+
+    ix = sig_inq_buffer_index(ERL_MESSAGE_FROM(msg));
+    buf = &bufs->slot[ix].buf;
+
+    erts_mtx_lock(&buf->lock);
+    *buf->last = msg;
+    buf->last = &msg->next;
+    if (buf->len++ == 0)
+        erts_atomic32_read_bor_nob(&bufs->u.hdr.nonempty,
+                                   (erts_aint32_t) (1U << ix));
+    erts_mtx_unlock(&buf->lock);
+
+    /*
+     * Pairs with the barrier in erts_proc_sig_deactivate_buffered__();
+     * either we see the receiver inactive, or it sees our buffer.
+     */
+    state = erts_atomic32_read_mb(&rp->state);
+    if (!(state & ERTS_PSFLG_ACTIVE))
+        erts_schedule_process(rp, state, 0);
+
+    return 1;
+}
+
+void
+erts_proc_sig_queue_flush_buffers__(Process *proc)
+{
+    ErtsSigInQBuffers *bufs;
+    Uint32 nonempty;
+
+    ERTS_LC_ASSERT(ERTS_PROC_IS_EXITING(proc)
+                   || (ERTS_PROC_LOCK_MSGQ
+                       & erts_proc_lc_my_proc_locks(proc)));
+
+    bufs = (ErtsSigInQBuffers *) erts_atomic_read_nob(&proc->sig_inq_buffers);
+    nonempty = (Uint32) erts_atomic32_read_acqb(&bufs->u.hdr.nonempty);
+
+    while (nonempty) {
+        int ix = 0;
+        ErtsSigInQBuffer *buf;
+
+        while (!(nonempty & (((Uint32) 1) << ix)))
+            ix++;
+        nonempty &= ~(((Uint32) 1) << ix);
+
+        buf = &bufs->slot[ix].buf;
+        erts_mtx_lock(&buf->lock);
+        if (buf->first) {
+            ERTS_HDBG_CHECK_SIGNAL_IN_QUEUE(proc);
+            ASSERT(!*proc->sig_inq.last);
+            *proc->sig_inq.last = buf->first;
+            proc->sig_inq.last = buf->last;
+            proc->sig_inq.len += buf->len;
+            ERTS_HDBG_CHECK_SIGNAL_IN_QUEUE(proc);
+            buf->first = NULL;
+            buf->last = &buf->first;
+            buf->len = 0;
+            erts_atomic32_read_band_nob(&bufs->u.hdr.nonempty,
+                                        ~((erts_aint32_t) (1U << ix)));
+        }
+        erts_mtx_unlock(&buf->lock);
+    }
+}
+
+void
+erts_proc_sig_deactivate_buffered__(Process *c_p, ErtsProcLocks locks)
+{
+    ErtsSigInQBuffers *bufs;
+    erts_aint32_t state;
+
+    bufs = (ErtsSigInQBuffers *) erts_atomic_read_nob(&c_p->sig_inq_buffers);
+    ASSERT(bufs);
+
+    state = erts_atomic32_read_band_mb(&c_p->state, ~ERTS_PSFLG_ACTIVE);
+    state &= ~ERTS_PSFLG_ACTIVE;
+
+    /* Messages put in a buffer by a sender that saw us active... */
+    if (erts_atomic32_read_nob(&bufs->u.hdr.nonempty))
+        erts_schedule_process(c_p, state, locks);
+}
+
+void
+erts_proc_sig_queue_free_buffers(Process *proc)
+{
+    ErtsSigInQBuffers *bufs;
+    int i;
+
+    bufs = (ErtsSigInQBuffers *) erts_atomic_read_nob(&proc->sig_inq_buffers);
+    if (!bufs)
+        return;
+
+    for (i = 0; i < ERTS_PROC_SIG_INQ_BUFFERS; i++) {
+        ErtsSigInQBuffer *buf = &bufs->slot[i].buf;
+        if (buf->first)
+            erts_cleanup_messages(buf->first);
+        erts_mtx_destroy(&buf->lock);
+    }
+
+    erts_free(ERTS_ALC_T_SIG_INQ_BUFFERS, bufs->u.hdr.block);
+    erts_atomic_set_nob(&proc->sig_inq_buffers, (erts_aint_t) NULL);
+}
+
 #ifdef ERTS_PROC_SIG_HARD_DEBUG
 
 static void
@@ -52,6 +52,16 @@
  *              a signal is located in the outer queue, it is still
  *              in transit between sender and receiver.
  *
+ *              A process whose msgq lock is frequently contended
+ *              gets in-queue buffers. Ordinary messages from senders
+ *              not holding any locks on the receiver are then placed
+ *              in one of these buffers, selected by sender, without
+ *              taking the msgq lock. The buffers are moved into the
+ *              outer queue, while holding the msgq lock, before any
+ *              other signal is enqueued there and when signals are
+ *              fetched, which preserves signal order between each
+ *              pair of sender and receiver.
+ *
  *              The middle and the inner queues are private to the
  *              receiving process and can only be accessed while
  *              holding the main process lock. The signal changes
@@ -1036,6 +1046,187 @@ erts_proc_sig_decode_dist(Process *proc, ErtsProcLocks proc_locks,
 ErtsDistExternal *
 erts_proc_sig_get_external(ErtsMessage *msgp);
 
+/**
+ *
+ * @brief Enable or disable the receive index of a process
+ *
+ * Implements process_flag(receive_index, Value). When
+ * enabled, messages in the inner signal queue are indexed
+ * on their tag, which lets receive skip messages that
+ * cannot match a tagged tuple pattern.
+ *
+ * @param[in]   c_p             Pointer to executing process
+ *
+ * @param[in]   value           'true' or 'false'
+ *
+ * @returns                     Old value, or THE_NON_VALUE
+ *                              on bad value.
+ */
+Eterm erts_proc_sig_set_receive_index(Process *c_p, Eterm value);
+
+/**
+ *
+ * @brief Index messages appended to the inner signal queue
+ *
+ * Should be called each time messages have been appended
+ * to the inner signal queue of a process.
+ *
+ * @param[in]   c_p             Pointer to process
+ *
+ * @param[in]   slot            Value 'sig_qs.last' had
+ *                              before the messages were
+ *                              appended.
+ */
+ERTS_GLB_INLINE void erts_recv_index_add(Process *c_p, ErtsMessage **slot);
+
+/**
+ *
+ * @brief Remove a message from the receive index
+ *
+ * Should be called just before a message is unlinked
+ * from the inner signal queue of a process that has a
+ * receive index.
+ *
+ * @param[in]   c_p             Pointer to process
+ *
+ * @param[in]   mp              Message to remove
+ *
+ * @param[in]   slot            Next pointer pointing to
+ *                              the message.
+ */
+void erts_recv_index_remove(Process *c_p, ErtsMessage *mp,
+                            ErtsMessage **slot);
+
+/**
+ *
+ * @brief Skip messages that cannot match a tagged tuple
+ *
+ * Moves the save pointer of the process from the current
+ * message, which should not match, to the next message that
+ * either is a tuple with the given tag and arity or has not
+ * been decoded yet. If there is no such message, the save
+ * pointer is moved to the end of the inner signal queue.
+ *
+ * @param[in]   c_p             Pointer to executing process
+ *                              with a receive index.
+ *
+ * @param[in]   tag             Tag (atom) of the tuple.
+ *
+ * @param[in]   arityval        Header word of the tuple.
+ *
+ * @returns                     Reductions to bump if the save
+ *                              pointer was moved; otherwise 0.
+ */
+int erts_recv_index_skip(Process *c_p, Eterm tag, Eterm arityval);
+
+/**
+ *
+ * @brief Free the receive index of an exiting process
+ *
+ * @param[in]   c_p             Pointer to process
+ */
+void erts_recv_index_destroy(Process *c_p);
+
+void erts_recv_index_add__(Process *c_p, ErtsMessage **slot);
+
+/*
+ * Number of contended acquisitions of the message queue lock
+ * of a process, in excess of uncontended ones, after which the
+ * process gets in-queue buffers. Zero disables the buffers.
+ * Set by the +zmqbl command line argument.
+ */
+extern Uint erts_proc_sig_inq_buffer_limit;
+
+/**
+ *
+ * @brief Lock the message queue lock of a receiver
+ *
+ * Locks ERTS_PROC_LOCK_MSGQ of a process on which the caller
+ * holds no locks other than possibly the main lock. If the
+ * lock is found to be contended often enough, in-queue buffers
+ * are installed on the process.
+ *
+ * @param[in]   rp              Pointer to receiving process
+ */
+void erts_proc_sig_queue_lock(Process *rp);
+
+/**
+ *
+ * @brief Install in-queue buffers on a process
+ *
+ * Does nothing if the process already has in-queue buffers
+ * or if they cannot be allocated. The message queue lock of
+ * the process must be held.
+ *
+ * @param[in]   rp              Pointer to process
+ */
+void erts_proc_sig_queue_install_buffers(Process *rp);
+
+/**
+ *
+ * @brief Try to enqueue a message in an in-queue buffer
+ *
+ * If the receiver has in-queue buffers, the message is
+ * placed in the buffer selected by its sender without
+ * taking the message queue lock of the receiver, and the
+ * receiver is scheduled if needed. Messages in the buffers
+ * are moved into the outer signal queue before anything
+ * else is enqueued there and when signals are fetched, so
+ * the order of signals from one sender is preserved.
+ *
+ * The caller should not hold any locks on the receiver other
+ * than possibly the main lock.
+ *
+ * @param[in]   rp              Pointer to receiving process
+ *
+ * @param[in]   msg             A single message signal
+ *
+ * @returns                     Non-zero if the message was
+ *                              consumed (enqueued or dropped
+ *                              since the receiver is exiting);
+ *                              otherwise zero.
+ */
+ERTS_GLB_INLINE int erts_proc_sig_queue_try_enqueue_to_buffer(Process *rp,
+                                                              ErtsMessage *msg);
+
+/**
+ *
+ * @brief Move messages in in-queue buffers to the outer queue
+ *
+ * The message queue lock of the process must be held.
+ *
+ * @param[in]   proc            Pointer to process
+ */
+ERTS_GLB_INLINE void erts_proc_sig_queue_flush_buffers(Process *proc);
+
+/**
+ *
+ * @brief Clear the active flag of a process about to wait
+ *
+ * Should be used instead of clearing ERTS_PSFLG_ACTIVE
+ * directly when a process waits for messages. Messages that
+ * were put into in-queue buffers after the process fetched
+ * its signals cause the process to be scheduled again.
+ *
+ * @param[in]   c_p             Pointer to executing process
+ *
+ * @param[in]   locks           Locks held on c_p
+ */
+ERTS_GLB_INLINE void erts_proc_sig_deactivate(Process *c_p,
+                                              ErtsProcLocks locks);
+
+/**
+ *
+ * @brief Free in-queue buffers and messages left in them
+ *
+ * @param[in]   proc            Pointer to process being freed
+ */
+void erts_proc_sig_queue_free_buffers(Process *proc);
+
+int erts_proc_sig_queue_enqueue_to_buffer__(Process *rp, ErtsMessage *msg);
+void erts_proc_sig_queue_flush_buffers__(Process *proc);
+void erts_proc_sig_deactivate_buffered__(Process *c_p, ErtsProcLocks locks);
+
 /**
  * @brief Initialize this functionality
  */
@@ -1072,6 +1263,8 @@ erts_proc_sig_fetch(Process *proc)
                        == (ERTS_PROC_LOCK_MAIN
                            | ERTS_PROC_LOCK_MSGQ)));
 
+    erts_proc_sig_queue_flush_buffers(proc);
+
     ERTS_HDBG_CHECK_SIGNAL_IN_QUEUE(proc);
     ERTS_HDBG_CHECK_SIGNAL_PRIV_QUEUE(proc, !0);
 
@@ -1121,6 +1314,37 @@ erts_proc_notify_new_sig(Process* rp, erts_aint32_t state,
     }
 }
 
+ERTS_GLB_INLINE void
+erts_recv_index_add(Process *c_p, ErtsMessage **slot)
+{
+    if (ERTS_UNLIKELY(c_p->sig_qs.recv_ix != NULL))
+        erts_recv_index_add__(c_p, slot);
+}
+
+ERTS_GLB_INLINE int
+erts_proc_sig_queue_try_enqueue_to_buffer(Process *rp, ErtsMessage *msg)
+{
+    if (ERTS_LIKELY(!erts_atomic_read_nob(&rp->sig_inq_buffers)))
+        return 0;
+    return erts_proc_sig_queue_enqueue_to_buffer__(rp, msg);
+}
+
+ERTS_GLB_INLINE void
+erts_proc_sig_queue_flush_buffers(Process *proc)
+{
+    if (ERTS_UNLIKELY(erts_atomic_read_nob(&proc->sig_inq_buffers)))
+        erts_proc_sig_queue_flush_buffers__(proc);
+}
+
+ERTS_GLB_INLINE void
+erts_proc_sig_deactivate(Process *c_p, ErtsProcLocks locks)
+{
+    if (ERTS_LIKELY(!erts_atomic_read_nob(&c_p->sig_inq_buffers)))
+        erts_atomic32_read_band_relb(&c_p->state, ~ERTS_PSFLG_ACTIVE);
+    else
+        erts_proc_sig_deactivate_buffered__(c_p, locks);
+}
+
 #endif /* ERTS_GLB_INLINE_INCL_FUNC_DEF */
 
 #endif /* ERTS_PROC_SIG_QUEUE_H__ */
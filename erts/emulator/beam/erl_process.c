@@ -80,6 +80,8 @@
 #define ERTS_SCHED_AUX_WORK_SLEEP_SPINCOUNT_FACT_NONE 0
 
 #define ERTS_SCHED_TSE_SLEEP_SPINCOUNT_FACT 1000
+#define ERTS_SCHED_ADAPTIVE_SPIN_MIN_NSEC 1000
+#define ERTS_SCHED_ADAPTIVE_SPIN_MAX_NSEC 50000
 #define ERTS_SCHED_SUSPEND_SLEEP_SPINCOUNT 0
 
 #if 0 || defined(DEBUG)
@@ -142,6 +144,8 @@ extern BeamInstr beam_continue_exit[];
 int ERTS_WRITE_UNLIKELY(erts_default_spo_flags) = SPO_ON_HEAP_MSGQ;
 int ERTS_WRITE_UNLIKELY(erts_sched_compact_load);
 int ERTS_WRITE_UNLIKELY(erts_sched_balance_util) = 0;
+int ERTS_WRITE_UNLIKELY(erts_sched_numa_aware) = 0;
+int ERTS_WRITE_UNLIKELY(erts_sched_dirty_fair_queuing) = 0;
 Uint ERTS_WRITE_UNLIKELY(erts_no_schedulers);
 Uint ERTS_WRITE_UNLIKELY(erts_no_total_schedulers);
 Uint ERTS_WRITE_UNLIKELY(erts_no_dirty_cpu_schedulers) = 0;
@@ -170,9 +174,11 @@ ErtsLcPSDLocks erts_psd_required_locks[ERTS_PSD_SIZE];
 typedef struct {
     int aux_work;
     int tse;
+    int adaptive;
 } ErtsBusyWaitParams;
 
 static ErtsBusyWaitParams sched_busy_wait_params[ERTS_SCHED_TYPE_LAST + 1];
+static int ERTS_WRITE_UNLIKELY(sched_wait_adaptive);
 
 static ERTS_INLINE ErtsBusyWaitParams *
 sched_get_busy_wait_params(ErtsSchedulerData *esdp)
@@ -344,6 +350,8 @@ static erts_atomic32_t function_calls;
 static erts_atomic32_t doing_sys_schedule;
 #endif
 static erts_atomic32_t no_empty_run_queues;
+static erts_atomic32_t runq_delay_enabled;
+static erts_atomic32_t sched_wakeup_latency_enabled;
 long erts_runq_supervision_interval = 0;
 static ethr_event runq_supervision_event;
 static erts_tid_t runq_supervisor_tid;
@@ -732,6 +740,16 @@ erts_pre_init_process(void)
         = ERTS_PSD_PENDING_SUSPEND_GET_LOCKS;
     erts_psd_required_locks[ERTS_PSD_PENDING_SUSPEND].set_locks
         = ERTS_PSD_PENDING_SUSPEND_SET_LOCKS;
+
+    erts_psd_required_locks[ERTS_PSD_GC_AGING].get_locks
+        = ERTS_PSD_GC_AGING_GET_LOCKS;
+    erts_psd_required_locks[ERTS_PSD_GC_AGING].set_locks
+        = ERTS_PSD_GC_AGING_SET_LOCKS;
+
+    erts_psd_required_locks[ERTS_PSD_INCR_MAJOR_GC].get_locks
+        = ERTS_PSD_INCR_MAJOR_GC_GET_LOCKS;
+    erts_psd_required_locks[ERTS_PSD_INCR_MAJOR_GC].set_locks
+        = ERTS_PSD_INCR_MAJOR_GC_SET_LOCKS;
 #endif
 }
 
@@ -1401,6 +1419,172 @@ erts_sched_wall_time_request(Process *c_p, int set, int enable,
     return ref;
 }
 
+/*
+ * Scheduler data of normal, dirty cpu, and dirty io schedulers
+ * numbered as in statistics(scheduler_wall_time_all).
+ */
+static ErtsSchedulerData *
+any_scheduler_ix(int ix)
+{
+    if (ix < erts_no_schedulers)
+        return ERTS_SCHEDULER_IX(ix);
+    ix -= erts_no_schedulers;
+    if (ix < erts_no_dirty_cpu_schedulers)
+        return ERTS_DIRTY_CPU_SCHEDULER_IX(ix);
+    ix -= erts_no_dirty_cpu_schedulers;
+    return ERTS_DIRTY_IO_SCHEDULER_IX(ix);
+}
+
+/*
+ * Busy wait information for all schedulers, as
+ * [{SchedulerId, SpinCount, WakeupLatency, SpinWaste}]
+ */
+Eterm
+erts_sched_wait_info(Process *c_p)
+{
+    int no = (int) (erts_no_schedulers
+                    + erts_no_dirty_cpu_schedulers
+                    + erts_no_dirty_io_schedulers);
+    int per_sched = 1 + 2*ERTS_SCHED_WAIT_HIST_SIZE;
+    Uint *vals = erts_alloc(ERTS_ALC_T_TMP, sizeof(Uint)*no*per_sched);
+    Uint sz, *szp, *hp, **hpp;
+    Eterm res;
+    int ix, i;
+
+    for (ix = 0; ix < no; ix++) {
+        ErtsSchedWaitInfo *swi = &any_scheduler_ix(ix)->sched_wait;
+        Uint *v = &vals[ix*per_sched];
+
+        v[0] = (Uint) erts_atomic32_read_nob(&swi->spincount);
+        for (i = 0; i < ERTS_SCHED_WAIT_HIST_SIZE; i++) {
+            v[1+i] = (Uint) erts_atomic_read_nob(&swi->wakeup_latency[i]);
+            v[1+ERTS_SCHED_WAIT_HIST_SIZE+i]
+                = (Uint) erts_atomic_read_nob(&swi->spin_waste[i]);
+        }
+    }
+
+    sz = 0;
+    szp = &sz;
+    hpp = NULL;
+    while (1) {
+        res = NIL;
+        for (ix = no - 1; ix >= 0; ix--) {
+            Eterm latency[ERTS_SCHED_WAIT_HIST_SIZE];
+            Eterm waste[ERTS_SCHED_WAIT_HIST_SIZE];
+            Eterm spincount, tpl;
+            Uint *v = &vals[ix*per_sched];
+
+            spincount = erts_bld_uint(hpp, szp, v[0]);
+            for (i = 0; i < ERTS_SCHED_WAIT_HIST_SIZE; i++) {
+                latency[i] = erts_bld_uint(hpp, szp, v[1+i]);
+                waste[i] = erts_bld_uint(hpp, szp,
+                                         v[1+ERTS_SCHED_WAIT_HIST_SIZE+i]);
+            }
+            tpl = erts_bld_tuple(hpp, szp, 4,
+                                 make_small(ix+1),
+                                 spincount,
+                                 erts_bld_tuplev(hpp, szp,
+                                                 ERTS_SCHED_WAIT_HIST_SIZE,
+                                                 latency),
+                                 erts_bld_tuplev(hpp, szp,
+                                                 ERTS_SCHED_WAIT_HIST_SIZE,
+                                                 waste));
+            res = erts_bld_cons(hpp, szp, tpl, res);
+        }
+        if (hpp)
+            break;
+        hp = HAlloc(c_p, sz);
+        szp = NULL;
+        hpp = &hp;
+    }
+
+    erts_free(ERTS_ALC_T_TMP, vals);
+    return res;
+}
+
+int
+erts_sched_set_wakeup_latency(int enable)
+{
+    return (int) erts_atomic32_xchg_nob(&sched_wakeup_latency_enabled,
+                                        (erts_aint32_t) !!enable);
+}
+
+int
+erts_sched_set_runq_delay(int enable)
+{
+    return (int) erts_atomic32_xchg_nob(&runq_delay_enabled,
+                                        (erts_aint32_t) !!enable);
+}
+
+/*
+ * Histograms of how long processes have waited in run queues
+ * before being scheduled, as [{SchedulerId, [{Prio, Hist}]}],
+ * or 'undefined' if not enabled.
+ */
+Eterm
+erts_sched_runq_delay_info(Process *c_p)
+{
+    static const Eterm prio_names[ERTS_NO_PROC_PRIO_LEVELS]
+        = {am_max, am_high, am_normal, am_low};
+    int no, per_sched, ix, prio, i;
+    Uint sz, *szp, *hp, **hpp, *vals;
+    Eterm res;
+
+    if (!erts_atomic32_read_nob(&runq_delay_enabled))
+        return am_undefined;
+
+    no = (int) (erts_no_schedulers
+                + erts_no_dirty_cpu_schedulers
+                + erts_no_dirty_io_schedulers);
+    per_sched = ERTS_NO_PROC_PRIO_LEVELS*ERTS_SCHED_WAIT_HIST_SIZE;
+    vals = erts_alloc(ERTS_ALC_T_TMP, sizeof(Uint)*no*per_sched);
+
+    for (ix = 0; ix < no; ix++) {
+        ErtsSchedWaitInfo *swi = &any_scheduler_ix(ix)->sched_wait;
+        Uint *v = &vals[ix*per_sched];
+        for (prio = 0; prio < ERTS_NO_PROC_PRIO_LEVELS; prio++) {
+            for (i = 0; i < ERTS_SCHED_WAIT_HIST_SIZE; i++)
+                v[prio*ERTS_SCHED_WAIT_HIST_SIZE + i]
+                    = (Uint) erts_atomic_read_nob(&swi->runq_delay[prio][i]);
+        }
+    }
+
+    sz = 0;
+    szp = &sz;
+    hpp = NULL;
+    while (1) {
+        res = NIL;
+        for (ix = no - 1; ix >= 0; ix--) {
+            Eterm prios = NIL;
+            Uint *v = &vals[ix*per_sched];
+            for (prio = ERTS_NO_PROC_PRIO_LEVELS - 1; prio >= 0; prio--) {
+                Eterm hist[ERTS_SCHED_WAIT_HIST_SIZE];
+                Eterm tpl;
+                for (i = 0; i < ERTS_SCHED_WAIT_HIST_SIZE; i++)
+                    hist[i] = erts_bld_uint(hpp, szp,
+                                            v[prio*ERTS_SCHED_WAIT_HIST_SIZE
+                                              + i]);
+                tpl = erts_bld_tuplev(hpp, szp, ERTS_SCHED_WAIT_HIST_SIZE,
+                                      hist);
+                tpl = erts_bld_tuple(hpp, szp, 2, prio_names[prio], tpl);
+                prios = erts_bld_cons(hpp, szp, tpl, prios);
+            }
+            res = erts_bld_cons(hpp, szp,
+                                erts_bld_tuple(hpp, szp, 2,
+                                               make_small(ix+1), prios),
+                                res);
+        }
+        if (hpp)
+            break;
+        hp = HAlloc(c_p, sz);
+        szp = NULL;
+        hpp = &hp;
+    }
+
+    erts_free(ERTS_ALC_T_TMP, vals);
+    return res;
+}
+
 static void
 reply_system_check(void *vscrp)
 {
@@ -1568,6 +1752,11 @@ erts_sched_finish_poke(ErtsSchedulerSleepInfo *ssi,
 	erts_check_io_interrupt(ssi->psi, 1);
 	/* fall through */
     case ERTS_SSI_FLG_TSE_SLEEPING:
+	if (sched_wait_adaptive
+	    || erts_atomic32_read_nob(&sched_wakeup_latency_enabled))
+	    erts_atomic64_cmpxchg_nob(&ssi->wake_time,
+				      (erts_aint64_t) erts_get_monotonic_time(NULL),
+				      (erts_aint64_t) 0);
 	erts_tse_set(ssi->event);
 	break;
     case 0:
@@ -2971,7 +3160,7 @@ sched_prep_cont_spin_wait(ErtsSchedulerSleepInfo *ssi)
 }
 
 static erts_aint32_t
-sched_spin_wait(ErtsSchedulerSleepInfo *ssi, int spincount)
+sched_spin_wait(ErtsSchedulerSleepInfo *ssi, int spincount, int *spunp)
 {
     int until_yield = ERTS_SCHED_SPIN_UNTIL_YIELD;
     int sc = spincount;
@@ -2989,9 +3178,139 @@ sched_spin_wait(ErtsSchedulerSleepInfo *ssi, int spincount)
 	    erts_thr_yield();
 	}
     } while (--sc > 0);
+    if (spunp)
+	*spunp = sc > 0 ? spincount - sc : spincount;
     return flgs;
 }
 
+static void
+init_sched_wait_info(ErtsSchedulerData *esdp)
+{
+    ErtsSchedWaitInfo *swi = &esdp->sched_wait;
+    int i;
+
+    swi->idle_avg = ERTS_SCHED_ADAPTIVE_SPIN_MAX_NSEC;
+    swi->spin_cost = 0;
+    erts_atomic32_init_nob(&swi->spincount,
+                           (erts_aint32_t) sched_get_busy_wait_params(esdp)->tse);
+    for (i = 0; i < ERTS_SCHED_WAIT_HIST_SIZE; i++) {
+        int prio;
+        erts_atomic_init_nob(&swi->wakeup_latency[i], 0);
+        erts_atomic_init_nob(&swi->spin_waste[i], 0);
+        for (prio = 0; prio < ERTS_NO_PROC_PRIO_LEVELS; prio++)
+            erts_atomic_init_nob(&swi->runq_delay[prio][i], 0);
+    }
+}
+
+static ERTS_INLINE void
+sched_wait_hist_inc(erts_atomic_t *hist, Sint64 nsec)
+{
+    /*
+     * Log2 buckets of microseconds. The first bucket counts
+     * times below one microsecond and the last one everything
+     * from 2^(ERTS_SCHED_WAIT_HIST_SIZE-2) microseconds and up.
+     */
+    Sint64 usec = nsec / 1000;
+    int ix;
+
+    if (usec <= 0)
+        ix = 0;
+    else if (usec >= ((Sint64) 1) << (ERTS_SCHED_WAIT_HIST_SIZE - 2))
+        ix = ERTS_SCHED_WAIT_HIST_SIZE - 1;
+    else
+        ix = erts_fit_in_bits_uint((Uint) usec);
+
+    /* Only modified by the scheduler itself... */
+    erts_atomic_set_nob(&hist[ix], erts_atomic_read_nob(&hist[ix]) + 1);
+}
+
+/*
+ * The scheduler spun 'spincount' times during 'spin_time'
+ * nanoseconds; update the average cost of 16 spins.
+ */
+static void
+sched_wait_spin_cost(ErtsSchedulerData *esdp, int spincount, Sint64 spin_time)
+{
+    ErtsSchedWaitInfo *swi = &esdp->sched_wait;
+
+    if (sched_get_busy_wait_params(esdp)->adaptive && spincount > 0) {
+        Sint64 cost = (spin_time * 16) / spincount;
+        if (swi->spin_cost == 0)
+            swi->spin_cost = cost;
+        else
+            swi->spin_cost += (cost - swi->spin_cost) / 4;
+        if (swi->spin_cost <= 0)
+            swi->spin_cost = 1;
+    }
+}
+
+/*
+ * The scheduler spun 'spincount' times during 'spin_time'
+ * nanoseconds without getting woken, and is about to sleep.
+ */
+static void
+sched_wait_spun(ErtsSchedulerData *esdp, int spincount, Sint64 spin_time)
+{
+    sched_wait_hist_inc(esdp->sched_wait.spin_waste, spin_time);
+    sched_wait_spin_cost(esdp, spincount, spin_time);
+}
+
+/*
+ * The scheduler was woken after sleeping since 'sleep_start'.
+ * The one waking it up stamps the time when it did so...
+ */
+static void
+sched_wait_woken(ErtsSchedulerData *esdp, ErtsMonotonicTime sleep_start,
+                 ErtsMonotonicTime now)
+{
+    ErtsMonotonicTime wake_time;
+
+    wake_time = (ErtsMonotonicTime)
+        erts_atomic64_xchg_nob(&esdp->ssi->wake_time, 0);
+    if (sleep_start <= wake_time && wake_time <= now)
+        sched_wait_hist_inc(esdp->sched_wait.wakeup_latency,
+                            ERTS_MONOTONIC_TO_NSEC(now - wake_time));
+}
+
+/*
+ * Adaptive busy wait. If work typically arrives sooner than
+ * it costs to go to sleep and be woken, spin for twice the
+ * average idle time; otherwise only spin for a short while.
+ */
+static void
+sched_wait_adapt(ErtsSchedulerData *esdp, Sint64 idle_time)
+{
+    ErtsSchedWaitInfo *swi = &esdp->sched_wait;
+    Sint64 spin_time, spincount;
+
+    if (idle_time > 2*ERTS_SCHED_ADAPTIVE_SPIN_MAX_NSEC)
+        idle_time = 2*ERTS_SCHED_ADAPTIVE_SPIN_MAX_NSEC;
+    swi->idle_avg += (idle_time - swi->idle_avg) / 4;
+
+    if (swi->spin_cost == 0)
+        return; /* Keep initial spincount until we know the cost */
+
+    if (swi->idle_avg >= ERTS_SCHED_ADAPTIVE_SPIN_MAX_NSEC)
+        spin_time = ERTS_SCHED_ADAPTIVE_SPIN_MIN_NSEC;
+    else {
+        spin_time = 2*swi->idle_avg;
+        if (spin_time < ERTS_SCHED_ADAPTIVE_SPIN_MIN_NSEC)
+            spin_time = ERTS_SCHED_ADAPTIVE_SPIN_MIN_NSEC;
+        else if (spin_time > ERTS_SCHED_ADAPTIVE_SPIN_MAX_NSEC)
+            spin_time = ERTS_SCHED_ADAPTIVE_SPIN_MAX_NSEC;
+    }
+
+    spincount = (spin_time * 16) / swi->spin_cost;
+    if (spincount > (ERTS_SCHED_SYS_SLEEP_SPINCOUNT_VERY_LONG
+                     * ERTS_SCHED_TSE_SLEEP_SPINCOUNT_FACT))
+        spincount = (ERTS_SCHED_SYS_SLEEP_SPINCOUNT_VERY_LONG
+                     * ERTS_SCHED_TSE_SLEEP_SPINCOUNT_FACT);
+    else if (spincount < 1)
+        spincount = 1;
+
+    erts_atomic32_set_nob(&swi->spincount, (erts_aint32_t) spincount);
+}
+
 static erts_aint32_t
 sched_set_sleeptype(ErtsSchedulerSleepInfo *ssi, erts_aint32_t sleep_type)
 {
@@ -3147,7 +3466,7 @@ aux_thread(void *unused)
 
 #if ERTS_POLL_USE_FALLBACK
 
-	    flgs = sched_spin_wait(ssi, 0);
+	    flgs = sched_spin_wait(ssi, 0, NULL);
 
 	    if (flgs & ERTS_SSI_FLG_SLEEPING) {
 		ASSERT(flgs & ERTS_SSI_FLG_WAITING);
@@ -3161,7 +3480,7 @@ aux_thread(void *unused)
 #else
             erts_thr_progress_prepare_wait(tpd);
 
-	    flgs = sched_spin_wait(ssi, 0);
+	    flgs = sched_spin_wait(ssi, 0, NULL);
 
 	    if (flgs & ERTS_SSI_FLG_SLEEPING) {
 		flgs = sched_set_sleeptype(ssi, ERTS_SSI_FLG_TSE_SLEEPING);
@@ -3245,7 +3564,7 @@ poll_thread(void *arg)
 	    if (thr_prgr_active)
 		erts_thr_progress_active(tpd, thr_prgr_active = 0);
 
-	    flgs = sched_spin_wait(ssi, 0);
+	    flgs = sched_spin_wait(ssi, 0, NULL);
 
 	    if (flgs & ERTS_SSI_FLG_SLEEPING) {
 		ASSERT(flgs & ERTS_SSI_FLG_WAITING);
@@ -3378,7 +3697,10 @@ scheduler_wait(int *fcalls, ErtsSchedulerData *esdp, ErtsRunQueue *rq)
 
     erts_runq_unlock(rq);
 
-    spincount = sched_get_busy_wait_params(esdp)->tse;
+    if (ERTS_RUNQ_IS_DIRTY_CPU_RUNQ(rq))
+        erts_par_copy_help();
+
+    spincount = (int) erts_atomic32_read_nob(&esdp->sched_wait.spincount);
 
     if (ERTS_SCHEDULER_IS_DIRTY(esdp))
         dirty_sched_wall_time_change(esdp, working = 0);
@@ -3439,7 +3761,7 @@ scheduler_wait(int *fcalls, ErtsSchedulerData *esdp, ErtsRunQueue *rq)
                     erts_thr_progress_active(erts_thr_prgr_data(esdp), thr_prgr_active = 0);
                     sched_wall_time_change(esdp, 0);
                 }
-                flgs = sched_spin_wait(ssi, 0);
+                flgs = sched_spin_wait(ssi, 0, NULL);
                 if (flgs & ERTS_SSI_FLG_SLEEPING) {
                     ASSERT(flgs & ERTS_SSI_FLG_WAITING);
                     flgs = sched_set_sleeptype(ssi, ERTS_SSI_FLG_POLL_SLEEPING);
@@ -3453,23 +3775,32 @@ scheduler_wait(int *fcalls, ErtsSchedulerData *esdp, ErtsRunQueue *rq)
                 *fcalls = 0;
                 clear_sys_scheduling();
             } else {
+                ErtsMonotonicTime spin_start;
+                int spun, slept;
                 if (!ERTS_SCHEDULER_IS_DIRTY(esdp)) {
                     if (thr_prgr_active) {
                         erts_thr_progress_active(erts_thr_prgr_data(esdp), thr_prgr_active = 0);
                         sched_wall_time_change(esdp, 0);
                     }
                     erts_thr_progress_prepare_wait(erts_thr_prgr_data(esdp));
+                    spin_start = current_time;
                 }
-                flgs = sched_spin_wait(ssi, spincount);
-                if (flgs & ERTS_SSI_FLG_SLEEPING) {
+                else
+                    spin_start = erts_get_monotonic_time(esdp);
+                flgs = sched_spin_wait(ssi, spincount, &spun);
+                slept = !!(flgs & ERTS_SSI_FLG_SLEEPING);
+                if (slept) {
+                    ErtsMonotonicTime sleep_start = erts_get_monotonic_time(esdp);
+                    sched_wait_spun(esdp, spun,
+                                    ERTS_MONOTONIC_TO_NSEC(sleep_start
+                                                           - spin_start));
                     ASSERT(flgs & ERTS_SSI_FLG_WAITING);
                     flgs = sched_set_sleeptype(ssi, ERTS_SSI_FLG_TSE_SLEEPING);
                     if (flgs & ERTS_SSI_FLG_SLEEPING) {
                         int res;
                         ASSERT(flgs & ERTS_SSI_FLG_TSE_SLEEPING);
                         ASSERT(flgs & ERTS_SSI_FLG_WAITING);
-                        current_time = ERTS_SCHEDULER_IS_DIRTY(esdp) ? 0 :
-                            erts_get_monotonic_time(esdp);
+                        current_time = sleep_start;
                         do {
                             Sint64 timeout;
                             if (current_time >= timeout_time)
@@ -3483,11 +3814,20 @@ scheduler_wait(int *fcalls, ErtsSchedulerData *esdp, ErtsRunQueue *rq)
                             ERTS_MSACC_SET_STATE_CACHED(ERTS_MSACC_STATE_SLEEP);
                             res = erts_tse_twait(ssi->event, timeout);
                             ERTS_MSACC_POP_STATE();
-                            current_time = ERTS_SCHEDULER_IS_DIRTY(esdp) ? 0 :
-                                erts_get_monotonic_time(esdp);
+                            current_time = erts_get_monotonic_time(esdp);
                         } while (res == EINTR);
+                        sched_wait_woken(esdp, sleep_start, current_time);
                     }
                 }
+                if (sched_get_busy_wait_params(esdp)->adaptive) {
+                    Sint64 idle_time;
+                    idle_time = ERTS_MONOTONIC_TO_NSEC(erts_get_monotonic_time(esdp)
+                                                       - spin_start);
+                    /* Woken while spinning; also tells the spin cost */
+                    if (!slept)
+                        sched_wait_spin_cost(esdp, spun, idle_time);
+                    sched_wait_adapt(esdp, idle_time);
+                }
                 if (!ERTS_SCHEDULER_IS_DIRTY(esdp))
                     erts_thr_progress_finalize_wait(erts_thr_prgr_data(esdp));
             }
@@ -3623,8 +3963,8 @@ wake_scheduler(ErtsRunQueue *rq)
     ssi_wake(rq->scheduler->ssi);
 }
 
-static void
-wake_dirty_scheduler(ErtsRunQueue *rq)
+static int
+wake_dirty_sleeper(ErtsRunQueue *rq)
 {
     ErtsSchedulerSleepInfo *lo_ssi, *fo_ssi;
     ErtsSchedulerSleepList *sl;
@@ -3637,7 +3977,7 @@ wake_dirty_scheduler(ErtsRunQueue *rq)
     lo_ssi = sl->list;
     if (!lo_ssi) {
 	erts_spin_unlock(&sl->lock);
-        wake_scheduler(rq);
+        return 0;
     }
     else {
 	erts_aint32_t flgs;
@@ -3659,9 +3999,29 @@ wake_dirty_scheduler(ErtsRunQueue *rq)
 	ERTS_THR_MEMORY_BARRIER;
 	flgs = ssi_flags_set_wake(fo_ssi);
 	erts_sched_finish_poke(fo_ssi, flgs);
+        return 1;
     }
 }
 
+static void
+wake_dirty_scheduler(ErtsRunQueue *rq)
+{
+    if (!wake_dirty_sleeper(rq))
+        wake_scheduler(rq);
+}
+
+/*
+ * Wake up to n sleeping dirty CPU schedulers without giving them any
+ * process to run; used to have them help out with work such as
+ * parallel copying of large terms.
+ */
+void
+erts_wake_dirty_cpu_schedulers(int n)
+{
+    while (n-- > 0 && wake_dirty_sleeper(ERTS_DIRTY_CPU_RUNQ))
+        ;
+}
+
 #define ERTS_NO_USED_RUNQS_SHIFT 16
 #define ERTS_NO_RUNQS_MASK 0xffffU
 
@@ -3821,10 +4181,271 @@ erts_sched_notify_check_cpu_bind(void)
 }
 
 
+/*
+ * Fair queuing of dirty work. Processes in a dirty run queue are
+ * grouped into classes by the module of the function they are
+ * executing (typically the module of the dirty NIF). Each class
+ * has its own priority queues and a virtual 'pass' that is
+ * advanced by the dirty execution time charged to the class
+ * divided by its weight. Within a priority, the non-empty class
+ * with the lowest pass is served first, so a module flooding a
+ * dirty run queue cannot starve other modules.
+ */
+
+static ERTS_INLINE ErtsDirtyRunQueueClass *
+dirty_class_lookup(ErtsDirtyRunQueueClasses *dcs, Eterm module, int create)
+{
+    int i, ix;
+
+    ASSERT(is_atom(module));
+    ix = (int) (atom_val(module) % ERTS_DIRTY_RUNQ_CLASSES);
+    for (i = 0; i < ERTS_DIRTY_RUNQ_CLASSES; i++) {
+	ErtsDirtyRunQueueClass *cls = &dcs->cls[ix];
+	if (cls->module == module)
+	    return cls;
+	if (is_non_value(cls->module)) {
+	    if (!create)
+		return NULL;
+	    cls->module = module;
+	    return cls;
+	}
+	if (++ix == ERTS_DIRTY_RUNQ_CLASSES)
+	    ix = 0;
+    }
+
+    return NULL; /* Table full */
+}
+
+/* Would dirty_class_lookup() with create set find a class slot? */
+static ERTS_INLINE int
+dirty_class_can_create(ErtsDirtyRunQueueClasses *dcs, Eterm module)
+{
+    int i, ix;
+
+    ASSERT(is_atom(module));
+    ix = (int) (atom_val(module) % ERTS_DIRTY_RUNQ_CLASSES);
+    for (i = 0; i < ERTS_DIRTY_RUNQ_CLASSES; i++) {
+	ErtsDirtyRunQueueClass *cls = &dcs->cls[ix];
+	if (cls->module == module || is_non_value(cls->module))
+	    return 1;
+	if (++ix == ERTS_DIRTY_RUNQ_CLASSES)
+	    ix = 0;
+    }
+
+    return 0;
+}
+
+static ERTS_INLINE ErtsRunPrioQueue *
+dirty_class_enqueue_queue(ErtsDirtyRunQueueClasses *dcs, int prio_q,
+			  Process *p)
+{
+    ErtsCodeMFA *mfa = p->current;
+    ErtsDirtyRunQueueClass *cls;
+
+    cls = dirty_class_lookup(dcs, mfa ? mfa->module : am_undefined, 1);
+    if (!cls) /* Table full; share the always present 'undefined' class */
+	cls = dirty_class_lookup(dcs, am_undefined, 0);
+    /* An idle class should not be able to save up service... */
+    if (cls->len++ == 0 && cls->pass < dcs->pass)
+	cls->pass = dcs->pass;
+    return &cls->prio[prio_q];
+}
+
+static ERTS_INLINE ErtsRunPrioQueue *
+dirty_class_select(ErtsDirtyRunQueueClasses *dcs, int prio_q)
+{
+    ErtsDirtyRunQueueClass *sel = NULL;
+    int i;
+
+    for (i = 0; i < ERTS_DIRTY_RUNQ_CLASSES; i++) {
+	ErtsDirtyRunQueueClass *cls = &dcs->cls[i];
+	if (cls->prio[prio_q].first && (!sel || cls->pass < sel->pass))
+	    sel = cls;
+    }
+
+    if (!sel) {
+	/* Empty; let the caller see an empty queue */
+	dcs->selected = NULL;
+	return &dcs->cls[0].prio[prio_q];
+    }
+
+    dcs->selected = sel;
+    if (dcs->pass < sel->pass)
+	dcs->pass = sel->pass;
+    return &sel->prio[prio_q];
+}
+
+static ERTS_INLINE ErtsRunPrioQueue *
+runq_prio_queue(ErtsRunQueue *runq, int prio_q)
+{
+    if (runq->dirty_classes)
+	return dirty_class_select(runq->dirty_classes, prio_q);
+    return &runq->procs.prio[prio_q];
+}
+
+static ERTS_INLINE void
+dirty_class_charge(ErtsSchedulerData *esdp)
+{
+    ErtsDirtyRunQueueClass *cls = esdp->dirty_class;
+    ErtsMonotonicTime now = erts_get_monotonic_time(esdp);
+
+    if (now > esdp->dirty_class_start)
+	cls->pass += ((Uint64) ERTS_MONOTONIC_TO_NSEC(now - esdp->dirty_class_start)
+		      / cls->weight);
+    cls->executed++;
+    esdp->dirty_class = NULL;
+}
+
+static ErtsDirtyRunQueueClasses *
+init_dirty_classes(void)
+{
+    ErtsDirtyRunQueueClasses *dcs;
+    int i, j;
+
+    dcs = erts_alloc_permanent_cache_aligned(ERTS_ALC_T_DIRTY_RUNQ_CLS,
+					     sizeof(ErtsDirtyRunQueueClasses));
+    dcs->pass = 0;
+    dcs->selected = NULL;
+    for (i = 0; i < ERTS_DIRTY_RUNQ_CLASSES; i++) {
+	ErtsDirtyRunQueueClass *cls = &dcs->cls[i];
+	cls->module = THE_NON_VALUE;
+	cls->weight = 1;
+	cls->pass = 0;
+	for (j = 0; j < ERTS_NO_PROC_PRIO_LEVELS - 1; j++) {
+	    cls->prio[j].first = NULL;
+	    cls->prio[j].last = NULL;
+	}
+	cls->len = 0;
+	cls->executed = 0;
+	cls->wait_time = 0;
+    }
+    (void) dirty_class_lookup(dcs, am_undefined, 1);
+    return dcs;
+}
+
+/*
+ * Set the weight of a dirty run queue class on both dirty run
+ * queues. Returns 0 if dirty fair queuing is not enabled, the
+ * weight is out of range, or there is no free class slot for
+ * the module in one of the dirty run queues.
+ */
+int
+erts_sched_set_dirty_class_weight(Eterm module, Uint weight,
+                                  Uint *old_weightp)
+{
+    ErtsRunQueue *rqs[2];
+    int i;
+
+    if (!erts_sched_dirty_fair_queuing
+        || is_not_atom(module)
+        || weight < 1
+        || weight > ERTS_DIRTY_RUNQ_CLASS_MAX_WEIGHT)
+        return 0;
+
+    rqs[0] = ERTS_DIRTY_CPU_RUNQ;
+    rqs[1] = ERTS_DIRTY_IO_RUNQ;
+
+    /* Change both or neither */
+    erts_runqs_lock(rqs[0], rqs[1]);
+    for (i = 0; i < 2; i++) {
+        if (!dirty_class_can_create(rqs[i]->dirty_classes, module)) {
+            erts_runqs_unlock(rqs[0], rqs[1]);
+            return 0;
+        }
+    }
+    for (i = 0; i < 2; i++) {
+        ErtsDirtyRunQueueClass *cls;
+        cls = dirty_class_lookup(rqs[i]->dirty_classes, module, 1);
+        ASSERT(cls);
+        if (i == 0)
+            *old_weightp = cls->weight;
+        cls->weight = weight;
+    }
+    erts_runqs_unlock(rqs[0], rqs[1]);
+
+    return 1;
+}
+
+/*
+ * Per class information of the dirty run queues as
+ * [{dirty_cpu, Classes}, {dirty_io, Classes}] where each class
+ * is {Module, Weight, QueueLength, Executed, WaitTimeMicroSeconds},
+ * or 'undefined' if dirty fair queuing is not enabled.
+ */
+Eterm
+erts_sched_dirty_class_info(Process *c_p)
+{
+    ErtsDirtyRunQueueClass *clss;
+    ErtsRunQueue *rqs[2];
+    Eterm names[2];
+    int no[2], rqix, i;
+    Uint sz, *szp, *hp, **hpp;
+    Eterm res;
+
+    if (!erts_sched_dirty_fair_queuing)
+        return am_undefined;
+
+    rqs[0] = ERTS_DIRTY_CPU_RUNQ;
+    rqs[1] = ERTS_DIRTY_IO_RUNQ;
+    names[0] = am_dirty_cpu;
+    names[1] = am_dirty_io;
+
+    clss = erts_alloc(ERTS_ALC_T_TMP,
+                      sizeof(ErtsDirtyRunQueueClass)*2*ERTS_DIRTY_RUNQ_CLASSES);
+
+    for (rqix = 0; rqix < 2; rqix++) {
+        ErtsDirtyRunQueueClasses *dcs = rqs[rqix]->dirty_classes;
+        no[rqix] = 0;
+        erts_runq_lock(rqs[rqix]);
+        for (i = 0; i < ERTS_DIRTY_RUNQ_CLASSES; i++) {
+            if (is_value(dcs->cls[i].module))
+                clss[rqix*ERTS_DIRTY_RUNQ_CLASSES + no[rqix]++] = dcs->cls[i];
+        }
+        erts_runq_unlock(rqs[rqix]);
+    }
+
+    sz = 0;
+    szp = &sz;
+    hpp = NULL;
+    while (1) {
+        res = NIL;
+        for (rqix = 1; rqix >= 0; rqix--) {
+            Eterm list = NIL;
+            for (i = no[rqix] - 1; i >= 0; i--) {
+                ErtsDirtyRunQueueClass *cls;
+                cls = &clss[rqix*ERTS_DIRTY_RUNQ_CLASSES + i];
+                list = erts_bld_cons(
+                    hpp, szp,
+                    erts_bld_tuple(hpp, szp, 5,
+                                   cls->module,
+                                   erts_bld_uint(hpp, szp, cls->weight),
+                                   erts_bld_uint(hpp, szp, cls->len),
+                                   erts_bld_uint64(hpp, szp, cls->executed),
+                                   erts_bld_uint64(hpp, szp,
+                                                   cls->wait_time / 1000)),
+                    list);
+            }
+            res = erts_bld_cons(hpp, szp,
+                                erts_bld_tuple(hpp, szp, 2, names[rqix], list),
+                                res);
+        }
+        if (hpp)
+            break;
+        hp = HAlloc(c_p, sz);
+        szp = NULL;
+        hpp = &hp;
+    }
+
+    erts_free(ERTS_ALC_T_TMP, clss);
+    return res;
+}
+
+
 static ERTS_INLINE void
 enqueue_process(ErtsRunQueue *runq, int prio, Process *p)
 {
     ErtsRunPrioQueue *rpq;
+    int prio_q;
 
     ERTS_LC_ASSERT(erts_lc_runq_is_locked(runq));
 
@@ -3832,13 +4453,23 @@ enqueue_process(ErtsRunQueue *runq, int prio, Process *p)
 
     if (prio == PRIORITY_LOW) {
 	p->schedule_count = RESCHEDULE_LOW;
-	rpq = &runq->procs.prio[PRIORITY_NORMAL];
+	prio_q = PRIORITY_NORMAL;
     }
     else {
 	p->schedule_count = 1;
-	rpq = &runq->procs.prio[prio];
+	prio_q = prio;
     }
 
+    if (runq->dirty_classes)
+	rpq = dirty_class_enqueue_queue(runq->dirty_classes, prio_q, p);
+    else
+	rpq = &runq->procs.prio[prio_q];
+
+    /* Keep the first time stamp if moved between run queues... */
+    if ((runq->dirty_classes || erts_atomic32_read_nob(&runq_delay_enabled))
+	&& !p->runq_enq_time)
+	p->runq_enq_time = erts_get_monotonic_time(NULL);
+
     p->next = NULL;
     if (rpq->last)
 	rpq->last->next = p;
@@ -3848,6 +4479,20 @@ enqueue_process(ErtsRunQueue *runq, int prio, Process *p)
 }
 
 
+/*
+ * Count processes that are moved between run queues of
+ * schedulers bound to cpus on different NUMA nodes...
+ */
+static ERTS_INLINE void
+count_numa_migrations(ErtsRunQueue *from_rq, ErtsRunQueue *to_rq, int no)
+{
+    erts_aint32_t from = erts_atomic32_read_nob(&from_rq->numa_node);
+    erts_aint32_t to = erts_atomic32_read_nob(&to_rq->numa_node);
+    if (from >= 0 && to >= 0 && from != to)
+	erts_atomic_add_nob(&to_rq->numa_migrations, (erts_aint_t) no);
+}
+
+
 static ERTS_INLINE void
 unqueue_process(ErtsRunQueue *runq,
 		ErtsRunPrioQueue *rpq,
@@ -3887,7 +4532,7 @@ dequeue_process(ErtsRunQueue *runq, int prio_q, erts_aint32_t *statep)
 	   || PRIORITY_HIGH == prio_q
 	   || PRIORITY_MAX == prio_q);
 
-    rpq = &runq->procs.prio[prio_q];
+    rpq = runq_prio_queue(runq, prio_q);
     p = rpq->first;
     if (!p)
 	return NULL;
@@ -3906,13 +4551,16 @@ dequeue_process(ErtsRunQueue *runq, int prio_q, erts_aint32_t *statep)
 
     unqueue_process(runq, rpq, rqi, prio, NULL, p);
 
+    if (runq->dirty_classes)
+	runq->dirty_classes->selected->len--;
+
     return p;
 }
 
 static ERTS_INLINE int
 check_requeue_process(ErtsRunQueue *rq, int prio_q)
 {
-    ErtsRunPrioQueue *rpq = &rq->procs.prio[prio_q];
+    ErtsRunPrioQueue *rpq = runq_prio_queue(rq, prio_q);
     Process *p = rpq->first;
     if (--p->schedule_count > 0 && p != rpq->last) {
 	/* reschedule */
@@ -4062,6 +4710,7 @@ immigrate(ErtsRunQueue *c_rq, ErtsMigrationPath *mp)
 
 			erts_runq_lock(c_rq);
 			enqueue_process(c_rq, prio, proc);
+			count_numa_migrations(rq, c_rq, 1);
 			if (!iflag)
 			    return; /* done */
 			erts_runq_unlock(c_rq);
@@ -4335,13 +4984,73 @@ evacuate_run_queue(ErtsRunQueue *rq,
     }
 }
 
+/*
+ * Steal strategies
+ *
+ * default - Victims are visited in index order starting at our own
+ *           run queue and a single process (or port) is moved per
+ *           successful steal.
+ *
+ * random  - Victims are visited in a pseudo random order which is
+ *           different for each thief so that idle schedulers do not
+ *           all pile up on the same victim. Victim run queues are
+ *           only try-locked during the first pass; if no task could
+ *           be stolen, one of the busy victims is locked
+ *           unconditionally. A successful steal moves up to half of
+ *           the processes in the victim's highest priority queue
+ *           (but at most ERTS_SCHED_STEAL_MAX_PROCS) while holding
+ *           the victim lock once, instead of one process per lock
+ *           round trip.
+ */
+
+typedef enum {
+    ERTS_SCHED_STEAL_TYPE_DEFAULT,
+    ERTS_SCHED_STEAL_TYPE_RANDOM
+} ErtsSchedStealType;
+
+#define ERTS_SCHED_STEAL_MAX_PROCS 32
+
+static ErtsSchedStealType sched_steal_type = ERTS_SCHED_STEAL_TYPE_DEFAULT;
+
+int
+erts_sched_set_steal_type(char *str)
+{
+    if (sys_strcmp(str, "default") == 0)
+        sched_steal_type = ERTS_SCHED_STEAL_TYPE_DEFAULT;
+    else if (sys_strcmp(str, "random") == 0)
+        sched_steal_type = ERTS_SCHED_STEAL_TYPE_RANDOM;
+    else
+        return EINVAL;
+    return 0;
+}
+
+static ERTS_INLINE Uint32
+steal_random(ErtsRunQueue *rq)
+{
+    /* xorshift32 */
+    Uint32 x = rq->steal_seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rq->steal_seed = x;
+    return x;
+}
+
+/*
+ * Returns non-zero if a task was stolen. If 'trylock' is set and the
+ * victim run queue is busy, -1 is returned without having stolen
+ * anything.
+ */
 static int
-try_steal_task_from_victim(ErtsRunQueue *rq, int *rq_lockedp, ErtsRunQueue *vrq, Uint32 flags)
+try_steal_task_from_victim(ErtsRunQueue *rq, int *rq_lockedp, ErtsRunQueue *vrq,
+                           Uint32 flags, int max_procs, int trylock)
 {
     Uint32 procs_qmask = flags & ERTS_RUNQ_FLGS_PROCS_QMASK;
     int max_prio_bit;
     ErtsRunPrioQueue *rpq;
 
+    ASSERT(0 < max_procs && max_procs <= ERTS_SCHED_STEAL_MAX_PROCS);
+
     if (*rq_lockedp) {
 	erts_runq_unlock(rq);
 	*rq_lockedp = 0;
@@ -4349,7 +5058,10 @@ try_steal_task_from_victim(ErtsRunQueue *rq, int *rq_lockedp, ErtsRunQueue *vrq,
 
     ERTS_LC_ASSERT(!erts_lc_runq_is_locked(rq));
 
-    erts_runq_lock(vrq);
+    if (!trylock)
+        erts_runq_lock(vrq);
+    else if (erts_runq_trylock(vrq) == EBUSY)
+        return -1;
 
     if (ERTS_RUNQ_FLGS_GET_NOB(rq) & ERTS_RUNQ_FLG_HALTING)
 	goto no_procs;
@@ -4359,6 +5071,9 @@ try_steal_task_from_victim(ErtsRunQueue *rq, int *rq_lockedp, ErtsRunQueue *vrq,
      */
 
     while (procs_qmask) {
+	Process *stolen[ERTS_SCHED_STEAL_MAX_PROCS];
+	int stolen_prio[ERTS_SCHED_STEAL_MAX_PROCS];
+	int no_stolen, max_stolen;
 	Process *prev_proc;
 	Process *proc;
 
@@ -4366,13 +5081,17 @@ try_steal_task_from_victim(ErtsRunQueue *rq, int *rq_lockedp, ErtsRunQueue *vrq,
 	switch (max_prio_bit) {
 	case MAX_BIT:
 	    rpq = &vrq->procs.prio[PRIORITY_MAX];
+	    max_stolen = erts_atomic32_read_nob(&vrq->procs.prio_info[PRIORITY_MAX].len);
 	    break;
 	case HIGH_BIT:
 	    rpq = &vrq->procs.prio[PRIORITY_HIGH];
+	    max_stolen = erts_atomic32_read_nob(&vrq->procs.prio_info[PRIORITY_HIGH].len);
 	    break;
 	case NORMAL_BIT:
 	case LOW_BIT:
 	    rpq = &vrq->procs.prio[PRIORITY_NORMAL];
+	    max_stolen = erts_atomic32_read_nob(&vrq->procs.prio_info[PRIORITY_NORMAL].len);
+	    max_stolen += erts_atomic32_read_nob(&vrq->procs.prio_info[PRIORITY_LOW].len);
 	    break;
 	case 0:
 	    goto no_procs;
@@ -4381,25 +5100,45 @@ try_steal_task_from_victim(ErtsRunQueue *rq, int *rq_lockedp, ErtsRunQueue *vrq,
 	    goto no_procs;
 	}
 
+	/* Leave at least half of the queue to the victim... */
+	max_stolen /= 2;
+	if (max_stolen > max_procs)
+	    max_stolen = max_procs;
+	if (max_stolen < 1)
+	    max_stolen = 1;
+
+	no_stolen = 0;
 	prev_proc = NULL;
 	proc = rpq->first;
 
 	while (proc) {
+	    Process *next_proc = proc->next;
 	    if (erts_try_change_runq_proc(proc, rq)) {
                 erts_aint32_t state = erts_atomic32_read_acqb(&proc->state);
 		/* Steal process */
 		int prio = (int) ERTS_PSFLGS_GET_PRQ_PRIO(state);
 		ErtsRunQueueInfo *rqi = &vrq->procs.prio_info[prio];
 		unqueue_process(vrq, rpq, rqi, prio, prev_proc, proc);
-		erts_runq_unlock(vrq);
-
-		erts_runq_lock(rq);
-		*rq_lockedp = 1;
-		enqueue_process(rq, prio, proc);
-		return !0;
+		stolen[no_stolen] = proc;
+		stolen_prio[no_stolen] = prio;
+		if (++no_stolen == max_stolen)
+		    break;
 	    }
-	    prev_proc = proc;
-	    proc = proc->next;
+	    else
+		prev_proc = proc;
+	    proc = next_proc;
+	}
+
+	if (no_stolen) {
+	    int i;
+	    erts_runq_unlock(vrq);
+
+	    erts_runq_lock(rq);
+	    *rq_lockedp = 1;
+	    for (i = 0; i < no_stolen; i++)
+		enqueue_process(rq, stolen_prio[i], stolen[i]);
+	    count_numa_migrations(vrq, rq, no_stolen);
+	    return !0;
 	}
 
 	procs_qmask &= ~max_prio_bit;
@@ -4432,22 +5171,87 @@ no_procs:
 }
 
 
+/*
+ * If 'numa_node' is not -1, only run queues of schedulers
+ * bound to cpus on that NUMA node are considered...
+ */
 static ERTS_INLINE int
-check_possible_steal_victim(ErtsRunQueue *rq, int *rq_lockedp, int vix)
+is_possible_steal_victim(ErtsRunQueue *vrq, int numa_node, Uint32 *flagsp)
+{
+    Uint32 flags;
+    if (numa_node >= 0
+	&& erts_atomic32_read_nob(&vrq->numa_node) != numa_node)
+	return 0;
+    flags = ERTS_RUNQ_FLGS_GET(vrq);
+    *flagsp = flags;
+    return (runq_got_work_to_execute_flags(flags)
+	    & (!(flags & ERTS_RUNQ_FLG_PROTECTED)));
+}
+
+static ERTS_INLINE int
+check_possible_steal_victim(ErtsRunQueue *rq, int *rq_lockedp, int vix,
+			    int numa_node)
 {
     ErtsRunQueue *vrq = ERTS_RUNQ_IX(vix);
-    Uint32 flags = ERTS_RUNQ_FLGS_GET(vrq);
-    if (runq_got_work_to_execute_flags(flags) & (!(flags & ERTS_RUNQ_FLG_PROTECTED)))
-	return try_steal_task_from_victim(rq, rq_lockedp, vrq, flags);
+    Uint32 flags;
+    if (is_possible_steal_victim(vrq, numa_node, &flags))
+	return try_steal_task_from_victim(rq, rq_lockedp, vrq, flags, 1, 0);
     else
 	return 0;
 }
 
+static int
+try_steal_task_random(ErtsRunQueue *rq, int *rq_lockedp, int blnc_rqs,
+		      int numa_node)
+{
+    int i, start_ix, busy_vix = -1;
+
+    start_ix = (int) (steal_random(rq) % (Uint32) blnc_rqs);
+
+    for (i = 0; i < blnc_rqs; i++) {
+	ErtsRunQueue *vrq;
+	Uint32 flags;
+	int res, vix;
+
+	if (erts_atomic32_read_acqb(&no_empty_run_queues) >= blnc_rqs)
+	    return 0;
+
+	vix = start_ix + i;
+	if (vix >= blnc_rqs)
+	    vix -= blnc_rqs;
+	if (vix == rq->ix)
+	    continue;
+
+	vrq = ERTS_RUNQ_IX(vix);
+	if (!is_possible_steal_victim(vrq, numa_node, &flags))
+	    continue;
+
+	res = try_steal_task_from_victim(rq, rq_lockedp, vrq, flags,
+					 ERTS_SCHED_STEAL_MAX_PROCS, 1);
+	if (res > 0)
+	    return res;
+	if (res < 0)
+	    busy_vix = vix;
+    }
+
+    /* Every victim with work was busy; wait for the last one seen... */
+    if (busy_vix >= 0
+	&& erts_atomic32_read_acqb(&no_empty_run_queues) < blnc_rqs) {
+	ErtsRunQueue *vrq = ERTS_RUNQ_IX(busy_vix);
+	Uint32 flags;
+	if (is_possible_steal_victim(vrq, numa_node, &flags))
+	    return try_steal_task_from_victim(rq, rq_lockedp, vrq, flags,
+					      ERTS_SCHED_STEAL_MAX_PROCS, 0);
+    }
+
+    return 0;
+}
+
 
 static int
 try_steal_task(ErtsRunQueue *rq)
 {
-    int res, rq_locked, vix, active_rqs, blnc_rqs;
+    int res, rq_locked, vix, active_rqs, blnc_rqs, numa_node;
     Uint32 flags;
 
     /* Protect jobs we steal from getting stolen from us... */
@@ -4465,14 +5269,33 @@ try_steal_task(ErtsRunQueue *rq)
     if (active_rqs > blnc_rqs)
 	active_rqs = blnc_rqs;
 
+    /*
+     * In NUMA aware mode we first only look for work on our own
+     * node, and then on all nodes...
+     */
+    numa_node = (erts_sched_numa_aware
+		 ? (int) erts_atomic32_read_nob(&rq->numa_node)
+		 : -1);
+
     if (rq->ix < active_rqs) {
 
+    steal:
+
+	if (sched_steal_type == ERTS_SCHED_STEAL_TYPE_RANDOM) {
+	    res = try_steal_task_random(rq, &rq_locked, blnc_rqs, numa_node);
+	    if (res || numa_node < 0)
+		goto done;
+	    numa_node = -1;
+	    goto steal;
+	}
+
 	/* First try to steal from an inactive run queue... */
 	if (active_rqs < blnc_rqs) {
 	    int no = blnc_rqs - active_rqs;
 	    int stop_ix = vix = active_rqs + rq->ix % no;
 	    while (erts_atomic32_read_acqb(&no_empty_run_queues) < blnc_rqs) {
-		res = check_possible_steal_victim(rq, &rq_locked, vix);
+		res = check_possible_steal_victim(rq, &rq_locked, vix,
+						  numa_node);
 		if (res)
 		    goto done;
 		vix++;
@@ -4493,11 +5316,16 @@ try_steal_task(ErtsRunQueue *rq)
 	    if (vix == rq->ix)
 		break;
 
-	    res = check_possible_steal_victim(rq, &rq_locked, vix);
+	    res = check_possible_steal_victim(rq, &rq_locked, vix, numa_node);
 	    if (res)
 		goto done;
 	}
 
+	if (numa_node >= 0) {
+	    numa_node = -1;
+	    goto steal;
+	}
+
     }
 
  done:
@@ -4528,6 +5356,7 @@ typedef struct {
     int full_reds_history_change;
     int oowc;
     int max_len;
+    int numa_node;
 #if ERTS_HAVE_SCHED_UTIL_BALANCING_SUPPORT
     int sched_util;
 #endif
@@ -4546,6 +5375,53 @@ rqc_len_cmp(const void *x, const void *y)
     return ((ErtsRunQueueCompare *) x)->len - ((ErtsRunQueueCompare *) y)->len;
 }
 
+/*
+ * NUMA aware balancing helpers. Both only reorder choices that
+ * check_balance() already considers valid, so that migration
+ * paths stay on the same NUMA node whenever possible...
+ */
+
+/* First run queue in [0, no) from 'tix' on the NUMA node of 'qix' */
+static int
+numa_local_runq_ix(int qix, int tix, int no)
+{
+    int numa_node = run_queue_info[qix].numa_node;
+    int i;
+    if (numa_node < 0)
+	return tix;
+    for (i = 0; i < no; i++) {
+	int ix = tix + i;
+	if (ix >= no)
+	    ix -= no;
+	if (run_queue_info[ix].numa_node == numa_node)
+	    return ix;
+    }
+    return tix;
+}
+
+/*
+ * Move an underloaded run queue on the same NUMA node as the
+ * run queue at 'fix' into position 'tix' of run_queue_compare...
+ */
+static void
+numa_local_immigrate_first(int fix, int tix)
+{
+    int numa_node = run_queue_info[run_queue_compare[fix].qix].numa_node;
+    int ix;
+    if (numa_node < 0)
+	return;
+    for (ix = tix; ix < fix && run_queue_compare[ix].len < 0; ix++) {
+	if (run_queue_info[run_queue_compare[ix].qix].numa_node == numa_node) {
+	    if (ix != tix) {
+		ErtsRunQueueCompare tmp = run_queue_compare[tix];
+		run_queue_compare[tix] = run_queue_compare[ix];
+		run_queue_compare[ix] = tmp;
+	    }
+	    return;
+	}
+    }
+}
+
 #define ERTS_PERCENT(X, Y) \
   ((Y) == 0 \
    ? ((X) == 0 ? 100 : INT_MAX) \
@@ -4785,6 +5661,8 @@ check_balance(ErtsRunQueue *c_rq)
 
 	run_queue_info[qix].oowc = rq->out_of_work_count;
 	run_queue_info[qix].max_len = rq->max_len;
+	run_queue_info[qix].numa_node
+	    = (int) erts_atomic32_read_nob(&rq->numa_node);
 	rq->check_balance_reds = INT_MAX;
 
 #if ERTS_HAVE_SCHED_UTIL_BALANCING_SUPPORT
@@ -4935,9 +5813,11 @@ check_balance(ErtsRunQueue *c_rq)
 	    }
 	}
 	for (qix = active; qix < blnc_no_rqs; qix++) {
+	    int tix = qix % active;
+	    if (erts_sched_numa_aware)
+		tix = numa_local_runq_ix(qix, tix, active);
 	    run_queue_info[qix].flags = ERTS_RUNQ_FLG_INACTIVE;
 	    for (pix = 0; pix < ERTS_NO_PRIO_LEVELS; pix++) {
-		int tix = qix % active;
 		ERTS_SET_RUNQ_FLG_EMIGRATE(run_queue_info[qix].flags, pix);
 		run_queue_info[qix].prio[pix].emigrate_to = tix;
 		run_queue_info[qix].prio[pix].immigrate_from = -1;
@@ -5064,6 +5944,8 @@ if (pix == 2) erts_fprintf(stderr, "\n");
 			eot = 1;
 		    if (eof || eot)
 			break;
+		    if (erts_sched_numa_aware)
+			numa_local_immigrate_first(fix, tix);
 		    from_qix = run_queue_compare[fix].qix;
 		    to_qix = run_queue_compare[tix].qix;
 		    if (run_queue_info[from_qix].prio[pix].avail == 0) {
@@ -5679,12 +6561,18 @@ erts_sched_set_busy_wait_threshold(ErtsSchedType sched_type, char *str)
 	sys_sched = ERTS_SCHED_SYS_SLEEP_SPINCOUNT_NONE;
 	aux_work_fact = ERTS_SCHED_AUX_WORK_SLEEP_SPINCOUNT_FACT_NONE;
     }
+    else if (sys_strcmp(str, "adaptive") == 0) {
+        /* Start out as medium until the spin cost is known... */
+	sys_sched = ERTS_SCHED_SYS_SLEEP_SPINCOUNT_MEDIUM;
+	aux_work_fact = ERTS_SCHED_AUX_WORK_SLEEP_SPINCOUNT_FACT_MEDIUM;
+    }
     else {
 	return EINVAL;
     }
 
     params->tse = sys_sched * ERTS_SCHED_TSE_SLEEP_SPINCOUNT_FACT;
     params->aux_work = sys_sched * aux_work_fact;
+    params->adaptive = sys_strcmp(str, "adaptive") == 0;
 
     return 0;
 }
@@ -5852,6 +6740,9 @@ init_scheduler_data(ErtsSchedulerData* esdp, int num,
     esdp->reductions = 0;
 
     init_sched_wall_time(esdp, time_stamp);
+    init_sched_wait_info(esdp);
+    esdp->dirty_class = NULL;
+    esdp->dirty_class_start = 0;
     erts_port_task_handle_init(&esdp->nosuspend_port_task_handle);
 }
 
@@ -5898,6 +6789,13 @@ erts_init_scheduling(int no_schedulers, int no_schedulers_online, int no_poll_th
     erts_atomic32_init_nob(&function_calls, 0);
 #endif
     erts_atomic32_init_nob(&no_empty_run_queues, 0);
+    erts_atomic32_init_nob(&runq_delay_enabled, 0);
+    erts_atomic32_init_nob(&sched_wakeup_latency_enabled, 0);
+    sched_wait_adaptive = 0;
+    for (ix = ERTS_SCHED_TYPE_FIRST; ix <= ERTS_SCHED_TYPE_LAST; ix++) {
+	if (sched_busy_wait_params[ix].adaptive)
+	    sched_wait_adaptive = 1;
+    }
 
     erts_no_run_queues = n;
 
@@ -5936,6 +6834,10 @@ erts_init_scheduling(int no_schedulers, int no_schedulers_online, int no_poll_th
 	erts_atomic32_set_nob(&rq->len, 0);
 	rq->wakeup_other = 0;
 	rq->wakeup_other_reds = 0;
+	rq->steal_seed = ((Uint32) ix + 1) * 2654435761U;
+	erts_atomic32_init_nob(&rq->numa_node, -1);
+	erts_atomic_init_nob(&rq->numa_migrations, 0);
+	rq->dirty_classes = NULL;
 
 	rq->procs.context_switches = 0;
 	rq->procs.reductions = 0;
@@ -5965,6 +6867,11 @@ erts_init_scheduling(int no_schedulers, int no_schedulers_online, int no_poll_th
 
     }
 
+    if (erts_sched_dirty_fair_queuing) {
+	ERTS_DIRTY_CPU_RUNQ->dirty_classes = init_dirty_classes();
+	ERTS_DIRTY_IO_RUNQ->dirty_classes = init_dirty_classes();
+    }
+
 
     if (erts_no_run_queues != 1) {
 	run_queue_info = erts_alloc(ERTS_ALC_T_RUNQ_BLNS,
@@ -6000,6 +6907,7 @@ erts_init_scheduling(int no_schedulers, int no_schedulers_online, int no_poll_th
 	erts_atomic32_init_nob(&ssi->flags, 0);
 	ssi->event = NULL; /* initialized in sched_thread_func */
 	erts_atomic32_init_nob(&ssi->aux_work, 0);
+	erts_atomic64_init_nob(&ssi->wake_time, 0);
     }
 
     aligned_sched_sleep_info += 1 /* aux thread */;
@@ -6015,6 +6923,7 @@ erts_init_scheduling(int no_schedulers, int no_schedulers_online, int no_poll_th
         ssi->prev = NULL;
 	ssi->event = NULL; /* initialized in sched_dirty_cpu_thread_func */
 	erts_atomic32_init_nob(&ssi->aux_work, 0);
+	erts_atomic64_init_nob(&ssi->wake_time, 0);
     }
     aligned_dirty_io_sched_sleep_info =
 	erts_alloc_permanent_cache_aligned(
@@ -6027,6 +6936,7 @@ erts_init_scheduling(int no_schedulers, int no_schedulers_online, int no_poll_th
         ssi->prev = NULL;
 	ssi->event = NULL; /* initialized in sched_dirty_io_thread_func */
 	erts_atomic32_init_nob(&ssi->aux_work, 0);
+	erts_atomic64_init_nob(&ssi->wake_time, 0);
     }
 
     aligned_poll_thread_sleep_info =
@@ -6039,6 +6949,7 @@ erts_init_scheduling(int no_schedulers, int no_schedulers_online, int no_poll_th
 	erts_atomic32_init_nob(&ssi->flags, 0);
 	ssi->event = NULL; /* initialized in poll_thread */
 	erts_atomic32_init_nob(&ssi->aux_work, 0);
+	erts_atomic64_init_nob(&ssi->wake_time, 0);
     }
 
     /* Create and initialize scheduler specific data */
@@ -6249,6 +7160,8 @@ make_proxy_proc(Process *prev_proxy, Process *proc, erts_aint32_t prio)
     }
 
     proxy->common.id = proc->common.id;
+    proxy->current = proc->current;
+    proxy->runq_enq_time = 0;
 
     return proxy;
 }
@@ -6447,8 +7360,10 @@ select_enqueue_run_queue(int enqueue, int enq_prio, Process *p, erts_aint32_t st
 	if (!bound) {
 	    ErtsRunQueue *new_runq = erts_check_emigration_need(runq, enq_prio);
             if (new_runq) {
-                if (erts_try_change_runq_proc(p, new_runq))
+                if (erts_try_change_runq_proc(p, new_runq)) {
+                    count_numa_migrations(runq, new_runq, 1);
                     runq = new_runq;
+                }
                 else
                     runq = erts_get_runq_proc(p, NULL);
             }
@@ -9203,6 +10118,20 @@ scheduler_gc_proc(Process *c_p, int reds_left)
     return reds;
 }
 
+static int
+scheduler_incr_gc_proc(Process *c_p, int reds_left)
+{
+    int fcalls, reds;
+    if (!ERTS_PROC_GET_SAVED_CALLS_BUF(c_p))
+	fcalls = reds_left;
+    else
+	fcalls = reds_left - CONTEXT_REDS;
+    reds = erts_incr_major_gc_slice(c_p, fcalls);
+    if (reds > reds_left)
+        reds = reds_left;
+    return reds;
+}
+
 static void
 unlock_lock_rq(int pre_free, void *vrq)
 {
@@ -9350,6 +10279,9 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
                                             proxy_p, is_normal_sched);
             proxy_p = NULL;
 
+            if (esdp->dirty_class)
+                dirty_class_charge(esdp);
+
             ERTS_PROC_REDUCTIONS_EXECUTED(esdp, rq,
                                           (int) ERTS_PSFLGS_GET_USR_PRIO(state),
                                           reds,
@@ -9585,7 +10517,9 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
 	 */
     pick_next_process: {
 	    erts_aint32_t psflg_band_mask;
-	    int prio_q;
+	    ErtsMonotonicTime enq_time;
+	    ErtsDirtyRunQueueClass *dcls;
+	    int prio_q, enq_prio;
 	    int qmask, qbit;
 
 	    flags = ERTS_RUNQ_FLGS_GET_NOB(rq);
@@ -9618,6 +10552,11 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
 
 	    ASSERT(p); /* Wrong qmask in rq->flags? */
 
+	    enq_time = p->runq_enq_time;
+	    p->runq_enq_time = 0;
+	    enq_prio = (int) ERTS_PSFLGS_GET_PRQ_PRIO(state);
+	    dcls = rq->dirty_classes ? rq->dirty_classes->selected : NULL;
+
 	    if (is_normal_sched) {
 		psflg_running = ERTS_PSFLG_RUNNING;
 		psflg_running_sys = ERTS_PSFLG_RUNNING_SYS;
@@ -9718,6 +10657,22 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
 		}
 	    }
 
+	    if (enq_time || dcls) {
+		ErtsMonotonicTime now = erts_get_monotonic_time(esdp);
+		if (enq_time && enq_time <= now) {
+		    Sint64 nsec = ERTS_MONOTONIC_TO_NSEC(now - enq_time);
+		    if (erts_atomic32_read_nob(&runq_delay_enabled))
+			sched_wait_hist_inc(esdp->sched_wait.runq_delay[enq_prio],
+					    nsec);
+		    if (dcls)
+			dcls->wait_time += (Uint64) nsec;
+		}
+		if (dcls) {
+		    esdp->dirty_class = dcls;
+		    esdp->dirty_class_start = now;
+		}
+	    }
+
 	    rq->procs.context_switches++;
 
 	    esdp->current_process = p;
@@ -9891,6 +10846,18 @@ Process *erts_schedule(ErtsSchedulerData *esdp, Process *p, int calls)
                         goto sched_out_proc;
                 }
             }
+            else if (p->flags & F_INCR_MAJOR_GC) {
+                if (!(state & ERTS_PSFLG_EXITING)
+                    && !(p->flags & (F_DELAY_GC|F_DISABLE_GC))) {
+                    int cost = scheduler_incr_gc_proc(p, reds);
+                    calls += cost;
+                    reds -= cost;
+                    if (reds <= 0)
+                        goto sched_out_proc;
+                    if (p->flags & (F_DIRTY_MAJOR_GC|F_DIRTY_MINOR_GC))
+                        goto sched_out_proc;
+                }
+            }
         }
 
 	if (proxy_p) {
@@ -11289,6 +12256,32 @@ erts_get_total_context_switches(void)
     return res;
 }
 
+Uint
+erts_get_total_numa_migrations(void)
+{
+    Uint res = 0;
+    int ix;
+    for (ix = 0; ix < erts_no_run_queues; ix++) {
+	ErtsRunQueue *rq = ERTS_RUNQ_IX(ix);
+	res += (Uint) erts_atomic_read_nob(&rq->numa_migrations);
+    }
+    return res;
+}
+
+/*
+ * NUMA node of the cpu that the calling scheduler is bound
+ * to, or -1 if not called by a bound normal scheduler or if
+ * the node is unknown.
+ */
+int
+erts_get_numa_node(void)
+{
+    ErtsSchedulerData *esdp = erts_get_scheduler_data();
+    if (!esdp || esdp->type != ERTS_SCHED_NORMAL)
+	return -1;
+    return (int) erts_atomic32_read_nob(&esdp->run_queue->numa_node);
+}
+
 void
 erts_get_total_reductions(Uint *redsp, Uint *diffp)
 {
@@ -11336,6 +12329,7 @@ erts_free_proc(Process *p)
     ASSERT(0 == erts_proc_read_refc(p));
     if (p->flags & F_DELAYED_DEL_PROC)
 	delete_process(p);
+    erts_proc_sig_queue_free_buffers(p);
     erts_free(ERTS_ALC_T_PROC, (void *) p);
 }
 
@@ -11353,6 +12347,8 @@ static void early_init_process_struct(void *varg, Eterm data)
 
     proc->common.id = make_internal_pid(data);
     erts_atomic32_init_nob(&proc->dirty_state, 0);
+    erts_atomic_init_nob(&proc->sig_inq_buffers, (erts_aint_t) NULL);
+    erts_atomic32_init_nob(&proc->sig_inq_contention, 0);
     proc->dirty_sys_tasks = NULL;
     erts_init_runq_proc(proc, arg->run_queue, arg->bound);
     erts_atomic32_init_relb(&proc->state, arg->state);
@@ -11506,6 +12502,7 @@ erl_create_process(Process* parent, /* Parent of process (default group leader).
 	p->max_gen_gcs    = (Uint16) erts_atomic32_read_nob(&erts_max_gen_gcs);
     }
     p->schedule_count = 0;
+    p->runq_enq_time = 0;
     ASSERT(p->min_heap_size == erts_next_heap_size(p->min_heap_size, 0));
 
     p->u.initial.module = mod;
@@ -11534,6 +12531,10 @@ erl_create_process(Process* parent, /* Parent of process (default group leader).
     p->old_hend = p->old_htop = p->old_heap = NULL;
     p->high_water = p->heap;
     p->gen_gcs = 0;
+    p->live_estimate = 0;
+    p->alloc_rate = 0;
+    p->gc_reds = 0;
+    p->resizes_avoided = 0;
     p->stop = p->hend = p->heap + sz;
     p->htop = p->heap;
     p->heap_sz = sz;
@@ -11601,6 +12602,7 @@ erl_create_process(Process* parent, /* Parent of process (default group leader).
     p->sig_qs.len = 0;
     p->sig_qs.nmsigs.next = NULL;
     p->sig_qs.nmsigs.last = NULL;
+    p->sig_qs.recv_ix = NULL;
     p->sig_inq.first = NULL;
     p->sig_inq.last = &p->sig_inq.first;
     p->sig_inq.len = 0;
@@ -11805,9 +12807,14 @@ void erts_init_empty_process(Process *p)
     p->live_hf_end = ERTS_INVALID_HFRAG_PTR;
     p->gen_gcs = 0;
     p->max_gen_gcs = 0;
+    p->live_estimate = 0;
+    p->alloc_rate = 0;
+    p->gc_reds = 0;
+    p->resizes_avoided = 0;
     p->min_heap_size = 0;
     p->min_vheap_size = 0;
     p->rcount = 0;
+    p->runq_enq_time = 0;
     p->common.id = ERTS_INVALID_PID;
     p->reds = 0;
     ERTS_TRACER(p) = erts_tracer_nil;
@@ -11849,6 +12856,7 @@ void erts_init_empty_process(Process *p)
     p->sig_qs.len = 0;
     p->sig_qs.nmsigs.next = NULL;
     p->sig_qs.nmsigs.last = NULL;
+    p->sig_qs.recv_ix = NULL;
     p->sig_inq.first = NULL;
     p->sig_inq.last = &p->sig_inq.first;
     p->sig_inq.len = 0;
@@ -11898,6 +12906,8 @@ void erts_init_empty_process(Process *p)
 #endif
 
     erts_atomic32_init_nob(&p->dirty_state, 0);
+    erts_atomic_init_nob(&p->sig_inq_buffers, (erts_aint_t) NULL);
+    erts_atomic32_init_nob(&p->sig_inq_contention, 0);
     p->dirty_sys_tasks = NULL;
     erts_atomic32_init_nob(&p->state, (erts_aint32_t) PRIORITY_NORMAL);
 
@@ -11988,6 +12998,7 @@ delete_process(Process* p)
     ErtsPSD *psd;
     struct saved_calls *scb;
     process_breakpoint_time_t *pbt;
+    struct erts_gc_aging *aging;
 
     VERBOSE(DEBUG_PROCESSES, ("Removing process: %T\n",p->common.id));
     VERBOSE(DEBUG_SHCOPY, ("[pid=%T] delete process: %p %p %p %p\n", p->common.id,
@@ -12004,6 +13015,12 @@ delete_process(Process* p)
     if (pbt)
         erts_free(ERTS_ALC_T_BPD, (void *) pbt);
 
+    aging = ERTS_PROC_SET_GC_AGING(p, NULL);
+    if (aging)
+        erts_free(ERTS_ALC_T_GC_AGING, (void *) aging);
+
+    erts_free_incr_major_gc(p);
+
     erts_destroy_nif_export(p);
 
     /* Cleanup psd */
@@ -12052,6 +13069,7 @@ delete_process(Process* p)
     erts_erase_dicts(p);
 
     /* free all pending messages */
+    erts_recv_index_destroy(p);
     erts_cleanup_messages(p->sig_qs.first);
     p->sig_qs.first = NULL;
     erts_cleanup_messages(p->sig_qs.cont);
@@ -13125,6 +14143,8 @@ erts_try_lock_sig_free_proc(Eterm pid, ErtsProcLocks locks,
     if (erts_proc_trylock(rp, tmp_locks) == EBUSY)
         return ERTS_PROC_LOCK_BUSY;
 
+    erts_proc_sig_queue_flush_buffers(rp);
+
     state = erts_atomic32_read_nob(&rp->state);
     if (statep)
         *statep = state;
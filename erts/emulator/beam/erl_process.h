@@ -105,6 +105,8 @@ struct saved_calls {
 extern Export exp_send, exp_receive, exp_timeout;
 extern int ERTS_WRITE_UNLIKELY(erts_sched_compact_load);
 extern int ERTS_WRITE_UNLIKELY(erts_sched_balance_util);
+extern int ERTS_WRITE_UNLIKELY(erts_sched_numa_aware);
+extern int ERTS_WRITE_UNLIKELY(erts_sched_dirty_fair_queuing);
 extern Uint ERTS_WRITE_UNLIKELY(erts_no_schedulers);
 extern Uint ERTS_WRITE_UNLIKELY(erts_no_total_schedulers);
 extern Uint ERTS_WRITE_UNLIKELY(erts_no_dirty_cpu_schedulers);
@@ -368,6 +370,7 @@ struct ErtsSchedulerSleepInfo_ {
     erts_tse_t *event;
     struct erts_poll_thread *psi;
     erts_atomic32_t aux_work;
+    erts_atomic64_t wake_time; /* when woken from tse sleep */
 };
 
 /* times to reschedule low prio process before running */
@@ -402,6 +405,30 @@ typedef struct {
     Process* last;
 } ErtsRunPrioQueue;
 
+/*
+ * With "+sdfq true", processes in the dirty run queues are
+ * queued per class (module of the code they execute). Classes
+ * get dirty scheduler time in proportion to their weights.
+ */
+#define ERTS_DIRTY_RUNQ_CLASSES 32
+#define ERTS_DIRTY_RUNQ_CLASS_MAX_WEIGHT 10000
+
+typedef struct ErtsDirtyRunQueueClass_ {
+    Eterm module;       /* THE_NON_VALUE if unused */
+    Uint weight;
+    Uint64 pass;        /* Nanoseconds executed divided by weight */
+    ErtsRunPrioQueue prio[ERTS_NO_PROC_PRIO_LEVELS-1];
+    Uint len;
+    Uint64 executed;
+    Uint64 wait_time;   /* Nanoseconds waited in queue */
+} ErtsDirtyRunQueueClass;
+
+typedef struct {
+    Uint64 pass;        /* Pass of last selected class */
+    ErtsDirtyRunQueueClass *selected;
+    ErtsDirtyRunQueueClass cls[ERTS_DIRTY_RUNQ_CLASSES];
+} ErtsDirtyRunQueueClasses;
+
 typedef enum {
     ERTS_SCHED_NORMAL = 0,
     ERTS_SCHED_DIRTY_CPU = 1,
@@ -490,6 +517,10 @@ struct ErtsRunQueue_ {
     erts_atomic32_t len;
     int wakeup_other;
     int wakeup_other_reds;
+    Uint32 steal_seed; /* only used by the scheduler owning the run queue */
+    erts_atomic32_t numa_node; /* of the cpu the scheduler is bound to, or -1 */
+    erts_atomic_t numa_migrations; /* processes moved in from other nodes */
+    ErtsDirtyRunQueueClasses *dirty_classes; /* NULL unless fair dirty queue */
 
     struct {
 	Uint context_switches;
@@ -557,6 +588,17 @@ typedef struct {
     } working;
 } ErtsSchedWallTime;
 
+#define ERTS_SCHED_WAIT_HIST_SIZE 16
+
+typedef struct {
+    Sint64 idle_avg;    /* Average idle time (nanoseconds) */
+    Sint64 spin_cost;   /* Average cost of 16 spins (nanoseconds) */
+    erts_atomic32_t spincount;
+    erts_atomic_t wakeup_latency[ERTS_SCHED_WAIT_HIST_SIZE];
+    erts_atomic_t spin_waste[ERTS_SCHED_WAIT_HIST_SIZE];
+    erts_atomic_t runq_delay[ERTS_NO_PROC_PRIO_LEVELS][ERTS_SCHED_WAIT_HIST_SIZE];
+} ErtsSchedWaitInfo;
+
 typedef struct {
     int sched;
     erts_aint32_t aux_work;
@@ -641,6 +683,8 @@ struct ErtsSchedulerData_ {
     ErtsSchedType type;
     Uint no;			/* Scheduler number for normal schedulers */
     Uint dirty_no;  /* Scheduler number for dirty schedulers */
+    ErtsDirtyRunQueueClass *dirty_class; /* of process being executed */
+    ErtsMonotonicTime dirty_class_start;
     int flxctr_slot_no; /* slot nr when a flxctr is used */
     struct enif_environment_t *current_nif;
     Process *dirty_shadow_process;
@@ -674,6 +718,7 @@ struct ErtsSchedulerData_ {
 
     Uint64 reductions;
     ErtsSchedWallTime sched_wall_time;
+    ErtsSchedWaitInfo sched_wait;
     ErtsGCInfo gc_info;
     ErtsPortTaskHandle nosuspend_port_task_handle;
     ErtsEtsTables ets_tables;
@@ -810,14 +855,16 @@ erts_reset_max_len(ErtsRunQueue *rq, ErtsRunQueueInfo *rqi)
 #define ERTS_PSD_ETS_FIXED_TABLES               7
 #define ERTS_PSD_DIST_ENTRY	                8
 #define ERTS_PSD_PENDING_SUSPEND                9
-#define ERTS_PSD_SUSPENDED_SAVED_CALLS_BUF	10 /* keep last... */
+#define ERTS_PSD_GC_AGING                       10
+#define ERTS_PSD_INCR_MAJOR_GC                  11
+#define ERTS_PSD_SUSPENDED_SAVED_CALLS_BUF	12 /* keep last... */
 
-#define ERTS_PSD_SIZE				11
+#define ERTS_PSD_SIZE				13
 
 #if !defined(HIPE)
 #  undef ERTS_PSD_SUSPENDED_SAVED_CALLS_BUF
 #  undef ERTS_PSD_SIZE
-#  define ERTS_PSD_SIZE 10
+#  define ERTS_PSD_SIZE 12
 #endif
 
 typedef struct {
@@ -857,6 +904,12 @@ typedef struct {
 #define ERTS_PSD_PENDING_SUSPEND_GET_LOCKS ERTS_PROC_LOCK_MAIN
 #define ERTS_PSD_PENDING_SUSPEND_SET_LOCKS ERTS_PROC_LOCK_MAIN
 
+#define ERTS_PSD_GC_AGING_GET_LOCKS ERTS_PROC_LOCK_MAIN
+#define ERTS_PSD_GC_AGING_SET_LOCKS ERTS_PROC_LOCK_MAIN
+
+#define ERTS_PSD_INCR_MAJOR_GC_GET_LOCKS ERTS_PROC_LOCK_MAIN
+#define ERTS_PSD_INCR_MAJOR_GC_SET_LOCKS ERTS_PROC_LOCK_MAIN
+
 typedef struct {
     ErtsProcLocks get_locks;
     ErtsProcLocks set_locks;
@@ -977,6 +1030,7 @@ struct process {
 				 */
     Uint32 rcount;		/* suspend count */
     int  schedule_count;	/* Times left to reschedule a low prio process */
+    ErtsMonotonicTime runq_enq_time; /* When enqueued if run_queue_delay */
     Uint reds;			/* No of reductions for this process  */
     Eterm group_leader;		/* Pid in charge (can be boxed) */
     Uint flags;			/* Trap exit, etc (no trace flags anymore) */
@@ -1039,6 +1093,11 @@ struct process {
     Uint64 bin_old_vheap_sz;	/* Virtual old heap block size for binaries */
     Uint64 bin_old_vheap;	/* Virtual old heap size for binaries */
 
+    Uint live_estimate;		/* Weighted live young data after GC (words) */
+    Uint alloc_rate;		/* Weighted words allocated per 1000 reductions */
+    Uint gc_reds;		/* Reductions at the last GC */
+    Uint resizes_avoided;	/* Heap resizes skipped due to the estimates */
+
     ErtsProcSysTaskQs *sys_task_qs;
     ErtsProcSysTask *dirty_sys_tasks;
 
@@ -1046,6 +1105,8 @@ struct process {
     erts_atomic32_t dirty_state; /* Process dirty state flags (see ERTS_PDSFLG_*) */
 
     ErtsSignalInQueue sig_inq;
+    erts_atomic_t sig_inq_buffers;      /* In-queue buffers, if any */
+    erts_atomic32_t sig_inq_contention; /* Contended msgq lock count */
     ErlTraceMessageQueue *trace_msg_q;
     erts_proc_lock_t lock;
     ErtsSchedulerData *scheduler_data;
@@ -1364,7 +1425,7 @@ extern int erts_system_profile_ts_type;
 #define F_DISTRIBUTION       (1 <<  6) /* Process used in distribution */
 #define F_USING_DDLL         (1 <<  7) /* Process has used the DDLL interface */
 #define F_HAVE_BLCKD_MSCHED  (1 <<  8) /* Process has blocked multi-scheduling */
-#define F_UNUSED             (1 <<  9)
+#define F_INCR_MAJOR_GC      (1 <<  9) /* Incremental major gc in progress */
 #define F_FORCE_GC           (1 << 10) /* Force gc at process in-scheduling */
 #define F_DISABLE_GC         (1 << 11) /* Disable GC (see below) */
 #define F_OFF_HEAP_MSGQ      (1 << 12) /* Off heap msg queue */
@@ -1553,6 +1614,13 @@ void erts_execute_dirty_system_task(Process *c_p);
 int erts_set_gc_state(Process *c_p, int enable);
 Eterm erts_sched_wall_time_request(Process *c_p, int set, int enable,
                                    int dirty_cpu, int want_dirty_io);
+Eterm erts_sched_wait_info(Process *c_p);
+int erts_sched_set_wakeup_latency(int enable);
+int erts_sched_set_runq_delay(int enable);
+Eterm erts_sched_runq_delay_info(Process *c_p);
+int erts_sched_set_dirty_class_weight(Eterm module, Uint weight,
+                                      Uint *old_weightp);
+Eterm erts_sched_dirty_class_info(Process *c_p);
 Eterm erts_system_check_request(Process *c_p);
 Eterm erts_gc_info_request(Process *c_p);
 Uint64 erts_get_proc_interval(void);
@@ -1732,6 +1800,7 @@ ERTS_GLB_INLINE int erts_proclist_is_last(ErtsProcList *list,
 
 int erts_sched_set_wakeup_other_threshold(ErtsSchedType sched_type, char *str);
 int erts_sched_set_wakeup_other_type(ErtsSchedType sched_type, char *str);
+int erts_sched_set_steal_type(char *str);
 int erts_sched_set_busy_wait_threshold(ErtsSchedType sched_type, char *str);
 int erts_sched_set_wake_cleanup_threshold(char *);
 
@@ -1778,6 +1847,7 @@ void erts_schedule_multi_misc_aux_work(int ignore_self,
 				       int max_sched,
 				       void (*func)(void *),
 				       void *arg);
+void erts_wake_dirty_cpu_schedulers(int n);
 erts_aint32_t erts_set_aux_work_timeout(int, erts_aint32_t, int);
 void erts_aux_work_timeout_late_init(ErtsSchedulerData *esdp);
 void erts_sched_notify_check_cpu_bind(void);
@@ -1834,6 +1904,8 @@ Eterm erts_get_process_priority(erts_aint32_t state);
 Eterm erts_set_process_priority(Process *p, Eterm prio);
 
 Uint erts_get_total_context_switches(void);
+Uint erts_get_total_numa_migrations(void);
+int erts_get_numa_node(void);
 void erts_get_total_reductions(Uint *, Uint *);
 void erts_get_exact_total_reductions(Process *, Uint *, Uint *);
 
@@ -2046,6 +2118,15 @@ erts_psd_set(Process *p, int ix, void *data)
 #define ERTS_PROC_SET_PENDING_SUSPEND(P, PS) \
     ((void *) erts_psd_set((P), ERTS_PSD_PENDING_SUSPEND, (void *) (PS)))
 
+#define ERTS_PROC_GET_GC_AGING(P) \
+    ((struct erts_gc_aging *) erts_psd_get((P), ERTS_PSD_GC_AGING))
+#define ERTS_PROC_SET_GC_AGING(P, GCA) \
+    ((struct erts_gc_aging *) erts_psd_set((P), ERTS_PSD_GC_AGING, (void *) (GCA)))
+#define ERTS_PROC_GET_INCR_MAJOR_GC(P) \
+    ((struct erts_incr_major_gc *) erts_psd_get((P), ERTS_PSD_INCR_MAJOR_GC))
+#define ERTS_PROC_SET_INCR_MAJOR_GC(P, IGC) \
+    ((struct erts_incr_major_gc *) erts_psd_set((P), ERTS_PSD_INCR_MAJOR_GC, (void *) (IGC)))
+
 #ifdef HIPE
 #define ERTS_PROC_GET_SUSPENDED_SAVED_CALLS_BUF(P) \
   ((struct saved_calls *) erts_psd_get((P), ERTS_PSD_SUSPENDED_SAVED_CALLS_BUF))
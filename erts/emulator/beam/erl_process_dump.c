@@ -134,6 +134,7 @@ Uint erts_process_memory(Process *p, int include_sigs_in_transit)
         size += (p->hend - p->heap) * sizeof(Eterm);
     if (p->old_hend && p->old_heap)
         size += (p->old_hend - p->old_heap) * sizeof(Eterm);
+    size += erts_incr_major_gc_memory(p);
 
     if (!include_sigs_in_transit) {
         /*
@@ -915,6 +915,7 @@ typedef struct ErtsLiteralArea_ {
 } ErtsLiteralArea;
 
 void erts_queue_release_literals(Process *c_p, ErtsLiteralArea* literals);
+Uint erts_literal_areas_pending_release(void);
 
 #define ERTS_LITERAL_AREA_ALLOC_SIZE(N) \
     (sizeof(ErtsLiteralArea) + sizeof(Eterm)*((N) - 1))
@@ -1070,6 +1071,7 @@ Eterm copy_object_x(Eterm, Process*, Uint);
 Uint size_object_x(Eterm, erts_literal_area_t*);
 #define size_object(Term) size_object_x(Term,NULL)
 #define size_object_litopt(Term,LitArea) size_object_x(Term,LitArea)
+Uint erts_size_object_sharing_hint(Eterm, erts_literal_area_t*, int*);
 
 Uint copy_shared_calculate(Eterm, erts_shcopy_t*);
 Eterm copy_shared_perform(Eterm, Uint, erts_shcopy_t*, Eterm**, ErlOffHeap*);
@@ -1084,6 +1086,75 @@ Eterm copy_struct_x(Eterm, Uint, Eterm**, ErlOffHeap*, Uint*, erts_literal_area_
 
 Eterm copy_shallow(Eterm* ERTS_RESTRICT, Uint, Eterm**, ErlOffHeap*);
 
+/* The state of a parallel copy, see erts_par_copy_calculate() */
+
+#define ERTS_PAR_COPY_DEF_PARTS 8
+#define ERTS_PAR_COPY_DEF_NODES 8
+
+typedef struct {
+    Eterm *src;         /* First source slot, or first cell of a list segment */
+    Uint n;             /* Number of slots or cells */
+    Uint size;          /* Heap words needed by the part */
+    Uint dst;           /* Skeleton offset of first destination slot */
+    Eterm tail;         /* List segment tail, THE_NON_VALUE if continued */
+    int list;
+    Eterm *hp;
+    struct erl_off_heap_header *oh_first;
+    struct erl_off_heap_header *oh_last;
+    Uint64 oh_overhead;
+} ErtsParCopyPart;
+
+typedef struct {
+    Eterm *src;
+    Uint size;
+    Uint dst;           /* Skeleton offset of the slot referring to the node */
+    int list;
+} ErtsParCopyNode;
+
+typedef struct ErtsParCopy_ {
+    struct ErtsParCopy_ *next;
+    erts_literal_area_t *litopt;
+    ErtsParCopyPart *parts;
+    Uint nparts;
+    Uint parts_sz;
+    ErtsParCopyNode *nodes;
+    Uint nnodes;
+    Uint nodes_sz;
+    Uint skel_words;
+    Eterm *skel;
+    erts_atomic_t claimed;
+    erts_atomic_t done;
+    erts_atomic32_t helpers;
+    ErtsParCopyPart parts_default[ERTS_PAR_COPY_DEF_PARTS];
+    ErtsParCopyNode nodes_default[ERTS_PAR_COPY_DEF_NODES];
+} ErtsParCopy;
+
+#define INITIALIZE_PAR_COPY(info)                                       \
+    do {                                                                \
+        (info).parts = (info).parts_default;                            \
+        (info).nparts = 0;                                              \
+        (info).parts_sz = ERTS_PAR_COPY_DEF_PARTS;                      \
+        (info).nodes = (info).nodes_default;                            \
+        (info).nnodes = 0;                                              \
+        (info).nodes_sz = ERTS_PAR_COPY_DEF_NODES;                      \
+        (info).skel_words = 0;                                          \
+    } while(0)
+
+#define DESTROY_PAR_COPY(info)                                          \
+    do {                                                                \
+        if ((info).parts != (info).parts_default)                       \
+            erts_free(ERTS_ALC_T_TMP, (info).parts);                    \
+        if ((info).nodes != (info).nodes_default)                       \
+            erts_free(ERTS_ALC_T_TMP, (info).nodes);                    \
+    } while(0)
+
+extern Uint erts_par_copy_threshold;
+
+void erts_init_par_copy(void);
+Uint erts_par_copy_calculate(Eterm, ErtsParCopy*, erts_literal_area_t*);
+Eterm erts_par_copy_perform(Eterm, Uint, ErtsParCopy*, Eterm**, ErlOffHeap*);
+void erts_par_copy_help(void);
+
 void erts_move_multi_frags(Eterm** hpp, ErlOffHeap*, ErlHeapFragment* first,
 			   Eterm* refs, unsigned nrefs, int literals);
 
@@ -1247,12 +1318,14 @@ void erts_init_bif_chksum(void);
 /* erl_bif_re.c */
 void erts_init_bif_re(void);
 Sint erts_re_set_loop_limit(Sint limit);
+Eterm erts_re_cache_info(Process *c_p);
 /* erl_bif_binary.c */
 void erts_init_bif_binary(void);
 Sint erts_binary_set_loop_limit(Sint limit);
 
 /* erl_bif_persistent.c */
-void erts_init_bif_persistent_term(void);
+#define ERTS_PERSISTENT_TERM_MAX_SHARDS 4096
+void erts_init_bif_persistent_term(Uint shards);
 Uint erts_persistent_term_count(void);
 void erts_init_persistent_dumping(void);
 extern ErtsLiteralArea** erts_persistent_areas;
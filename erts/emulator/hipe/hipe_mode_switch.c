@@ -499,7 +499,8 @@ Process *hipe_mode_switch(Process *p, unsigned cmd, Eterm reg[])
           if (erts_atomic32_read_nob(&p->state) & ERTS_PSFLG_EXITING)
               ASSERT(erts_atomic32_read_nob(&p->state) & ERTS_PSFLG_ACTIVE);
           else if (!(p->flags & F_HIPE_RECV_YIELD))
-              erts_atomic32_read_band_relb(&p->state, ~ERTS_PSFLG_ACTIVE);
+              erts_proc_sig_deactivate(p, (ERTS_PROC_LOCK_MAIN
+                                           | ERTS_PROC_LOCKS_MSG_RECEIVE));
           else {
               /* Yielded from receive */
               ERTS_VBUMP_ALL_REDS(p);
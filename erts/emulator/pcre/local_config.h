@@ -85,5 +85,19 @@
    ASCII/UTF-8/16/32, but not both at once. */
 #define SUPPORT_UTF 
 
+/* Define to enable the JIT compiler in pcre_jit_compile.c. It is only
+   enabled on the architectures where the bundled sljit (see the sljit
+   directory) can generate native code; the JIT is only used by re when
+   a pattern is compiled with the jit option. */
+#if defined(__x86_64__) || defined(_M_X64) \
+    || defined(__i386__) || defined(_M_IX86) \
+    || defined(__aarch64__) || defined(__arm__) \
+    || defined(__ppc64__) || defined(__powerpc64__) \
+    || defined(__ppc__) || defined(__powerpc__) \
+    || defined(__mips__) \
+    || (defined(__sparc__) && !defined(__arch64__))
+#define SUPPORT_JIT
+#endif
+
 /* Version number of package */
 #define VERSION "8.42"
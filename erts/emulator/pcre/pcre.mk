@@ -49,6 +49,8 @@ PCRE_OBJDIR = $(ERL_TOP)/erts/emulator/pcre/obj/$(TARGET)/$(TYPE)
 
 PCRE_DIR =  $(ERL_TOP)/erts/emulator/pcre
 
+PCRE_SLJIT = $(wildcard $(PCRE_DIR)/sljit/*.[ch])
+
 PCRE_CFLAGS = $(filter-out -DDEBUG,$(CFLAGS)) -DERLANG_INTEGRATION
 
 ifeq ($(TARGET), win32)
@@ -98,7 +100,7 @@ $(PCRE_OBJDIR)/pcre_globals.o: $(PCRE_DIR)/pcre_globals.c \
 	$(PCRE_DIR)/pcre.h $(PCRE_DIR)/ucp.h
 $(PCRE_OBJDIR)/pcre_jit_compile.o: $(PCRE_DIR)/pcre_jit_compile.c \
 	$(PCRE_DIR)/pcre_internal.h $(PCRE_DIR)/local_config.h \
-	$(PCRE_DIR)/pcre.h $(PCRE_DIR)/ucp.h
+	$(PCRE_DIR)/pcre.h $(PCRE_DIR)/ucp.h $(PCRE_SLJIT)
 $(PCRE_OBJDIR)/pcre_latin_1_table.o: $(PCRE_DIR)/pcre_latin_1_table.c \
 	$(PCRE_DIR)/pcre_internal.h $(PCRE_DIR)/local_config.h \
 	$(PCRE_DIR)/pcre.h $(PCRE_DIR)/ucp.h
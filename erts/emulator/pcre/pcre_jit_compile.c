@@ -180,7 +180,11 @@ typedef struct executable_functions {
   void *executable_funcs[JIT_NUMBER_OF_COMPILE_MODES];
   void *read_only_data_heads[JIT_NUMBER_OF_COMPILE_MODES];
   sljit_uw executable_sizes[JIT_NUMBER_OF_COMPILE_MODES];
+#if defined(ERLANG_INTEGRATION)
+  pcre_jit_callback callback;
+#else
   PUBL(jit_callback) callback;
+#endif
   void *userdata;
   sljit_u32 top_bracket;
   sljit_u32 limit_match;
@@ -11663,7 +11667,7 @@ return retval;
 #if defined COMPILE_PCRE8
 #if defined(ERLANG_INTEGRATION)
 PCRE_EXP_DEFN int PCRE_CALL_CONVENTION
-erts_pcre_jit_exec(const pcre *argument_re, const pcre_extra *extra_data,
+erts_pcre_jit_exec(const pcre *argument_re, const erts_pcre_extra *extra_data,
   PCRE_SPTR subject, int length, int start_offset, int options,
   int *offsets, int offset_count, pcre_jit_stack *stack)
 #else
@@ -11803,7 +11807,11 @@ if (startsize > maxsize)
   startsize = maxsize;
 startsize = (startsize + STACK_GROWTH_RATE - 1) & ~(STACK_GROWTH_RATE - 1);
 maxsize = (maxsize + STACK_GROWTH_RATE - 1) & ~(STACK_GROWTH_RATE - 1);
+#if defined(ERLANG_INTEGRATION)
+return (pcre_jit_stack*)sljit_allocate_stack(startsize, maxsize, NULL);
+#else
 return (PUBL(jit_stack)*)sljit_allocate_stack(startsize, maxsize, NULL);
+#endif
 }
 
 #if defined COMPILE_PCRE8
@@ -11828,7 +11836,7 @@ sljit_free_stack((struct sljit_stack *)stack, NULL);
 #if defined COMPILE_PCRE8
 #if defined(ERLANG_INTEGRATION)
 PCRE_EXP_DECL void
-erts_pcre_assign_jit_stack(pcre_extra *extra, pcre_jit_callback callback, void *userdata)
+erts_pcre_assign_jit_stack(erts_pcre_extra *extra, pcre_jit_callback callback, void *userdata)
 #else
 PCRE_EXP_DECL void
 pcre_assign_jit_stack(pcre_extra *extra, pcre_jit_callback callback, void *userdata)
@@ -30,6 +30,16 @@
 
 #if HAVE_ERTS_MMAP
 
+#if HAVE_MMAP && defined(__linux__)
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  if defined(SYS_mbind)
+#    define ERTS_MMAP_NUMA_BIND 1
+#    define ERTS_MMAP_MPOL_PREFERRED 1
+#    define ERTS_MMAP_NUMA_MAX_NODES 1024
+#  endif
+#endif
+
 /* #define ERTS_MMAP_OP_RINGBUF_SZ 100 */
 
 #if defined(DEBUG) || 0
@@ -1487,6 +1497,34 @@ alloc_desc_insert_free_seg(ErtsMemMapper* mm,
     return ERTS_PAGEALIGNED_SIZE;
 }
 
+/*
+ * In NUMA aware scheduling mode, ask the OS to place the pages of
+ * newly mapped segments on the NUMA node of the calling scheduler.
+ * This is only a preference; pages already touched are not moved,
+ * and failures are ignored. Only fresh OS mappings are bound;
+ * segments from the supercarrier are handed out without a system
+ * call, and their pages may already have been touched elsewhere.
+ */
+static ERTS_INLINE void
+numa_bind_segment(void *seg, UWord size)
+{
+#ifdef ERTS_MMAP_NUMA_BIND
+    unsigned long mask[ERTS_MMAP_NUMA_MAX_NODES / (8*sizeof(unsigned long))];
+    int node, bits = 8*sizeof(unsigned long);
+
+    if (!erts_sched_numa_aware)
+	return;
+    node = erts_get_numa_node();
+    if (node < 0 || ERTS_MMAP_NUMA_MAX_NODES <= node)
+	return;
+    sys_memzero((void *) mask, sizeof(mask));
+    mask[node / bits] = 1UL << (node % bits);
+    (void) syscall(SYS_mbind, seg, (unsigned long) size,
+		   ERTS_MMAP_MPOL_PREFERRED, mask,
+		   (unsigned long) ERTS_MMAP_NUMA_MAX_NODES + 1, 0);
+#endif
+}
+
 void *
 erts_mmap(ErtsMemMapper* mm, Uint32 flags, UWord *sizep)
 {
@@ -1659,6 +1697,7 @@ erts_mmap(ErtsMemMapper* mm, Uint32 flags, UWord *sizep)
 
 	ERTS_MMAP_OP_LCK(seg, *sizep, asize);
 	ERTS_MMAP_SIZE_OS_INC(asize);
+	numa_bind_segment(seg, asize);
 	*sizep = asize;
 	return (void *) seg;
     }
@@ -2,3 +2,4 @@
 {groups,"../emulator_test",binary_SUITE,[iolist_size_benchmarks]}.
 {groups,"../emulator_test",erts_debug_SUITE,[interpreter_size_bench]}.
 {groups,"../emulator_test",hash_SUITE,[phash2_benchmark]}.
+{groups,"../emulator_test",process_SUITE,[parallel_copy_bench]}.
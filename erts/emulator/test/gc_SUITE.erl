@@ -33,16 +33,22 @@
     grow_stack_heap/1,
     max_heap_size/1,
     minor_major_gc_option_async/1,
-    minor_major_gc_option_self/1
+    minor_major_gc_option_self/1,
+    tenure_age/1,
+    major_gc_slice/1,
+    heap_sizing/1
 ]).
 
+-export([heap_sizing_run/0]).
+
 suite() ->
     [{ct_hooks,[ts_install_cth]}].
 
 all() -> 
     [grow_heap, grow_stack, grow_stack_heap, max_heap_size,
     minor_major_gc_option_self,
-    minor_major_gc_option_async].
+    minor_major_gc_option_async, tenure_age, major_gc_slice,
+    heap_sizing].
 
 
 %% Produce a growing list of elements,
@@ -202,6 +208,349 @@ long_receive() ->
             ok
     end.
 
+%% Test that data stays in the young generation for the number of
+%% minor collections given by process_flag(tenure_age, Age).
+tenure_age(_Config) ->
+    1 = process_flag(tenure_age, 1),
+    {'EXIT', {badarg, _}} = (catch process_flag(tenure_age, 0)),
+    {'EXIT', {badarg, _}} = (catch process_flag(tenure_age, 9)),
+    {'EXIT', {badarg, _}} = (catch process_flag(tenure_age, foo)),
+    {garbage_collection, GC} = process_info(self(), garbage_collection),
+    1 = proplists:get_value(tenure_age, GC),
+    {garbage_collection_info, GCI} =
+        process_info(self(), garbage_collection_info),
+    false = lists:keymember(age_survival, 1, GCI),
+    [ok = tenure_age_survival(Age) || Age <- lists:seq(2, 8)],
+    [ok = tenure_age_integrity(Age) || Age <- [1, 2, 3, 8]],
+    ok.
+
+tenure_age_survival(Age) ->
+    Parent = self(),
+    {Pid, Ref} =
+        spawn_opt(
+          fun() ->
+                  1 = process_flag(tenure_age, Age),
+                  %% Promote some data to get an old heap
+                  Old = lists:seq(1, 100),
+                  erlang:garbage_collect(),
+                  erlang:garbage_collect(self(), [{type, minor}]),
+                  Data = lists:seq(1, 1000),
+                  Survived = [tenure_age_minor(K) || K <- lists:seq(1, Age)],
+                  100 = length(Old),
+                  Parent ! {self(), length(Data), Survived}
+          end, [monitor, {min_heap_size, 100000}, {fullsweep_after, 1000}]),
+    receive
+        {Pid, 1000, Survived} ->
+            %% The list of 2000 words has aged by one for each minor collection
+            [true = S >= 2000 || S <- Survived],
+            receive {'DOWN', Ref, process, Pid, normal} -> ok end;
+        {'DOWN', Ref, process, Pid, Reason} ->
+            ct:fail({tenure_age, Age, Reason})
+    end.
+
+tenure_age_minor(K) ->
+    {garbage_collection, GC0} = process_info(self(), garbage_collection),
+    {garbage_collection_info, GCI0} =
+        process_info(self(), garbage_collection_info),
+    Before = lists:nth(K, proplists:get_value(age_survival, GCI0)),
+    erlang:garbage_collect(self(), [{type, minor}]),
+    {garbage_collection, GC1} = process_info(self(), garbage_collection),
+    {garbage_collection_info, GCI1} =
+        process_info(self(), garbage_collection_info),
+    Ages = proplists:get_value(age_survival, GCI1),
+    Age = proplists:get_value(tenure_age, GC1),
+    Age = length(Ages) - 1,
+    MinorGCs = proplists:get_value(minor_gcs, GC0) + 1,
+    MinorGCs = proplists:get_value(minor_gcs, GC1),
+    lists:nth(K, Ages) - Before.
+
+%% Keep a mix of terms alive across many collections while
+%% tenuring at different ages and verify that they are intact.
+tenure_age_integrity(Age) ->
+    Parent = self(),
+    {Pid, Ref} =
+        spawn_opt(
+          fun() ->
+                  process_flag(tenure_age, Age),
+                  Keep = [{I, float(I), integer_to_list(I), <<I:32>>,
+                           #{I => I}} || I <- lists:seq(1, 2000)],
+                  Hash = erlang:phash2(Keep),
+                  Map = tenure_age_loop(2000, Keep, Hash, #{}),
+                  Hash = erlang:phash2(Keep),
+                  Parent ! {self(), map_size(Map)}
+          end, [monitor]),
+    receive
+        {Pid, 50} ->
+            receive {'DOWN', Ref, process, Pid, normal} -> ok end;
+        {'DOWN', Ref, process, Pid, Reason} ->
+            ct:fail({tenure_age, Age, Reason})
+    end.
+
+tenure_age_loop(0, _Keep, _Hash, Map) ->
+    maps:fold(fun(K, {L, <<K:64, Bin/binary>>}, ok) ->
+                      Bin = integer_to_binary(K),
+                      K = length(L),
+                      ok
+              end, ok, Map),
+    Map;
+tenure_age_loop(I, Keep, Hash, Map0) ->
+    Garbage = lists:seq(1, I rem 50),
+    Map = case I rem 7 of
+              0 ->
+                  K = I rem 50,
+                  Map0#{K => {lists:seq(1, K), <<K:64, (integer_to_binary(K))/binary>>}};
+              _ ->
+                  Map0
+          end,
+    self() ! {msg, Garbage},
+    receive {msg, Garbage} -> ok end,
+    case I rem 100 of
+        0 -> Hash = erlang:phash2(Keep);
+        _ -> ok
+    end,
+    tenure_age_loop(I - 1, Keep, Hash, Map).
+
+%% Test that fullsweep collections are done incrementally, without
+%% any major collection, when process_flag(major_gc_slice, Words)
+%% is set, and that live data survives them intact.
+major_gc_slice(_Config) ->
+    0 = process_flag(major_gc_slice, 0),
+    {'EXIT', {badarg, _}} = (catch process_flag(major_gc_slice, -1)),
+    {'EXIT', {badarg, _}} = (catch process_flag(major_gc_slice, foo)),
+    {garbage_collection, GC} = process_info(self(), garbage_collection),
+    0 = proplists:get_value(major_gc_slice, GC),
+    [ok = major_gc_slice_integrity(Slice) || Slice <- [100, 1000, 100000]],
+    [ok = major_gc_slice_growing(Slice) || Slice <- [1000, 10000, 100000]],
+    ok = major_gc_slice_interrupted(),
+    ok.
+
+major_gc_slice_integrity(Slice) ->
+    Parent = self(),
+    {Pid, Ref} =
+        spawn_opt(
+          fun() ->
+                  0 = process_flag(major_gc_slice, Slice),
+                  Parent ! {self(), ready},
+                  receive go -> ok end,
+                  Keep = major_gc_slice_data(3000),
+                  Hash = erlang:phash2(Keep),
+                  {Bin, Size} = major_gc_slice_loop(3000, Keep, Hash, <<>>, 0),
+                  Size = byte_size(Bin),
+                  Hash = erlang:phash2(Keep),
+                  {garbage_collection_info, GCI} =
+                      process_info(self(), garbage_collection_info),
+                  Parent ! {self(), proplists:get_value(old_heap_block_size, GCI)}
+          end, [monitor, {fullsweep_after, 2}]),
+    receive {Pid, ready} -> ok end,
+    1 = erlang:trace(Pid, true, [garbage_collection]),
+    Pid ! go,
+    receive
+        {Pid, OldHeapSz} ->
+            receive {'DOWN', Ref, process, Pid, normal} -> ok end,
+            %% Far more data than this has been promoted and reclaimed
+            true = OldHeapSz < 500000,
+            false = major_gc_slice_got_major(Pid, Slice),
+            ok;
+        {'DOWN', Ref, process, Pid, Reason} ->
+            ct:fail({major_gc_slice, Slice, Reason})
+    end.
+
+%% A live set that keeps growing, and is not promoted while a
+%% collection is in progress, is promoted once the collection is
+%% finished instead of staying in the young generation.
+major_gc_slice_growing(Slice) ->
+    Parent = self(),
+    {Pid, Ref} =
+        spawn_opt(
+          fun() ->
+                  0 = process_flag(major_gc_slice, Slice),
+                  Parent ! {self(), ready},
+                  receive go -> ok end,
+                  Grown = major_gc_slice_grow(50000, []),
+                  {garbage_collection_info, GCI} =
+                      process_info(self(), garbage_collection_info),
+                  Parent ! {self(), erts_debug:flat_size(Grown),
+                            proplists:get_value(old_heap_size, GCI)}
+          end, [monitor, {fullsweep_after, 2}]),
+    receive {Pid, ready} -> ok end,
+    1 = erlang:trace(Pid, true, [garbage_collection]),
+    Pid ! go,
+    receive
+        {Pid, Live, OldHeapSz} ->
+            receive {'DOWN', Ref, process, Pid, normal} -> ok end,
+            true = OldHeapSz > Live div 20,
+            false = major_gc_slice_got_major(Pid, Slice),
+            ok;
+        {'DOWN', Ref, process, Pid, Reason} ->
+            ct:fail({major_gc_slice_growing, Slice, Reason})
+    end.
+
+major_gc_slice_grow(0, Acc) ->
+    Acc;
+major_gc_slice_grow(I, Acc) ->
+    _Garbage = lists:seq(1, 20),
+    major_gc_slice_grow(I - 1, [{I, integer_to_list(I), <<I:800>>} | Acc]).
+
+%% Major collections of less than a slice of data are done at once
+major_gc_slice_got_major(Pid, Slice) ->
+    receive
+        {trace, Pid, gc_major_start, Info} ->
+            OldHeapSz = proplists:get_value(old_heap_size, Info),
+            HeapSz = proplists:get_value(heap_size, Info),
+            if
+                OldHeapSz =:= 0; OldHeapSz + HeapSz =< Slice ->
+                    major_gc_slice_got_major(Pid, Slice);
+                true ->
+                    true
+            end;
+        {trace, Pid, _, _} -> major_gc_slice_got_major(Pid, Slice)
+    after 0 -> false
+    end.
+
+%% Terms of all kinds, including off-heap ones
+major_gc_slice_data(N) ->
+    [{I, float(I), integer_to_list(I), <<I:32>>, <<I:800>>, I bsl 80,
+      #{I => I}, fun() -> I end, make_ref(), atomics:new(1, [])}
+     || I <- lists:seq(1, N)].
+
+major_gc_slice_loop(0, _Keep, _Hash, Bin, Size) ->
+    {Bin, Size};
+major_gc_slice_loop(I, Keep, Hash, Bin0, Size) ->
+    %% Medium-lived garbage that gets promoted
+    Garbage = major_gc_slice_data(I rem 20),
+    self() ! {msg, Garbage},
+    receive {msg, Garbage} -> ok end,
+    %% A writable binary that survives collections
+    Bin = <<Bin0/binary, I:8>>,
+    Sum = major_gc_slice_sum(Bin, 0),
+    Sum = major_gc_slice_sum(Bin, 0),
+    case I rem 100 of
+        0 ->
+            Hash = erlang:phash2(Keep),
+            erlang:yield();
+        _ -> ok
+    end,
+    major_gc_slice_loop(I - 1, Keep, Hash, Bin, Size + 1).
+
+major_gc_slice_sum(<<B:8, Rest/binary>>, Acc) ->
+    major_gc_slice_sum(Rest, Acc + B);
+major_gc_slice_sum(<<>>, Acc) ->
+    Acc.
+
+%% Explicit major collections and process exits abandon an
+%% incremental collection in progress.
+major_gc_slice_interrupted() ->
+    [begin
+         {Pid, Ref} =
+             spawn_opt(
+               fun() ->
+                       process_flag(major_gc_slice, 10),
+                       Keep = major_gc_slice_data(2000),
+                       Hash = erlang:phash2(Keep),
+                       major_gc_slice_loop(500, Keep, Hash, <<>>, 0),
+                       erlang:garbage_collect(),
+                       Hash = erlang:phash2(Keep),
+                       major_gc_slice_loop(1000000, Keep, Hash, <<>>, 0)
+               end, [monitor, {fullsweep_after, 0}]),
+         receive after T -> ok end,
+         exit(Pid, kill),
+         receive {'DOWN', Ref, process, Pid, killed} -> ok end
+     end || T <- [10, 50, 100, 200]],
+    ok.
+
+%% Test that the ewma heap sizing policy (+hsp ewma) avoids
+%% repeatedly growing and shrinking the heap of a process whose live
+%% data alternates between large and small.
+heap_sizing(Config) when is_list(Config) ->
+    {garbage_collection_info, GCI} =
+        process_info(self(), garbage_collection_info),
+    case erlang:system_info(heap_sizing) of
+        last -> undefined = proplists:get_value(live_estimate, GCI);
+        ewma -> true = is_integer(proplists:get_value(live_estimate, GCI))
+    end,
+    {'EXIT', {badarg, _}} = (catch erlang:system_info(heap_sizing_x)),
+
+    Pa = filename:dirname(code:which(?MODULE)),
+    Run = fun(Policy) ->
+                  {ok, Node} = test_server:start_node(
+                                 heap_sizing, slave,
+                                 [{args, "-pa " ++ Pa ++ " +hsp " ++ Policy}]),
+                  Policy = atom_to_list(rpc:call(Node, erlang, system_info,
+                                                 [heap_sizing])),
+                  Res = rpc:call(Node, ?MODULE, heap_sizing_run, []),
+                  test_server:stop_node(Node),
+                  Res
+          end,
+    {LastResizes, LastInfo, _} = Run("last"),
+    {EwmaResizes, EwmaInfo, EwmaFinalSize} = Run("ewma"),
+    ct:log("last: ~p resizes~n~p~newma: ~p resizes~n~p",
+           [LastResizes, LastInfo, EwmaResizes, EwmaInfo]),
+    undefined = proplists:get_value(resizes_avoided, LastInfo),
+    true = proplists:get_value(resizes_avoided, EwmaInfo) > 0,
+    true = proplists:get_value(live_estimate, EwmaInfo) > 0,
+    true = proplists:get_value(alloc_rate, EwmaInfo) > 0,
+    true = EwmaResizes * 2 < LastResizes,
+
+    %% The heap is still shrunk once the large requests stop
+    PeakSize = proplists:get_value(heap_block_size, EwmaInfo),
+    true = PeakSize > 60000,
+    true = EwmaFinalSize < PeakSize,
+    ok.
+
+%% Returns the number of heap block size changes during the large
+%% requests, the garbage collection info at the end of them, and the
+%% heap block size after many small requests
+heap_sizing_run() ->
+    Parent = self(),
+    Pid = spawn(fun() ->
+                        receive go -> ok end,
+                        heap_sizing_loop(200),
+                        {garbage_collection_info, GCI} =
+                            process_info(self(), garbage_collection_info),
+                        Parent ! {self(), GCI},
+                        heap_sizing_small(20000),
+                        {garbage_collection_info, FinalGCI} =
+                            process_info(self(), garbage_collection_info),
+                        Parent ! {self(), final, FinalGCI}
+                end),
+    1 = erlang:trace(Pid, true, [garbage_collection]),
+    Pid ! go,
+    heap_sizing_collect(Pid, 0, undefined).
+
+heap_sizing_collect(Pid, Resizes, Size) ->
+    receive
+        {trace, Pid, GC, Info} when GC =:= gc_minor_end;
+                                   GC =:= gc_major_end ->
+            case proplists:get_value(heap_block_size, Info) of
+                Size -> heap_sizing_collect(Pid, Resizes, Size);
+                NewSize -> heap_sizing_collect(Pid, Resizes + 1, NewSize)
+            end;
+        {trace, Pid, _, _} ->
+            heap_sizing_collect(Pid, Resizes, Size);
+        {Pid, GCI} ->
+            receive
+                {Pid, final, FinalGCI} ->
+                    {Resizes, GCI,
+                     proplists:get_value(heap_block_size, FinalGCI)}
+            end
+    end.
+
+%% Every other request keeps a large structure alive while it works
+heap_sizing_loop(0) ->
+    ok;
+heap_sizing_loop(I) ->
+    Tmp = lists:seq(1, 300 + (I rem 2) * 60000),
+    Work = [X * 2 || X <- Tmp],
+    _ = lists:sum(Work),
+    heap_sizing_small(50),
+    heap_sizing_loop(I - 1).
+
+heap_sizing_small(0) ->
+    ok;
+heap_sizing_small(N) ->
+    _ = lists:seq(1, 100),
+    heap_sizing_small(N - 1).
+
 minor_major_gc_option_self(_Config) ->
     %% Try as major, the test process will self-trigger GC
     check_gc_tracing_around(
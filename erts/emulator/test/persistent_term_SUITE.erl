@@ -27,10 +27,12 @@
          off_heap_values/1,keys/1,collisions/1,
          init_restart/1, put_erase_trapping/1,
          killed_while_trapping_put/1,
-         killed_while_trapping_erase/1]).
+         killed_while_trapping_erase/1,
+         put_many/1, put_many_trapping/1,
+         killed_while_trapping_put_many/1, shards/1]).
 
 %%
--export([test_init_restart_cmd/1]).
+-export([test_init_restart_cmd/1, shards_do/0]).
 
 suite() ->
     [{ct_hooks,[ts_install_cth]},
@@ -40,7 +42,8 @@ all() ->
     [basic,purging,sharing,get_trapping,info,info_trapping,
      killed_while_trapping,off_heap_values,keys,collisions,
      init_restart, put_erase_trapping, killed_while_trapping_put,
-     killed_while_trapping_erase].
+     killed_while_trapping_erase, put_many, put_many_trapping,
+     killed_while_trapping_put_many, shards].
 
 init_per_suite(Config) ->
     %% Put a term in the dict so that we know that the testcases handle
@@ -696,3 +699,167 @@ repeat(_Fun, 0) ->
 repeat(Fun, N) ->
     Fun(),
     repeat(Fun, N-1).
+
+%% Test storing many terms at once.
+
+put_many(_Config) ->
+    Chk = chk(),
+    do_put_many(),
+    put_many_purging(),
+    chk(Chk).
+
+do_put_many() ->
+    Seq = lists:seq(1, 500),
+    Kvs = [{{?MODULE,put_many,I},{value,I}} || I <- Seq],
+    ok = persistent_term:put_many(Kvs),
+    _ = [V = persistent_term:get(K) || {K,V} <- Kvs],
+    ok = persistent_term:put_many([]),
+    {'EXIT',{badarg,_}} = (catch persistent_term:put_many(a)),
+    {'EXIT',{badarg,_}} = (catch persistent_term:put_many([{a,b}|c])),
+    {'EXIT',{badarg,_}} = (catch persistent_term:put_many([{a,b,c}])),
+
+    %% The last value is kept for a duplicated key.
+    DupKey = {?MODULE,put_many,dup},
+    ok = persistent_term:put_many([{DupKey,1},{DupKey,{two}},{DupKey,1},
+                                   {DupKey,{three}}]),
+    {three} = persistent_term:get(DupKey),
+
+    %% Values equal to the stored ones are left in place.
+    Key1 = {?MODULE,put_many,1},
+    Value1 = persistent_term:get(Key1),
+    ok = persistent_term:put_many(Kvs),
+    true = erts_debug:same(Value1, persistent_term:get(Key1)),
+
+    %% Replace some of the terms, one by one and many at once.
+    ok = persistent_term:put(Key1, new),
+    new = persistent_term:get(Key1),
+    Kvs2 = [{K,{new_value,I}} || {{_,_,I}=K,_} <- Kvs, I rem 2 =:= 0],
+    ok = persistent_term:put_many(Kvs2),
+    _ = [V = persistent_term:get(K) || {K,V} <- Kvs2],
+
+    _ = [true = persistent_term:erase(K) || {K,_} <- Kvs],
+    true = persistent_term:erase(DupKey),
+    ok.
+
+%% The terms stored by one call are released when the last of them
+%% is deleted.
+
+put_many_purging() ->
+    Parent = self(),
+    Key1 = {?MODULE,?FUNCTION_NAME,1},
+    Key2 = {?MODULE,?FUNCTION_NAME,2},
+    ok = persistent_term:put_many([{Key1,{term,[<<"abc",0:777/unit:8>>]}},
+                                   {Key2,{term,other}}]),
+    {Pid,Ref} = spawn_monitor(fun() -> put_many_holder(Parent, Key1) end),
+    receive {Pid,gotten} -> ok end,
+    true = persistent_term:erase(Key1),
+    receive after 100 -> ok end,
+    Pid ! {Parent,check},
+    receive {Pid,shared} -> ok end,
+    true = persistent_term:erase(Key2),
+    Pid ! {Parent,erased},
+    receive
+        {'DOWN',Ref,process,Pid,Reason} ->
+            normal = Reason
+    end,
+    ok.
+
+put_many_holder(Parent, Key) ->
+    Term = persistent_term:get(Key),
+    0 = erts_debug:size_shared(Term),
+    Parent ! {self(),gotten},
+    receive
+        {Parent,check} ->
+            0 = erts_debug:size_shared(Term),
+            Parent ! {self(),shared}
+    end,
+    receive
+        {Parent,erased} ->
+            purging_tester_1(Term)
+    end.
+
+%% Test that a large batch is stored in several time slices.
+
+put_many_trapping(_Config) ->
+    Chk = chk(),
+    erts_debug:set_internal_state(available_internal_state, true),
+    Kvs = [{{?MODULE,?FUNCTION_NAME,I},{value,lists:seq(1, I rem 100)}} ||
+              I <- lists:seq(1, 50000)],
+    Parent = self(),
+    {Pid,Ref} = spawn_monitor(fun() ->
+                                      receive go -> ok end,
+                                      ok = persistent_term:put_many(Kvs),
+                                      Parent ! {self(),done}
+                              end),
+    1 = erlang:trace(Pid, true, [running]),
+    Pid ! go,
+    receive {Pid,done} -> ok end,
+    receive {'DOWN',Ref,process,Pid,normal} -> ok end,
+    TRef = erlang:trace_delivered(Pid),
+    receive {trace_delivered,Pid,TRef} -> ok end,
+    Outs = put_many_outs(0),
+    io:format("Scheduled out ~p times\n", [Outs]),
+    true = Outs > 1,
+    _ = [V = persistent_term:get(K) || {K,V} <- Kvs],
+
+    %% Replace the terms while trapping at random points.
+    Kvs2 = [{K,{new,V}} || {K,V} <- Kvs],
+    repeat(fun() ->
+                   erts_debug:set_internal_state(reds_left, rand:uniform(250)),
+                   ok = persistent_term:put_many(lists:sublist(Kvs2, 1000))
+           end, 10),
+    ok = persistent_term:put_many(Kvs2),
+    _ = [V = persistent_term:get(K) || {K,V} <- Kvs2],
+    _ = [true = persistent_term:erase(K) || {K,_} <- Kvs],
+    erts_debug:set_internal_state(available_internal_state, false),
+    chk(Chk).
+
+put_many_outs(N) ->
+    receive
+        {trace,_,out,{persistent_term,put_many,1}} ->
+            put_many_outs(N+1);
+        {trace,_,_,_} ->
+            put_many_outs(N)
+    after 0 ->
+            N
+    end.
+
+killed_while_trapping_put_many(_Config) ->
+    Chk = chk(),
+    Kvs = [{{?MODULE,?FUNCTION_NAME,I},{value,I}} ||
+              I <- lists:seq(1, 20000)],
+    repeat(
+      fun() ->
+              Pid = spawn(fun() -> ok = persistent_term:put_many(Kvs) end),
+              timer:sleep(1),
+              erlang:exit(Pid, kill),
+              ok = persistent_term:put_many(lists:sublist(Kvs, 100)),
+              _ = [persistent_term:erase(K) || {K,_} <- Kvs]
+      end,
+      10),
+    chk(Chk).
+
+%% Test spreading the terms over several hash tables.
+
+shards(_Config) ->
+    Pa = filename:dirname(code:which(?MODULE)),
+    {ok,Node} = test_server:start_node(?FUNCTION_NAME, slave,
+                                       [{args, "+zpts 8 -pa " ++ Pa}]),
+    try
+        ok = rpc:call(Node, ?MODULE, shards_do, [])
+    after
+        test_server:stop_node(Node)
+    end.
+
+shards_do() ->
+    Chk = chk(),
+    N = 1000,
+    Seq = lists:seq(1, N),
+    seq(2, Seq, Chk),
+    seq(3, Seq, Chk),
+    #{count:=Count} = persistent_term:info(),
+    true = Count >= N,
+    do_put_many(),
+    _ = [true = persistent_term:erase({?MODULE,{key,I}}) || I <- Seq],
+    [] = [P || {{?MODULE,_},_}=P <- pget(Chk)],
+    chk(Chk).
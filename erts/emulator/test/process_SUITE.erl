@@ -27,6 +27,7 @@
 %%	register/2 (partially)
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 -define(heap_binary_size, 64).
 
@@ -49,6 +50,9 @@
 	 otp_4725/1, bad_register/1, garbage_collect/1, otp_6237/1,
 	 process_info_messages/1, process_flag_badarg/1, process_flag_heap_size/1,
 	 spawn_opt_heap_size/1, spawn_opt_max_heap_size/1,
+	 parallel_copy/1, parallel_copy_bench/1, message_sharing/1,
+         send_many/1, receive_index/1, receive_index_bench/1,
+         message_queue_buffers/1, message_queue_buffers_bench/1,
 	 processes_large_tab/1, processes_default_tab/1, processes_small_tab/1,
 	 processes_this_tab/1, processes_apply_trap/1,
 	 processes_last_call_trap/1, processes_gc_trap/1,
@@ -70,6 +74,11 @@
 -export([hangaround/2, processes_bif_test/0, do_processes/1,
 	 processes_term_proc_list_test/1]).
 
+-export([parallel_copy_test/0, parallel_copy_writable_test/0,
+         parallel_copy_bench_run/0,
+         message_sharing_test/0, message_queue_buffers_test/0,
+         message_queue_buffers_bench_run/0]).
+
 suite() ->
     [{ct_hooks,[ts_install_cth]},
      {timetrap, {minutes, 9}}].
@@ -89,7 +98,9 @@ all() ->
      bump_reductions, low_prio, yield, yield2, otp_4725,
      bad_register, garbage_collect, process_info_messages,
      process_flag_badarg, process_flag_heap_size,
-     spawn_opt_heap_size, spawn_opt_max_heap_size, otp_6237,
+     spawn_opt_heap_size, spawn_opt_max_heap_size, parallel_copy,
+     message_sharing, send_many, receive_index, message_queue_buffers,
+     otp_6237,
      {group, processes_bif},
      {group, otp_7738}, garb_other_running,
      {group, system_task}].
@@ -110,7 +121,10 @@ groups() ->
      {system_task, [],
       [no_priority_inversion, no_priority_inversion2,
        system_task_blast, system_task_on_suspended, system_task_failed_enqueue,
-       gc_request_when_gc_disabled, gc_request_blast_when_gc_disabled]}].
+       gc_request_when_gc_disabled, gc_request_blast_when_gc_disabled]},
+     {parallel_copy_bench, [], [parallel_copy_bench]},
+     {receive_index_bench, [], [receive_index_bench]},
+     {message_queue_buffers_bench, [], [message_queue_buffers_bench]}].
 
 init_per_suite(Config) ->
     A0 = case application:start(sasl) of
@@ -1587,6 +1601,7 @@ process_flag_badarg(Config) when is_list(Config) ->
 
     chk_badarg(fun () -> process_flag(priority, 4711) end),
     chk_badarg(fun () -> process_flag(save_calls, hmmm) end),
+    chk_badarg(fun () -> process_flag(receive_index, hmmm) end),
     P= spawn_link(fun () -> receive die -> ok end end),
     chk_badarg(fun () -> process_flag(P, save_calls, hmmm) end),
     chk_badarg(fun () -> process_flag(gurka, save_calls, hmmm) end),
@@ -2317,6 +2332,487 @@ flush() ->
             ok
     end.
 
+%% Send large terms of all shapes between processes on a node that
+%% copies terms of at least 1000 words in parallel.
+parallel_copy(Config) when is_list(Config) ->
+    {ok, Node} = start_node(Config, "+zpcs 1000 +SDcpu 4"),
+    Tags = rpc:call(Node, ?MODULE, parallel_copy_test, []),
+    true = rpc:call(Node, ?MODULE, parallel_copy_writable_test, []),
+    stop_node(Node),
+    Tags = [Tag || {Tag, _} <- parallel_copy_terms()],
+    ok.
+
+%% A writable binary that is not part of the message should stay
+%% writable. The large heap keeps a GC from shrinking it meanwhile.
+parallel_copy_writable_test() ->
+    Self = self(),
+    spawn_opt(fun () ->
+                      Self ! {writable, parallel_copy_writable()}
+              end, [{min_heap_size, 4000000}]),
+    receive {writable, Res} -> Res end.
+
+parallel_copy_writable() ->
+    Kept = parallel_copy_append(<<>>, 1000),
+    true = binary:referenced_byte_size(Kept) > byte_size(Kept),
+    Seq = lists:seq(1, 20000),
+    Self = self(),
+    Echo = spawn_link(fun () ->
+                              receive Msg -> Self ! Msg end
+                      end),
+    Echo ! {echo, [{Seq}, Seq], parallel_copy_append(<<>>, 1000)},
+    receive {echo, _, _} -> ok end,
+    binary:referenced_byte_size(Kept) > byte_size(Kept).
+
+parallel_copy_test() ->
+    Self = self(),
+    Echo = spawn_link(fun Loop() ->
+                              receive
+                                  {Tag, Term} ->
+                                      Self ! {Tag, Term},
+                                      Loop()
+                              end
+                      end),
+    Tags = [begin
+                Echo ! {Tag, Term},
+                receive {Tag, Term} -> Tag end
+            end || {Tag, Term} <- parallel_copy_terms()],
+    unlink(Echo),
+    exit(Echo, kill),
+    erlang:garbage_collect(),
+    Tags.
+
+parallel_copy_terms() ->
+    Bin = list_to_binary(lists:duplicate(200, $a)),
+    <<_:3, SubBin/bitstring>> = Bin,
+    Fun = fun(X) -> {X, Bin} end,
+    Seq = lists:seq(1, 20000),
+    Literal = {a, literal, [term], #{1 => 2}},
+    [{tuple, list_to_tuple([{I, Bin, I * 1.5} || I <- Seq])},
+     {list, [{I, SubBin, 1 bsl 100} || I <- Seq]},
+     {improper_list, Seq ++ Bin},
+     {flatmap, #{a => Seq, b => [Fun], c => {make_ref(), self()}}},
+     {hashmap, maps:from_list([{I, [I, Bin]} || I <- Seq])},
+     {short_list, [{Seq}, Seq | lists:seq(1, 100)]},
+     {literals, {Literal, Seq, [Literal | Literal]}},
+     {nested, parallel_copy_nested(5)},
+     {writable_binary, {Seq, parallel_copy_append(<<>>, 1000)}},
+     {small, {1, [2], 3}}].
+
+parallel_copy_nested(0) ->
+    lists:seq(1, 500);
+parallel_copy_nested(N) ->
+    Sub = parallel_copy_nested(N - 1),
+    {Sub, [Sub], #{N => Sub}}.
+
+parallel_copy_append(Bin, 0) ->
+    Bin;
+parallel_copy_append(Bin, N) ->
+    parallel_copy_append(<<Bin/binary, N:32>>, N - 1).
+
+%% Send terms with and without internal sharing on a node that
+%% preserves sharing in messages when it pays off.
+message_sharing(Config) when is_list(Config) ->
+    #{mode := flat} = erlang:system_info(message_sharing),
+    {ok, Node} = start_node(Config, "+zms adaptive"),
+    ok = rpc:call(Node, ?MODULE, message_sharing_test, []),
+    Tags = rpc:call(Node, ?MODULE, parallel_copy_test, []),
+    stop_node(Node),
+    Tags = [Tag || {Tag, _} <- parallel_copy_terms()],
+    ok.
+
+message_sharing_test() ->
+    #{mode := adaptive,
+      shared_sends := Sends0,
+      bytes_saved := Saved0} = erlang:system_info(message_sharing),
+    Seq = lists:seq(1, 20000),
+    Tree = [{I, [I]} || I <- Seq],
+    Tree = message_sharing_echo(Tree),
+    #{shared_sends := Sends0,
+      bytes_saved := Saved0} = erlang:system_info(message_sharing),
+    Dag = message_sharing_dag(12),
+    Dag = message_sharing_echo(Dag),
+    #{shared_sends := Sends1,
+      bytes_saved := Saved1} = erlang:system_info(message_sharing),
+    true = Sends1 > Sends0,
+    Flat = erts_debug:flat_size(Dag),
+    Shared = erts_debug:size(Dag),
+    true = Saved1 - Saved0 >= (Flat - Shared) * erlang:system_info(wordsize),
+    ok.
+
+message_sharing_echo(Term) ->
+    Self = self(),
+    Echo = spawn_link(fun() ->
+                              receive
+                                  Msg -> Self ! {self(), Msg}
+                              end
+                      end),
+    Echo ! Term,
+    receive {Echo, Msg} -> Msg end.
+
+message_sharing_dag(0) ->
+    lists:seq(1, 10);
+message_sharing_dag(N) ->
+    Sub = message_sharing_dag(N - 1),
+    {Sub, [Sub]}.
+
+%% Send messages of different shapes to many processes at once with
+%% erlang:send_many/2.
+send_many(Config) when is_list(Config) ->
+    Bin = list_to_binary(lists:duplicate(200, $a)),
+    Holders = [spawn_link(fun send_many_holder/0) || _ <- lists:seq(1, 20)],
+    Terms = [{tuple, [1, 2], Bin, 1 bsl 100, 1.5, self(), make_ref()},
+             [list | {Bin, fun() -> Bin end}],
+             #{flatmap => [Bin]},
+             maps:from_list([{I, I} || I <- lists:seq(1, 100)]),
+             {large, lists:seq(1, 100000)},
+             atom,
+             <<"binary">>],
+    [begin
+         ok = erlang:send_many(Holders ++ Holders, Term),
+         [Term = send_many_get(H) || H <- Holders]
+     end || Term <- Terms],
+
+    %% Other kinds of destinations
+    Name = send_many_holder,
+    register(Name, spawn_link(fun send_many_holder/0)),
+    {Dead, DeadMon} = spawn_monitor(fun() -> ok end),
+    receive {'DOWN', DeadMon, process, Dead, normal} -> ok end,
+    ok = erlang:send_many([self(), Name, Dead, self()], {hello, Bin}),
+    [receive {hello, Bin} -> ok end || _ <- [1, 2]],
+    {hello, Bin} = send_many_get(whereis(Name)),
+    ok = erlang:send_many([], {hello, Bin}),
+    {'EXIT', {badarg, _}} = (catch erlang:send_many(Name, x)),
+    {'EXIT', {badarg, _}} = (catch erlang:send_many([self() | Name], x)),
+    receive x -> ok end,
+
+    %% Enough destinations to make send_many yield
+    ok = erlang:send_many(lists:append(lists:duplicate(1000, Holders)),
+                          {many, Bin}),
+    [{many, Bin} = send_many_get(H) || H <- Holders],
+
+    %% Keep a message while the areas messages are copied into are
+    %% released.
+    Kept = {kept, lists:seq(1, 50), Bin},
+    ok = erlang:send_many(Holders, Kept),
+    [ok = erlang:send_many([self()], {filler, lists:seq(1, 1000)})
+     || _ <- lists:seq(1, 200)],
+    [receive {filler, _} -> ok end || _ <- lists:seq(1, 200)],
+    BigBin = binary:copy(<<$b>>, 100000),
+    [ok = erlang:send_many([self()], {filler, BigBin})
+     || _ <- lists:seq(1, 50)],
+    [receive {filler, BigBin} -> ok end || _ <- lists:seq(1, 50)],
+    ct:sleep(500),
+    [begin H ! gc, Kept = send_many_get(H) end || H <- Holders],
+
+    %% An arena that is not full is released once it has been idle
+    [H ! dropped || H <- Holders],
+    ok = erlang:send_many([self()], {idle, Bin}),
+    receive {idle, Bin} -> ok end,
+    Held = erts_debug:alloc_blocks_size(literal_alloc),
+    wait_until(fun () ->
+                       erts_debug:alloc_blocks_size(literal_alloc) < Held
+               end),
+    [begin H ! gc, dropped = send_many_get(H) end || H <- Holders],
+    ok.
+
+send_many_holder() ->
+    send_many_holder(undefined).
+
+send_many_holder(Term) ->
+    receive
+        {get, From} ->
+            From ! {self(), Term},
+            send_many_holder(Term);
+        gc ->
+            erlang:garbage_collect(),
+            send_many_holder(Term);
+        NewTerm ->
+            send_many_holder(NewTerm)
+    end.
+
+send_many_get(Holder) ->
+    Holder ! {get, self()},
+    receive {Holder, Term} -> Term end.
+
+%% Receive tagged messages out of a long message queue with
+%% process_flag(receive_index, true).
+receive_index(Config) when is_list(Config) ->
+    false = process_flag(receive_index, true),
+    Self = self(),
+    Noise = [{noise, I} || I <- lists:seq(1, 1000)] ++ lists:seq(1, 1000),
+    [Self ! M || M <- lists:sublist(Noise, 1000)],
+    Self ! {reply, a},
+    [Self ! M || M <- lists:nthtail(1000, Noise)],
+    Self ! {reply, b},
+    Self ! {reply, x, y},
+    a = receive_index_reply(),
+    b = receive_index_reply(),
+    timeout = receive_index_reply(0),
+    Ref = make_ref(),
+    Self ! {reply, Ref, c},
+    Self ! {reply, other, d},
+    c = receive_index_reply3(Ref),
+    d = receive_index_reply3(other),
+    y = receive_index_reply3(x),
+
+    %% Messages arriving while waiting
+    spawn(fun () ->
+                  receive after 100 -> ok end,
+                  [Self ! {late_noise, I} || I <- lists:seq(1, 100)],
+                  Self ! {reply, late}
+          end),
+    late = receive_index_reply(),
+
+    %% Receive with a catch-all clause must not skip anything
+    Self ! {reply, first},
+    {other, {noise, 1}} = receive
+                              {reply, _} = R -> R;
+                              Other -> {other, Other}
+                          end,
+
+    %% The index is dropped and rebuilt without changing the queue
+    true = process_flag(receive_index, false),
+    false = process_flag(receive_index, true),
+    {reply, first} = receive {reply, _} = R1 -> R1 end,
+    {messages, Msgs} = process_info(Self, messages),
+    Msgs = tl(Noise) ++ [{late_noise, I} || I <- lists:seq(1, 100)],
+    Msgs = receive_index_flush(),
+
+    %% Skipping past many messages with the tag but another content
+    %% must not rescan them for every skip
+    [begin Self ! {reply, other, I}, Self ! {noise, I} end
+     || I <- lists:seq(1, 5000)],
+    Self ! {reply, Ref, e},
+    {reductions, Reds0} = process_info(Self, reductions),
+    e = receive_index_reply3(Ref),
+    {reductions, Reds1} = process_info(Self, reductions),
+    true = Reds1 - Reds0 < 100000,
+    10000 = length(receive_index_flush()),
+
+    %% A process with an index and queued messages exits
+    P = spawn(fun () ->
+                      process_flag(receive_index, true),
+                      receive {reply, _} -> ok end
+              end),
+    [P ! {noise, I} || I <- lists:seq(1, 10000)],
+    exit(P, kill),
+    true = process_flag(receive_index, false),
+    ok.
+
+receive_index_reply() ->
+    receive {reply, X} -> X end.
+
+receive_index_reply(Timeout) ->
+    receive {reply, X} -> X after Timeout -> timeout end.
+
+receive_index_reply3(Ref) ->
+    receive {reply, Ref, X} -> X end.
+
+receive_index_flush() ->
+    receive M -> [M | receive_index_flush()] after 0 -> [] end.
+
+%% Measure the time it takes to receive a tagged message with and
+%% without a receive index, depending on the length of the queue of
+%% messages that do not match.
+receive_index_bench(Config) when is_list(Config) ->
+    Res = [begin
+               Plain = receive_index_bench_run(Len, false),
+               Indexed = receive_index_bench_run(Len, true),
+               ct_event:notify(#event{name = benchmark_data,
+                                      data = [{suite, ?MODULE},
+                                              {name, "receive_index_"
+                                               ++ integer_to_list(Len)},
+                                              {value, Plain / Indexed}]}),
+               {Len, Plain, Indexed}
+           end || Len <- [0, 10, 100, 1000, 10000, 100000]],
+    {comment, io_lib:format("{QueueLen, PlainUs, IndexedUs}: ~p", [Res])}.
+
+receive_index_bench_run(Len, Index) ->
+    Self = self(),
+    Rounds = 1000,
+    process_flag(receive_index, Index),
+    [Self ! {noise, I} || I <- lists:seq(1, Len)],
+    {Time, _} = timer:tc(fun () ->
+                                 [begin
+                                      Self ! {reply, I},
+                                      I = receive_index_reply()
+                                  end || I <- lists:seq(1, Rounds)]
+                         end),
+    _ = receive_index_flush(),
+    process_flag(receive_index, false),
+    Time / Rounds.
+
+%% Compare the time it takes to send large terms with and without
+%% parallel copying.
+parallel_copy_bench(Config) when is_list(Config) ->
+    {ok, Serial} = start_node(Config, ""),
+    {ok, Parallel} = start_node(Config, "+zpcs 100000"),
+    SerialRes = rpc:call(Serial, ?MODULE, parallel_copy_bench_run, []),
+    ParallelRes = rpc:call(Parallel, ?MODULE, parallel_copy_bench_run, []),
+    stop_node(Serial),
+    stop_node(Parallel),
+    Speedups = [begin
+                    Speedup = STime / PTime,
+                    ct_event:notify(#event{name = benchmark_data,
+                                           data = [{suite, ?MODULE},
+                                                   {name, Shape},
+                                                   {value, Speedup}]}),
+                    {Shape, Speedup}
+                end || {{Shape, STime}, {Shape, PTime}}
+                           <- lists:zip(SerialRes, ParallelRes)],
+    {comment, io_lib:format("Speedup: ~p", [Speedups])}.
+
+parallel_copy_bench_run() ->
+    Seq = lists:seq(1, 1000000),
+    Shapes = [{list, Seq},
+              {tuple_list, [{I, <<"abc">>, float(I)} || I <- Seq]},
+              {map, maps:from_list([{I, {I, I}} || I <- Seq])},
+              {tuple, list_to_tuple([[I, I] || I <- Seq])}],
+    Echo = spawn_link(fun Loop() ->
+                              receive
+                                  {From, _} ->
+                                      From ! done,
+                                      Loop()
+                              end
+                      end),
+    Res = [{Shape, parallel_copy_bench_send(Echo, Term, 10)}
+           || {Shape, Term} <- Shapes],
+    unlink(Echo),
+    exit(Echo, kill),
+    Res.
+
+parallel_copy_bench_send(Echo, Term, N) ->
+    erlang:garbage_collect(),
+    lists:min([element(1, timer:tc(fun() ->
+                                           Echo ! {self(), Term},
+                                           receive done -> ok end
+                                   end))
+               || _ <- lists:seq(1, N)]).
+
+%% Send messages and exit signals from many processes at once to one
+%% process on a node that gives processes whose message queue lock
+%% is contended message buffers. Signals from each sender must
+%% arrive in the order they were sent.
+message_queue_buffers(Config) when is_list(Config) ->
+    {ok, Node} = start_node(Config, "+zmqbl 1 +S 8"),
+    ok = rpc:call(Node, ?MODULE, message_queue_buffers_test, []),
+    stop_node(Node),
+    ok.
+
+message_queue_buffers_test() ->
+    enable_internal_state(),
+    %% Buffers installed due to contention, if any
+    _ = mqb_run(false, false),
+    %% Buffers installed up front
+    true = mqb_run(false, true),
+    %% Let messages pile up in the buffers and check that they are
+    %% all counted in the message queue length.
+    true = mqb_run(true, true),
+    ok.
+
+mqb_run(Wait, Install) ->
+    Self = self(),
+    NoSenders = 50,
+    NoSignals = 2000,
+    Rcvr = spawn(fun () ->
+                         process_flag(trap_exit, true),
+                         Install andalso
+                             erts_debug:set_internal_state(sig_inq_buffers,
+                                                           self()),
+                         Self ! {self(), started},
+                         Wait andalso
+                             receive go -> ok end,
+                         QLen = process_info(self(), message_queue_len),
+                         Seen = mqb_receive(NoSenders * NoSignals, #{}),
+                         Buffered = erts_debug:get_internal_state(
+                                      {sig_inq_buffers, self()}),
+                         Self ! {self(), QLen, Seen, Buffered}
+                 end),
+    receive {Rcvr, started} -> ok end,
+    Senders = [spawn_monitor(fun () -> mqb_send(Rcvr, 1, NoSignals) end)
+               || _ <- lists:seq(1, NoSenders)],
+    [receive {'DOWN', Mon, process, Pid, normal} -> ok end
+     || {Pid, Mon} <- Senders],
+    Wait andalso (Rcvr ! go),
+    receive
+        {Rcvr, QLen, Seen, Buffered} ->
+            if
+                Wait ->
+                    {message_queue_len, Len} = QLen,
+                    Len = NoSenders * NoSignals;
+                true ->
+                    ok
+            end,
+            Expected = maps:from_list([{Pid, NoSignals}
+                                       || {Pid, _} <- Senders]),
+            Expected = Seen,
+            Buffered
+    end.
+
+mqb_send(_Rcvr, I, N) when I > N ->
+    ok;
+mqb_send(Rcvr, I, N) ->
+    case I rem 10 of
+        0 -> exit(Rcvr, {seq, I});
+        _ -> Rcvr ! {seq, self(), I}
+    end,
+    mqb_send(Rcvr, I + 1, N).
+
+mqb_receive(0, Seen) ->
+    Seen;
+mqb_receive(Left, Seen) ->
+    {From, I} = receive
+                    {seq, F, X} -> {F, X};
+                    {'EXIT', F, {seq, X}} -> {F, X}
+                end,
+    I = maps:get(From, Seen, 0) + 1,
+    mqb_receive(Left - 1, Seen#{From => I}).
+
+%% Compare the time it takes for many processes to send to one
+%% process with and without message buffers.
+message_queue_buffers_bench(Config) when is_list(Config) ->
+    {ok, Locked} = start_node(Config, ""),
+    {ok, Buffered} = start_node(Config, "+zmqbl 10"),
+    LockedRes = rpc:call(Locked, ?MODULE, message_queue_buffers_bench_run, []),
+    BufferedRes = rpc:call(Buffered, ?MODULE,
+                           message_queue_buffers_bench_run, []),
+    stop_node(Locked),
+    stop_node(Buffered),
+    Speedups = [begin
+                    Speedup = LTime / BTime,
+                    ct_event:notify(#event{name = benchmark_data,
+                                           data = [{suite, ?MODULE},
+                                                   {name, "message_queue_buffers_"
+                                                    ++ integer_to_list(N)},
+                                                   {value, Speedup}]}),
+                    {N, Speedup}
+                end || {{N, LTime}, {N, BTime}}
+                           <- lists:zip(LockedRes, BufferedRes)],
+    {comment, io_lib:format("{Senders, Speedup}: ~p", [Speedups])}.
+
+message_queue_buffers_bench_run() ->
+    Schedulers = erlang:system_info(schedulers_online),
+    [{N, message_queue_buffers_bench_send(N, 100000 div N)}
+     || N <- lists:usort([1, Schedulers, 2 * Schedulers, 10 * Schedulers])].
+
+message_queue_buffers_bench_send(NoSenders, NoMsgs) ->
+    Self = self(),
+    Rcvr = spawn_link(fun () ->
+                              [receive _ -> ok end
+                               || _ <- lists:seq(1, NoSenders * NoMsgs)],
+                              Self ! {self(), done}
+                      end),
+    {Time, _} =
+        timer:tc(fun () ->
+                         [spawn_link(fun () ->
+                                             [Rcvr ! I
+                                              || I <- lists:seq(1, NoMsgs)]
+                                     end)
+                          || _ <- lists:seq(1, NoSenders)],
+                         receive {Rcvr, done} -> ok end
+                 end),
+    Time.
+
 %% error_logger report handler proxy
 init(Pid) ->
     {ok, Pid}.
@@ -32,6 +32,7 @@
 %-define(line_trace, 1).
 
 -include_lib("common_test/include/ct.hrl").
+-include_lib("common_test/include/ct_event.hrl").
 
 %-compile(export_all).
 -export([all/0, suite/0, groups/0,
@@ -58,7 +59,14 @@
 	 scheduler_suspend/1,
 	 dirty_scheduler_threads/1,
          poll_threads/1,
-	 reader_groups/1]).
+	 reader_groups/1,
+	 steal_strategy/1,
+	 steal_strategy_bench/1,
+	 numa_aware/1,
+	 adaptive_busy_wait/1,
+	 dirty_fair_queuing/1]).
+
+-export([steal_strategy_run/2]).
 
 suite() ->
     [{ct_hooks,[ts_install_cth]},
@@ -74,12 +82,17 @@ all() ->
      scheduler_suspend_basic, scheduler_suspend,
      dirty_scheduler_threads,
      poll_threads,
-     reader_groups].
+     reader_groups,
+     steal_strategy,
+     numa_aware,
+     adaptive_busy_wait,
+     dirty_fair_queuing].
 
 groups() -> 
     [{scheduler_bind, [],
       [scheduler_bind_types, cpu_topology, update_cpu_info,
-       sct_cmd, sbt_cmd]}].
+       sct_cmd, sbt_cmd]},
+     {steal_strategy_bench, [], [steal_strategy_bench]}].
 
 init_per_suite(Config) ->
     Config.
@@ -1794,6 +1807,221 @@ reader_groups_map(CPUT, Groups) ->
     erlang:system_flag(cpu_topology, Old),
     lists:sort(Res).
 
+%% Run spawn/exit and ping-pong load with both steal strategies on
+%% more schedulers than there are cores, so that schedulers
+%% frequently run out of work and steal from each other.
+steal_strategy(Config) when is_list(Config) ->
+    lists:foreach(
+      fun (Strategy) ->
+              {ok, Node} = start_node(Config, "+S 8 +sst " ++ Strategy),
+              [[{spawn_exit, _}, {ping_pong, _}]]
+                  = mcall(Node, [fun () -> steal_strategy_run(16, 1000) end]),
+              stop_node(Node)
+      end,
+      ["default", "random"]),
+    ok.
+
+%% Compare spawn/exit and ping-pong throughput of the random steal
+%% strategy with the default one.
+steal_strategy_bench(Config) when is_list(Config) ->
+    {ok, Default} = start_node(Config, "+sst default"),
+    {ok, Random} = start_node(Config, "+sst random"),
+    N = 8 * erlang:system_info(schedulers),
+    DefaultRes = rpc:call(Default, ?MODULE, steal_strategy_run, [N, 20000]),
+    RandomRes = rpc:call(Random, ?MODULE, steal_strategy_run, [N, 20000]),
+    stop_node(Default),
+    stop_node(Random),
+    Speedups = [begin
+                    Speedup = DTime / RTime,
+                    ct_event:notify(#event{name = benchmark_data,
+                                           data = [{suite, ?MODULE},
+                                                   {name, "steal_strategy_"
+                                                    ++ atom_to_list(Load)},
+                                                   {value, Speedup}]}),
+                    {Load, Speedup}
+                end || {{Load, DTime}, {Load, RTime}}
+                           <- lists:zip(DefaultRes, RandomRes)],
+    {comment, io_lib:format("{Load, Speedup}: ~p", [Speedups])}.
+
+%% Run with NUMA aware scheduling on bound schedulers. Whether any
+%% migrations between NUMA nodes are seen depends on the machine, so
+%% only check that everything works and that they are counted sanely.
+numa_aware(Config) when is_list(Config) ->
+    {ok, Node} = start_node(Config, "+S 8 +sbt db +snuma true"),
+    [{[{spawn_exit, _}, {ping_pong, _}], Migrations}]
+        = mcall(Node, [fun () ->
+                               Res = steal_strategy_run(16, 1000),
+                               {Res, erlang:system_info(numa_migrations)}
+                       end]),
+    stop_node(Node),
+    true = is_integer(Migrations) andalso Migrations >= 0,
+    {ok, Unbound} = start_node(Config, "+S 8 +sbt u +snuma true"),
+    [0] = mcall(Unbound, [fun () ->
+                                  _ = steal_strategy_run(16, 1000),
+                                  erlang:system_info(numa_migrations)
+                          end]),
+    stop_node(Unbound),
+    ok.
+
+adaptive_busy_wait(Config) when is_list(Config) ->
+    NoScheds = erlang:system_info(schedulers)
+        + erlang:system_info(dirty_cpu_schedulers)
+        + erlang:system_info(dirty_io_schedulers),
+    chk_sched_wait(NoScheds, erlang:statistics(scheduler_wait)),
+    false = erlang:system_flag(scheduler_wait, true),
+    true = erlang:system_flag(scheduler_wait, false),
+    %% Dirty CPU schedulers keep the fixed medium spincount that
+    %% normal schedulers start out with when adaptive
+    {ok, Node} = start_node(Config, "+S 4:4 +sbwt adaptive +sbwtdcpu medium"),
+    [{_, SchedWait}] = mcall(Node, [fun () ->
+                                            Res = steal_strategy_run(16, 1000),
+                                            {Res, erlang:statistics(scheduler_wait)}
+                                    end]),
+    NodeScheds = rpc:call(Node, erlang, system_info, [schedulers])
+        + rpc:call(Node, erlang, system_info, [dirty_cpu_schedulers])
+        + rpc:call(Node, erlang, system_info, [dirty_io_schedulers]),
+    stop_node(Node),
+    chk_sched_wait(NodeScheds, SchedWait),
+    {Normal, [{_, MediumSpinCount, _, _} | _]} = lists:split(4, SchedWait),
+    true = lists:any(fun ({_, SpinCount, _, _}) ->
+                             SpinCount =/= MediumSpinCount
+                     end,
+                     Normal),
+    %% Wakeup latency is measured when adaptive
+    true = lists:any(fun ({_, _, Latency, _}) ->
+                             lists:sum(tuple_to_list(Latency)) > 0
+                     end,
+                     Normal),
+    ok.
+
+dirty_fair_queuing(Config) when is_list(Config) ->
+    undefined = erlang:statistics(dirty_queue_classes),
+    {'EXIT', {badarg, _}} =
+        (catch erlang:system_flag(dirty_queue_weight, {erts_debug, 2})),
+    {ok, Node} = start_node(Config, "+sdfq true"),
+    [{1, 2, Classes}] =
+        mcall(Node,
+              [fun () ->
+                       Old = erlang:system_flag(dirty_queue_weight,
+                                                {erts_debug, 2}),
+                       New = erlang:system_flag(dirty_queue_weight,
+                                                {erts_debug, 2}),
+                       Ps = [spawn_monitor(
+                               fun () ->
+                                       [erts_debug:DirtyBif(wait, 10)
+                                        || _ <- lists:seq(1, 5)]
+                               end)
+                             || DirtyBif <- [dirty_cpu, dirty_io],
+                                _ <- lists:seq(1, 10)],
+                       [receive {'DOWN', M, process, P, _} -> ok end
+                        || {P, M} <- Ps],
+                       {Old, New, erlang:statistics(dirty_queue_classes)}
+               end]),
+    {badrpc, {'EXIT', {badarg, _}}} =
+        rpc:call(Node, erlang, system_flag,
+                 [dirty_queue_weight, {erts_debug, 0}]),
+    %% No more than 32 classes per dirty run queue; the table
+    %% fills up and further modules are rejected
+    SetRes = [rpc:call(Node, erlang, system_flag,
+                       [dirty_queue_weight,
+                        {list_to_atom("dfq_mod_" ++ integer_to_list(N)), 3}])
+              || N <- lists:seq(1, 40)],
+    {Set, [{badrpc, {'EXIT', {badarg, _}}} | _] = Rejected} =
+        lists:splitwith(fun (Res) -> Res =:= 1 end, SetRes),
+    true = length(Set) < 32,
+    true = lists:all(fun ({badrpc, {'EXIT', {badarg, _}}}) -> true;
+                         (_) -> false
+                     end, Rejected),
+    %% A rejected module takes a class slot in neither dirty run queue
+    RejectedMods = [list_to_atom("dfq_mod_" ++ integer_to_list(N))
+                    || N <- lists:seq(length(Set) + 1, 40)],
+    [] = [Mod || {_, Cls} <- rpc:call(Node, erlang, statistics,
+                                      [dirty_queue_classes]),
+                 {Mod, _, _, _, _} <- Cls,
+                 lists:member(Mod, RejectedMods)],
+    {undefined, 1, _, _, _} =
+        lists:keyfind(undefined, 1,
+                      proplists:get_value(
+                        dirty_cpu,
+                        rpc:call(Node, erlang, statistics,
+                                 [dirty_queue_classes]))),
+    stop_node(Node),
+    [{dirty_cpu, CpuClasses}, {dirty_io, IoClasses}] = Classes,
+    lists:foreach(fun ({Mod, Weight, Len, Executed, WaitTime}) ->
+                          true = is_atom(Mod),
+                          true = is_integer(Weight) andalso Weight >= 1,
+                          true = is_integer(Len) andalso Len >= 0,
+                          true = is_integer(Executed) andalso Executed >= 0,
+                          true = is_integer(WaitTime) andalso WaitTime >= 0
+                  end,
+                  CpuClasses ++ IoClasses),
+    {erts_debug, 2, 0, 50, _} = lists:keyfind(erts_debug, 1, CpuClasses),
+    {erts_debug, 2, 0, 50, _} = lists:keyfind(erts_debug, 1, IoClasses),
+    ok.
+
+chk_sched_wait(NoScheds, SchedWait) ->
+    NoScheds = length(SchedWait),
+    lists:foldl(fun ({Id, SpinCount, Latency, Waste}, Id) ->
+                        true = is_integer(SpinCount) andalso SpinCount >= 0,
+                        16 = tuple_size(Latency),
+                        16 = tuple_size(Waste),
+                        lists:foreach(fun (C) ->
+                                              true = is_integer(C) andalso C >= 0
+                                      end,
+                                      tuple_to_list(Latency)
+                                      ++ tuple_to_list(Waste)),
+                        Id + 1
+                end, 1, SchedWait).
+
+steal_strategy_run(NoWorkers, NoOps) ->
+    [{spawn_exit, steal_spawn_exit(NoWorkers, NoOps)},
+     {ping_pong, steal_ping_pong(NoWorkers, NoOps)}].
+
+steal_spawn_exit(NoWorkers, NoProcs) ->
+    steal_run_workers(
+      NoWorkers,
+      fun () ->
+              Self = self(),
+              lists:foreach(fun (_) ->
+                                    Pid = spawn(fun () -> Self ! self() end),
+                                    receive Pid -> ok end
+                            end,
+                            lists:seq(1, NoProcs))
+      end).
+
+steal_ping_pong(NoPairs, NoRounds) ->
+    steal_run_workers(
+      NoPairs,
+      fun () ->
+              Pong = spawn_link(fun Loop () ->
+                                        receive
+                                            {From, I} -> From ! I, Loop();
+                                            stop -> ok
+                                        end
+                                end),
+              lists:foreach(fun (I) ->
+                                    Pong ! {self(), I},
+                                    receive I -> ok end
+                            end,
+                            lists:seq(1, NoRounds)),
+              Pong ! stop
+      end).
+
+steal_run_workers(NoWorkers, Fun) ->
+    Self = self(),
+    {Time, ok} =
+        timer:tc(fun () ->
+                         Ws = [spawn_link(fun () ->
+                                                  Fun(),
+                                                  Self ! {self(), done}
+                                          end)
+                               || _ <- lists:seq(1, NoWorkers)],
+                         lists:foreach(fun (W) ->
+                                               receive {W, done} -> ok end
+                                       end, Ws)
+                 end),
+    Time.
+
 %%
 %% Utils
 %%
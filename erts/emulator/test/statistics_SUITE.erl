@@ -33,7 +33,8 @@
          scheduler_wall_time_all/1,
          msb_scheduler_wall_time/1,
 	 reductions/1, reductions_big/1, garbage_collection/1, io/1,
-	 badarg/1, run_queues_lengths_active_tasks/1, msacc/1]).
+	 badarg/1, run_queues_lengths_active_tasks/1, msacc/1,
+         run_queue_delay/1]).
 
 %% Internal exports.
 
@@ -52,7 +53,7 @@ all() ->
      msb_scheduler_wall_time,
      garbage_collection, io, badarg,
      run_queues_lengths_active_tasks,
-     msacc].
+     msacc, run_queue_delay].
 
 groups() -> 
     [{wall_clock, [],
@@ -728,3 +729,56 @@ msacc_sum_states() ->
                                           maps:update(Key, NewValue, Acc)
                                   end, Cnt, Counters)
                 end,InitialCounters,Stats).
+
+run_queue_delay(Config) when is_list(Config) ->
+    undefined = statistics(run_queue_delay),
+    false = erlang:system_flag(run_queue_delay, true),
+    try
+        Before = run_queue_delay_sum(statistics(run_queue_delay)),
+        Prios = [max, high, normal, low],
+        Yielders = [spawn_link(fun () ->
+                                       process_flag(priority, Prio),
+                                       rqd_yield(10000)
+                               end) || Prio <- Prios, _ <- lists:seq(1, 4)],
+        lists:foreach(fun (Pid) ->
+                              Mon = erlang:monitor(process, Pid),
+                              receive {'DOWN', Mon, process, Pid, _} -> ok end
+                      end, Yielders),
+        Stats = statistics(run_queue_delay),
+        NoScheds = erlang:system_info(schedulers)
+            + erlang:system_info(dirty_cpu_schedulers)
+            + erlang:system_info(dirty_io_schedulers),
+        NoScheds = length(Stats),
+        lists:foldl(fun ({Id, PrioHists}, Id) ->
+                            Prios = [Prio || {Prio, _} <- PrioHists],
+                            lists:foreach(fun ({_, Hist}) ->
+                                                  16 = tuple_size(Hist)
+                                          end, PrioHists),
+                            Id + 1
+                    end, 1, Stats),
+        After = run_queue_delay_sum(Stats),
+        lists:foreach(fun (Prio) ->
+                              true = (maps:get(Prio, After)
+                                      >= maps:get(Prio, Before) + 4*10000)
+                      end, Prios)
+    after
+        true = erlang:system_flag(run_queue_delay, false)
+    end,
+    undefined = statistics(run_queue_delay),
+    ok.
+
+run_queue_delay_sum(Stats) ->
+    lists:foldl(fun ({_Id, PrioHists}, Acc0) ->
+                        lists:foldl(fun ({Prio, Hist}, Acc) ->
+                                            Sum = lists:sum(tuple_to_list(Hist)),
+                                            maps:update_with(Prio,
+                                                             fun (S) -> S + Sum end,
+                                                             Sum, Acc)
+                                    end, Acc0, PrioHists)
+                end, #{}, Stats).
+
+rqd_yield(0) ->
+    ok;
+rqd_yield(N) ->
+    erlang:yield(),
+    rqd_yield(N-1).
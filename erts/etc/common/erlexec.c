@@ -135,8 +135,11 @@ static char *pluss_val_switches[] = {
     "bwt",
     "cl",
     "ct",
+    "dfq",
     "ecio",
     "fwi",
+    "numa",
+    "st",
     "tbt",
     "wct",
     "wtdcpu",
@@ -159,6 +162,7 @@ static char *plush_val_switches[] = {
     "maxk",
     "maxel",
     "mqd",
+    "sp",
     "",
     NULL
 };
@@ -174,6 +178,10 @@ static char *plusz_val_switches[] = {
     "dbbl",
     "dntgc",
     "ebwt",
+    "pts",
+    "pcs",
+    "ms",
+    "mqbl",
     NULL
 };
 
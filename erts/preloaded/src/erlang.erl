@@ -28,6 +28,7 @@
 -export([crasher/6]).
 -export([fun_info/1]).
 -export([send_nosuspend/2, send_nosuspend/3]).
+-export([send_many/2]).
 -export([localtime_to_universaltime/1]).
 -export([suspend_process/1]).
 -export([min/2, max/2]).
@@ -2247,6 +2248,15 @@ open_port(PortName, PortSettings) ->
       OldN :: 0..10000;
                   (sensitive, Boolean) -> OldBoolean when
       Boolean :: boolean(),
+      OldBoolean :: boolean();
+                  (tenure_age, Age) -> OldAge when
+      Age :: 1..8,
+      OldAge :: 1..8;
+                  (major_gc_slice, Words) -> OldWords when
+      Words :: non_neg_integer(),
+      OldWords :: non_neg_integer();
+                  (receive_index, Boolean) -> OldBoolean when
+      Boolean :: boolean(),
       OldBoolean :: boolean();
                   %% Deliberately not documented.
                   ({monitor_nodes, term()}, term()) -> term();
@@ -2306,7 +2316,8 @@ process_flag(_Flag, _Value) ->
       {dictionary, Dictionary :: [{Key :: term(), Value :: term()}]} |
       {error_handler, Module :: module()} |
       {garbage_collection, GCInfo :: [{atom(),non_neg_integer()}]} |
-      {garbage_collection_info, GCInfo :: [{atom(),non_neg_integer()}]} |
+      {garbage_collection_info,
+       GCInfo :: [{atom(),non_neg_integer() | [non_neg_integer()]}]} |
       {group_leader, GroupLeader :: pid()} |
       {heap_size, Size :: non_neg_integer()} |
       {initial_call, mfa()} |
@@ -2413,6 +2424,15 @@ spawn_opt(_Tuple) ->
       ActiveTasks :: non_neg_integer();
 		(context_switches) -> {ContextSwitches,0} when
       ContextSwitches :: non_neg_integer();
+                (dirty_queue_classes) -> [{DirtyQueue, [DirtyQueueClass]}]
+                                         | undefined when
+      DirtyQueue :: dirty_cpu | dirty_io,
+      DirtyQueueClass :: {Module, Weight, QueueLength, Executed, WaitTime},
+      Module :: module(),
+      Weight :: pos_integer(),
+      QueueLength :: non_neg_integer(),
+      Executed :: non_neg_integer(),
+      WaitTime :: non_neg_integer();
                 (exact_reductions) -> {Total_Exact_Reductions,
                                        Exact_Reductions_Since_Last_Call} when
       Total_Exact_Reductions :: non_neg_integer(),
@@ -2439,6 +2459,11 @@ spawn_opt(_Tuple) ->
       Total_Reductions :: non_neg_integer(),
       Reductions_Since_Last_Call :: non_neg_integer();
                 (run_queue) -> non_neg_integer();
+                (run_queue_delay) -> [{SchedulerId, [{Priority, Delays}]}]
+                                     | undefined when
+      SchedulerId :: pos_integer(),
+      Priority :: priority_level(),
+      Delays :: tuple();
                 (run_queue_lengths) -> [RunQueueLength] when
       RunQueueLength :: non_neg_integer();
                 (run_queue_lengths_all) -> [RunQueueLength] when
@@ -2446,6 +2471,12 @@ spawn_opt(_Tuple) ->
                 (runtime) -> {Total_Run_Time, Time_Since_Last_Call} when
       Total_Run_Time :: non_neg_integer(),
       Time_Since_Last_Call :: non_neg_integer();
+                (scheduler_wait) -> [{SchedulerId, SpinCount,
+                                      WakeupLatency, SpinWaste}] when
+      SchedulerId :: pos_integer(),
+      SpinCount :: non_neg_integer(),
+      WakeupLatency :: tuple(),
+      SpinWaste :: tuple();
                 (scheduler_wall_time) -> [{SchedulerId, ActiveTime, TotalTime}] | undefined when
       SchedulerId :: pos_integer(),
       ActiveTime  :: non_neg_integer(),
@@ -2495,6 +2526,10 @@ subtract(_,_) ->
                                 OldDirtyCPUSchedulersOnline when
       DirtyCPUSchedulersOnline :: pos_integer(),
       OldDirtyCPUSchedulersOnline :: pos_integer();
+                        (dirty_queue_weight, {Module, Weight}) -> OldWeight when
+      Module :: module(),
+      Weight :: 1..10000,
+      OldWeight :: 1..10000;
                         (erts_alloc, {Alloc, F, V}) -> ok | notsup when
       Alloc :: atom(),
       F :: atom(),
@@ -2518,9 +2553,15 @@ subtract(_,_) ->
                         (multi_scheduling, BlockState) -> OldBlockState when
       BlockState :: block | unblock | block_normal | unblock_normal,
       OldBlockState :: blocked | disabled | enabled;
+                        (run_queue_delay, Boolean) -> OldBoolean when
+      Boolean :: boolean(),
+      OldBoolean :: boolean();
                         (scheduler_bind_type, How) -> OldBindType when
       How :: scheduler_bind_type() | default_bind,
       OldBindType :: scheduler_bind_type();
+                        (scheduler_wait, Boolean) -> OldBoolean when
+      Boolean :: boolean(),
+      OldBoolean :: boolean();
                         (scheduler_wall_time, Boolean) ->  OldBoolean when
       Boolean :: boolean(),
       OldBoolean :: boolean();
@@ -2749,7 +2790,17 @@ tuple_to_list(_Tuple) ->
          (update_cpu_info) -> changed | unchanged;
          (version) -> string();
          (wordsize | {wordsize, internal} | {wordsize, external}) -> 4 | 8;
-         (overview) -> boolean().
+         (overview) -> boolean();
+         (re_cache) -> #{entries := non_neg_integer(),
+                         evictions := non_neg_integer(),
+                         hits := non_neg_integer(),
+                         max_entries := pos_integer(),
+                         misses := non_neg_integer()};
+         (heap_sizing) -> last | ewma;
+         (message_sharing) -> #{bytes_saved := non_neg_integer(),
+                                mode := flat | adaptive,
+                                shared_sends := non_neg_integer()};
+         (numa_migrations) -> non_neg_integer().
 system_info(_Item) ->
     erlang:nif_error(undefined).
 
@@ -3103,6 +3154,22 @@ send_nosuspend(Pid, Msg, Opts) ->
 	_  -> false
     end.
 
+-spec erlang:send_many(Dests, Msg) -> ok when
+      Dests :: [dst()],
+      Msg :: term().
+send_many(Dests, Msg) ->
+    try
+        send_many_1(erts_internal:send_many(Dests, Msg), Msg)
+    catch
+        error:Error -> erlang:error(Error, [Dests, Msg])
+    end.
+
+send_many_1([Dest | Dests], Msg) ->
+    erlang:send(Dest, Msg),
+    send_many_1(Dests, Msg);
+send_many_1([], _Msg) ->
+    ok.
+
 -spec erlang:localtime_to_universaltime(Localtime) -> Universaltime when
       Localtime :: calendar:datetime(),
       Universaltime :: calendar:datetime().
@@ -99,6 +99,8 @@
 
 -export([spawn_system_process/3]).
 
+-export([send_many/2]).
+
 %%
 %% Await result of send to port
 %%
@@ -735,3 +737,11 @@ counters_info(_Ref) ->
     Args :: list().
 spawn_system_process(_Mod, _Func, _Args) ->
     erlang:nif_error(undefined).
+
+-spec send_many(Dests, Msg) -> Rest when
+      Dests :: [Dest],
+      Msg :: term(),
+      Rest :: [Dest],
+      Dest :: pid() | port() | atom() | {atom(), node()}.
+send_many(_Dests, _Msg) ->
+    erlang:nif_error(undefined).
@@ -19,7 +19,7 @@
 %%
 -module(persistent_term).
 
--export([erase/1,get/0,get/1,get/2,info/0,put/2]).
+-export([erase/1,get/0,get/1,get/2,info/0,put/2,put_many/1]).
 
 -type key() :: term().
 -type value() :: term().
@@ -60,3 +60,8 @@ info() ->
       Value :: value().
 put(_Key, _Value) ->
     erlang:nif_error(undef).
+
+-spec put_many(KeyValues) -> 'ok' when
+      KeyValues :: [{key(),value()}].
+put_many(_KeyValues) ->
+    erlang:nif_error(undef).
@@ -65,10 +65,12 @@
 
 -export([all/0, delete/1, delete/2, delete_all_objects/1,
          delete_object/2, first/1, give_away/3, info/1, info/2,
+         info_many/2,
          insert/2, insert_new/2, is_compiled_ms/1, last/1, lookup/2,
-         lookup_element/3, match/1, match/2, match/3, match_object/1,
-         match_object/2, match_object/3, match_spec_compile/1,
-         match_spec_run_r/3, member/2, new/2, next/2, prev/2,
+         lookup_element/3, lookup_many/2, match/1, match/2, match/3,
+         match_object/1, match_object/2, match_object/3,
+         match_spec_compile/1, match_spec_run_r/3, member/2,
+         member_many/2, new/2, next/2, prev/2,
          rename/2, safe_fixtable/2, select/1, select/2, select/3,
          select_count/2, select_delete/2, select_replace/2, select_reverse/1,
          select_reverse/2, select_reverse/3, setopts/2, slot/2,
@@ -177,12 +179,28 @@ info(_) ->
       Item :: compressed | fixed | heir | id | keypos | memory
             | name | named_table | node | owner | protection
             | safe_fixed | safe_fixed_monotonic_time | size | stats | type
-	    | write_concurrency | read_concurrency,
+	    | write_concurrency | read_concurrency
+            | load_factor | incremental_resize | resize
+            | chain_length_histogram | contention_limits | adaptation
+            | read_mode,
       Value :: term().
 
 info(_, _) ->
     erlang:nif_error(undef).
 
+-spec info_many(Tabs, Item) -> [Value | undefined] when
+      Tabs :: [tab()],
+      Item :: compressed | fixed | heir | id | keypos | memory
+            | name | named_table | node | owner | protection
+            | safe_fixed | safe_fixed_monotonic_time | size | type
+	    | write_concurrency | read_concurrency
+            | load_factor | incremental_resize | resize
+            | contention_limits | adaptation | read_mode,
+      Value :: term().
+
+info_many(_, _) ->
+    erlang:nif_error(undef).
+
 -spec insert(Tab, ObjectOrObjects) -> true when
       Tab :: tab(),
       ObjectOrObjects :: tuple() | [tuple()].
@@ -227,6 +245,14 @@ lookup(_, _) ->
 lookup_element(_, _, _) ->
     erlang:nif_error(undef).
 
+-spec lookup_many(Tab, Keys) -> [[Object]] when
+      Tab :: tab(),
+      Keys :: [term()],
+      Object :: tuple().
+
+lookup_many(_, _) ->
+    erlang:nif_error(undef).
+
 -spec match(Tab, Pattern) -> [Match] when
       Tab :: tab(),
       Pattern :: match_pattern(),
@@ -302,6 +328,13 @@ match_spec_run_r(_, _, _) ->
 member(_, _) ->
     erlang:nif_error(undef).
 
+-spec member_many(Tab, Keys) -> [boolean()] when
+      Tab :: tab(),
+      Keys :: [term()].
+
+member_many(_, _) ->
+    erlang:nif_error(undef).
+
 -spec new(Name, Options) -> tid() | atom() when
       Name :: atom(),
       Options :: [Option],
@@ -311,6 +344,10 @@ member(_, _) ->
       Access :: access(),
       Tweaks :: {write_concurrency, boolean()}
               | {read_concurrency, boolean()}
+              | {load_factor, number()}
+              | {incremental_resize, boolean()}
+              | {contention_limits, {neg_integer(), pos_integer()}}
+              | {read_mode, copy | shared_literal}
               | compressed,
       Pos :: pos_integer(),
       HeirData :: term().
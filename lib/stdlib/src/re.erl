@@ -29,7 +29,7 @@
                         | no_auto_capture | dupnames | ungreedy
                         | {newline, nl_spec()}
                         | bsr_anycrlf | bsr_unicode
-                        | no_start_optimize | ucp | never_utf.
+                        | no_start_optimize | ucp | never_utf | jit.
 
 %%% BIFs
 
@@ -867,6 +867,8 @@ copt(ungreedy) ->
     true;
 copt(unicode) ->
     true;
+copt(jit) ->
+    true;
 copt(_) ->
     false.
 
@@ -39,10 +39,12 @@
 -export([lookup_element_mult/1]).
 -export([foldl_ordered/1, foldr_ordered/1, foldl/1, foldr/1, fold_empty/1]).
 -export([t_delete_object/1, t_init_table/1, t_whitebox/1,
-         select_bound_chunk/1,
-	 t_delete_all_objects/1, t_insert_list/1, t_test_ms/1,
+         select_bound_chunk/1, select_key_range/1,
+	 t_delete_all_objects/1, t_insert_list/1, t_lookup_many/1, t_test_ms/1,
+         t_select_tuple_patterns/1,
 	 t_select_delete/1,t_select_replace/1,t_select_replace_next_bug/1,t_ets_dets/1]).
 -export([test_table_size_concurrency/1,test_table_memory_concurrency/1,
+         t_info_many/1, t_info_many_during_snapshots/1,
          test_delete_table_while_size_snapshot/1, test_delete_table_while_size_snapshot_helper/0]).
 
 -export([ordered/1, ordered_match/1, interface_equality/1,
@@ -65,18 +67,24 @@
 -export([select_mbuf_trapping/1]).
 -export([otp_7665/1]).
 -export([meta_wb/1]).
--export([grow_shrink/1, grow_pseudo_deleted/1, shrink_pseudo_deleted/1]).
+-export([grow_shrink/1, grow_pseudo_deleted/1, shrink_pseudo_deleted/1,
+         incremental_resize/1, hash_stats/1, catree_adaptation/1,
+         read_mode_shared_literal/1]).
 -export([meta_lookup_unnamed_read/1, meta_lookup_unnamed_write/1,
 	 meta_lookup_named_read/1, meta_lookup_named_write/1,
 	 meta_newdel_unnamed/1, meta_newdel_named/1]).
 -export([smp_insert/1, smp_fixed_delete/1, smp_unfix_fix/1, smp_select_delete/1,
          smp_ordered_iteration/1,
-         smp_select_replace/1, otp_8166/1, otp_8732/1, delete_unfix_race/1]).
+         smp_select_replace/1, smp_lockfree_lookup/1,
+         otp_8166/1, otp_8732/1, delete_unfix_race/1]).
 -export([throughput_benchmark/0,
          throughput_benchmark/1,
          test_throughput_benchmark/1,
          long_throughput_benchmark/1,
-         lookup_catree_par_vs_seq_init_benchmark/0]).
+         lookup_catree_par_vs_seq_init_benchmark/0,
+         lookup_hash_concurrency_benchmark/0,
+         select_match_backend_benchmark/0,
+         catree_adaptation_benchmark/0]).
 -export([exit_large_table_owner/1,
 	 exit_many_large_table_owner/1,
 	 exit_many_tables_owner/1,
@@ -133,9 +141,11 @@ all() ->
      update_counter_with_default, partly_bound,
      update_counter_table_growth,
      match_heavy, {group, fold}, member, t_delete_object,
-     select_bound_chunk,
+     select_bound_chunk, select_key_range,
      t_init_table, t_whitebox, t_delete_all_objects,
-     t_insert_list, t_test_ms, t_select_delete, t_select_replace,
+     t_insert_list, t_lookup_many, t_test_ms, t_select_tuple_patterns,
+     t_select_delete,
+     t_select_replace,
      t_select_replace_next_bug,
      t_ets_dets, memory, t_select_reverse, t_bucket_disappears,
      t_named_select, select_fixtab_owner_change,
@@ -143,9 +153,11 @@ all() ->
      otp_5340, otp_6338, otp_6842_select_1000, otp_7665,
      select_mbuf_trapping,
      otp_8732, meta_wb, grow_shrink, grow_pseudo_deleted,
-     shrink_pseudo_deleted, {group, meta_smp}, smp_insert,
+     shrink_pseudo_deleted, incremental_resize, hash_stats,
+     catree_adaptation, read_mode_shared_literal,
+     {group, meta_smp}, smp_insert,
      smp_fixed_delete, smp_unfix_fix, smp_select_replace,
-     smp_ordered_iteration,
+     smp_lockfree_lookup, smp_ordered_iteration,
      smp_select_delete, otp_8166, exit_large_table_owner,
      exit_many_large_table_owner, exit_many_tables_owner,
      exit_many_many_tables_owner, write_concurrency, heir,
@@ -162,6 +174,8 @@ all() ->
      {group, benchmark},
      test_table_size_concurrency,
      test_table_memory_concurrency,
+     t_info_many,
+     t_info_many_during_snapshots,
      test_delete_table_while_size_snapshot].
 
 
@@ -833,8 +847,9 @@ adjust_xmem([_T1,_T2,_T3,_T4], {A0,B0,C0,D0} = _Mem0, EstCnt) ->
     %% Adjust for 64-bit, smp, and os:
     %%   Table struct size may differ.
 
-    {TabSz, EstSz} = erts_debug:get_internal_state('DbTable_words'),
-    HTabSz = TabSz + EstCnt*EstSz,
+    %%   Each segment table extension adds a segment with a header.
+    {TabSz, EstSz, SegHdrSz} = erts_debug:get_internal_state('DbTable_words'),
+    HTabSz = TabSz + EstCnt*EstSz + (EstCnt+1)*SegHdrSz,
     OrdSetExtra = case erlang:system_info(wordsize) of
                       8 -> 40; % larger stack on 64 bit architectures
                       _ -> 0
@@ -882,6 +897,64 @@ select_bound_chunk_do(Opts) ->
     {[{key, 1}], '$end_of_table'} = ets:select(T, [{{key,1},[],['$_']}], 100000),
     ok.
 
+%% Test select with comparison guards on variables in the key, which
+%% limit the traversed key range of ordered tables.
+select_key_range(_Config) ->
+    EtsMem = etsmem(),
+    repeat_for_opts(fun select_key_range_do/1, [set_types]),
+    verify_etsmem(EtsMem).
+
+select_key_range_do(Opts) ->
+    T = ets_new(x, Opts),
+    ets:insert(T, [{{Tenant, Ts, Id}, Ts * Id}
+                   || Tenant <- [a, b], Ts <- lists:seq(1, 300), Id <- [1, 2]]),
+    ets:insert(T, [{K, K} || K <- lists:seq(1, 500)]),
+    ets:insert(T, [{K / 2, K} || K <- lists:seq(1, 9, 2)]),
+    MSs = [[{{{b,'$1','_'},'_'}, [{'>=','$1',50}, {'<','$1',60}], ['$_']}],
+           [{{'$1','_'}, [{'>','$1',100}, {'=<','$1',110}], ['$_']}],
+           [{{'$1','_'}, [{'andalso',{'>=','$1',1.5},{'<','$1',3}}], ['$_']}],
+           [{{{'$1','$2','_'},'_'}, [{'=:=','$1',a}, {'<',250,'$2'}], ['$_']}],
+           [{{'$1','_'}, [{'==','$1',42}], ['$_']}],
+           [{{{a,'$1','$2'},'_'},
+             [{'>=','$1',10}, {'<','$1',20}, {'==','$2',2}], ['$_']}],
+           [{{{a,'$1','_'},'_'}, [{'>','$1',{const,290}}], ['$_']},
+            {{'$1','_'}, [{'<','$1',5}], ['$_']}],
+           [{{'$1','_'}, [{'>','$1',10}, {'<','$1',5}], ['$_']}],
+           [{{'$1','_'}, [{'orelse',{'<','$1',3},{'>','$1',498}}], ['$_']}],
+           [{{'$1','$2'}, [{'>','$2',598}], ['$_']}],
+           [{{'$1','_'}, [{'<','$1',a}, {'>','$1',495}], ['$_']}]],
+    Ordered = ets:info(T, type) =:= ordered_set,
+    [begin
+         Expected = ets:match_spec_run(ets:tab2list(T),
+                                       ets:match_spec_compile(MS)),
+         Res = ets:select(T, MS),
+         Chunked = select_key_range_chunks(ets:select(T, MS, 7), []),
+         case Ordered of
+             true ->
+                 Expected = Res,
+                 Expected = lists:reverse(ets:select_reverse(T, MS)),
+                 Expected = Chunked;
+             false ->
+                 SortedExpected = lists:sort(Expected),
+                 SortedExpected = lists:sort(Res),
+                 SortedExpected = lists:sort(Chunked)
+         end,
+         Count = length(Expected),
+         Count = ets:select_count(T, [{H,G,[true]} || {H,G,_} <- MS])
+     end || MS <- MSs],
+    DelMS = [{{{b,'$1','_'},'_'}, [{'>=','$1',50}, {'<','$1',60}], [true]}],
+    20 = ets:select_count(T, DelMS),
+    20 = ets:select_delete(T, DelMS),
+    0 = ets:select_count(T, DelMS),
+    4 = ets:select_count(T, [{{{b,'$1','_'},'_'}, [{'>=','$1',49}, {'<','$1',61}],
+                              [true]}]),
+    ets:delete(T).
+
+select_key_range_chunks('$end_of_table', Acc) ->
+    Acc;
+select_key_range_chunks({Objs, Cont}, Acc) ->
+    select_key_range_chunks(ets:select(Cont), Acc ++ Objs).
+
 
 %% Test ets:to/from_dets.
 t_ets_dets(Config) when is_list(Config) ->
@@ -928,7 +1001,7 @@ t_delete_all_objects(Config) when is_list(Config) ->
 
 get_kept_objects(T) ->
     case ets:info(T,stats) of
-	{_,_,_,_,_,_,KO}  ->
+	{_,_,_,_,_,_,KO,_,_}  ->
 	    KO;
         _ ->
             0
@@ -1173,6 +1246,124 @@ t_insert_list_do(Opts) ->
     ets:delete(T).
 
 
+%% Test ets:lookup_many/2 and ets:member_many/2.
+t_lookup_many(Config) when is_list(Config) ->
+    EtsMem = etsmem(),
+    repeat_for_opts(fun t_lookup_many_do/1,
+                    [all_types, write_concurrency, read_concurrency,
+                     compressed]),
+    verify_etsmem(EtsMem).
+
+t_lookup_many_do(Opts) ->
+    T = ets_new(x, Opts),
+    N = 20000,
+    Type = ets:info(T, type),
+    [ets:insert(T, {K, integer_to_list(K), lists:duplicate(K rem 5, K)})
+     || K <- lists:seq(1, N)],
+    case Type of
+        bag -> [ets:insert(T, {K, other}) || K <- lists:seq(1, N, 3)];
+        duplicate_bag -> [ets:insert(T, {K, other}) || K <- lists:seq(1, N, 3)];
+        _ -> ok
+    end,
+    [] = ets:lookup_many(T, []),
+    [] = ets:member_many(T, []),
+    %% Enough keys to make the BIFs trap, including missing ones
+    Keys = [rand:uniform(N + N div 4) || _ <- lists:seq(1, 3*N)]
+        ++ [-1, a, {N}],
+    Lookups = [ets:lookup(T, K) || K <- Keys],
+    Lookups = ets:lookup_many(T, Keys),
+    Members = [ets:member(T, K) || K <- Keys],
+    Members = ets:member_many(T, Keys),
+    Objs = ets:lookup(T, 17),
+    [Objs] = ets:lookup_many(T, [17]),
+    case Type of
+        ordered_set ->
+            %% Keys compare equal, as for lookup/2
+            [[{1, "1", _}], [{2, "2", _}]] = ets:lookup_many(T, [1.0, 2.0]);
+        _ ->
+            [false, false] = ets:member_many(T, [1.0, 2.0])
+    end,
+    {'EXIT',{badarg,_}} = (catch ets:lookup_many(T, [1,2|3])),
+    {'EXIT',{badarg,_}} = (catch ets:member_many(T, not_a_list)),
+    {'EXIT',{badarg,_}} = (catch ets:lookup_many(T, lists:seq(1, N) ++ x)),
+    {'EXIT',{badarg,_}} = (catch ets:lookup_many(no_table, [1])),
+    ets:delete(T),
+    {'EXIT',{badarg,_}} = (catch ets:member_many(T, [1])).
+
+%% Test tuple patterns compiled to the skip and compare-element
+%% superinstructions, with both the threaded and switch match backends.
+t_select_tuple_patterns(Config) when is_list(Config) ->
+    EtsMem = etsmem(),
+    erts_debug:set_internal_state(available_internal_state, true),
+    try
+        [begin
+             _ = erts_debug:set_internal_state(ets_match_threaded, Threaded),
+             repeat_for_opts(fun t_select_tuple_patterns_do/1,
+                             [set_types, compressed])
+         end || Threaded <- [false, true]]
+    after
+        _ = erts_debug:set_internal_state(ets_match_threaded, true),
+        erts_debug:set_internal_state(available_internal_state, false)
+    end,
+    verify_etsmem(EtsMem).
+
+t_select_tuple_patterns_do(Opts) ->
+    T = ets_new(x, Opts),
+    Objs = [case K rem 4 of
+                0 -> {K};
+                1 -> {K, K rem 3};
+                2 -> {K, K rem 3, a, [K]};
+                3 -> {K, b, {K rem 3, c}, 1.5, K rem 7}
+            end || K <- lists:seq(1, 400)],
+    ets:insert(T, Objs),
+    Patterns = [{'_'},
+                {'_', 2},
+                {'_', '_'},
+                {'_', '_', a, '_'},
+                {'_', 1, '_', '_'},
+                {'_', '_', '_', '$1'},
+                {'$1', '_', '_', '_', 4},
+                {'_', b, '_', 1.5, '_'},
+                {'_', '_', {2, '_'}, '_', '_'},
+                {'_', '_', {'_', c}, '_', '$1'},
+                {'_', '$1', '_', '$1'},
+                {'_', '$1', {'$1', '_'}, '_', '_'},
+                {'_', '_', '_', '_', '_', '_'}],
+    [begin
+         Expected = lists:sort([O || O <- Objs, tuple_pattern_match(P, O)]),
+         Expected = lists:sort(ets:select(T, [{P, [], ['$_']}])),
+         Expected = lists:sort(ets:match_object(T, P))
+     end || P <- Patterns],
+    ets:delete(T).
+
+tuple_pattern_match(P, O) ->
+    tuple_pattern_match(P, O, #{}) =/= false.
+
+tuple_pattern_match('_', _, B) ->
+    B;
+tuple_pattern_match(V, O, B) when is_atom(V) ->
+    case atom_to_list(V) of
+        [$$ | _] ->
+            case B of
+                #{V := O} -> B;
+                #{V := _} -> false;
+                _ -> B#{V => O}
+            end;
+        _ when V =:= O -> B;
+        _ -> false
+    end;
+tuple_pattern_match(P, O, B) when is_tuple(P), is_tuple(O),
+                                  tuple_size(P) =:= tuple_size(O) ->
+    lists:foldl(fun(_, false) -> false;
+                   ({PE, OE}, Acc) -> tuple_pattern_match(PE, OE, Acc)
+                end,
+                B,
+                lists:zip(tuple_to_list(P), tuple_to_list(O)));
+tuple_pattern_match(P, O, B) when P =:= O ->
+    B;
+tuple_pattern_match(_, _, _) ->
+    false.
+
 %% Test interface of ets:test_ms/2.
 t_test_ms(Config) when is_list(Config) ->
     EtsMem = etsmem(),
@@ -4500,6 +4691,93 @@ test_table_size_concurrency(Config) when is_list(Config) ->
 test_table_memory_concurrency(Config) when is_list(Config) ->
     test_table_counter_concurrency(memory).
 
+%% Test ets:info_many/2, including approximate size reads of a table
+%% with decentralized counters while ets:info(T, size) snapshots are
+%% taken concurrently.
+t_info_many(Config) when is_list(Config) ->
+    EtsMem = etsmem(),
+    T1 = ets_new(x, [set]),
+    T2 = ets_new(x, [public, ordered_set, {write_concurrency, true}]),
+    T3 = ets_new(t_info_many_named, [named_table, bag]),
+    T4 = ets_new(x, []),
+    ets:delete(T4),
+    [ets:insert(T, {K}) || T <- [T1, T2, T3], K <- lists:seq(1, 100)],
+    Tabs = [T1, T2, T3, T4, no_such_table_xxyy],
+    [100, 100, 100, undefined, undefined] = ets:info_many(Tabs, size),
+    Memory = [ets:info(T, memory) || T <- Tabs],
+    Memory = ets:info_many(Tabs, memory),
+    [set, ordered_set, bag, undefined, undefined] = ets:info_many(Tabs, type),
+    T3Id = ets:info(T3, id),
+    [T1, T2, T3Id, undefined, undefined] = ets:info_many(Tabs, id),
+    [] = ets:info_many([], size),
+    %% Enough tables to make the BIF trap
+    Many = lists:duplicate(20000, T2) ++ [T1],
+    Sizes = lists:duplicate(20001, 100),
+    Sizes = ets:info_many(Many, size),
+    {'EXIT',{badarg,_}} = (catch ets:info_many(T1, size)),
+    {'EXIT',{badarg,_}} = (catch ets:info_many([T1|T2], size)),
+    {'EXIT',{badarg,_}} = (catch ets:info_many(Many ++ x, size)),
+    {'EXIT',{badarg,_}} = (catch ets:info_many([T1, 17], size)),
+    {'EXIT',{badarg,_}} = (catch ets:info_many([T1], no_such_item)),
+    {'EXIT',{badarg,_}} = (catch ets:info_many([T1], "size")),
+    {'EXIT',{badarg,_}} = (catch ets:info_many([T1], stats)),
+    {'EXIT',{badarg,_}} = (catch ets:info_many([T1], chain_length_histogram)),
+
+    %% Approximate reads must never count an item twice or lose it
+    %% while snapshots move the counters between arrays
+    ItemsToAdd = 200000,
+    ets:delete_all_objects(T2),
+    P = self(),
+    Snapshotters = [spawn_link(fun() -> info_many_snapshot_loop(T2) end)
+                    || _ <- lists:seq(1, 4)],
+    Readers = [spawn_link(fun() ->
+                                  info_many_size_loop(T2, ItemsToAdd, 0),
+                                  P ! done
+                          end)
+               || _ <- lists:seq(1, 4)],
+    add_loop(T2, ItemsToAdd),
+    ets:insert(T2, {done}),
+    [receive done -> ok end || _ <- Readers],
+    [begin unlink(Pid), exit(Pid, kill) end || Pid <- Snapshotters],
+    FinalSize = ItemsToAdd + 1,
+    [FinalSize] = ets:info_many([T2], size),
+    FinalSize = ets:info(T2, size),
+    [ets:delete(T) || T <- [T1, T2, T3]],
+    verify_etsmem(EtsMem).
+
+%% Approximate reads by ets:info_many/2 of a table with decentralized
+%% counters while ets:info(T, size) snapshots keep replacing and
+%% freeing its counter arrays.
+t_info_many_during_snapshots(Config) when is_list(Config) ->
+    EtsMem = etsmem(),
+    T = ets_new(x, [public, ordered_set, {write_concurrency, true}]),
+    ets:insert(T, [{K} || K <- lists:seq(1, 1000)]),
+    Snapshotters = [spawn_link(fun() -> info_many_snapshot_loop(T) end)
+                    || _ <- lists:seq(1, 4)],
+    Tabs = lists:duplicate(100, T),
+    Sizes = lists:duplicate(100, 1000),
+    [Sizes = ets:info_many(Tabs, size) || _ <- lists:seq(1, 20000)],
+    [begin unlink(Pid), exit(Pid, kill) end || Pid <- Snapshotters],
+    1000 = ets:info(T, size),
+    ets:delete(T),
+    verify_etsmem(EtsMem).
+
+info_many_snapshot_loop(T) ->
+    _ = ets:info(T, size),
+    info_many_snapshot_loop(T).
+
+info_many_size_loop(T, Max, PrevSize) ->
+    [Size] = ets:info_many([T], size),
+    if
+        Size < PrevSize -> ct:fail({decreasing, PrevSize, Size});
+        Size > Max + 1 -> ct:fail({too_large, Size});
+        true -> ok
+    end,
+    case ets:member(T, done) of
+        true -> ok;
+        false -> info_many_size_loop(T, Max, Size)
+    end.
+
 %% Tests that calling the ets:delete operation on a table T with
 %% decentralized counters works while ets:info(T, size) operations are
 %% active
@@ -5855,6 +6133,293 @@ shrink_pseudo_deleted_do(Type) ->
     ets:delete(T),
     process_flag(scheduler,0).
 
+%% Hash tables with incremental_resize are split and joined by scheduler
+%% aux work towards the configured load factor.
+incremental_resize(Config) when is_list(Config) ->
+    {'EXIT',{badarg,_}} = (catch ets:new(t, [{load_factor, 0.1}])),
+    {'EXIT',{badarg,_}} = (catch ets:new(t, [{load_factor, 17}])),
+    {'EXIT',{badarg,_}} = (catch ets:new(t, [{load_factor, a}])),
+    {'EXIT',{badarg,_}} = (catch ets:new(t, [{incremental_resize, a}])),
+    OSet = ets:new(t, [ordered_set, {incremental_resize, true}]),
+    false = ets:info(OSet, load_factor),
+    false = ets:info(OSet, incremental_resize),
+    false = ets:info(OSet, resize),
+    false = ets:info(OSet, chain_length_histogram),
+    ets:delete(OSet),
+    repeat_for_opts(fun incremental_resize_do/1,
+                    [[set,bag,duplicate_bag], write_concurrency,
+                     [{load_factor,0.5}, {load_factor,1}, {load_factor,4.0}]]).
+
+incremental_resize_do(Opts) ->
+    EtsMem = etsmem(),
+    T = ets_new(t, [public, {incremental_resize, true} | Opts]),
+    {load_factor, LoadFactor} = lists:keyfind(load_factor, 1, Opts),
+    true = (LoadFactor == ets:info(T, load_factor)),
+    true = ets:info(T, incremental_resize),
+    N = 50000,
+    Workers = 4,
+    Pids = [my_spawn_opt(fun() ->
+                                 [true = ets:insert(T, {K, K})
+                                  || K <- lists:seq(W, N, Workers)]
+                         end, [link, monitor])
+            || W <- lists:seq(1, Workers)],
+    [receive {'DOWN', Ref, process, Pid, normal} -> ok end
+     || {Pid, Ref} <- Pids],
+    N = ets:info(T, size),
+    Grown = incremental_resize_wait(T, LoadFactor),
+    Buckets = proplists:get_value(buckets, Grown),
+    true = Buckets >= N / LoadFactor,
+    true = proplists:get_value(splits, Grown) > 0,
+    Hist = ets:info(T, chain_length_histogram),
+    16 = length(Hist),
+    Buckets = lists:sum(Hist),
+    [[{K, K}] = ets:lookup(T, K) || K <- lists:seq(1, N)],
+    [true = ets:delete(T, K) || K <- lists:seq(1, N)],
+    Shrunk = incremental_resize_wait(T, LoadFactor),
+    256 = proplists:get_value(buckets, Shrunk),
+    true = proplists:get_value(joins, Shrunk) > 0,
+    true = proplists:get_value(aux_jobs, Shrunk) > 0,
+    ets:delete(T),
+    verify_etsmem(EtsMem).
+
+%% ordered_set tables with write_concurrency split and join base nodes
+%% within the configured contention limits and count doing so.
+catree_adaptation(Config) when is_list(Config) ->
+    EtsMem = etsmem(),
+    WC = {write_concurrency, true},
+    [{'EXIT',{badarg,_}} = (catch ets:new(t, [ordered_set, WC,
+                                              {contention_limits, Limits}]))
+     || Limits <- [{1, 10}, {-10, 0}, {-20000, 10}, {-10, 20000},
+                   {-10, 1.5}, {a, b}, foo]],
+    [begin
+         T = ets:new(t, Opts),
+         false = ets:info(T, contention_limits),
+         false = ets:info(T, adaptation),
+         ets:delete(T)
+     end || Opts <- [[set, WC], [ordered_set], [ordered_set, {contention_limits, {-1, 1}}]]],
+    Default = ets:new(t, [ordered_set, WC]),
+    {-1000, 1000} = ets:info(Default, contention_limits),
+    [{splits, 0}, {joins, 0}, {lock_waits, 0}] = ets:info(Default, adaptation),
+    ets:delete(Default),
+
+    %% Split on the first contended lock and (almost) never join
+    T1 = ets:new(t, [ordered_set, public, WC, {contention_limits, {-19999, 1}}]),
+    {-19999, 1} = ets:info(T1, contention_limits),
+    case erlang:system_info(schedulers_online) of
+        1 ->
+            ok;
+        NScheds ->
+            catree_adaptation_contend(T1, NScheds, 500),
+            Adapted = ets:info(T1, adaptation),
+            io:format("Adapted: ~p Stats: ~p\n", [Adapted, ets:info(T1, stats)]),
+            true = proplists:get_value(lock_waits, Adapted) > 0,
+            true = proplists:get_value(splits, Adapted) > 0
+    end,
+    ets:delete(T1),
+
+    %% Join as soon as there is no contention
+    T2 = ets:new(t, [ordered_set, public, WC, {contention_limits, {-1, 19999}}]),
+    erts_debug:set_internal_state(ets_force_split, {T2, true}),
+    [ets:insert(T2, {K}) || K <- lists:seq(1, 1000)],
+    erts_debug:set_internal_state(ets_force_split, {T2, false}),
+    {RouteNodes, _, _} = ets:info(T2, stats),
+    true = RouteNodes > 0,
+    [ets:insert(T2, {K}) || _ <- lists:seq(1, 10), K <- lists:seq(1, 1000)],
+    {FewerRouteNodes, _, _} = ets:info(T2, stats),
+    true = FewerRouteNodes < RouteNodes,
+    true = proplists:get_value(joins, ets:info(T2, adaptation)) > 0,
+    1000 = ets:info(T2, size),
+    ets:delete(T2),
+    verify_etsmem(EtsMem).
+
+catree_adaptation_contend(T, NProcs, Ms) ->
+    Parent = self(),
+    Pids = [my_spawn_link(
+              fun() ->
+                      catree_adaptation_contend_loop(T, Parent)
+              end) || _ <- lists:seq(1, NProcs)],
+    receive after Ms -> ok end,
+    [Pid ! stop || Pid <- Pids],
+    [receive {done, Pid} -> ok end || Pid <- Pids],
+    ok.
+
+catree_adaptation_contend_loop(T, Parent) ->
+    receive
+        stop -> Parent ! {done, self()}
+    after 0 ->
+            K = rand:uniform(10000),
+            ets:insert(T, {K}),
+            ets:delete(T, K + 1),
+            catree_adaptation_contend_loop(T, Parent)
+    end.
+
+%% ets:info(T, stats) and ets:info(T, chain_length_histogram) walk hash
+%% tables in several slices.
+hash_stats(Config) when is_list(Config) ->
+    repeat_for_opts(fun hash_stats_do/1,
+                    [[set,bag,duplicate_bag], write_concurrency, compressed]).
+
+hash_stats_do(Opts) ->
+    EtsMem = etsmem(),
+    T = ets_new(t, [public | Opts]),
+    N = 100000,
+    filltabint(T, N),
+    N = ets:info(T, size),
+    {Buckets, AvgLen, StdDev, ExpSD, MinLen, MaxLen, 0,
+     BytesPerObject, Contention} = ets:info(T, stats),
+    true = is_float(AvgLen) andalso is_float(StdDev) andalso is_float(ExpSD),
+    true = MinLen =< AvgLen andalso AvgLen =< MaxLen,
+    true = (Buckets =:= proplists:get_value(buckets, ets:info(T, resize))),
+    %% At least the tuple and a small key and value
+    true = BytesPerObject >= 3 * erlang:system_info(wordsize),
+    case ets:info(T, write_concurrency) of
+        true -> 64 = length(Contention);
+        false -> [] = Contention
+    end,
+    true = lists:all(fun(C) -> is_integer(C) andalso C >= 0 end, Contention),
+    Hist = ets:info(T, chain_length_histogram),
+    Buckets = lists:sum(Hist),
+    N = lists:sum([Len*Cnt || {Len,Cnt} <- lists:zip(lists:seq(0, 15), Hist)]),
+    %% The table may go away while the stats are computed
+    {Pid, Ref} = my_spawn_opt(fun() -> hash_stats_loop(T) end,
+                              [link, monitor]),
+    receive after 10 -> ok end,
+    ets:delete(T),
+    receive {'DOWN', Ref, process, Pid, normal} -> ok end,
+    verify_etsmem(EtsMem).
+
+hash_stats_loop(T) ->
+    case ets:info(T, stats) of
+        undefined -> ok;
+        Stats when tuple_size(Stats) =:= 9 -> hash_stats_loop(T)
+    end.
+
+%% Hash tables in read_mode shared_literal return objects without
+%% copying, and the objects stay valid for readers after they have been
+%% overwritten, updated or deleted.
+read_mode_shared_literal(Config) when is_list(Config) ->
+    {'EXIT',{badarg,_}} = (catch ets:new(t, [{read_mode, a}])),
+    [begin
+         T = ets:new(t, Opts),
+         copy = ets:info(T, read_mode),
+         ets:delete(T)
+     end || Opts <- [[], [{read_mode, copy}],
+                     [ordered_set, {read_mode, shared_literal}],
+                     [compressed, {read_mode, shared_literal}]]],
+    repeat_for_opts(fun read_mode_shared_literal_do/1,
+                    [[set,bag,duplicate_bag], write_concurrency,
+                     read_concurrency]).
+
+read_mode_shared_literal_do(Opts) ->
+    EtsMem = etsmem(),
+    LiteralMem = erts_debug:alloc_blocks_size(literal_alloc),
+    T = ets_new(t, [public, {read_mode, shared_literal} | Opts]),
+    shared_literal = ets:info(T, read_mode),
+    Big = lists:seq(1, 1000),
+    Bin = list_to_binary(lists:duplicate(100, $a)),
+    Obj = {key, Big, Bin, fun() -> Big end, 0},
+    true = ets:insert(T, Obj),
+    true = ets:insert(T, {other, Big}),
+    [O1] = ets:lookup(T, key),
+    [O2] = ets:lookup(T, key),
+    true = erts_debug:same(O1, O2),
+    Obj = O1,
+    [[O3], []] = ets:lookup_many(T, [key, nokey]),
+    true = erts_debug:same(O1, O3),
+    BinElem = case ets:lookup_element(T, key, 3) of
+                  [E] -> E; % bag
+                  E -> E
+              end,
+    true = erts_debug:same(element(3, O1), BinElem),
+    Self = self(),
+    Holder = my_spawn_link(fun() ->
+                                   [H] = ets:lookup(T, key),
+                                   Self ! {self(), ready},
+                                   receive check -> Self ! {self(), H} end
+                           end),
+    receive {Holder, ready} -> ok end,
+    case ets:info(T, type) of
+        set ->
+            1 = ets:update_counter(T, key, {5, 1}),
+            true = ets:update_element(T, key, {3, updated}),
+            [{key, Big, updated, _, 1}] = ets:lookup(T, key),
+            true = ets:insert(T, {key, overwritten}),
+            [{key, overwritten}] = ets:lookup(T, key);
+        _ ->
+            true = ets:insert(T, {key, added}),
+            2 = length(ets:lookup(T, key))
+    end,
+    true = ets:delete(T, key),
+    [] = ets:lookup(T, key),
+    %% Small objects are packed into shared literal areas
+    Calls = literal_alloc_calls(),
+    [true = ets:insert(T, {I, [I]}) || I <- lists:seq(1, 1000)],
+    [{500, [500]}] = ets:lookup(T, 500),
+    true = literal_alloc_calls() - Calls < 100,
+    [true = ets:delete(T, I) || I <- lists:seq(1, 1000)],
+    %% The objects left in mostly emptied chunks are moved out of them
+    [true = ets:insert(T, {I, [I]}) || I <- lists:seq(1, 20000)],
+    [Kept] = ets:lookup(T, 100),
+    Peak = ets:info(T, memory),
+    [true = ets:delete(T, I) || I <- lists:seq(1, 20000), I rem 100 =/= 0],
+    true = ets:info(T, memory) < Peak div 5,
+    [[{I, [I]}] = ets:lookup(T, I) || I <- lists:seq(100, 20000, 100)],
+    %% Objects never read are freed at once, the others when no process
+    %% refers to them anymore.
+    true = ets:delete(T),
+    wait_for_literal_release(LiteralMem),
+    erlang:garbage_collect(),
+    Obj = O1,
+    {100, [100]} = Kept,
+    Holder ! check,
+    receive {Holder, Obj} -> ok end,
+    verify_etsmem(EtsMem).
+
+literal_alloc_calls() ->
+    case erlang:system_info({allocator, literal_alloc}) of
+        false ->
+            0;
+        Instances ->
+            lists:sum([G * 1000000000 + N
+                       || {instance, _, Info} <- Instances,
+                          {calls, Calls} <- Info,
+                          {literal_alloc, G, N} <- Calls])
+    end.
+
+%% Wait a while for objects queued for the literal area collector to be
+%% released. Modules loaded meanwhile may keep the size up.
+wait_for_literal_release(undefined) ->
+    ok;
+wait_for_literal_release(Size) ->
+    repeat_while(fun(0) ->
+                         {false, timeout};
+                    (N) ->
+                         case erts_debug:alloc_blocks_size(literal_alloc) of
+                             NewSize when NewSize > Size ->
+                                 receive after 10 -> ok end,
+                                 {true, N - 1};
+                             _ ->
+                                 {false, ok}
+                         end
+                 end, 500).
+
+%% Wait until the table neither needs to grow nor shrink
+incremental_resize_wait(T, LoadFactor) ->
+    repeat_while(fun(_) ->
+                         Info = ets:info(T, resize),
+                         Size = ets:info(T, size),
+                         Buckets = proplists:get_value(buckets, Info),
+                         Limit = trunc(Buckets * LoadFactor),
+                         case Size =< Limit andalso
+                             (Buckets =:= 256 orelse Size >= Limit div 2) of
+                             true ->
+                                 {false, Info};
+                             false ->
+                                 receive after 10 -> ok end,
+                                 {true, Info}
+                         end
+                 end, []).
+
 
 
 meta_lookup_unnamed_read(Config) when is_list(Config) ->
@@ -6188,7 +6753,7 @@ verify_table_load(T) ->
         ordered_set -> ok;
         _ ->
             Stats = ets:info(T,stats),
-            {Buckets,AvgLen,StdDev,ExpSD,_MinLen,_MaxLen,_} = Stats,
+            {Buckets,AvgLen,StdDev,ExpSD,_MinLen,_MaxLen,_,_,_} = Stats,
             ok = if
                      AvgLen > 1.2 ->
                          io:format("Table overloaded: Stats=~p\n~p\n",
@@ -6332,6 +6897,69 @@ smp_select_replace_do(Opts) ->
     true = ets:delete(T),
     ok.
 
+%% Lookups that bypass the bucket locks of hash tables with both
+%% read_concurrency and write_concurrency must only ever see complete
+%% objects while they are concurrently replaced, updated and deleted.
+smp_lockfree_lookup(Config) when is_list(Config) ->
+    repeat_for_opts(fun smp_lockfree_lookup_do/1,
+                    [[set,bag,duplicate_bag]]).
+
+smp_lockfree_lookup_do(Opts) ->
+    KeyRange = 1000,
+    T = ets_new(smp_lockfree_lookup,
+                [public, {read_concurrency, true}, {write_concurrency, true}
+                 | Opts],
+                KeyRange),
+    Type = ets:info(T, type),
+    RefcBin = list_to_binary(lists:seq(1, 100)),
+    Obj = fun(K, V) -> {K, V, 2*V, RefcBin} end,
+    CheckObj = fun(K, {K2, V, V2, Bin}) when K2 =:= K, V2 =:= 2*V,
+                                             Bin =:= RefcBin ->
+                       ok;
+                  (K, Other) ->
+                       ct:fail({bad_object, K, Other})
+               end,
+    InitF = fun (_) -> 0 end,
+    ExecF = fun (Lookups) ->
+                    K = rand:uniform(KeyRange),
+                    V = rand:uniform(100),
+                    case rand:uniform(10) of
+                        1 -> ets:insert(T, Obj(K, V));
+                        2 -> ets:delete(T, K);
+                        3 -> ets:delete_object(T, Obj(K, V));
+                        4 when Type =:= set ->
+                            ets:update_counter(T, K, [{2,1},{3,2}], Obj(K, 0));
+                        5 when Type =:= set ->
+                            ets:update_element(T, K, [{2,V},{3,2*V}]);
+                        6 ->
+                            %% Grow and shrink the table
+                            Ks = [K*KeyRange + I || I <- lists:seq(1, 100)],
+                            ets:insert(T, [Obj(K2, V) || K2 <- Ks]),
+                            [ets:delete(T, K2) || K2 <- Ks];
+                        _ ->
+                            ok
+                    end,
+                    Objs = ets:lookup(T, K),
+                    [CheckObj(K, O) || O <- Objs],
+                    true = (Type =/= set orelse length(Objs) =< 1),
+                    true = is_boolean(ets:member(T, K)),
+                    receive stop ->
+                            [end_of_work | Lookups+1]
+                    after 0 ->
+                            Lookups+1
+                    end
+            end,
+    FiniF = fun (Lookups) -> Lookups end,
+    Pids = run_sched_workers(InitF, ExecF, FiniF, infinite),
+    receive after 3*1000 -> ok end,
+    [P ! stop || P <- Pids],
+    Results = wait_pids(Pids),
+    io:format("~p lookups\n", [lists:sum(Results)]),
+    Size = ets:info(T, size),
+    Size = length(ets:tab2list(T)),
+    true = ets:delete(T),
+    ok.
+
 %% Iterate ordered_set with write_concurrency
 %% and make sure we hit all "stable" long lived keys
 %% while "volatile" objects are randomly inserted and deleted.
@@ -7349,6 +7977,155 @@ lookup_catree_par_vs_seq_init_benchmark() ->
           print_result_paths_fun = fun stdout_notify_res/2
         }).
 
+%% Lookup throughput of hash tables for an increasing number of
+%% concurrent readers, compare with and without bucket lock free reads
+%% (read_concurrency combined with write_concurrency).
+lookup_hash_concurrency_benchmark() ->
+    N = erlang:system_info(schedulers),
+    throughput_benchmark(
+      #ets_throughput_bench_config{
+         benchmark_duration_ms = 10000,
+         recover_time_ms = 1000,
+         thread_counts = [X || X <- lists:usort([1,2,4,8,16,32,64,N div 2,N]),
+                               X > 0, X =< N],
+         key_ranges = [1000, 1000000],
+         init_functions = [fun prefill_table/4],
+         nr_of_repeats = 1,
+         scenarios =
+             [
+              [
+               {1.0, lookup}
+              ],
+              [
+               {0.01, insert},
+               {0.01, delete},
+               {0.98, lookup}
+              ]
+             ],
+         table_types =
+             [
+              [set, public, {read_concurrency, true}],
+              [set, public, {write_concurrency, true}],
+              [set, public, {write_concurrency, true}, {read_concurrency, true}]
+             ],
+         print_result_paths_fun = fun stdout_notify_res/2
+        }).
+
+%% Full table select time with threaded match spec execution compared
+%% to the switch interpreter (ets_match_threaded internal state).
+select_match_backend_benchmark() ->
+    erts_debug:set_internal_state(available_internal_state, true),
+    NrOfObjects = 200000,
+    NrOfRepeats = 20,
+    MatchSpecs =
+        [{"element const", [{{'_', 3, '_', '_'}, [], [true]}]},
+         {"key guard", [{{'$1', '_', foo, '_'}, [{'>', '$1', 100}], [true]}]},
+         {"nested guard", [{{'_', '$1', '_', {'$2'}},
+                            [{'>', '$1', 5}, {'<', '$2', 1000}],
+                            [true]}]}],
+    TableTypes = [[set, public],
+                  [ordered_set, public],
+                  [ordered_set, public, {write_concurrency, true}]],
+    Time =
+        fun(T, MS, Threaded) ->
+                case erts_debug:set_internal_state(ets_match_threaded,
+                                                   Threaded) of
+                    ok ->
+                        {Us, _} = timer:tc(
+                                    fun() ->
+                                            [ets:select_count(T, MS)
+                                             || _ <- lists:seq(1, NrOfRepeats)]
+                                    end),
+                        Us;
+                    notsup ->
+                        notsup
+                end
+        end,
+    try
+        [begin
+             T = ets:new(t, TableType),
+             ets:insert(T, [{K, K rem 10, foo, {K}}
+                            || K <- lists:seq(1, NrOfObjects)]),
+             [begin
+                  Switch = Time(T, MS, false),
+                  Threaded = Time(T, MS, true),
+                  io:format("~p ~s: switch ~p us, threaded ~p us~n",
+                            [TableType, Name, Switch, Threaded])
+              end || {Name, MS} <- MatchSpecs],
+             ets:delete(T)
+         end || TableType <- TableTypes],
+        ok
+    after
+        _ = erts_debug:set_internal_state(ets_match_threaded, true),
+        erts_debug:set_internal_state(available_internal_state, false)
+    end.
+
+%% Bursty mixed range scan/insert load on ordered_set tables with
+%% write_concurrency, for a few contention limits. Prints throughput and
+%% base node splits and joins for each phase. A policy that thrashes joins
+%% base nodes in the quiet phases only to split them again in the next
+%% burst.
+catree_adaptation_benchmark() ->
+    NrOfSchedulers = erlang:system_info(schedulers_online),
+    KeyRange = 100000,
+    PhaseMs = 1000,
+    Phases = lists:append(lists:duplicate(4, [{burst, NrOfSchedulers},
+                                              {quiet, 1}])),
+    Counters = [splits, joins, lock_waits],
+    RunPhase =
+        fun({Phase, NrOfProcs}, {T, Prev}) ->
+                Ops = catree_adaptation_bench_phase(T, NrOfProcs, KeyRange,
+                                                    PhaseMs),
+                Info = ets:info(T, adaptation),
+                {RouteNodes, _, _} = ets:info(T, stats),
+                [Splits, Joins, LockWaits] =
+                    [proplists:get_value(C, Info) - proplists:get_value(C, Prev)
+                     || C <- Counters],
+                io:format("~-5w ~3w procs: ~10w ops/s ~6w splits ~6w joins "
+                          "~8w lock waits ~5w route nodes~n",
+                          [Phase, NrOfProcs, Ops * 1000 div PhaseMs,
+                           Splits, Joins, LockWaits, RouteNodes]),
+                {T, Info}
+        end,
+    lists:foreach(
+      fun(Limits) ->
+              T = ets:new(t, [ordered_set, public, {write_concurrency, true},
+                              {contention_limits, Limits}]),
+              ets:insert(T, [{K} || K <- lists:seq(1, KeyRange, 2)]),
+              io:format("~nContention limits ~p:~n", [Limits]),
+              lists:foldl(RunPhase, {T, ets:info(T, adaptation)}, Phases),
+              ets:delete(T)
+      end,
+      [{-1000, 1000}, {-4000, 1000}, {-4000, 4000}, {-16000, 1000}]).
+
+catree_adaptation_bench_phase(T, NrOfProcs, KeyRange, Ms) ->
+    Parent = self(),
+    Pids = [spawn_link(fun() ->
+                               catree_adaptation_bench_loop(T, KeyRange,
+                                                            Parent, 0)
+                       end) || _ <- lists:seq(1, NrOfProcs)],
+    receive after Ms -> ok end,
+    [Pid ! stop || Pid <- Pids],
+    lists:sum([receive {ops, Pid, Ops} -> Ops end || Pid <- Pids]).
+
+catree_adaptation_bench_loop(T, KeyRange, Parent, Ops) ->
+    receive
+        stop -> Parent ! {ops, self(), Ops}
+    after 0 ->
+            K = rand:uniform(KeyRange),
+            case K rem 10 of
+                0 ->
+                    ets:select_count(T, [{{'$1'}, [{'>=', '$1', K},
+                                                   {'<', '$1', K + 100}],
+                                          [true]}]);
+                N when N < 5 ->
+                    ets:insert(T, {K});
+                _ ->
+                    ets:delete(T, K)
+            end,
+            catree_adaptation_bench_loop(T, KeyRange, Parent, Ops + 1)
+    end.
+
 add_lists(L1,L2) ->
     add_lists(L1,L2,[]).
 add_lists([],[],Acc) ->
@@ -28,7 +28,7 @@
 	 pcre_compile_workspace_overflow/1,re_infinite_loop/1, 
 	 re_backwards_accented/1,opt_dupnames/1,opt_all_names/1,inspect/1,
 	 opt_no_start_optimize/1,opt_never_utf/1,opt_ucp/1,
-	 match_limit/1,sub_binaries/1,copt/1]).
+	 match_limit/1,sub_binaries/1,copt/1,opt_jit/1,run_cache/1]).
 
 -include_lib("common_test/include/ct.hrl").
 -include_lib("kernel/include/file.hrl").
@@ -45,7 +45,7 @@ all() ->
      pcre_compile_workspace_overflow, re_infinite_loop, 
      re_backwards_accented, opt_dupnames, opt_all_names, 
      inspect, opt_no_start_optimize,opt_never_utf,opt_ucp,
-     match_limit, sub_binaries, re_version].
+     match_limit, sub_binaries, re_version, opt_jit, run_cache].
 
 groups() -> 
     [].
@@ -891,6 +891,113 @@ match_limit(Config) when is_list(Config) ->
 					 [{match_limit,-1},
 					  report_errors,global])),
     ok.
+%% Check that patterns compiled with the jit option give the same
+%% results as interpreted patterns.
+opt_jit(Config) when is_list(Config) ->
+    Cases = [{"ABDabcdABCD","abcd",[]},
+             {"ABDabcdABCD","ABCD",[caseless]},
+             {"2019-03-11 12:45:01 ERROR [db] connection refused",
+              "^(\\d{4}-\\d{2}-\\d{2}) (\\S+) (ERROR|WARN|INFO) \\[(\\w+)\\]",[]},
+             {"line1\nline2\n","^line(\\d)$",[multiline]},
+             {"a\nb","a.b",[dotall]},
+             {"aaab","a+?",[ungreedy]},
+             {[967,$a,$b],"\\w+",[unicode,ucp]},
+             {"key=val other=x","(?<k>\\w+)=(?<v>\\w+)",[dupnames]},
+             {"abcabc","x",[]}],
+    RunOpts = [[],
+               [{capture,all,list}],
+               [{capture,all,binary},notempty],
+               [global],
+               [global,{capture,first,index}],
+               [{offset,1}],
+               [notbol,noteol],
+               [anchored],
+               [{newline,any}]],
+    _ = [begin
+             {ok,MP} = re:compile(RE, COpts),
+             {ok,JitMP} = re:compile(RE, [jit|COpts]),
+             Expected = re:run(Subj, MP, ROpts),
+             Expected = re:run(Subj, JitMP, ROpts),
+             Expected = re:run(Subj, RE, [jit|COpts++ROpts]),
+             Expected = re:run(unicode:characters_to_binary(Subj),
+                               JitMP, ROpts)
+         end || {Subj,RE,COpts} <- Cases, ROpts <- RunOpts],
+
+    {ok,NamedMP} = re:compile("(?<A>A)|(?<B>B)",[jit]),
+    {namelist,[<<"A">>,<<"B">>]} = re:inspect(NamedMP,namelist),
+
+    %% A jit pattern is only usable as a compiled pattern, not to be
+    %% compiled again.
+    {'EXIT',{badarg,_}} = (catch re:run("abc", NamedMP, [jit])),
+
+    %% Split and replace accept the option.
+    [<<"a">>,<<"b">>,<<"c">>] = re:split("a,b,c", ",", [jit]),
+    "a;b;c" = re:replace("a,b,c", ",", ";", [jit,global,{return,list}]),
+
+    %% Long subjects and catastrophic backtracking fall back to the
+    %% interpreter, which yields.
+    Long = binary:copy(<<"abcdefghij">>, 100000),
+    {ok,LongMP} = re:compile("j(a)", [jit]),
+    {match,[{9,2},{10,1}]} = re:run(Long, LongMP),
+    99999 = length(element(2, re:run(Long, LongMP, [global]))),
+    Backtrack = lists:duplicate(30, $a) ++ "z",
+    {ok,BacktrackMP} = re:compile("(a+)*zz", [jit]),
+    nomatch = re:run(Backtrack, BacktrackMP),
+    {error,match_limit} = re:run(Backtrack, BacktrackMP,
+                                 [{match_limit,3000},report_errors]),
+    ok.
+
+%% Check that textual regular expressions given to re:run/3 are
+%% cached with their compile options.
+run_cache(Config) when is_list(Config) ->
+    #{entries := _, evictions := _, hits := _, misses := _,
+      max_entries := MaxEntries} = erlang:system_info(re_cache),
+    true = MaxEntries >= erlang:system_info(schedulers),
+    Schedulers = erlang:system_info(schedulers),
+    N = 1000,
+    RE = "^run_cache (\\w+)",
+    Subject = <<"run_cache hit">>,
+    #{hits := Hits0} = erlang:system_info(re_cache),
+    _ = [{match,[{0,13},{10,3}]} = re:run(Subject, RE) || _ <- lists:seq(1, N)],
+    #{hits := Hits1} = erlang:system_info(re_cache),
+    true = Hits1 - Hits0 >= N - Schedulers,
+
+    %% The compile options are part of the key.
+    _ = [begin
+             {match,[{0,13},{10,3}]} = re:run(Subject, RE, []),
+             nomatch = re:run(<<"RUN_CACHE hit">>, RE, []),
+             {match,[{0,13},{10,3}]} = re:run(<<"RUN_CACHE hit">>, RE,
+                                              [caseless]),
+             {match,[{0,13},{10,3}]} = re:run(Subject, RE, [caseless]),
+             {match,[{0,13},{10,3}]} = re:run(Subject, list_to_binary(RE),
+                                              [unicode]),
+             {match,[{0,13},{10,3}]} = re:run(Subject, RE,
+                                              [{newline,crlf}]),
+             {match,[{0,13},{10,3}]} = re:run(Subject, RE, [multiline])
+         end || _ <- lists:seq(1, 10)],
+    {match,[[{0,13},{10,3}]]} = re:run(Subject, RE, [global]),
+    {error,{compile,_}} = re:run(Subject, "(", [report_errors]),
+    {error,{compile,_}} = re:run(Subject, "(", [report_errors]),
+    {'EXIT',{badarg,_}} = (catch re:run(Subject, "(")),
+
+    %% Filling the cache with distinct expressions evicts the least
+    %% recently used ones.
+    #{evictions := Evictions0} = erlang:system_info(re_cache),
+    _ = [{match,_} = re:run(integer_to_list(I), integer_to_list(I))
+         || I <- lists:seq(1, 2 * MaxEntries)],
+    #{evictions := Evictions1, entries := Entries} =
+        erlang:system_info(re_cache),
+    true = Evictions1 > Evictions0,
+    true = Entries =< MaxEntries,
+
+    %% Long expressions are not cached.
+    Long = lists:duplicate(2000, $a),
+    #{hits := Hits2} = erlang:system_info(re_cache),
+    _ = [{match,[{0,2000}]} = re:run(Long, Long) || _ <- lists:seq(1, N)],
+    #{hits := Hits3} = erlang:system_info(re_cache),
+    true = Hits3 - Hits2 < N,
+    ok.
+
 %% Test that we get sub-binaries if subject is a binary and we capture
 %% binaries.
 sub_binaries(Config) when is_list(Config) ->
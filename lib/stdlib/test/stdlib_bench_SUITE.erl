@@ -29,7 +29,7 @@ suite() -> [{ct_hooks,[{ts_install_cth,[{nodenames,2}]}]}].
 
 
 all() ->
-    [{group,unicode},{group,base64},{group,binary},
+    [{group,unicode},{group,base64},{group,binary},{group,re},
      {group,gen_server},{group,gen_statem},
      {group,gen_server_comparison},{group,gen_statem_comparison}].
 
@@ -45,6 +45,11 @@ groups() ->
        matches_single_pattern_no_match,
        matches_single_pattern_eventual_match,
        matches_single_pattern_frequent_match]},
+     {re, [{repeat, 3}],
+      [re_log_timestamp, re_log_timestamp_jit,
+       re_log_error, re_log_error_jit,
+       re_log_ipv4, re_log_ipv4_jit,
+       re_log_key_value, re_log_key_value_jit]},
      {base64,[{repeat,5}],
       [decode_binary, decode_binary_to_string,
        decode_list, decode_list_to_string,
@@ -182,6 +187,63 @@ matches_single_pattern_frequent_match(_Config) ->
 
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+%% Typical regular expressions for picking apart log files, matched
+%% with and without the jit compile option.
+
+re_log_timestamp(_Config) ->
+    comment(re_log(timestamp, [])).
+
+re_log_timestamp_jit(_Config) ->
+    comment(re_log(timestamp, [jit])).
+
+re_log_error(_Config) ->
+    comment(re_log(error, [])).
+
+re_log_error_jit(_Config) ->
+    comment(re_log(error, [jit])).
+
+re_log_ipv4(_Config) ->
+    comment(re_log(ipv4, [])).
+
+re_log_ipv4_jit(_Config) ->
+    comment(re_log(ipv4, [jit])).
+
+re_log_key_value(_Config) ->
+    comment(re_log(key_value, [])).
+
+re_log_key_value_jit(_Config) ->
+    comment(re_log(key_value, [jit])).
+
+re_log(Kind, Opts) ->
+    {ok, MP} = re:compile(log_regex(Kind), [multiline|Opts]),
+    test(100, re, run, [log_lines(), MP, [global]]).
+
+log_regex(timestamp) ->
+    "^(\\d{4}-\\d{2}-\\d{2})T(\\d{2}:\\d{2}:\\d{2})\\.\\d+Z \\[(\\w+)\\]";
+log_regex(error) ->
+    "\\[(?:ERROR|CRITICAL)\\].*\\b(timeout|refused|closed)\\b";
+log_regex(ipv4) ->
+    "\\b(?:\\d{1,3}\\.){3}\\d{1,3}\\b";
+log_regex(key_value) ->
+    "(\\w+)=(\"[^\"]*\"|\\S+)".
+
+log_lines() ->
+    Levels = {"DEBUG", "INFO", "INFO", "WARNING", "ERROR", "CRITICAL"},
+    Events = {"connection refused", "request served", "timeout waiting for reply",
+              "socket closed by peer", "cache miss"},
+    iolist_to_binary(
+      [io_lib:format("2019-03-~2..0wT~2..0w:~2..0w:~2..0w.~3..0wZ [~s] "
+                     "peer=10.~w.~w.~w user=\"u~w\" ~s\n",
+                     [I rem 28 + 1, I rem 24, I rem 60, (I * 7) rem 60,
+                      I rem 1000,
+                      element(I rem tuple_size(Levels) + 1, Levels),
+                      I rem 256, (I div 256) rem 256, (I * 13) rem 256,
+                      I rem 97,
+                      element(I rem tuple_size(Events) + 1, Events)])
+       || I <- lists:seq(1, 1000)]).
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 decode_binary(_Config) ->
     comment(test(base64, decode, [encoded_binary()])).
 